@@ -25,12 +25,6 @@
  * @{
  */
 
-#if defined(WIN32)
-#include <windows.h>
-#else
-#include <sys/time.h>
-#endif
-
 #include "ch.h"
 
 /*===========================================================================*/
@@ -110,22 +104,14 @@ void _port_thread_start(msg_t (*pf)(void *), void *p) {
 
 /**
  * @brief   Returns the current value of the realtime counter.
+ * @note    The counter is derived from the simulator clock, it counts
+ *          microseconds.
  *
  * @return              The realtime counter value.
  */
 rtcnt_t port_rt_get_counter_value(void) {
-#if defined(WIN32)
-  LARGE_INTEGER n;
 
-  QueryPerformanceCounter(&n);
-
-  return (rtcnt_t)(n.QuadPart / 1000LL);
-#else
-  struct timeval tv;
-
-  gettimeofday(&tv, NULL);
-  return ((rtcnt_t)tv.tv_sec * (rtcnt_t)1000000) + (rtcnt_t)tv.tv_usec;
-#endif
+  return (rtcnt_t)(_sim_get_time() / 1000U);
 }
 
 /** @} */
@@ -303,7 +303,9 @@ extern "C" {
                                                            void *p);
   /*lint -restore*/
   rtcnt_t port_rt_get_counter_value(void);
+  uint64_t _sim_get_time(void);
   void _sim_check_for_interrupts(void);
+  void _sim_wait_for_interrupts(void);
 #ifdef __cplusplus
 }
 #endif
@@ -431,11 +433,12 @@ static inline void port_enable(void) {
  *          The simplest implementation is an empty function or macro but this
  *          would not take advantage of architecture-specific power saving
  *          modes.
- * @note    Implemented as an inlined @p WFI instruction.
+ * @note    The host process is blocked until the next simulated
+ *          interrupt.
  */
 static inline void port_wait_for_interrupt(void) {
 
-  _sim_check_for_interrupts();
+  _sim_wait_for_interrupts();
 }
 
 #endif /* !defined(_FROM_ASM_) */
@@ -0,0 +1,209 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    SIMX64/chcore.c
+ * @brief   Simulator on x86-64 port code.
+ *
+ * @addtogroup SIMX64_GCC_CORE
+ * @{
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "ch.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+PORT_CORE_LOCAL bool port_isr_context_flag;
+PORT_CORE_LOCAL syssts_t port_irq_sts;
+#if (PORT_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Identifier of the core running on the current host thread.
+ */
+PORT_CORE_LOCAL unsigned port_core_id;
+
+/**
+ * @brief   Kernel spinlock shared by all cores.
+ */
+volatile bool port_spinlock;
+#endif
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+#if (PORT_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Core start parameters.
+ */
+typedef struct {
+  unsigned              core_id;
+  void                  (*corefn)(void);
+} core_start_t;
+#endif
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+#if (PORT_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+static core_start_t core_start[PORT_CORES_NUMBER];
+#endif
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+#if (PORT_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Host thread running a simulated core.
+ *
+ * @param[in] p         pointer to the core start parameters
+ * @return              Never returns.
+ */
+static void *core_thread(void *p) {
+  core_start_t *csp = (core_start_t *)p;
+
+  port_core_id = csp->core_id;
+  port_irq_sts = (syssts_t)0;
+  port_isr_context_flag = false;
+  csp->corefn();
+
+  return NULL;
+}
+#endif
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * Performs a context switch between two threads.
+ * @param ntp the thread to be switched in
+ * @param otp the thread to be switched out
+ */
+__attribute__((used))
+static void __dummy(thread_t *ntp, thread_t *otp) {
+  (void)ntp; (void)otp;
+
+  asm volatile (
+#if defined(__APPLE__)
+                ".globl _port_switch                            \n\t"
+                "_port_switch:"
+#else
+                ".globl port_switch                             \n\t"
+                "port_switch:"
+#endif
+                "push    %%rbp                                  \n\t"
+                "push    %%rbx                                  \n\t"
+                "push    %%r12                                  \n\t"
+                "push    %%r13                                  \n\t"
+                "push    %%r14                                  \n\t"
+                "push    %%r15                                  \n\t"
+                "movq    %%rsp, %c0(%%rsi)                      \n\t"
+                "movq    %c0(%%rdi), %%rsp                      \n\t"
+                "pop     %%r15                                  \n\t"
+                "pop     %%r14                                  \n\t"
+                "pop     %%r13                                  \n\t"
+                "pop     %%r12                                  \n\t"
+                "pop     %%rbx                                  \n\t"
+                "pop     %%rbp                                  \n\t"
+                "ret                                            \n\t"
+#if defined(__APPLE__)
+                ".globl __port_thread_start                     \n\t"
+                "__port_thread_start:"
+#else
+                ".globl _port_thread_start                      \n\t"
+                "_port_thread_start:"
+#endif
+                "movq    %%r12, %%rdi                           \n\t"
+                "movq    %%r13, %%rsi                           \n\t"
+#if defined(__APPLE__)
+                "call    __port_thread_exec"
+#else
+                "call    _port_thread_exec"
+#endif
+                : : "i" (offsetof(thread_t, ctx.sp)));
+}
+
+/**
+ * @brief   Start a thread by invoking its work function.
+ * @details If the work function returns @p chThdExit() is automatically
+ *          invoked.
+ * @note    Invoked by the @p _port_thread_start() trampoline.
+ */
+__attribute__((used, noreturn))
+void _port_thread_exec(msg_t (*pf)(void *), void *p) {
+
+  chSysUnlock();
+  pf(p);
+  chThdExit(0);
+  while(1);
+}
+
+
+/**
+ * @brief   Returns the current value of the realtime counter.
+ * @note    The counter is derived from the simulator clock and counts
+ *          nanoseconds.
+ *
+ * @return              The realtime counter value.
+ */
+rtcnt_t port_rt_get_counter_value(void) {
+
+  return (rtcnt_t)_sim_get_time();
+}
+
+#if (PORT_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a simulated core.
+ * @details A new host thread is created, the specified function is
+ *          executed on it and must invoke @p chSysInit() before using
+ *          any kernel service.
+ * @pre     The first core must have been initialized.
+ *
+ * @param[in] core_id   the identifier of the core to be started, from 1 to
+ *                      @p PORT_CORES_NUMBER - 1
+ * @param[in] corefn    the core main function
+ */
+void port_start_core(unsigned core_id, void (*corefn)(void)) {
+  pthread_t thread;
+
+  chDbgCheck((core_id > 0U) && (core_id < (unsigned)PORT_CORES_NUMBER));
+
+  core_start[core_id].core_id = core_id;
+  core_start[core_id].corefn  = corefn;
+  if (pthread_create(&thread, NULL, core_thread, &core_start[core_id]) != 0) {
+    printf("Unable to start core %u\n", core_id);
+    exit(1);
+  }
+}
+#endif
+
+/** @} */
@@ -0,0 +1,12 @@
+# List of the ChibiOS/RT SIMX64 port files.
+PORTSRC = ${CHIBIOS}/os/common/ports/SIMX64/chcore.c
+
+PORTASM = 
+
+PORTINC = ${CHIBIOS}/os/common/ports/SIMX64/compilers/GCC \
+          ${CHIBIOS}/os/common/ports/SIMX64
+
+# Shared variables
+ALLXASMSRC += $(PORTASM)
+ALLCSRC    += $(PORTSRC)
+ALLINC     += $(PORTINC)
@@ -31,6 +31,41 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Fall-back algorithms sizes
+ * @{
+ */
+/**
+ * @brief   Size of an AES block.
+ */
+#define CRY_AES_BLOCK_SIZE                  16U
+
+/**
+ * @brief   Size of a SHA-1 digest.
+ */
+#define CRY_SHA1_SIZE                       20U
+
+/**
+ * @brief   Size of a SHA-256 digest.
+ */
+#define CRY_SHA256_SIZE                     32U
+
+/**
+ * @brief   Size of a SHA-512 digest.
+ */
+#define CRY_SHA512_SIZE                     64U
+
+/**
+ * @brief   Size of a SHA-1 and SHA-256 input block.
+ */
+#define CRY_SHA256_BLOCK_SIZE               64U
+
+/**
+ * @brief   Size of a SHA-512 input block.
+ */
+#define CRY_SHA512_BLOCK_SIZE               128U
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -96,6 +131,14 @@ typedef enum {
   CRY_ERR_OP_FAILURE = 6                    /**< Failed operation.          */
 } cryerror_t;
 
+/**
+ * @brief   Type of a scatter-gather buffer descriptor.
+ */
+typedef struct {
+  uint8_t                   *base;          /**< @brief Buffer address.     */
+  size_t                    size;           /**< @brief Buffer size.        */
+} cryiovec_t;
+
 /**
  * @brief   Type of an algorithm identifier.
  * @note    It is only used to determine the key required for operations.
@@ -107,6 +150,43 @@ typedef enum {
   cry_algo_hmac                             /**< HMAC variable size.        */
 } cryalgorithm_t;
 
+#if (HAL_CRY_USE_FALLBACK == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a software fall-back AES transient key.
+ * @note    The LLD driver structure embeds it when the LLD does not
+ *          support AES.
+ */
+typedef struct {
+  unsigned                  nr;             /**< @brief Number of rounds,
+                                                        zero if no key has
+                                                        been loaded.        */
+  uint32_t                  ek[60];         /**< @brief Encryption round
+                                                        keys.               */
+  uint32_t                  dk[60];         /**< @brief Decryption round
+                                                        keys for the
+                                                        equivalent inverse
+                                                        cipher.             */
+} cryaeskey_t;
+
+/**
+ * @brief   Type of a software fall-back HMAC transient key.
+ * @note    The LLD driver structure embeds it when the LLD does not
+ *          support HMAC-SHA256 or HMAC-SHA512.
+ * @note    The key is stored zero-padded to the hash block size, keys
+ *          longer than a block are replaced by their digest.
+ */
+typedef struct {
+  bool                      loaded;         /**< @brief A key has been
+                                                        loaded.             */
+  uint8_t                   k256[CRY_SHA256_BLOCK_SIZE];
+                                            /**< @brief Key for
+                                                        HMAC-SHA256.        */
+  uint8_t                   k512[CRY_SHA512_BLOCK_SIZE];
+                                            /**< @brief Key for
+                                                        HMAC-SHA512.        */
+} cryhmackey_t;
+#endif
+
 #if HAL_CRY_ENFORCE_FALLBACK == FALSE
 /* Use the defined low level driver.*/
 #include "hal_crypto_lld.h"
@@ -157,6 +237,8 @@ typedef struct {
 struct CRYDriver {
   crystate_t                state;
   const CRYConfig           *config;
+  cryaeskey_t               fb_aeskey;
+  cryhmackey_t              fb_hmackey;
 };
 #endif /* HAL_CRY_ENFORCE_FALLBACK == TRUE */
 
@@ -165,6 +247,19 @@ struct CRYDriver {
 #include "hal_crypto_fallback.h"
 #endif
 
+#if HAL_CRY_USE_FALLBACK == FALSE
+/* Stub @p AESCTRContext and @p AESGCMContext structure type declarations.
+   The streaming modes are only implemented by the fallback and it is not
+   enabled.*/
+typedef struct {
+  uint32_t dummy;
+} AESCTRContext;
+
+typedef struct {
+  uint32_t dummy;
+} AESGCMContext;
+#endif
+
 #if (HAL_CRY_USE_FALLBACK == FALSE) && (CRY_LLD_SUPPORTS_SHA1 == FALSE)
 /* Stub @p SHA1Context structure type declaration. It is not provided by
    the LLD and the fallback is not enabled.*/
@@ -303,6 +398,64 @@ extern "C" {
                                const uint8_t *iv,
                                size_t tag_size,
                                const uint8_t *tag_in);
+  cryerror_t cryAES_CTRInit(CRYDriver *cryp,
+                            AESCTRContext *ctxp,
+                            crykey_t key_id,
+                            const uint8_t *iv);
+  cryerror_t cryAES_CTRUpdate(CRYDriver *cryp,
+                              AESCTRContext *ctxp,
+                              size_t size,
+                              const uint8_t *in,
+                              uint8_t *out);
+  cryerror_t cryAES_CTRV(CRYDriver *cryp,
+                         crykey_t key_id,
+                         size_t iovcnt,
+                         const cryiovec_t *iov,
+                         const uint8_t *iv);
+  cryerror_t cryAES_GCMInit(CRYDriver *cryp,
+                            AESGCMContext *ctxp,
+                            crykey_t key_id,
+                            const uint8_t *iv);
+  cryerror_t cryAES_GCMUpdateAuth(CRYDriver *cryp,
+                                  AESGCMContext *ctxp,
+                                  size_t size,
+                                  const uint8_t *in);
+  cryerror_t cryEncryptAES_GCMUpdate(CRYDriver *cryp,
+                                     AESGCMContext *ctxp,
+                                     size_t size,
+                                     const uint8_t *in,
+                                     uint8_t *out);
+  cryerror_t cryDecryptAES_GCMUpdate(CRYDriver *cryp,
+                                     AESGCMContext *ctxp,
+                                     size_t size,
+                                     const uint8_t *in,
+                                     uint8_t *out);
+  cryerror_t cryEncryptAES_GCMFinal(CRYDriver *cryp,
+                                    AESGCMContext *ctxp,
+                                    size_t tag_size,
+                                    uint8_t *tag_out);
+  cryerror_t cryDecryptAES_GCMFinal(CRYDriver *cryp,
+                                    AESGCMContext *ctxp,
+                                    size_t tag_size,
+                                    const uint8_t *tag_in);
+  cryerror_t cryEncryptAES_GCMV(CRYDriver *cryp,
+                                crykey_t key_id,
+                                size_t auth_cnt,
+                                const cryiovec_t *auth_iov,
+                                size_t text_cnt,
+                                const cryiovec_t *text_iov,
+                                const uint8_t *iv,
+                                size_t tag_size,
+                                uint8_t *tag_out);
+  cryerror_t cryDecryptAES_GCMV(CRYDriver *cryp,
+                                crykey_t key_id,
+                                size_t auth_cnt,
+                                const cryiovec_t *auth_iov,
+                                size_t text_cnt,
+                                const cryiovec_t *text_iov,
+                                const uint8_t *iv,
+                                size_t tag_size,
+                                const uint8_t *tag_in);
   cryerror_t cryLoadDESTransientKey(CRYDriver *cryp,
                                     size_t size,
                                     const uint8_t *keyp);
@@ -0,0 +1,382 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_fallback.h
+ * @brief   Cryptographic Driver software fall-back macros and structures.
+ *
+ * @addtogroup CRYPTO
+ * @{
+ */
+
+#ifndef HAL_CRYPTO_FALLBACK_H
+#define HAL_CRYPTO_FALLBACK_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   State of a software SHA-1 computation.
+ */
+typedef struct {
+  uint32_t                  h[5];           /**< @brief Intermediate hash.  */
+  uint64_t                  length;         /**< @brief Processed bytes.    */
+  uint8_t                   buf[CRY_SHA256_BLOCK_SIZE];
+                                            /**< @brief Partial block.      */
+} crysha1state_t;
+
+/**
+ * @brief   State of a software SHA-256 computation.
+ */
+typedef struct {
+  uint32_t                  h[8];           /**< @brief Intermediate hash.  */
+  uint64_t                  length;         /**< @brief Processed bytes.    */
+  uint8_t                   buf[CRY_SHA256_BLOCK_SIZE];
+                                            /**< @brief Partial block.      */
+} crysha256state_t;
+
+/**
+ * @brief   State of a software SHA-512 computation.
+ */
+typedef struct {
+  uint64_t                  h[8];           /**< @brief Intermediate hash.  */
+  uint64_t                  length;         /**< @brief Processed bytes.    */
+  uint8_t                   buf[CRY_SHA512_BLOCK_SIZE];
+                                            /**< @brief Partial block.      */
+} crysha512state_t;
+
+/**
+ * @brief   State of a software GHASH computation.
+ */
+typedef struct {
+  uint64_t                  hl[16];         /**< @brief Multiples of H, low
+                                                        words.              */
+  uint64_t                  hh[16];         /**< @brief Multiples of H, high
+                                                        words.              */
+  uint64_t                  xh;             /**< @brief Hash state, high
+                                                        word.               */
+  uint64_t                  xl;             /**< @brief Hash state, low
+                                                        word.               */
+} cryghash_t;
+
+/**
+ * @brief   Type of an AES-CTR streaming context.
+ */
+typedef struct {
+  crykey_t                  key_id;         /**< @brief Key identifier.     */
+  uint8_t                   cb[CRY_AES_BLOCK_SIZE];
+                                            /**< @brief Next counter block. */
+  uint8_t                   ks[CRY_AES_BLOCK_SIZE];
+                                            /**< @brief Current keystream
+                                                        block.              */
+  size_t                    ks_pos;         /**< @brief Used bytes of the
+                                                        keystream block.    */
+} AESCTRContext;
+
+/**
+ * @brief   Type of an AES-GCM streaming context.
+ */
+typedef struct {
+  AESCTRContext             ctr;            /**< @brief Text encryption
+                                                        state.              */
+  cryghash_t                ghash;          /**< @brief Authentication
+                                                        state.              */
+  uint8_t                   mask[CRY_AES_BLOCK_SIZE];
+                                            /**< @brief Encrypted initial
+                                                        counter block.      */
+  uint8_t                   buf[CRY_AES_BLOCK_SIZE];
+                                            /**< @brief Partial block to be
+                                                        hashed.             */
+  size_t                    buf_pos;        /**< @brief Bytes in the
+                                                        partial block.      */
+  size_t                    auth_size;      /**< @brief Authenticated data
+                                                        size.               */
+  size_t                    text_size;      /**< @brief Text size.          */
+  bool                      text;           /**< @brief Text phase, the
+                                                        authenticated data
+                                                        is complete.        */
+} AESGCMContext;
+
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA-1 context.
+ */
+typedef struct {
+  crysha1state_t            state;          /**< @brief Hash state.         */
+} SHA1Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA-256 context.
+ */
+typedef struct {
+  crysha256state_t          state;          /**< @brief Hash state.         */
+} SHA256Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA-512 context.
+ */
+typedef struct {
+  crysha512state_t          state;          /**< @brief Hash state.         */
+} SHA512Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a HMAC-SHA256 context.
+ */
+typedef struct {
+  crysha256state_t          inner;          /**< @brief Inner hash state,
+                                                        key xor ipad.       */
+  crysha256state_t          outer;          /**< @brief Outer hash state,
+                                                        key xor opad.       */
+} HMACSHA256Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a HMAC-SHA512 context.
+ */
+typedef struct {
+  crysha512state_t          inner;          /**< @brief Inner hash state,
+                                                        key xor ipad.       */
+  crysha512state_t          outer;          /**< @brief Outer hash state,
+                                                        key xor opad.       */
+} HMACSHA512Context;
+#endif
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void cry_fallback_clear(CRYDriver *cryp);
+  cryerror_t cry_fallback_aes_loadkey(CRYDriver *cryp,
+                                      size_t size,
+                                      const uint8_t *keyp);
+  cryerror_t cry_fallback_encrypt_AES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_decrypt_AES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_encrypt_AES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_decrypt_AES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_encrypt_AES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_CFB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CFB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_CTR(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CTR(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_GCM(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t auth_size,
+                                          const uint8_t *auth_in,
+                                          size_t text_size,
+                                          const uint8_t *text_in,
+                                          uint8_t *text_out,
+                                          const uint8_t *iv,
+                                          size_t tag_size,
+                                          uint8_t *tag_out);
+  cryerror_t cry_fallback_decrypt_AES_GCM(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t auth_size,
+                                          const uint8_t *auth_in,
+                                          size_t text_size,
+                                          const uint8_t *text_in,
+                                          uint8_t *text_out,
+                                          const uint8_t *iv,
+                                          size_t tag_size,
+                                          const uint8_t *tag_in);
+  cryerror_t cry_fallback_AES_CTR_init(CRYDriver *cryp,
+                                       AESCTRContext *ctxp,
+                                       crykey_t key_id,
+                                       const uint8_t *iv);
+  cryerror_t cry_fallback_AES_CTR_update(CRYDriver *cryp,
+                                         AESCTRContext *ctxp,
+                                         size_t size,
+                                         const uint8_t *in,
+                                         uint8_t *out);
+  cryerror_t cry_fallback_AES_GCM_init(CRYDriver *cryp,
+                                       AESGCMContext *ctxp,
+                                       crykey_t key_id,
+                                       const uint8_t *iv);
+  cryerror_t cry_fallback_AES_GCM_update_auth(CRYDriver *cryp,
+                                              AESGCMContext *ctxp,
+                                              size_t size,
+                                              const uint8_t *in);
+  cryerror_t cry_fallback_encrypt_AES_GCM_update(CRYDriver *cryp,
+                                                 AESGCMContext *ctxp,
+                                                 size_t size,
+                                                 const uint8_t *in,
+                                                 uint8_t *out);
+  cryerror_t cry_fallback_decrypt_AES_GCM_update(CRYDriver *cryp,
+                                                 AESGCMContext *ctxp,
+                                                 size_t size,
+                                                 const uint8_t *in,
+                                                 uint8_t *out);
+  cryerror_t cry_fallback_encrypt_AES_GCM_final(CRYDriver *cryp,
+                                                AESGCMContext *ctxp,
+                                                size_t tag_size,
+                                                uint8_t *tag_out);
+  cryerror_t cry_fallback_decrypt_AES_GCM_final(CRYDriver *cryp,
+                                                AESGCMContext *ctxp,
+                                                size_t tag_size,
+                                                const uint8_t *tag_in);
+  cryerror_t cry_fallback_des_loadkey(CRYDriver *cryp,
+                                      size_t size,
+                                      const uint8_t *keyp);
+  cryerror_t cry_fallback_encrypt_DES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_decrypt_DES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_encrypt_DES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_decrypt_DES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_encrypt_DES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_DES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_SHA1_init(CRYDriver *cryp, SHA1Context *sha1ctxp);
+  cryerror_t cry_fallback_SHA1_update(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                      size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA1_final(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                     uint8_t *out);
+  cryerror_t cry_fallback_SHA256_init(CRYDriver *cryp,
+                                      SHA256Context *sha256ctxp);
+  cryerror_t cry_fallback_SHA256_update(CRYDriver *cryp,
+                                        SHA256Context *sha256ctxp,
+                                        size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA256_final(CRYDriver *cryp,
+                                       SHA256Context *sha256ctxp,
+                                       uint8_t *out);
+  cryerror_t cry_fallback_SHA512_init(CRYDriver *cryp,
+                                      SHA512Context *sha512ctxp);
+  cryerror_t cry_fallback_SHA512_update(CRYDriver *cryp,
+                                        SHA512Context *sha512ctxp,
+                                        size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA512_final(CRYDriver *cryp,
+                                       SHA512Context *sha512ctxp,
+                                       uint8_t *out);
+  cryerror_t cry_fallback_hmac_loadkey(CRYDriver *cryp,
+                                       size_t size,
+                                       const uint8_t *keyp);
+  cryerror_t cry_fallback_HMACSHA256_init(CRYDriver *cryp,
+                                          HMACSHA256Context *hmacsha256ctxp);
+  cryerror_t cry_fallback_HMACSHA256_update(CRYDriver *cryp,
+                                            HMACSHA256Context *hmacsha256ctxp,
+                                            size_t size,
+                                            const uint8_t *in);
+  cryerror_t cry_fallback_HMACSHA256_final(CRYDriver *cryp,
+                                           HMACSHA256Context *hmacsha256ctxp,
+                                           uint8_t *out);
+  cryerror_t cry_fallback_HMACSHA512_init(CRYDriver *cryp,
+                                          HMACSHA512Context *hmacsha512ctxp);
+  cryerror_t cry_fallback_HMACSHA512_update(CRYDriver *cryp,
+                                            HMACSHA512Context *hmacsha512ctxp,
+                                            size_t size,
+                                            const uint8_t *in);
+  cryerror_t cry_fallback_HMACSHA512_final(CRYDriver *cryp,
+                                           HMACSHA512Context *hmacsha512ctxp,
+                                           uint8_t *out);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_CRYPTO_FALLBACK_H */
+
+/** @} */
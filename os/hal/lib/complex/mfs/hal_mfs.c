@@ -62,6 +62,115 @@
 #define ALIGNED_SIZEOF(t)                                                   \
   (((sizeof (t) - 1U) | MFS_ALIGN_MASK) + 1U)
 
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Bank magic 2 for the checkpoints-enabled layout.
+ */
+#define BANK_MAGIC_2                    MFS_BANK_MAGIC_SI_CP_2
+#else
+#define BANK_MAGIC_2                    MFS_BANK_MAGIC_CP_2
+#endif
+
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Bank magic 2 of the same layout without checkpoints.
+ * @note    Banks with this magic are converted on mount.
+ */
+#define BANK_MAGIC_LEGACY_2             MFS_BANK_MAGIC_SI_2
+#else
+#define BANK_MAGIC_LEGACY_2             MFS_BANK_MAGIC_2
+#endif
+
+/**
+ * @brief   Offset of the first record within a bank without checkpoints.
+ */
+#define LEGACY_RECORDS_OFFSET                                               \
+  ((flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t))
+
+/**
+ * @brief   Checkpoint slot size aligned.
+ */
+#define ALIGNED_CP_SLOT_SIZE                                                \
+  (flash_offset_t)ALIGNED_SIZEOF(mfs_checkpoint_slot_t)
+
+/**
+ * @brief   Size of the checkpoint slots area after the bank header.
+ */
+#define CP_AREA_SIZE                                                        \
+  (ALIGNED_CP_SLOT_SIZE * (flash_offset_t)MFS_CFG_CHECKPOINT_SLOTS)
+
+/**
+ * @brief   Maximum size of the checkpoint record data.
+ */
+#define CP_MAX_DATA_SIZE                                                    \
+  (sizeof (mfs_record_descriptor_t) * (size_t)MFS_CFG_MAX_RECORDS)
+
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Size of the checkpoint record data.
+ * @note    Only the existing records are saved in sorted index mode.
+ */
+#define CP_DATA_SIZE(mfsp)                                                  \
+  (sizeof (mfs_record_descriptor_t) * (size_t)(mfsp)->descriptors_num)
+
+/**
+ * @brief   Checks the size of a checkpoint record data.
+ */
+#define CP_IS_VALID_SIZE(n)                                                 \
+  (((n) <= CP_MAX_DATA_SIZE) &&                                             \
+   (((n) % sizeof (mfs_record_descriptor_t)) == 0U))
+#else
+#define CP_DATA_SIZE(mfsp)              CP_MAX_DATA_SIZE
+#define CP_IS_VALID_SIZE(n)             ((n) == CP_MAX_DATA_SIZE)
+#endif
+#else
+#if MFS_CFG_USE_SORTED_INDEX == TRUE
+#define BANK_MAGIC_2                    MFS_BANK_MAGIC_SI_2
+#else
+#define BANK_MAGIC_2                    MFS_BANK_MAGIC_2
+#endif
+#define CP_AREA_SIZE                    0U
+#endif
+
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of used elements in the records index.
+ */
+#define DESCRIPTORS_NUM(mfsp)           ((mfsp)->descriptors_num)
+#else
+#define DESCRIPTORS_NUM(mfsp)           (uint32_t)MFS_CFG_MAX_RECORDS
+#endif
+
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Sets the record identifier in the data header buffer.
+ * @note    Reserved fields are left in erased state.
+ */
+#define HDR_SET_ID(mfsp, hid) do {                                          \
+  (mfsp)->buffer.dhdr.fields.id        = (uint32_t)(hid);                   \
+  (mfsp)->buffer.dhdr.fields.reserved1 = (uint16_t)(mfsp)->config->erased;  \
+  (mfsp)->buffer.dhdr.fields.reserved2 = (uint32_t)(mfsp)->config->erased;  \
+} while (false)
+#else
+#define HDR_SET_ID(mfsp, hid) do {                                          \
+  (mfsp)->buffer.dhdr.fields.id        = (uint16_t)(hid);                   \
+} while (false)
+#endif
+
+/**
+ * @brief   Offset of the first record within a bank.
+ */
+#define RECORDS_OFFSET                                                      \
+  ((flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t) + CP_AREA_SIZE)
+
+/**
+ * @brief   Checks if a bank magic 2 belongs to any of the MFS layouts.
+ */
+#define BANK_IS_MFS_MAGIC_2(m)                                              \
+  (((m) == MFS_BANK_MAGIC_2) || ((m) == MFS_BANK_MAGIC_CP_2) ||             \
+   ((m) == MFS_BANK_MAGIC_SI_2) || ((m) == MFS_BANK_MAGIC_SI_CP_2))
+
 /**
  * @brief   Combines two values (0..3) in one (0..15).
  */
@@ -142,11 +251,153 @@ static void mfs_state_reset(MFSDriver *mfsp) {
   mfsp->current_counter = 0U;
   mfsp->next_offset     = 0U;
   mfsp->used_space      = 0U;
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  mfsp->cp_slot         = 0U;
+  mfsp->cp_pending      = 0U;
+#endif
 
   for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
     mfsp->descriptors[i].offset = 0U;
     mfsp->descriptors[i].size   = 0U;
   }
+#if MFS_CFG_USE_SORTED_INDEX == TRUE
+  mfsp->descriptors_num = 0U;
+#endif
+}
+
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Binary search into the sorted records index.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @return              The position of the first descriptor with an
+ *                      identifier greater or equal to @p id.
+ *
+ * @notapi
+ */
+static uint32_t mfs_index_search(MFSDriver *mfsp, mfs_id_t id) {
+  uint32_t lo, hi;
+
+  lo = 0U;
+  hi = mfsp->descriptors_num;
+  while (lo < hi) {
+    uint32_t mid = lo + ((hi - lo) / 2U);
+
+    if (mfsp->descriptors[mid].id < id) {
+      lo = mid + 1U;
+    }
+    else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+#endif
+
+/**
+ * @brief   Returns the descriptor of an existing record.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @return              Pointer to the record descriptor.
+ * @retval NULL         if the record does not exist.
+ *
+ * @notapi
+ */
+static mfs_record_descriptor_t *mfs_descriptor_find(MFSDriver *mfsp,
+                                                    mfs_id_t id) {
+#if MFS_CFG_USE_SORTED_INDEX == TRUE
+  uint32_t i = mfs_index_search(mfsp, id);
+
+  if ((i < mfsp->descriptors_num) && (mfsp->descriptors[i].id == id)) {
+    return &mfsp->descriptors[i];
+  }
+#else
+  if (mfsp->descriptors[id - 1U].offset != 0U) {
+    return &mfsp->descriptors[id - 1U];
+  }
+#endif
+
+  return NULL;
+}
+
+/**
+ * @brief   Creates or updates the descriptor of a record.
+ * @note    In sorted index mode records written in increasing identifiers
+ *          order are appended without searching.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @param[in] offset    offset of the record header
+ * @param[in] size      size of the record data
+ * @return              The operation result.
+ * @retval false        if the operation succeeded.
+ * @retval true         if the records index is full.
+ *
+ * @notapi
+ */
+static bool mfs_descriptor_update(MFSDriver *mfsp, mfs_id_t id,
+                                  flash_offset_t offset, uint32_t size) {
+  mfs_record_descriptor_t *dp;
+
+#if MFS_CFG_USE_SORTED_INDEX == TRUE
+  uint32_t i, n = mfsp->descriptors_num;
+
+  if ((n == 0U) || (mfsp->descriptors[n - 1U].id < id)) {
+    i = n;
+  }
+  else {
+    i = mfs_index_search(mfsp, id);
+  }
+
+  if ((i >= n) || (mfsp->descriptors[i].id != id)) {
+    /* New record, making space for it.*/
+    if (n >= (uint32_t)MFS_CFG_MAX_RECORDS) {
+      return true;
+    }
+    memmove((void *)&mfsp->descriptors[i + 1U],
+            (const void *)&mfsp->descriptors[i],
+            sizeof (mfs_record_descriptor_t) * (size_t)(n - i));
+    mfsp->descriptors[i].id = id;
+    mfsp->descriptors_num = n + 1U;
+  }
+  dp = &mfsp->descriptors[i];
+#else
+  dp = &mfsp->descriptors[id - 1U];
+#endif
+
+  dp->offset = offset;
+  dp->size   = size;
+
+  return false;
+}
+
+/**
+ * @brief   Removes the descriptor of a record, if present.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ *
+ * @notapi
+ */
+static void mfs_descriptor_remove(MFSDriver *mfsp, mfs_id_t id) {
+
+#if MFS_CFG_USE_SORTED_INDEX == TRUE
+  uint32_t i = mfs_index_search(mfsp, id);
+
+  if ((i < mfsp->descriptors_num) && (mfsp->descriptors[i].id == id)) {
+    mfsp->descriptors_num--;
+    memmove((void *)&mfsp->descriptors[i],
+            (const void *)&mfsp->descriptors[i + 1U],
+            sizeof (mfs_record_descriptor_t) *
+            (size_t)(mfsp->descriptors_num - i));
+  }
+#else
+  mfsp->descriptors[id - 1U].offset = 0U;
+  mfsp->descriptors[id - 1U].size   = 0U;
+#endif
 }
 
 static flash_offset_t mfs_flash_get_bank_offset(MFSDriver *mfsp,
@@ -200,6 +451,12 @@ static mfs_error_t mfs_flash_write(MFSDriver *mfsp,
                                    size_t n,
                                    const uint8_t *wp) {
   flash_error_t ferr;
+#if MFS_CFG_WRITE_VERIFY == TRUE
+  union {
+    mfs_data_header_t       dhdr;
+    uint8_t                 data8[sizeof (mfs_data_header_t)];
+  } u;
+#endif
 
   ferr = flashProgram(mfsp->config->flashp, offset, n, wp);
   if (ferr != FLASH_NO_ERROR) {
@@ -208,6 +465,16 @@ static mfs_error_t mfs_flash_write(MFSDriver *mfsp,
   }
 
 #if MFS_CFG_WRITE_VERIFY == TRUE
+  /* Partial data headers are written from within the driver buffer which
+     is also used for reading back, the written part is saved before being
+     overwritten.*/
+  if ((wp > mfsp->buffer.data8) &&
+      (wp < mfsp->buffer.data8 + sizeof (mfs_data_header_t)) &&
+      (n < sizeof (mfs_data_header_t))) {
+    memcpy((void *)u.data8, (const void *)wp, n);
+    wp = u.data8;
+  }
+
   /* Verifying the written data by reading it back and comparing.*/
   while (n > 0U) {
     size_t chunk = n <= MFS_CFG_BUFFER_SIZE ? n : MFS_CFG_BUFFER_SIZE;
@@ -376,7 +643,7 @@ static mfs_error_t mfs_bank_write_header(MFSDriver *mfsp,
   }
 
   bhdr.fields.magic1    = MFS_BANK_MAGIC_1;
-  bhdr.fields.magic2    = MFS_BANK_MAGIC_2;
+  bhdr.fields.magic2    = BANK_MAGIC_2;
   bhdr.fields.counter   = cnt;
   bhdr.fields.reserved1 = (uint16_t)mfsp->config->erased;
   bhdr.fields.crc       = crc16(0xFFFFU, bhdr.hdr8,
@@ -408,7 +675,6 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
 
   /* Checking header fields integrity.*/
   if ((mfsp->buffer.bhdr.fields.magic1 != MFS_BANK_MAGIC_1) ||
-      (mfsp->buffer.bhdr.fields.magic2 != MFS_BANK_MAGIC_2) ||
       (mfsp->buffer.bhdr.fields.counter == mfsp->config->erased) ||
       (mfsp->buffer.bhdr.fields.reserved1 != (uint16_t)mfsp->config->erased)) {
     return MFS_BANK_GARBAGE;
@@ -421,11 +687,27 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
     return MFS_BANK_GARBAGE;
   }
 
-  return MFS_BANK_OK;
+  /* Checking the layout, a valid bank written with another layout must not
+     be treated as garbage and erased.*/
+  if (mfsp->buffer.bhdr.fields.magic2 == BANK_MAGIC_2) {
+    return MFS_BANK_OK;
+  }
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  if (mfsp->buffer.bhdr.fields.magic2 == BANK_MAGIC_LEGACY_2) {
+    /* Same layout without checkpoints, it is converted on mount.*/
+    return MFS_BANK_OK;
+  }
+#endif
+  if (BANK_IS_MFS_MAGIC_2(mfsp->buffer.bhdr.fields.magic2)) {
+    return MFS_BANK_FOREIGN;
+  }
+
+  return MFS_BANK_GARBAGE;
 }
 
 /**
  * @brief   Scans blocks searching for records.
+ * @details The scan starts from the current value of @p next_offset.
  * @note    The block integrity is strongly checked.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
@@ -439,15 +721,15 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
 static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
                                          mfs_bank_t bank,
                                          bool *wflagp) {
-  flash_offset_t hdr_offset, start_offset, end_offset;
+  flash_offset_t hdr_offset, end_offset;
 
   /* No warning by default.*/
   *wflagp = false;
 
   /* Boundaries.*/
-  start_offset = mfs_flash_get_bank_offset(mfsp, bank);
-  hdr_offset   = start_offset + (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
-  end_offset   = start_offset + mfsp->config->bank_size;
+  hdr_offset   = mfsp->next_offset;
+  end_offset   = mfs_flash_get_bank_offset(mfsp, bank) +
+                 mfsp->config->bank_size;
 
   /* Scanning records until there is there is not enough space left for an
      header.*/
@@ -473,13 +755,26 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
     /* It is not erased so checking for integrity.*/
     if ((u.dhdr.fields.magic1 != MFS_HEADER_MAGIC_1) ||
         (u.dhdr.fields.magic2 != MFS_HEADER_MAGIC_2) ||
-        (u.dhdr.fields.id < 1U) ||
-        (u.dhdr.fields.id > (uint32_t)MFS_CFG_MAX_RECORDS) ||
         (u.dhdr.fields.size > end_offset - hdr_offset)) {
       *wflagp = true;
       break;
     }
 
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    /* Checkpoint records not referenced by a slot are just skipped, the
+       index is rebuilt from the records.*/
+    if (u.dhdr.fields.id == MFS_CHECKPOINT_ID) {
+      hdr_offset = hdr_offset + ALIGNED_REC_SIZE(u.dhdr.fields.size);
+      continue;
+    }
+#endif
+
+    if ((u.dhdr.fields.id < 1U) ||
+        (u.dhdr.fields.id > (uint32_t)MFS_RECORD_ID_MAX)) {
+      *wflagp = true;
+      break;
+    }
+
     /* Finally checking the CRC, we need to perform it in chunks because
        we have a limited buffer.*/
     crc = 0xFFFFU;
@@ -510,13 +805,19 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
     else {
       /* Zero-sized records are erase markers.*/
       if (u.dhdr.fields.size == 0U) {
-        mfsp->descriptors[u.dhdr.fields.id - 1U].offset = 0U;
-        mfsp->descriptors[u.dhdr.fields.id - 1U].size   = 0U;
+        mfs_descriptor_remove(mfsp, (mfs_id_t)u.dhdr.fields.id);
       }
       else {
-        mfsp->descriptors[u.dhdr.fields.id - 1U].offset = hdr_offset;
-        mfsp->descriptors[u.dhdr.fields.id - 1U].size   = u.dhdr.fields.size;
+        /* The index cannot overflow unless the storage has been written
+           using a larger index.*/
+        if (mfs_descriptor_update(mfsp, (mfs_id_t)u.dhdr.fields.id,
+                                  hdr_offset, u.dhdr.fields.size)) {
+          return MFS_ERR_INTERNAL;
+        }
       }
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+      mfsp->cp_pending++;
+#endif
     }
 
     /* On the next header.*/
@@ -575,6 +876,189 @@ static mfs_error_t mfs_bank_get_state(MFSDriver *mfsp,
   return MFS_NO_ERROR;
 }
 
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the offset of a checkpoint slot.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @param[in] slot      the slot index
+ * @return              The slot offset.
+ *
+ * @notapi
+ */
+static flash_offset_t mfs_checkpoint_slot_offset(MFSDriver *mfsp,
+                                                 mfs_bank_t bank,
+                                                 uint32_t slot) {
+
+  return mfs_flash_get_bank_offset(mfsp, bank) +
+         (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t) +
+         (ALIGNED_CP_SLOT_SIZE * (flash_offset_t)slot);
+}
+
+/**
+ * @brief   Writes a checkpoint of the records index.
+ * @details The checkpoint record is appended to the current bank and then
+ *          referenced by the next free slot. The checkpoint is silently
+ *          skipped if there are no free slots or not enough immediately
+ *          available space, a later mount would just scan more records.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_write(MFSDriver *mfsp) {
+  flash_offset_t free, asize;
+  mfs_checkpoint_slot_t slot;
+
+  /* Checking for a free slot and for immediately available space.*/
+  asize = ALIGNED_REC_SIZE(CP_DATA_SIZE(mfsp));
+  free  = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+           mfsp->config->bank_size) - mfsp->next_offset;
+  if ((mfsp->cp_slot >= (uint32_t)MFS_CFG_CHECKPOINT_SLOTS) ||
+      (asize > free)) {
+    return MFS_NO_ERROR;
+  }
+
+  /* Writing the checkpoint like a normal record, the magic is written
+     last.*/
+  HDR_SET_ID(mfsp, MFS_CHECKPOINT_ID);
+  mfsp->buffer.dhdr.fields.size   = (uint32_t)CP_DATA_SIZE(mfsp);
+  mfsp->buffer.dhdr.fields.crc    = crc16(0xFFFFU,
+                                          (const uint8_t *)mfsp->descriptors,
+                                          CP_DATA_SIZE(mfsp));
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset + (sizeof (uint32_t) * 2U),
+                               sizeof (mfs_data_header_t) - (sizeof (uint32_t) * 2U),
+                               mfsp->buffer.data8 + (sizeof (uint32_t) * 2U)));
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset + sizeof (mfs_data_header_t),
+                               CP_DATA_SIZE(mfsp),
+                               (const uint8_t *)mfsp->descriptors));
+  mfsp->buffer.dhdr.fields.magic1 = (uint32_t)MFS_HEADER_MAGIC_1;
+  mfsp->buffer.dhdr.fields.magic2 = (uint32_t)MFS_HEADER_MAGIC_2;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfsp->next_offset,
+                               sizeof (uint32_t) * 2U,
+                               mfsp->buffer.data8));
+
+  /* The slot makes the checkpoint visible to the mount procedure.*/
+  slot.fields.offset = (uint32_t)mfsp->next_offset;
+  slot.fields.check  = ~(uint32_t)mfsp->next_offset;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               mfs_checkpoint_slot_offset(mfsp,
+                                                          mfsp->current_bank,
+                                                          mfsp->cp_slot),
+                               sizeof (mfs_checkpoint_slot_t),
+                               slot.slot8));
+
+  /* Checkpoints are not accounted in the used space, they are obsolete as
+     soon as a newer one is written.*/
+  mfsp->next_offset += asize;
+  mfsp->cp_slot++;
+  mfsp->cp_pending = 0U;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Loads the records index from the most recent checkpoint.
+ * @details The used slots are located using a binary search, slots are
+ *          then tried starting from the most recent one. On success the
+ *          index and @p next_offset reflect the state at checkpoint time.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_load(MFSDriver *mfsp, mfs_bank_t bank) {
+  flash_offset_t start_offset, end_offset;
+  uint32_t lo, hi;
+  mfs_checkpoint_slot_t slot;
+
+  start_offset = mfs_flash_get_bank_offset(mfsp, bank);
+  end_offset   = start_offset + mfsp->config->bank_size;
+
+  /* Slots are written in sequence so the first erased one is searched
+     using a bisection.*/
+  lo = 0U;
+  hi = (uint32_t)MFS_CFG_CHECKPOINT_SLOTS;
+  while (lo < hi) {
+    uint32_t mid = lo + ((hi - lo) / 2U);
+
+    RET_ON_ERROR(mfs_flash_read(mfsp,
+                                mfs_checkpoint_slot_offset(mfsp, bank, mid),
+                                sizeof (mfs_checkpoint_slot_t),
+                                slot.slot8));
+    if ((slot.slot32[0] == mfsp->config->erased) &&
+        (slot.slot32[1] == mfsp->config->erased)) {
+      hi = mid;
+    }
+    else {
+      lo = mid + 1U;
+    }
+  }
+
+  /* Next checkpoints are written after the used slots, also after slots
+     damaged by a power loss.*/
+  mfsp->cp_slot = lo;
+
+  /* Trying the used slots starting from the most recent one.*/
+  while (lo > 0U) {
+    flash_offset_t cp_offset;
+    uint32_t size;
+    uint16_t crc;
+
+    lo--;
+    RET_ON_ERROR(mfs_flash_read(mfsp,
+                                mfs_checkpoint_slot_offset(mfsp, bank, lo),
+                                sizeof (mfs_checkpoint_slot_t),
+                                slot.slot8));
+    cp_offset = (flash_offset_t)slot.fields.offset;
+    if ((slot.fields.check != ~slot.fields.offset) ||
+        (cp_offset < start_offset + RECORDS_OFFSET) ||
+        (cp_offset > end_offset - ALIGNED_DHDR_SIZE)) {
+      continue;
+    }
+
+    /* Checking the checkpoint record header.*/
+    RET_ON_ERROR(mfs_flash_read(mfsp, cp_offset,
+                                sizeof (mfs_data_header_t),
+                                mfsp->buffer.data8));
+    if ((mfsp->buffer.dhdr.fields.magic1 != MFS_HEADER_MAGIC_1) ||
+        (mfsp->buffer.dhdr.fields.magic2 != MFS_HEADER_MAGIC_2) ||
+        (mfsp->buffer.dhdr.fields.id != MFS_CHECKPOINT_ID) ||
+        !CP_IS_VALID_SIZE(mfsp->buffer.dhdr.fields.size) ||
+        (mfsp->buffer.dhdr.fields.size >
+         (end_offset - cp_offset) - sizeof (mfs_data_header_t))) {
+      continue;
+    }
+    size = mfsp->buffer.dhdr.fields.size;
+    crc  = mfsp->buffer.dhdr.fields.crc;
+
+    /* Loading the index directly from flash then checking it.*/
+    RET_ON_ERROR(mfs_flash_read(mfsp, cp_offset + sizeof (mfs_data_header_t),
+                                size,
+                                (uint8_t *)mfsp->descriptors));
+    if (crc16(0xFFFFU, (const uint8_t *)mfsp->descriptors, size) == crc) {
+#if MFS_CFG_USE_SORTED_INDEX == TRUE
+      mfsp->descriptors_num = size / (uint32_t)sizeof (mfs_record_descriptor_t);
+#endif
+      mfsp->next_offset = cp_offset + ALIGNED_REC_SIZE(size);
+      return MFS_NO_ERROR;
+    }
+
+    /* Discarding the damaged index.*/
+    memset((void *)mfsp->descriptors, 0, size);
+  }
+
+  return MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_USE_CHECKPOINTS == TRUE */
+
 /**
  * @brief   Enforces a garbage collection.
  * @details Storage data is compacted into a single bank.
@@ -598,11 +1082,10 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
   }
 
   /* Write address.*/
-  dest_offset = mfs_flash_get_bank_offset(mfsp, dbank) +
-                ALIGNED_SIZEOF(mfs_bank_header_t);
+  dest_offset = mfs_flash_get_bank_offset(mfsp, dbank) + RECORDS_OFFSET;
 
   /* Copying the most recent record instances only.*/
-  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+  for (i = 0; i < DESCRIPTORS_NUM(mfsp); i++) {
     uint32_t totsize = ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
     if (mfsp->descriptors[i].offset != 0) {
       RET_ON_ERROR(mfs_flash_copy(mfsp, dest_offset,
@@ -617,6 +1100,9 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
   mfsp->current_bank = dbank;
   mfsp->current_counter += 1U;
   mfsp->next_offset = dest_offset;
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  mfsp->cp_slot = 0U;
+#endif
 
   /* The header is written after the data.*/
   RET_ON_ERROR(mfs_bank_write_header(mfsp, dbank, mfsp->current_counter));
@@ -629,6 +1115,8 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
 
 /**
  * @brief   Performs a flash partition mount attempt.
+ * @note    Banks written without checkpoints are converted by a garbage
+ *          collection when checkpoints are enabled.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @return              The operation status.
@@ -639,7 +1127,7 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
   mfs_bank_state_t sts0, sts1;
   mfs_bank_t bank;
   uint32_t cnt0 = 0, cnt1 = 0;
-  bool w1 = false, w2 = false;
+  bool w1 = false, w2 = false, legacy = false;
 
   /* Resetting the bank state.*/
   mfs_state_reset(mfsp);
@@ -648,6 +1136,12 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
   RET_ON_ERROR(mfs_bank_get_state(mfsp, MFS_BANK_0, &sts0, &cnt0));
   RET_ON_ERROR(mfs_bank_get_state(mfsp, MFS_BANK_1, &sts1, &cnt1));
 
+  /* Banks written with an incompatible layout are left untouched, the
+     application has to erase the storage explicitly.*/
+  if ((sts0 == MFS_BANK_FOREIGN) || (sts1 == MFS_BANK_FOREIGN)) {
+    return MFS_ERR_INV_LAYOUT;
+  }
+
   /* Handling all possible scenarios, each one requires its own recovery
      strategy.*/
   switch (PAIR(sts0, sts1)) {
@@ -744,26 +1238,53 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
     /* Storing the bank data.*/
     mfsp->current_bank    = bank;
     mfsp->current_counter = mfsp->buffer.bhdr.fields.counter;
+    mfsp->next_offset     = mfs_flash_get_bank_offset(mfsp, bank) +
+                            RECORDS_OFFSET;
+
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    if (mfsp->buffer.bhdr.fields.magic2 == BANK_MAGIC_LEGACY_2) {
+      /* Bank written without checkpoints, records follow the header.*/
+      legacy = true;
+      mfsp->next_offset = mfs_flash_get_bank_offset(mfsp, bank) +
+                          LEGACY_RECORDS_OFFSET;
+    }
+    else {
+      /* Starting from the most recent checkpoint, if any.*/
+      RET_ON_ERROR(mfs_checkpoint_load(mfsp, bank));
+    }
+#endif
 
     /* Scanning for the most recent instance of all records.*/
     RET_ON_ERROR(mfs_bank_scan_records(mfsp, bank, &w2));
 
     /* Calculating the effective used size.*/
-    mfsp->used_space = ALIGNED_SIZEOF(mfs_bank_header_t);
-    for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+    mfsp->used_space = RECORDS_OFFSET;
+    for (i = 0; i < DESCRIPTORS_NUM(mfsp); i++) {
       if (mfsp->descriptors[i].offset != 0U) {
         mfsp->used_space += ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
       }
     }
+
+    /* The records must fit after the checkpoint area once converted.*/
+    if (legacy && (mfsp->used_space > mfsp->config->bank_size)) {
+      return MFS_ERR_INV_LAYOUT;
+    }
   }
 
   /* In case of detected problems then a garbage collection is performed in
-     order to repair/remove anomalies.*/
-  if (w2) {
+     order to repair/remove anomalies, the same is done in order to convert
+     a bank written without checkpoints.*/
+  if (w2 || legacy) {
     RET_ON_ERROR(mfs_garbage_collect(mfsp));
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    RET_ON_ERROR(mfs_checkpoint_write(mfsp));
+#endif
   }
 
-  return (w1 || w2) ? MFS_WARN_REPAIR : MFS_NO_ERROR;
+  if (w1 || w2) {
+    return MFS_WARN_REPAIR;
+  }
+  return legacy ? MFS_WARN_GC : MFS_NO_ERROR;
 }
 
 /**
@@ -778,6 +1299,9 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
  * @retval MFS_ERR_FLASH_FAILURE    if the flash memory is unusable because HW
  *                                  failures. Makes the driver enter the
  *                                  @p MFS_ERROR state.
+ * @retval MFS_ERR_INV_LAYOUT       if the storage has been written with an
+ *                                  incompatible layout. Makes the driver
+ *                                  enter the @p MFS_ERROR state.
  * @retval MFS_ERR_INTERNAL         if an internal logic failure is detected.
  *
  * @api
@@ -793,9 +1317,9 @@ mfs_error_t mfs_mount(MFSDriver *mfsp) {
     mfs_error_t err;
 
     err = mfs_try_mount(mfsp);
-    if (err == MFS_ERR_INTERNAL) {
-      /* Special case, do not retry on internal errors but report
-         immediately.*/
+    if ((err == MFS_ERR_INTERNAL) || (err == MFS_ERR_INV_LAYOUT)) {
+      /* Special case, do not retry on internal errors or incompatible
+         layouts but report immediately.*/
       mfsp->state = MFS_ERROR;
       return err;
     }
@@ -842,6 +1366,10 @@ void mfsObjectInit(MFSDriver *mfsp) {
  * @retval MFS_ERR_FLASH_FAILURE    if the flash memory is unusable because HW
  *                                  failures. Makes the driver enter the
  *                                  @p MFS_ERROR state.
+ * @retval MFS_ERR_INV_LAYOUT       if the storage has been written with an
+ *                                  incompatible layout, it can be reclaimed
+ *                                  using @p mfsErase(). Makes the driver
+ *                                  enter the @p MFS_ERROR state.
  * @retval MFS_ERR_INTERNAL         if an internal logic failure is detected.
  *
  * @api
@@ -877,11 +1405,14 @@ void mfsStop(MFSDriver *mfsp) {
 
 /**
  * @brief   Destroys the state of the managed storage by erasing the flash.
+ * @note    The operation is also allowed in @p MFS_ERROR state, this is
+ *          the way to reclaim a storage written with an incompatible
+ *          layout.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @return              The operation status.
  * @retval MFS_ERR_INV_STATE        if the driver is in not in @p MFS_READY
- *                                  state.
+ *                                  or @p MFS_ERROR state.
  * @retval MFS_NO_ERROR             if the operation has been successfully
  *                                  completed.
  * @retval MFS_ERR_FLASH_FAILURE    if the flash memory is unusable because HW
@@ -895,7 +1426,7 @@ mfs_error_t mfsErase(MFSDriver *mfsp) {
 
   osalDbgCheck(mfsp != NULL);
 
-  if (mfsp->state != MFS_READY) {
+  if ((mfsp->state != MFS_READY) && (mfsp->state != MFS_ERROR)) {
     return MFS_ERR_INV_STATE;
   }
 
@@ -910,7 +1441,7 @@ mfs_error_t mfsErase(MFSDriver *mfsp) {
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] id        record numeric identifier, the valid range is between
- *                      @p 1 and @p MFS_CFG_MAX_RECORDS
+ *                      @p 1 and @p MFS_RECORD_ID_MAX
  * @param[in,out] np    on input is the maximum buffer size, on return it is
  *                      the size of the data copied into the buffer
  * @param[out] buffer   pointer to a buffer for record data
@@ -931,10 +1462,11 @@ mfs_error_t mfsErase(MFSDriver *mfsp) {
  */
 mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
                           size_t *np, uint8_t *buffer) {
+  mfs_record_descriptor_t *dp;
   uint16_t crc;
 
   osalDbgCheck((mfsp != NULL) &&
-               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
+               (id >= 1U) && (id <= MFS_RECORD_ID_MAX) &&
                (np != NULL) && (*np > 0U) && (buffer != NULL));
 
   if ((mfsp->state != MFS_READY) && (mfsp->state != MFS_TRANSACTION)) {
@@ -942,25 +1474,26 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
   }
 
   /* Checking if the requested record actually exists.*/
-  if (mfsp->descriptors[id - 1U].offset == 0U) {
+  dp = mfs_descriptor_find(mfsp, id);
+  if (dp == NULL) {
     return MFS_ERR_NOT_FOUND;
   }
 
   /* Making sure to not overflow the buffer.*/
-  if (*np < mfsp->descriptors[id - 1U].size) {
+  if (*np < dp->size) {
     return MFS_ERR_INV_SIZE;
   }
 
   /* Header read from flash.*/
   RET_ON_ERROR(mfs_flash_read(mfsp,
-                              mfsp->descriptors[id - 1U].offset,
+                              dp->offset,
                               sizeof (mfs_data_header_t),
                               mfsp->buffer.data8));
 
   /* Data read from flash.*/
-  *np = mfsp->descriptors[id - 1U].size;
+  *np = dp->size;
   RET_ON_ERROR(mfs_flash_read(mfsp,
-                              mfsp->descriptors[id - 1U].offset + sizeof (mfs_data_header_t),
+                              dp->offset + sizeof (mfs_data_header_t),
                               *np,
                               buffer));
 
@@ -979,7 +1512,7 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] id        record numeric identifier, the valid range is between
- *                      @p 1 and @p MFS_CFG_MAX_RECORDS
+ *                      @p 1 and @p MFS_RECORD_ID_MAX
  * @param[in] n         size of data to be written, it cannot be zero
  * @param[in] buffer    pointer to a buffer for record data
  * @return              The operation status.
@@ -1004,19 +1537,31 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
  */
 mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
                            size_t n, const uint8_t *buffer) {
+  mfs_record_descriptor_t *dp;
   flash_offset_t free, asize, rspace;
 
   osalDbgCheck((mfsp != NULL) &&
-               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
+               (id >= 1U) && (id <= MFS_RECORD_ID_MAX) &&
                (n > 0U) && (buffer != NULL));
 
   /* Aligned record size.*/
   asize = ALIGNED_REC_SIZE(n);
 
+  /* Current instance of the record, if any.*/
+  dp = mfs_descriptor_find(mfsp, id);
+
   /* Normal mode code path.*/
   if (mfsp->state == MFS_READY) {
     bool warning = false;
 
+#if MFS_CFG_USE_SORTED_INDEX == TRUE
+    /* A new record must fit in the records index.*/
+    if ((dp == NULL) &&
+        (mfsp->descriptors_num >= (uint32_t)MFS_CFG_MAX_RECORDS)) {
+      return MFS_ERR_OUT_OF_MEM;
+    }
+#endif
+
     /* If the required space is beyond the available (compacted) block
        size then an error is returned.
        NOTE: The space for one extra header is reserved in order to allow
@@ -1037,7 +1582,7 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
     }
 
     /* Writing the data header without the magic, it will be written last.*/
-    mfsp->buffer.dhdr.fields.id     = (uint16_t)id;
+    HDR_SET_ID(mfsp, id);
     mfsp->buffer.dhdr.fields.size   = (uint32_t)n;
     mfsp->buffer.dhdr.fields.crc    = crc16(0xFFFFU, buffer, n);
     RET_ON_ERROR(mfs_flash_write(mfsp,
@@ -1061,16 +1606,24 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
 
     /* The size of the old record instance, if present, must be subtracted
        to the total used size.*/
-    if (mfsp->descriptors[id - 1U].offset != 0U) {
-      mfsp->used_space -= ALIGNED_REC_SIZE(mfsp->descriptors[id - 1U].size);
+    if (dp != NULL) {
+      mfsp->used_space -= ALIGNED_REC_SIZE(dp->size);
     }
 
     /* Adjusting bank-related metadata.*/
-    mfsp->descriptors[id - 1U].offset = mfsp->next_offset;
-    mfsp->descriptors[id - 1U].size   = (uint32_t)n;
+    (void)mfs_descriptor_update(mfsp, id, mfsp->next_offset, (uint32_t)n);
     mfsp->next_offset += asize;
     mfsp->used_space  += asize;
 
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    /* Checkpoint after a garbage collection or after enough operations.*/
+    mfsp->cp_pending++;
+    if (warning ||
+        (mfsp->cp_pending >= (uint32_t)MFS_CFG_CHECKPOINT_INTERVAL)) {
+      RET_ON_ERROR(mfs_checkpoint_write(mfsp));
+    }
+#endif
+
     return warning ? MFS_WARN_GC : MFS_NO_ERROR;
   }
 
@@ -1092,8 +1645,27 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
       return MFS_ERR_TRANSACTION_SIZE;
     }
 
+#if MFS_CFG_USE_SORTED_INDEX == TRUE
+    /* A new record must fit in the records index together with the new
+       records already written in the transaction, the estimation is
+       conservative.*/
+    if (dp == NULL) {
+      uint32_t i, num = mfsp->descriptors_num + 1U;
+
+      for (i = 0U; i < mfsp->tr_nops; i++) {
+        if ((mfsp->tr_ops[i].size > 0U) &&
+            (mfs_descriptor_find(mfsp, mfsp->tr_ops[i].id) == NULL)) {
+          num++;
+        }
+      }
+      if (num > (uint32_t)MFS_CFG_MAX_RECORDS) {
+        return MFS_ERR_OUT_OF_MEM;
+      }
+    }
+#endif
+
     /* Writing the data header without the magic, it will be written last.*/
-    mfsp->buffer.dhdr.fields.id     = (uint16_t)id;
+    HDR_SET_ID(mfsp, id);
     mfsp->buffer.dhdr.fields.size   = (uint32_t)n;
     mfsp->buffer.dhdr.fields.crc    = crc16(0xFFFFU, buffer, n);
     RET_ON_ERROR(mfs_flash_write(mfsp,
@@ -1130,7 +1702,7 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] id        record numeric identifier, the valid range is between
- *                      @p 1 and @p MFS_CFG_MAX_RECORDS
+ *                      @p 1 and @p MFS_RECORD_ID_MAX
  * @return              The operation status.
  * @retval MFS_NO_ERROR             if the operation has been successfully
  *                                  completed.
@@ -1152,10 +1724,11 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
  * @api
  */
 mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
+  mfs_record_descriptor_t *dp;
   flash_offset_t free, asize, rspace;
 
   osalDbgCheck((mfsp != NULL) &&
-               (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS));
+               (id >= 1U) && (id <= MFS_RECORD_ID_MAX));
 
   /* Aligned record size.*/
   asize = ALIGNED_DHDR_SIZE;
@@ -1165,7 +1738,8 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
     bool warning = false;
 
     /* Checking if the requested record actually exists.*/
-    if (mfsp->descriptors[id - 1U].offset == 0U) {
+    dp = mfs_descriptor_find(mfsp, id);
+    if (dp == NULL) {
       return MFS_ERR_NOT_FOUND;
     }
 
@@ -1190,7 +1764,7 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
        record is logically erased.*/
     mfsp->buffer.dhdr.fields.magic1 = (uint32_t)MFS_HEADER_MAGIC_1;
     mfsp->buffer.dhdr.fields.magic2 = (uint32_t)MFS_HEADER_MAGIC_2;
-    mfsp->buffer.dhdr.fields.id     = (uint16_t)id;
+    HDR_SET_ID(mfsp, id);
     mfsp->buffer.dhdr.fields.size   = (uint32_t)0;
     mfsp->buffer.dhdr.fields.crc    = (uint16_t)0xFFFF;
     RET_ON_ERROR(mfs_flash_write(mfsp,
@@ -1199,10 +1773,18 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
                                  mfsp->buffer.data8));
 
     /* Adjusting bank-related metadata.*/
-    mfsp->used_space  -= ALIGNED_REC_SIZE(mfsp->descriptors[id - 1U].size);
-    mfsp->next_offset += sizeof (mfs_data_header_t);
-    mfsp->descriptors[id - 1U].offset = 0U;
-    mfsp->descriptors[id - 1U].size   = 0U;
+    mfsp->used_space  -= ALIGNED_REC_SIZE(dp->size);
+    mfsp->next_offset += asize;
+    mfs_descriptor_remove(mfsp, id);
+
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    /* Checkpoint after a garbage collection or after enough operations.*/
+    mfsp->cp_pending++;
+    if (warning ||
+        (mfsp->cp_pending >= (uint32_t)MFS_CFG_CHECKPOINT_INTERVAL)) {
+      RET_ON_ERROR(mfs_checkpoint_write(mfsp));
+    }
+#endif
 
     return warning ? MFS_WARN_GC : MFS_NO_ERROR;
   }
@@ -1213,7 +1795,7 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
     mfs_transaction_op_t *top;
 
     /* Checking if the requested record actually exists.*/
-    if (mfsp->descriptors[id - 1U].offset == 0U) {
+    if (mfs_descriptor_find(mfsp, id) == NULL) {
       return MFS_ERR_NOT_FOUND;
     }
 
@@ -1232,7 +1814,7 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
 
     /* Writing the data header with size set to zero, it means that the
        record is logically erased. Note, the magic number is not set.*/
-    mfsp->buffer.dhdr.fields.id     = (uint16_t)id;
+    HDR_SET_ID(mfsp, id);
     mfsp->buffer.dhdr.fields.size   = (uint32_t)0;
     mfsp->buffer.dhdr.fields.crc    = (uint16_t)0xFFFF;
     RET_ON_ERROR(mfs_flash_write(mfsp,
@@ -1283,7 +1865,14 @@ mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp) {
     return MFS_ERR_INV_STATE;
   }
 
-  return mfs_garbage_collect(mfsp);
+  RET_ON_ERROR(mfs_garbage_collect(mfsp));
+
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  /* The compacted bank is checkpointed immediately.*/
+  RET_ON_ERROR(mfs_checkpoint_write(mfsp));
+#endif
+
+  return MFS_NO_ERROR;
 }
 
 #if (MFS_CFG_TRANSACTION_MAX > 0) || defined(__DOXYGEN__)
@@ -1402,28 +1991,31 @@ mfs_error_t mfsCommitTransaction(MFSDriver *mfsp) {
      magic number, now updating the internal state using the buffered data.*/
   mfsp->next_offset = mfsp->tr_next_offset;
   while (top < &mfsp->tr_ops[mfsp->tr_nops]) {
-    unsigned i = (unsigned)top->id - 1U;
+    mfs_record_descriptor_t *dp = mfs_descriptor_find(mfsp, top->id);
 
     /* The calculation is a bit different depending on write or erase record
        operations.*/
     if (top->size > 0U) {
       /* It is a write.*/
-      if (mfsp->descriptors[i].offset != 0U) {
+      if (dp != NULL) {
         /* The size of the old record instance, if present, must be subtracted
            to the total used size.*/
-        mfsp->used_space -= ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
+        mfsp->used_space -= ALIGNED_REC_SIZE(dp->size);
       }
 
-      /* Adjusting bank-related metadata.*/
-      mfsp->used_space           += ALIGNED_REC_SIZE(top->size);
-      mfsp->descriptors[i].offset = top->offset;
-      mfsp->descriptors[i].size   = top->size;
+      /* Adjusting bank-related metadata, the index space has been checked
+         when the operation has been buffered.*/
+      mfsp->used_space += ALIGNED_REC_SIZE(top->size);
+      if (mfs_descriptor_update(mfsp, top->id, top->offset, top->size)) {
+        return MFS_ERR_INTERNAL;
+      }
     }
     else {
       /* It is an erase.*/
-      mfsp->used_space           -= ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
-      mfsp->descriptors[i].offset = 0U;
-      mfsp->descriptors[i].size   = 0U;
+      if (dp != NULL) {
+        mfsp->used_space -= ALIGNED_REC_SIZE(dp->size);
+        mfs_descriptor_remove(mfsp, top->id);
+      }
     }
 
     /* On the next element.*/
@@ -1433,6 +2025,11 @@ mfs_error_t mfsCommitTransaction(MFSDriver *mfsp) {
   /* Returning to ready mode.*/
   mfsp->state = MFS_READY;
 
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  /* A committed transaction is a batch, it is always checkpointed.*/
+  RET_ON_ERROR(mfs_checkpoint_write(mfsp));
+#endif
+
   return MFS_NO_ERROR;
 }
 
@@ -1470,6 +2067,11 @@ mfs_error_t mfsRollbackTransaction(MFSDriver *mfsp) {
      a garbage collection.*/
   if (mfsp->tr_nops > 0U) {
     err = mfs_garbage_collect(mfsp);
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    if (err == MFS_NO_ERROR) {
+      err = mfs_checkpoint_write(mfsp);
+    }
+#endif
   }
   else {
     err = MFS_NO_ERROR;
@@ -38,6 +38,9 @@
 #define MFS_BANK_MAGIC_2                    0xF0339CC5U
 #define MFS_HEADER_MAGIC_1                  0x5FAE45F0U
 #define MFS_HEADER_MAGIC_2                  0xF045AE5FU
+#define MFS_BANK_MAGIC_CP_2                 0xF0339CC6U
+#define MFS_BANK_MAGIC_SI_2                 0xF0339CC7U
+#define MFS_BANK_MAGIC_SI_CP_2              0xF0339CC8U
 
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
@@ -49,7 +52,9 @@
  */
 /**
  * @brief   Maximum number of indexed records in the managed storage.
- * @note    Record indexes go from 1 to @p MFS_CFG_MAX_RECORDS.
+ * @note    Record indexes go from 1 to @p MFS_CFG_MAX_RECORDS unless
+ *          @p MFS_CFG_USE_SORTED_INDEX is enabled, in that case this is
+ *          the maximum number of existing records.
  */
 #if !defined(MFS_CFG_MAX_RECORDS) || defined(__DOXYGEN__)
 #define MFS_CFG_MAX_RECORDS                 32
@@ -107,6 +112,59 @@
 #if !defined(MFS_CFG_TRANSACTION_MAX) || defined(__DOXYGEN__)
 #define MFS_CFG_TRANSACTION_MAX             16
 #endif
+
+/**
+ * @brief   Enables checkpoint records.
+ * @details A checkpoint is a snapshot of the records index written in the
+ *          current bank after a batch of write operations. On mount the
+ *          index is loaded from the most recent checkpoint and only the
+ *          records written after it are scanned.
+ * @note    Records covered by a checkpoint are not checked on mount, data
+ *          errors would be detected on read.
+ * @note    This option changes the flash layout. Banks written with
+ *          checkpoints disabled are converted on mount by a garbage
+ *          collection, the mount returns @p MFS_WARN_GC. Banks written
+ *          with checkpoints enabled cannot be mounted with checkpoints
+ *          disabled, the mount fails with @p MFS_ERR_INV_LAYOUT and the
+ *          storage has to be erased using @p mfsErase().
+ */
+#if !defined(MFS_CFG_USE_CHECKPOINTS) || defined(__DOXYGEN__)
+#define MFS_CFG_USE_CHECKPOINTS             FALSE
+#endif
+
+/**
+ * @brief   Number of checkpoint slots in a bank.
+ * @details Each bank reserves, after its header, an array of slots pointing
+ *          to the written checkpoints. When all slots have been used no more
+ *          checkpoints are written until the next garbage collection.
+ */
+#if !defined(MFS_CFG_CHECKPOINT_SLOTS) || defined(__DOXYGEN__)
+#define MFS_CFG_CHECKPOINT_SLOTS            16
+#endif
+
+/**
+ * @brief   Number of record operations between checkpoints.
+ * @note    A checkpoint is also written after each committed transaction
+ *          and after each garbage collection.
+ */
+#if !defined(MFS_CFG_CHECKPOINT_INTERVAL) || defined(__DOXYGEN__)
+#define MFS_CFG_CHECKPOINT_INTERVAL         8
+#endif
+
+/**
+ * @brief   Enables a sorted records index.
+ * @details Records identifiers become arbitrary 32 bits keys, the index
+ *          only contains the existing records and it is kept sorted by
+ *          identifier, lookups are performed using a binary search.
+ * @note    This option changes the flash layout, data headers are larger
+ *          in order to contain 32 bits identifiers. Banks written with a
+ *          different setting cannot be mounted, the mount fails with
+ *          @p MFS_ERR_INV_LAYOUT and the storage has to be erased using
+ *          @p mfsErase().
+ */
+#if !defined(MFS_CFG_USE_SORTED_INDEX) || defined(__DOXYGEN__)
+#define MFS_CFG_USE_SORTED_INDEX            FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -144,6 +202,38 @@
 #error "invalid MFS_CFG_TRANSACTION_MAX value"
 #endif
 
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Record identifier reserved to checkpoint records.
+ */
+#define MFS_CHECKPOINT_ID                   0xFFFFFFFFU
+
+/**
+ * @brief   Highest valid record identifier.
+ */
+#define MFS_RECORD_ID_MAX                   0xFFFFFFFEU
+#else
+#define MFS_CHECKPOINT_ID                   0xFFFFU
+#define MFS_RECORD_ID_MAX                   ((mfs_id_t)MFS_CFG_MAX_RECORDS)
+#endif
+
+#if (MFS_CFG_USE_SORTED_INDEX == FALSE) &&                                  \
+    (MFS_CFG_MAX_RECORDS >= MFS_CHECKPOINT_ID)
+#error "invalid MFS_CFG_MAX_RECORDS value"
+#endif
+
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) && (MFS_CFG_BUFFER_SIZE < 32)
+#error "MFS_CFG_USE_SORTED_INDEX requires MFS_CFG_BUFFER_SIZE >= 32"
+#endif
+
+#if (MFS_CFG_CHECKPOINT_SLOTS < 1) || (MFS_CFG_CHECKPOINT_SLOTS > 256)
+#error "invalid MFS_CFG_CHECKPOINT_SLOTS value"
+#endif
+
+#if MFS_CFG_CHECKPOINT_INTERVAL < 1
+#error "invalid MFS_CFG_CHECKPOINT_INTERVAL value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -184,7 +274,8 @@ typedef enum {
   MFS_ERR_TRANSACTION_SIZE = -6,
   MFS_ERR_NOT_ERASED = -7,
   MFS_ERR_FLASH_FAILURE = -8,
-  MFS_ERR_INTERNAL = -9
+  MFS_ERR_INTERNAL = -9,
+  MFS_ERR_INV_LAYOUT = -10
 } mfs_error_t;
 
 /**
@@ -193,7 +284,8 @@ typedef enum {
 typedef enum {
   MFS_BANK_ERASED = 0,
   MFS_BANK_OK = 1,
-  MFS_BANK_GARBAGE = 2
+  MFS_BANK_GARBAGE = 2,
+  MFS_BANK_FOREIGN = 3
 } mfs_bank_state_t;
 
 /**
@@ -248,6 +340,32 @@ typedef union {
      * @brief   Data header magic 2.
      */
     uint32_t                magic2;
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+    /**
+     * @brief   Record identifier.
+     */
+    uint32_t                id;
+    /**
+     * @brief   Data CRC.
+     */
+    uint16_t                crc;
+    /**
+     * @brief   Reserved field.
+     */
+    uint16_t                reserved1;
+    /**
+     * @brief   Data size.
+     * @note    The next record is located at @p MFS_ALIGN_NEXT(size).
+     */
+    uint32_t                size;
+    /**
+     * @brief   Reserved field.
+     */
+    uint32_t                reserved2;
+  } fields;
+  uint8_t                   hdr8[24];
+  uint32_t                  hdr32[6];
+#else
     /**
      * @brief   Record identifier.
      */
@@ -264,9 +382,39 @@ typedef union {
   } fields;
   uint8_t                   hdr8[16];
   uint32_t                  hdr32[4];
+#endif
 } mfs_data_header_t;
 
+/**
+ * @brief   Type of a checkpoint slot.
+ * @details Slots are written in sequence after the bank header, each one
+ *          points to a checkpoint record.
+ */
+typedef union {
+  struct {
+    /**
+     * @brief   Offset of the checkpoint record header.
+     */
+    uint32_t                offset;
+    /**
+     * @brief   Bitwise complement of the offset.
+     */
+    uint32_t                check;
+  } fields;
+  uint8_t                   slot8[8];
+  uint32_t                  slot32[2];
+} mfs_checkpoint_slot_t;
+
+/**
+ * @brief   Type of a record descriptor.
+ */
 typedef struct {
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Record identifier.
+   */
+  mfs_id_t                  id;
+#endif
   /**
    * @brief   Offset of the record header.
    */
@@ -364,8 +512,17 @@ typedef struct {
   /**
    * @brief   Offsets of the most recent instance of the records.
    * @note    Zero means that there is not a record with that id.
+   * @note    If @p MFS_CFG_USE_SORTED_INDEX is enabled then the first
+   *          @p descriptors_num elements describe the existing records
+   *          sorted by identifier.
    */
   mfs_record_descriptor_t   descriptors[MFS_CFG_MAX_RECORDS];
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Number of existing records.
+   */
+  uint32_t                  descriptors_num;
+#endif
 #if (MFS_CFG_TRANSACTION_MAX > 0) || defined(__DOXYGEN__)
   /**
    * @brief   Next write offset for current transaction.
@@ -383,6 +540,16 @@ typedef struct {
    * @brief   Buffered operations in current transaction.
    */
   mfs_transaction_op_t      tr_ops[MFS_CFG_TRANSACTION_MAX];
+#endif
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Next free checkpoint slot in the current bank.
+   */
+  uint32_t                  cp_slot;
+  /**
+   * @brief   Record operations performed since the last checkpoint.
+   */
+  uint32_t                  cp_pending;
 #endif
   /**
    * @brief   Transient buffer.
@@ -128,6 +128,21 @@ struct CRYDriver {
    */
   uint8_t                   key0_buffer[HAL_CRY_MAX_KEY_SIZE];
 #endif
+#if ((HAL_CRY_USE_FALLBACK == TRUE) && (CRY_LLD_SUPPORTS_AES == FALSE)) ||  \
+    defined(__DOXYGEN__)
+  /**
+   * @brief   Fall-back AES transient key.
+   */
+  cryaeskey_t               fb_aeskey;
+#endif
+#if ((HAL_CRY_USE_FALLBACK == TRUE) &&                                      \
+     ((CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) ||                            \
+      (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE))) || defined(__DOXYGEN__)
+  /**
+   * @brief   Fall-back HMAC transient key.
+   */
+  cryhmackey_t              fb_hmackey;
+#endif
 #if defined(CRY_DRIVER_EXT_FIELDS)
   CRY_DRIVER_EXT_FIELDS
 #endif
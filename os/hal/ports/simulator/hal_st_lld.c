@@ -30,6 +30,11 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Half of the system time range.
+ */
+#define ST_HALF_RANGE       ((systime_t)1 << (OSAL_ST_RESOLUTION - 1))
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -42,10 +47,42 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Host time of the counter zero, in nanoseconds.
+ */
+static uint64_t st_base;
+
+/**
+ * @brief   Alarm time.
+ */
+static systime_t st_alarm;
+
+/**
+ * @brief   Alarm status.
+ */
+static bool st_alarm_active;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the number of ticks elapsed since initialization.
+ * @note    The simulator time is scaled with microseconds resolution, the
+ *          result does not overflow for frequencies up to 1MHz.
+ *
+ * @return              The number of ticks, not wrapped.
+ */
+static uint64_t st_get_ticks(void) {
+
+  return (((_sim_get_time() - st_base) / 1000U) *
+          (uint64_t)OSAL_ST_FREQUENCY) / 1000000U;
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -60,7 +97,156 @@
  * @notapi
  */
 void st_lld_init(void) {
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  st_base         = _sim_get_time();
+  st_alarm        = (systime_t)0;
+  st_alarm_active = false;
+#endif
+}
+
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time counter value.
+ * @note    The counter is derived from the simulator clock.
+ *
+ * @return              The counter value.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_counter(void) {
+
+  return (systime_t)st_get_ticks();
+}
+
+/**
+ * @brief   Starts the alarm.
+ * @note    Makes sure that no spurious alarms are triggered after
+ *          this call.
+ *
+ * @param[in] time      the time to be set for the first alarm
+ *
+ * @notapi
+ */
+void st_lld_start_alarm(systime_t time) {
+
+  st_alarm        = time;
+  st_alarm_active = true;
+}
+
+/**
+ * @brief   Stops the alarm interrupt.
+ *
+ * @notapi
+ */
+void st_lld_stop_alarm(void) {
+
+  st_alarm_active = false;
+}
+
+/**
+ * @brief   Sets the alarm time.
+ *
+ * @param[in] time      the time to be set for the next alarm
+ *
+ * @notapi
+ */
+void st_lld_set_alarm(systime_t time) {
+
+  st_alarm = time;
+}
+
+/**
+ * @brief   Returns the current alarm time.
+ *
+ * @return              The currently set alarm time.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_alarm(void) {
+
+  return st_alarm;
+}
+
+/**
+ * @brief   Determines if the alarm is active.
+ *
+ * @return              The alarm status.
+ * @retval false        if the alarm is not active.
+ * @retval true         is the alarm is active
+ *
+ * @notapi
+ */
+bool st_lld_is_alarm_active(void) {
+
+  return st_alarm_active;
+}
+
+/**
+ * @brief   Returns the simulator time of the next alarm.
+ * @details Used by the platform in order to block the host process until
+ *          the alarm is due.
+ *
+ * @param[out] deadlinep    pointer to the simulator time of the alarm, in
+ *                          nanoseconds
+ * @return                  The alarm status.
+ * @retval false            if the alarm is not active.
+ * @retval true             is the alarm is active
+ *
+ * @notapi
+ */
+bool st_lld_get_alarm_deadline(uint64_t *deadlinep) {
+  uint64_t now;
+  systime_t delta;
+
+  if (!st_alarm_active) {
+    return false;
+  }
+
+  /* Alarms in the past are due immediately.*/
+  now = st_get_ticks();
+  delta = (systime_t)(st_alarm - (systime_t)now);
+  if (delta >= ST_HALF_RANGE) {
+    delta = (systime_t)0;
+  }
+
+  /* Host time of the alarm tick, rounded up.*/
+  *deadlinep = st_base +
+               ((((now + (uint64_t)delta) * 1000000U) +
+                 (uint64_t)OSAL_ST_FREQUENCY - 1U) /
+                (uint64_t)OSAL_ST_FREQUENCY) * 1000U;
+
+  return true;
+}
+
+/**
+ * @brief   Alarm interrupt simulation.
+ * @details If the alarm is due then the system timer handler is invoked.
+ *
+ * @return                  The interrupt status.
+ * @retval false            if the alarm is not due.
+ * @retval true             if the alarm interrupt has been served.
+ *
+ * @notapi
+ */
+bool st_lld_serve_interrupt(void) {
+
+  if (!st_alarm_active ||
+      ((systime_t)(st_lld_get_counter() - st_alarm) >= ST_HALF_RANGE)) {
+    return false;
+  }
+
+  OSAL_IRQ_PROLOGUE();
+
+  osalSysLockFromISR();
+  osalOsTimerHandlerI();
+  osalSysUnlockFromISR();
+
+  OSAL_IRQ_EPILOGUE();
+
+  return true;
 }
+#endif /* OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING */
 
 #endif /* OSAL_ST_MODE != OSAL_ST_MODE_NONE */
 
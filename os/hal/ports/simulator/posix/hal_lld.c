@@ -22,9 +22,14 @@
  * @{
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
-#include <sys/time.h>
+#include <time.h>
+#include <poll.h>
 
 #include "hal.h"
 
@@ -36,13 +41,82 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
-static struct timeval nextcnt;
-static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
+/**
+ * @brief   Maximum number of host descriptors waited by the idle loop.
+ */
+#define SIM_MAX_POLLFDS     8
+
+#if (SIM_USE_VIRTUAL_TIME == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Simulator virtual time, in nanoseconds.
+ * @note    Accessed from all the simulated cores, only atomic operations
+ *          are allowed.
+ */
+static uint64_t vtime;
+
+/**
+ * @brief   Host wait of the idle loop when there are no timer events, in
+ *          milliseconds.
+ */
+#define SIM_IDLE_POLL_MS    1
+#endif
+
+#if (OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC) || defined(__DOXYGEN__)
+/**
+ * @brief   Simulator time of the next system tick, in nanoseconds.
+ * @note    Each simulated core has its own system tick.
+ */
+static uint64_t nextcnt[SIM_CORES_NUMBER];
+
+/**
+ * @brief   System tick period, in nanoseconds.
+ */
+static const uint64_t tick = 1000000000ULL / OSAL_ST_FREQUENCY;
+#endif
+
+#if (SIM_CORES_NUMBER > 1) || defined(__DOXYGEN__)
+/**
+ * @brief   Pending notifications, one for each core.
+ */
+static volatile bool notify_pending[SIM_CORES_NUMBER];
+
+/**
+ * @brief   Notification pipes, used to wake up idle cores.
+ */
+static int notify_pipe[SIM_CORES_NUMBER][2];
+#endif
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (SIM_CORES_NUMBER > 1) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the identifier of the current core.
+ */
+#define sim_core_id()       port_get_core_id()
+#else
+#define sim_core_id()       0U
+#endif
+
+#if (SIM_USE_VIRTUAL_TIME == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Moves the virtual time forward to the specified time.
+ * @note    The virtual time is never moved backward, another core could
+ *          have advanced it already.
+ *
+ * @param[in] t         the new virtual time, in nanoseconds
+ */
+static void sim_advance_time(uint64_t t) {
+  uint64_t cur = __atomic_load_n(&vtime, __ATOMIC_ACQUIRE);
+
+  while ((cur < t) &&
+         !__atomic_compare_exchange_n(&vtime, &cur, t, false,
+                                      __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+  }
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -61,27 +135,90 @@ void hal_lld_init(void) {
 #else
   puts("ChibiOS/RT simulator (Linux)\n");
 #endif
-  gettimeofday(&nextcnt, NULL);
-  timeradd(&nextcnt, &tick, &nextcnt);
+#if SIM_USE_VIRTUAL_TIME == TRUE
+  puts("Virtual time mode\n");
+#endif
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  nextcnt[0] = _sim_get_time() + tick;
+#endif
+#if SIM_CORES_NUMBER > 1
+  {
+    unsigned i;
+
+    for (i = 0U; i < SIM_CORES_NUMBER; i++) {
+      notify_pending[i] = false;
+      if (pipe(notify_pipe[i]) != 0) {
+        printf("Unable to create the cores notification pipes\n");
+        exit(1);
+      }
+      (void) fcntl(notify_pipe[i][0], F_SETFL, O_NONBLOCK);
+      (void) fcntl(notify_pipe[i][1], F_SETFL, O_NONBLOCK);
+    }
+  }
+#endif
+}
+
+/**
+ * @brief   Returns the simulator time.
+ * @note    The simulator time is the host monotonic time unless the
+ *          virtual time mode is enabled.
+ *
+ * @return              The simulator time in nanoseconds.
+ */
+uint64_t _sim_get_time(void) {
+#if SIM_USE_VIRTUAL_TIME == TRUE
+
+  return __atomic_load_n(&vtime, __ATOMIC_ACQUIRE);
+#else
+  struct timespec ts;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+#endif
 }
 
 /**
  * @brief   Interrupt simulation.
+ * @details Serves the pending simulated interrupts without waiting.
  */
 void _sim_check_for_interrupts(void) {
-  struct timeval tv;
+  unsigned core = sim_core_id();
   bool int_occurred = false;
 
+  (void)core;
+
+#if SIM_USE_VIRTUAL_TIME == TRUE
+  (void) __atomic_fetch_add(&vtime, (uint64_t)SIM_VIRTUAL_TIME_QUANTUM,
+                            __ATOMIC_ACQ_REL);
+#endif
+
+#if SIM_CORES_NUMBER > 1
+  /* Notifications from other cores.*/
+  if (__atomic_exchange_n(&notify_pending[core], false, __ATOMIC_ACQ_REL)) {
+    uint8_t buf[16];
+
+    while (read(notify_pipe[core][0], buf, sizeof (buf)) > 0) {
+    }
+    int_occurred = true;
+  }
+
+  /* The first tick of secondary cores is scheduled on their first check.*/
+  if (nextcnt[core] == 0U) {
+    nextcnt[core] = _sim_get_time() + tick;
+  }
+#endif
+
 #if HAL_USE_SERIAL
-  if (sd_lld_interrupt_pending()) {
+  /* The serial ports are served by the first core.*/
+  if ((core == 0U) && sd_lld_interrupt_pending()) {
     int_occurred = true;
   }
 #endif
 
-  gettimeofday(&tv, NULL);
-  if (timercmp(&tv, &nextcnt, >=)) {
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  if (_sim_get_time() >= nextcnt[core]) {
     int_occurred = true;
-    timeradd(&nextcnt, &tick, &nextcnt);
+    nextcnt[core] += tick;
 
     CH_IRQ_PROLOGUE();
 
@@ -91,13 +228,118 @@ void _sim_check_for_interrupts(void) {
 
     CH_IRQ_EPILOGUE();
   }
+#elif OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  if (st_lld_serve_interrupt()) {
+    int_occurred = true;
+  }
+#endif
 
   if (int_occurred) {
+#if SIM_CORES_NUMBER > 1
+    /* Other cores can access the ready list, the kernel lock is taken.*/
+    chSysLock();
+    if (chSchIsPreemptionRequired())
+      chSchDoReschedule();
+    chSysUnlock();
+#else
     _dbg_check_lock();
     if (chSchIsPreemptionRequired())
       chSchDoReschedule();
     _dbg_check_unlock();
+#endif
+  }
+}
+
+/**
+ * @brief   Waits for the next simulated interrupt.
+ * @details The host process is blocked until the next system timer event
+ *          or until activity on the simulated peripherals, then the pending
+ *          interrupts are served. This function is meant to be invoked by
+ *          the idle thread.
+ * @note    In virtual time mode the time jumps to the next system timer
+ *          event instead of waiting for it. If there is no timer event
+ *          then the host waits for peripherals activity for at most
+ *          @p SIM_IDLE_POLL_MS milliseconds and the time advances by one
+ *          quantum, the idle loop never blocks indefinitely.
+ */
+void _sim_wait_for_interrupts(void) {
+  struct pollfd fds[SIM_MAX_POLLFDS];
+  unsigned core = sim_core_id();
+  nfds_t nfds = 0;
+  uint64_t deadline = 0U, now;
+  bool timed = false;
+
+  (void)core;
+
+#if HAL_USE_SERIAL
+  if (core == 0U) {
+    nfds = (nfds_t)sd_lld_get_pollfds(fds, SIM_MAX_POLLFDS - 1);
+  }
+#endif
+
+#if SIM_CORES_NUMBER > 1
+  fds[nfds].fd      = notify_pipe[core][0];
+  fds[nfds].events  = POLLIN;
+  fds[nfds].revents = 0;
+  nfds++;
+#endif
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  deadline = nextcnt[core];
+  timed = true;
+#elif OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  timed = st_lld_get_alarm_deadline(&deadline);
+#endif
+
+  now = _sim_get_time();
+#if SIM_USE_VIRTUAL_TIME == TRUE
+  /* Peripherals activity is checked without waiting, if there is none
+     then the time jumps straight to the next timer event.*/
+  if (poll(fds, nfds, timed ? 0 : SIM_IDLE_POLL_MS) <= 0) {
+    if (timed && (deadline > now)) {
+      sim_advance_time(deadline);
+    }
+  }
+#else
+  if (!timed || (deadline > now)) {
+#if defined(__linux__)
+    struct timespec ts, *tsp = NULL;
+
+    if (timed) {
+      ts.tv_sec  = (time_t)((deadline - now) / 1000000000ULL);
+      ts.tv_nsec = (long)((deadline - now) % 1000000000ULL);
+      tsp = &ts;
+    }
+    (void) ppoll(fds, nfds, tsp, NULL);
+#else
+    int ms = -1;
+
+    if (timed) {
+      ms = (int)(((deadline - now) + 999999ULL) / 1000000ULL);
+    }
+    (void) poll(fds, nfds, ms);
+#endif
+  }
+#endif
+
+  _sim_check_for_interrupts();
+}
+
+#if (SIM_CORES_NUMBER > 1) || defined(__DOXYGEN__)
+/**
+ * @brief   Notifies a simulated core.
+ * @details The core is awakened if waiting for interrupts, it reschedules
+ *          on its next interrupts check.
+ *
+ * @param[in] core_id   the identifier of the core to be notified
+ */
+void _sim_notify_core(unsigned core_id) {
+  uint8_t b = 0U;
+
+  if (!__atomic_exchange_n(&notify_pending[core_id], true, __ATOMIC_ACQ_REL)) {
+    (void) write(notify_pipe[core_id][1], &b, 1);
   }
 }
+#endif
 
 /** @} */
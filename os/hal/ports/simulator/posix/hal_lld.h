@@ -33,8 +33,10 @@
 #include <netdb.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #endif
 #include <stdio.h>
+#include <stdint.h>
 
 /*===========================================================================*/
 /* Driver constants.                                                         */
@@ -53,10 +55,59 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Virtual time mode.
+ * @details If enabled the simulator clock is decoupled from the host clock,
+ *          time only advances by @p SIM_VIRTUAL_TIME_QUANTUM on each
+ *          interrupts check and, when all threads are idle, it jumps
+ *          straight to the next system timer event. Runs are faster than
+ *          real time and reproducible.
+ * @note    The default is @p FALSE.
+ * @note    Benchmarks results are not meaningful in this mode, also busy
+ *          loops on the realtime counter, like @p chSysPolledDelayX(),
+ *          must check for interrupts in order to make progress.
+ */
+#if !defined(SIM_USE_VIRTUAL_TIME) || defined(__DOXYGEN__)
+#define SIM_USE_VIRTUAL_TIME                FALSE
+#endif
+
+/**
+ * @brief   Simulated time consumed by each interrupts check.
+ * @details Busy loops polling the simulator interrupts make progress
+ *          by this amount of nanoseconds for each iteration.
+ * @note    Only used in virtual time mode.
+ */
+#if !defined(SIM_VIRTUAL_TIME_QUANTUM) || defined(__DOXYGEN__)
+#define SIM_VIRTUAL_TIME_QUANTUM            1000U
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (SIM_USE_VIRTUAL_TIME == TRUE) && (SIM_VIRTUAL_TIME_QUANTUM == 0U)
+#error "invalid SIM_VIRTUAL_TIME_QUANTUM value"
+#endif
+
+/**
+ * @brief   Number of simulated cores.
+ */
+#if (CH_CFG_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+#define SIM_CORES_NUMBER                    PORT_CORES_NUMBER
+#else
+#define SIM_CORES_NUMBER                    1
+#endif
+
+#if SIM_CORES_NUMBER > 1
+#if SIM_USE_VIRTUAL_TIME == TRUE
+#error "virtual time mode not supported with multiple cores"
+#endif
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+#error "tick-less mode not supported with multiple cores"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -69,7 +120,12 @@
 extern "C" {
 #endif
   void hal_lld_init(void);
+  uint64_t _sim_get_time(void);
   void _sim_check_for_interrupts(void);
+  void _sim_wait_for_interrupts(void);
+#if SIM_CORES_NUMBER > 1
+  void _sim_notify_core(unsigned core_id);
+#endif
 #ifdef __cplusplus
 }
 #endif
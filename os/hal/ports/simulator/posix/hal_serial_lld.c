@@ -215,6 +215,26 @@ static bool outint(SerialDriver *sdp) {
   return false;
 }
 
+static unsigned addfds(SerialDriver *sdp, struct pollfd *fds, unsigned n) {
+
+  if (sdp->com_data != -1) {
+    fds->fd = sdp->com_data;
+    fds->events = POLLIN;
+    if (!oqIsEmptyI(&sdp->oqueue)) {
+      fds->events |= POLLOUT;
+    }
+  }
+  else if (sdp->com_listen != -1) {
+    fds->fd = sdp->com_listen;
+    fds->events = POLLIN;
+  }
+  else {
+    return n;
+  }
+  fds->revents = 0;
+  return n + 1U;
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -293,6 +313,26 @@ bool sd_lld_interrupt_pending(void) {
   return b;
 }
 
+/**
+ * @brief   Returns the host descriptors the serial drivers are waiting on.
+ * @details The idle loop waits on these descriptors, a connection, incoming
+ *          data or free space for pending output wake up the simulator.
+ *
+ * @param[out] fds      array of @p pollfd structures to be filled
+ * @param[in] max       number of elements in the array
+ * @return              The number of filled elements.
+ */
+unsigned sd_lld_get_pollfds(struct pollfd *fds, unsigned max) {
+  unsigned n = 0U;
+
+  if (max >= 2U) {
+    n = addfds(&SD1, &fds[n], n);
+    n = addfds(&SD2, &fds[n], n);
+  }
+
+  return n;
+}
+
 #endif /* HAL_USE_SERIAL */
 
 /** @} */
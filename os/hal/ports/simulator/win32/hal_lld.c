@@ -34,6 +34,14 @@
 
 static LARGE_INTEGER nextcnt;
 static LARGE_INTEGER slice;
+static LARGE_INTEGER hostfreq;
+
+/**
+ * @brief   Longest wait in the idle loop, in milliseconds.
+ * @note    Sockets are not waited on this platform, the serial drivers are
+ *          polled at this interval while the system is idle.
+ */
+#define SIM_MAX_WAIT_MS     1U
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
@@ -64,6 +72,7 @@ void hal_lld_init(void) {
     printf("QueryPerformanceFrequency() error");
     exit(1);
   }
+  hostfreq = slice;
   slice.QuadPart /= CH_CFG_ST_FREQUENCY;
   QueryPerformanceCounter(&nextcnt);
   nextcnt.QuadPart += slice.QuadPart;
@@ -71,8 +80,24 @@ void hal_lld_init(void) {
   fflush(stdout);
 }
 
+/**
+ * @brief   Returns the simulator time.
+ * @note    On this platform the simulator time is the host monotonic time.
+ *
+ * @return              The simulator time in nanoseconds.
+ */
+uint64_t _sim_get_time(void) {
+  LARGE_INTEGER n;
+
+  QueryPerformanceCounter(&n);
+  return ((uint64_t)n.QuadPart / (uint64_t)hostfreq.QuadPart) * 1000000000ULL +
+         (((uint64_t)n.QuadPart % (uint64_t)hostfreq.QuadPart) * 1000000000ULL) /
+         (uint64_t)hostfreq.QuadPart;
+}
+
 /**
  * @brief   Interrupt simulation.
+ * @details Serves the pending simulated interrupts without waiting.
  */
 void _sim_check_for_interrupts(void) {
   LARGE_INTEGER n;
@@ -84,6 +109,7 @@ void _sim_check_for_interrupts(void) {
   }
 #endif
 
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
   /* Interrupt Timer simulation (10ms interval).*/
   QueryPerformanceCounter(&n);
   if (n.QuadPart > nextcnt.QuadPart) {
@@ -98,6 +124,12 @@ void _sim_check_for_interrupts(void) {
 
     CH_IRQ_EPILOGUE();
   }
+#elif OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  (void)n;
+  if (st_lld_serve_interrupt()) {
+    int_occurred = true;
+  }
+#endif
 
   if (int_occurred) {
     _dbg_check_lock();
@@ -107,4 +139,42 @@ void _sim_check_for_interrupts(void) {
   }
 }
 
+/**
+ * @brief   Waits for the next simulated interrupt.
+ * @details The host process sleeps until the next system timer event, for
+ *          at most @p SIM_MAX_WAIT_MS milliseconds, then the pending
+ *          interrupts are served. This function is meant to be invoked by
+ *          the idle thread.
+ */
+void _sim_wait_for_interrupts(void) {
+  uint64_t deadline = 0U, now;
+  bool timed = false;
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  LARGE_INTEGER n;
+
+  QueryPerformanceCounter(&n);
+  if (nextcnt.QuadPart > n.QuadPart) {
+    deadline = (uint64_t)(nextcnt.QuadPart - n.QuadPart) * 1000000000ULL /
+               (uint64_t)hostfreq.QuadPart;
+  }
+  now = 0U;
+  timed = true;
+#elif OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  now = _sim_get_time();
+  timed = st_lld_get_alarm_deadline(&deadline);
+#endif
+
+  if (!timed || (deadline > now)) {
+    DWORD ms = SIM_MAX_WAIT_MS;
+
+    if (timed && ((deadline - now) < (uint64_t)ms * 1000000ULL)) {
+      ms = (DWORD)((deadline - now) / 1000000ULL);
+    }
+    Sleep(ms);
+  }
+
+  _sim_check_for_interrupts();
+}
+
 /** @} */
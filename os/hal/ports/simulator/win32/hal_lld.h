@@ -27,6 +27,7 @@
 
 #include <windows.h>
 #include <stdio.h>
+#include <stdint.h>
 
 /*===========================================================================*/
 /* Driver constants.                                                         */
@@ -57,7 +58,9 @@
 extern "C" {
 #endif
   void hal_lld_init(void);
+  uint64_t _sim_get_time(void);
   void _sim_check_for_interrupts(void);
+  void _sim_wait_for_interrupts(void);
 #ifdef __cplusplus
 }
 #endif
@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 #if (HAL_USE_CRY == TRUE) || defined(__DOXYGEN__)
@@ -71,6 +73,9 @@ void cryObjectInit(CRYDriver *cryp) {
 
   cryp->state    = CRY_STOP;
   cryp->config   = NULL;
+#if HAL_CRY_USE_FALLBACK == TRUE
+  cry_fallback_clear(cryp);
+#endif
 #if defined(CRY_DRIVER_EXT_INIT_HOOK)
   CRY_DRIVER_EXT_INIT_HOOK(cryp);
 #endif
@@ -102,6 +107,7 @@ void cryStart(CRYDriver *cryp, const CRYConfig *config) {
 
 /**
  * @brief   Deactivates the cryptographic peripheral.
+ * @note    The fall-back transient keys, if any, are cleared.
  *
  * @param[in] cryp              pointer to the @p CRYDriver object
  *
@@ -118,6 +124,9 @@ void cryStop(CRYDriver *cryp) {
 
 #if HAL_CRY_ENFORCE_FALLBACK == FALSE
   cry_lld_stop(cryp);
+#endif
+#if HAL_CRY_USE_FALLBACK == TRUE
+  cry_fallback_clear(cryp);
 #endif
   cryp->config = NULL;
   cryp->state  = CRY_STOP;
@@ -821,6 +830,531 @@ cryerror_t cryDecryptAES_GCM(CRYDriver *cryp,
 #endif
 }
 
+/**
+ * @brief   AES-CTR streaming initialization.
+ * @note    The streaming modes are implemented by the fallback, the single
+ *          block operation of the LLD is used if available.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] ctxp             pointer to an AES-CTR context to be
+ *                              initialized
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] iv                128 bits input vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryAES_CTRInit(CRYDriver *cryp,
+                          AESCTRContext *ctxp,
+                          crykey_t key_id,
+                          const uint8_t *iv) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) && (iv != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_AES_CTR_init(cryp, ctxp, key_id, iv);
+#else
+  (void)cryp;
+  (void)ctxp;
+  (void)key_id;
+  (void)iv;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   AES-CTR streaming update.
+ * @details Encryption and decryption are the same operation, the message
+ *          can be split in parts of any size.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to an AES-CTR context
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input text
+ * @param[out] out              buffer for the output text, it can be the
+ *                              same as @p in
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryAES_CTRUpdate(CRYDriver *cryp,
+                            AESCTRContext *ctxp,
+                            size_t size,
+                            const uint8_t *in,
+                            uint8_t *out) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) &&
+               (in != NULL) && (out != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_AES_CTR_update(cryp, ctxp, size, in, out);
+#else
+  (void)cryp;
+  (void)ctxp;
+  (void)size;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   Scatter-gather AES-CTR operation.
+ * @details The buffers are processed in place as a single message,
+ *          encryption and decryption are the same operation.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] iovcnt            number of buffer descriptors
+ * @param[in] iov               array of buffer descriptors
+ * @param[in] iv                128 bits input vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryAES_CTRV(CRYDriver *cryp,
+                       crykey_t key_id,
+                       size_t iovcnt,
+                       const cryiovec_t *iov,
+                       const uint8_t *iv) {
+  AESCTRContext ctx;
+  cryerror_t err;
+  size_t i;
+
+  osalDbgCheck((cryp != NULL) && (iov != NULL) && (iv != NULL));
+
+  err = cryAES_CTRInit(cryp, &ctx, key_id, iv);
+  for (i = 0U; (i < iovcnt) && (err == CRY_NOERROR); i++) {
+    err = cryAES_CTRUpdate(cryp, &ctx, iov[i].size,
+                           iov[i].base, iov[i].base);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   AES-GCM streaming initialization.
+ * @details The operation is performed in phases: the authenticated data
+ *          is added using @p cryAES_GCMUpdateAuth(), then the text is
+ *          processed using @p cryEncryptAES_GCMUpdate() or
+ *          @p cryDecryptAES_GCMUpdate(), finally the tag is generated or
+ *          verified.
+ * @note    The streaming modes are implemented by the fallback, the single
+ *          block operation of the LLD is used if available.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] ctxp             pointer to an AES-GCM context to be
+ *                              initialized
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryAES_GCMInit(CRYDriver *cryp,
+                          AESGCMContext *ctxp,
+                          crykey_t key_id,
+                          const uint8_t *iv) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) && (iv != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_AES_GCM_init(cryp, ctxp, key_id, iv);
+#else
+  (void)cryp;
+  (void)ctxp;
+  (void)key_id;
+  (void)iv;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   AES-GCM streaming authenticated data update.
+ * @pre     The text processing must not be started.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to an AES-GCM context
+ * @param[in] size              size of the data buffer to be authenticated
+ * @param[in] in                buffer containing the data to be authenticated
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryAES_GCMUpdateAuth(CRYDriver *cryp,
+                                AESGCMContext *ctxp,
+                                size_t size,
+                                const uint8_t *in) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) && (in != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_AES_GCM_update_auth(cryp, ctxp, size, in);
+#else
+  (void)cryp;
+  (void)ctxp;
+  (void)size;
+  (void)in;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   AES-GCM streaming encryption update.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to an AES-GCM context
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext, it can be
+ *                              the same as @p in
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryEncryptAES_GCMUpdate(CRYDriver *cryp,
+                                   AESGCMContext *ctxp,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) &&
+               (in != NULL) && (out != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_encrypt_AES_GCM_update(cryp, ctxp, size, in, out);
+#else
+  (void)cryp;
+  (void)ctxp;
+  (void)size;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   AES-GCM streaming decryption update.
+ * @note    The plaintext is released before the authentication tag is
+ *          verified, it must not be used until @p cryDecryptAES_GCMFinal()
+ *          succeeds.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to an AES-GCM context
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext, it can be
+ *                              the same as @p in
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryDecryptAES_GCMUpdate(CRYDriver *cryp,
+                                   AESGCMContext *ctxp,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) &&
+               (in != NULL) && (out != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_decrypt_AES_GCM_update(cryp, ctxp, size, in, out);
+#else
+  (void)cryp;
+  (void)ctxp;
+  (void)size;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   AES-GCM streaming encryption finalization.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to an AES-GCM context
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[out] tag_out          buffer for the generated authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryEncryptAES_GCMFinal(CRYDriver *cryp,
+                                  AESGCMContext *ctxp,
+                                  size_t tag_size,
+                                  uint8_t *tag_out) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) &&
+               (tag_size >= (size_t)1) && (tag_size <= (size_t)16) &&
+               (tag_out != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_encrypt_AES_GCM_final(cryp, ctxp, tag_size, tag_out);
+#else
+  (void)cryp;
+  (void)ctxp;
+  (void)tag_size;
+  (void)tag_out;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   AES-GCM streaming decryption finalization.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to an AES-GCM context
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[in] tag_in            buffer containing the authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryDecryptAES_GCMFinal(CRYDriver *cryp,
+                                  AESGCMContext *ctxp,
+                                  size_t tag_size,
+                                  const uint8_t *tag_in) {
+
+  osalDbgCheck((cryp != NULL) && (ctxp != NULL) &&
+               (tag_size >= (size_t)1) && (tag_size <= (size_t)16) &&
+               (tag_in != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_decrypt_AES_GCM_final(cryp, ctxp, tag_size, tag_in);
+#else
+  (void)cryp;
+  (void)ctxp;
+  (void)tag_size;
+  (void)tag_in;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   Scatter-gather AES-GCM encryption.
+ * @details The authenticated data and the text are gathered from arrays
+ *          of buffers, the text is encrypted in place in a single pass.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] auth_cnt          number of authenticated data descriptors
+ * @param[in] auth_iov          array of authenticated data descriptors
+ * @param[in] text_cnt          number of text descriptors
+ * @param[in] text_iov          array of text descriptors
+ * @param[in] iv                128 bits input vector
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[out] tag_out          buffer for the generated authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryEncryptAES_GCMV(CRYDriver *cryp,
+                              crykey_t key_id,
+                              size_t auth_cnt,
+                              const cryiovec_t *auth_iov,
+                              size_t text_cnt,
+                              const cryiovec_t *text_iov,
+                              const uint8_t *iv,
+                              size_t tag_size,
+                              uint8_t *tag_out) {
+  AESGCMContext ctx;
+  cryerror_t err;
+  size_t i;
+
+  osalDbgCheck((cryp != NULL) &&
+               ((auth_cnt == (size_t)0) || (auth_iov != NULL)) &&
+               ((text_cnt == (size_t)0) || (text_iov != NULL)) &&
+               (iv != NULL) && (tag_out != NULL));
+
+  err = cryAES_GCMInit(cryp, &ctx, key_id, iv);
+  for (i = 0U; (i < auth_cnt) && (err == CRY_NOERROR); i++) {
+    err = cryAES_GCMUpdateAuth(cryp, &ctx, auth_iov[i].size,
+                               auth_iov[i].base);
+  }
+  for (i = 0U; (i < text_cnt) && (err == CRY_NOERROR); i++) {
+    err = cryEncryptAES_GCMUpdate(cryp, &ctx, text_iov[i].size,
+                                  text_iov[i].base, text_iov[i].base);
+  }
+  if (err == CRY_NOERROR) {
+    err = cryEncryptAES_GCMFinal(cryp, &ctx, tag_size, tag_out);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Scatter-gather AES-GCM decryption.
+ * @details The authenticated data and the text are gathered from arrays
+ *          of buffers, the text is decrypted in place in a single pass.
+ * @note    If the authentication fails then the text buffers are cleared,
+ *          the unauthenticated plaintext is never returned.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] auth_cnt          number of authenticated data descriptors
+ * @param[in] auth_iov          array of authenticated data descriptors
+ * @param[in] text_cnt          number of text descriptors
+ * @param[in] text_iov          array of text descriptors
+ * @param[in] iv                128 bits input vector
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[in] tag_in            buffer containing the authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_TYPE the selected key is invalid for this operation.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
+ * @retval CRY_ERR_OP_FAILURE   if the operation failed, implementation
+ *                              dependent.
+ *
+ * @api
+ */
+cryerror_t cryDecryptAES_GCMV(CRYDriver *cryp,
+                              crykey_t key_id,
+                              size_t auth_cnt,
+                              const cryiovec_t *auth_iov,
+                              size_t text_cnt,
+                              const cryiovec_t *text_iov,
+                              const uint8_t *iv,
+                              size_t tag_size,
+                              const uint8_t *tag_in) {
+  AESGCMContext ctx;
+  cryerror_t err;
+  size_t i;
+
+  osalDbgCheck((cryp != NULL) &&
+               ((auth_cnt == (size_t)0) || (auth_iov != NULL)) &&
+               ((text_cnt == (size_t)0) || (text_iov != NULL)) &&
+               (iv != NULL) && (tag_in != NULL));
+
+  err = cryAES_GCMInit(cryp, &ctx, key_id, iv);
+  for (i = 0U; (i < auth_cnt) && (err == CRY_NOERROR); i++) {
+    err = cryAES_GCMUpdateAuth(cryp, &ctx, auth_iov[i].size,
+                               auth_iov[i].base);
+  }
+  for (i = 0U; (i < text_cnt) && (err == CRY_NOERROR); i++) {
+    err = cryDecryptAES_GCMUpdate(cryp, &ctx, text_iov[i].size,
+                                  text_iov[i].base, text_iov[i].base);
+  }
+  if (err == CRY_NOERROR) {
+    err = cryDecryptAES_GCMFinal(cryp, &ctx, tag_size, tag_in);
+    if (err == CRY_ERR_AUTH_FAILED) {
+      for (i = 0U; i < text_cnt; i++) {
+        memset(text_iov[i].base, 0, text_iov[i].size);
+      }
+    }
+  }
+
+  return err;
+}
+
 /**
  * @brief   Initializes the DES transient key.
  * @note    It is the underlying implementation to decide which key sizes are
@@ -1501,7 +2035,21 @@ cryerror_t cryLoadHMACTransientKey(CRYDriver *cryp,
 
 #if (CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE) ||                               \
     (CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE)
+#if (HAL_CRY_USE_FALLBACK == TRUE) &&                                       \
+    ((CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) ||                             \
+     (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE))
+  {
+    /* One of the HMAC variants is implemented by the fall-back, the key
+       is required by both implementations.*/
+    cryerror_t err = cry_lld_hmac_loadkey(cryp, size, keyp);
+    if (err != CRY_NOERROR) {
+      return err;
+    }
+    return cry_fallback_hmac_loadkey(cryp, size, keyp);
+  }
+#else
   return cry_lld_hmac_loadkey(cryp, size, keyp);
+#endif
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_hmac_loadkey(cryp, size, keyp);
 #else
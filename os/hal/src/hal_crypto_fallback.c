@@ -0,0 +1,2827 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_fallback.c
+ * @brief   Cryptographic Driver software fall-back code.
+ * @details Portable implementations of the algorithms not supported by the
+ *          low level driver, only the functions required by the LLD
+ *          capabilities are compiled in.
+ *          - AES uses a single 1kB lookup table per direction, the other
+ *            three tables are obtained by rotation. When the LLD supports
+ *            the single block AES operation then the modes are built on
+ *            top of it.
+ *          - GHASH uses 4 bits tables built for each operation and
+ *            processes the hash state as two 64 bits words.
+ *          - SHA-1, SHA-256, SHA-512 and HMAC are complete
+ *            implementations, HMAC pre-computes the padded keys when the
+ *            key is loaded.
+ *          - DES is not implemented.
+ *          .
+ * @note    The fall-back transient keys are stored in the driver
+ *          structure, they are cleared when the driver is stopped.
+ * @note    The lookup tables make the AES implementation exposed to cache
+ *          timing attacks on systems with data caches.
+ *
+ * @addtogroup CRYPTO
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if ((HAL_USE_CRY == TRUE) && (HAL_CRY_USE_FALLBACK == TRUE)) ||            \
+    defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the chunks processed by the AES-GCM streaming functions.
+ * @details Each chunk is encrypted and then hashed, it should fit the
+ *          data cache.
+ */
+#define FALLBACK_GCM_CHUNK_SIZE             256U
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) ||                                   \
+    (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE)
+#define FALLBACK_NEEDS_SHA256               TRUE
+#else
+#define FALLBACK_NEEDS_SHA256               FALSE
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) ||                                   \
+    (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE)
+#define FALLBACK_NEEDS_SHA512               TRUE
+#else
+#define FALLBACK_NEEDS_SHA512               FALSE
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || (FALLBACK_NEEDS_SHA256 == TRUE) ||  \
+    (FALLBACK_NEEDS_SHA512 == TRUE)
+#define FALLBACK_NEEDS_HASH                 TRUE
+#else
+#define FALLBACK_NEEDS_HASH                 FALSE
+#endif
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) ||                              \
+    (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE)
+#define FALLBACK_NEEDS_HMAC                 TRUE
+#else
+#define FALLBACK_NEEDS_HMAC                 FALSE
+#endif
+
+/**
+ * @brief   Big endian 32 bits load.
+ */
+#define GET_U32_BE(p)                                                       \
+  (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) |                    \
+   ((uint32_t)(p)[2] << 8)  | (uint32_t)(p)[3])
+
+/**
+ * @brief   Big endian 64 bits load.
+ */
+#define GET_U64_BE(p)                                                       \
+  (((uint64_t)GET_U32_BE(p) << 32) | (uint64_t)GET_U32_BE((p) + 4))
+
+/**
+ * @brief   Big endian 32 bits store.
+ */
+#define PUT_U32_BE(p, v) do {                                               \
+  (p)[0] = (uint8_t)((v) >> 24);                                            \
+  (p)[1] = (uint8_t)((v) >> 16);                                            \
+  (p)[2] = (uint8_t)((v) >> 8);                                             \
+  (p)[3] = (uint8_t)(v);                                                    \
+} while (false)
+
+/**
+ * @brief   Big endian 64 bits store.
+ */
+#define PUT_U64_BE(p, v) do {                                               \
+  PUT_U32_BE((p), (uint32_t)((v) >> 32));                                   \
+  PUT_U32_BE((p) + 4, (uint32_t)(v));                                       \
+} while (false)
+
+/**
+ * @brief   32 bits right rotation.
+ */
+#define ROR32(x, n)         (((x) >> (n)) | ((x) << (32U - (n))))
+
+/**
+ * @brief   64 bits right rotation.
+ */
+#define ROR64(x, n)         (((x) >> (n)) | ((x) << (64U - (n))))
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+#if (CRY_LLD_SUPPORTS_AES == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   AES S-box.
+ */
+static const uint8_t aes_sbox[256] = {
+  0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B,
+  0xFE, 0xD7, 0xAB, 0x76, 0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0,
+  0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0, 0xB7, 0xFD, 0x93, 0x26,
+  0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+  0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2,
+  0xEB, 0x27, 0xB2, 0x75, 0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0,
+  0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84, 0x53, 0xD1, 0x00, 0xED,
+  0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+  0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F,
+  0x50, 0x3C, 0x9F, 0xA8, 0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5,
+  0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2, 0xCD, 0x0C, 0x13, 0xEC,
+  0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+  0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14,
+  0xDE, 0x5E, 0x0B, 0xDB, 0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C,
+  0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79, 0xE7, 0xC8, 0x37, 0x6D,
+  0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+  0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F,
+  0x4B, 0xBD, 0x8B, 0x8A, 0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E,
+  0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E, 0xE1, 0xF8, 0x98, 0x11,
+  0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+  0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F,
+  0xB0, 0x54, 0xBB, 0x16
+};
+
+/**
+ * @brief   AES inverse S-box.
+ */
+static const uint8_t aes_inv_sbox[256] = {
+  0x52, 0x09, 0x6A, 0xD5, 0x30, 0x36, 0xA5, 0x38, 0xBF, 0x40, 0xA3, 0x9E,
+  0x81, 0xF3, 0xD7, 0xFB, 0x7C, 0xE3, 0x39, 0x82, 0x9B, 0x2F, 0xFF, 0x87,
+  0x34, 0x8E, 0x43, 0x44, 0xC4, 0xDE, 0xE9, 0xCB, 0x54, 0x7B, 0x94, 0x32,
+  0xA6, 0xC2, 0x23, 0x3D, 0xEE, 0x4C, 0x95, 0x0B, 0x42, 0xFA, 0xC3, 0x4E,
+  0x08, 0x2E, 0xA1, 0x66, 0x28, 0xD9, 0x24, 0xB2, 0x76, 0x5B, 0xA2, 0x49,
+  0x6D, 0x8B, 0xD1, 0x25, 0x72, 0xF8, 0xF6, 0x64, 0x86, 0x68, 0x98, 0x16,
+  0xD4, 0xA4, 0x5C, 0xCC, 0x5D, 0x65, 0xB6, 0x92, 0x6C, 0x70, 0x48, 0x50,
+  0xFD, 0xED, 0xB9, 0xDA, 0x5E, 0x15, 0x46, 0x57, 0xA7, 0x8D, 0x9D, 0x84,
+  0x90, 0xD8, 0xAB, 0x00, 0x8C, 0xBC, 0xD3, 0x0A, 0xF7, 0xE4, 0x58, 0x05,
+  0xB8, 0xB3, 0x45, 0x06, 0xD0, 0x2C, 0x1E, 0x8F, 0xCA, 0x3F, 0x0F, 0x02,
+  0xC1, 0xAF, 0xBD, 0x03, 0x01, 0x13, 0x8A, 0x6B, 0x3A, 0x91, 0x11, 0x41,
+  0x4F, 0x67, 0xDC, 0xEA, 0x97, 0xF2, 0xCF, 0xCE, 0xF0, 0xB4, 0xE6, 0x73,
+  0x96, 0xAC, 0x74, 0x22, 0xE7, 0xAD, 0x35, 0x85, 0xE2, 0xF9, 0x37, 0xE8,
+  0x1C, 0x75, 0xDF, 0x6E, 0x47, 0xF1, 0x1A, 0x71, 0x1D, 0x29, 0xC5, 0x89,
+  0x6F, 0xB7, 0x62, 0x0E, 0xAA, 0x18, 0xBE, 0x1B, 0xFC, 0x56, 0x3E, 0x4B,
+  0xC6, 0xD2, 0x79, 0x20, 0x9A, 0xDB, 0xC0, 0xFE, 0x78, 0xCD, 0x5A, 0xF4,
+  0x1F, 0xDD, 0xA8, 0x33, 0x88, 0x07, 0xC7, 0x31, 0xB1, 0x12, 0x10, 0x59,
+  0x27, 0x80, 0xEC, 0x5F, 0x60, 0x51, 0x7F, 0xA9, 0x19, 0xB5, 0x4A, 0x0D,
+  0x2D, 0xE5, 0x7A, 0x9F, 0x93, 0xC9, 0x9C, 0xEF, 0xA0, 0xE0, 0x3B, 0x4D,
+  0xAE, 0x2A, 0xF5, 0xB0, 0xC8, 0xEB, 0xBB, 0x3C, 0x83, 0x53, 0x99, 0x61,
+  0x17, 0x2B, 0x04, 0x7E, 0xBA, 0x77, 0xD6, 0x26, 0xE1, 0x69, 0x14, 0x63,
+  0x55, 0x21, 0x0C, 0x7D
+};
+
+/**
+ * @brief   AES encryption table, SubBytes and MixColumns of a byte.
+ * @note    The other three tables are byte rotations of this one.
+ */
+static const uint32_t aes_te[256] = {
+  0xC66363A5U, 0xF87C7C84U, 0xEE777799U, 0xF67B7B8DU, 0xFFF2F20DU,
+  0xD66B6BBDU, 0xDE6F6FB1U, 0x91C5C554U, 0x60303050U, 0x02010103U,
+  0xCE6767A9U, 0x562B2B7DU, 0xE7FEFE19U, 0xB5D7D762U, 0x4DABABE6U,
+  0xEC76769AU, 0x8FCACA45U, 0x1F82829DU, 0x89C9C940U, 0xFA7D7D87U,
+  0xEFFAFA15U, 0xB25959EBU, 0x8E4747C9U, 0xFBF0F00BU, 0x41ADADECU,
+  0xB3D4D467U, 0x5FA2A2FDU, 0x45AFAFEAU, 0x239C9CBFU, 0x53A4A4F7U,
+  0xE4727296U, 0x9BC0C05BU, 0x75B7B7C2U, 0xE1FDFD1CU, 0x3D9393AEU,
+  0x4C26266AU, 0x6C36365AU, 0x7E3F3F41U, 0xF5F7F702U, 0x83CCCC4FU,
+  0x6834345CU, 0x51A5A5F4U, 0xD1E5E534U, 0xF9F1F108U, 0xE2717193U,
+  0xABD8D873U, 0x62313153U, 0x2A15153FU, 0x0804040CU, 0x95C7C752U,
+  0x46232365U, 0x9DC3C35EU, 0x30181828U, 0x379696A1U, 0x0A05050FU,
+  0x2F9A9AB5U, 0x0E070709U, 0x24121236U, 0x1B80809BU, 0xDFE2E23DU,
+  0xCDEBEB26U, 0x4E272769U, 0x7FB2B2CDU, 0xEA75759FU, 0x1209091BU,
+  0x1D83839EU, 0x582C2C74U, 0x341A1A2EU, 0x361B1B2DU, 0xDC6E6EB2U,
+  0xB45A5AEEU, 0x5BA0A0FBU, 0xA45252F6U, 0x763B3B4DU, 0xB7D6D661U,
+  0x7DB3B3CEU, 0x5229297BU, 0xDDE3E33EU, 0x5E2F2F71U, 0x13848497U,
+  0xA65353F5U, 0xB9D1D168U, 0x00000000U, 0xC1EDED2CU, 0x40202060U,
+  0xE3FCFC1FU, 0x79B1B1C8U, 0xB65B5BEDU, 0xD46A6ABEU, 0x8DCBCB46U,
+  0x67BEBED9U, 0x7239394BU, 0x944A4ADEU, 0x984C4CD4U, 0xB05858E8U,
+  0x85CFCF4AU, 0xBBD0D06BU, 0xC5EFEF2AU, 0x4FAAAAE5U, 0xEDFBFB16U,
+  0x864343C5U, 0x9A4D4DD7U, 0x66333355U, 0x11858594U, 0x8A4545CFU,
+  0xE9F9F910U, 0x04020206U, 0xFE7F7F81U, 0xA05050F0U, 0x783C3C44U,
+  0x259F9FBAU, 0x4BA8A8E3U, 0xA25151F3U, 0x5DA3A3FEU, 0x804040C0U,
+  0x058F8F8AU, 0x3F9292ADU, 0x219D9DBCU, 0x70383848U, 0xF1F5F504U,
+  0x63BCBCDFU, 0x77B6B6C1U, 0xAFDADA75U, 0x42212163U, 0x20101030U,
+  0xE5FFFF1AU, 0xFDF3F30EU, 0xBFD2D26DU, 0x81CDCD4CU, 0x180C0C14U,
+  0x26131335U, 0xC3ECEC2FU, 0xBE5F5FE1U, 0x359797A2U, 0x884444CCU,
+  0x2E171739U, 0x93C4C457U, 0x55A7A7F2U, 0xFC7E7E82U, 0x7A3D3D47U,
+  0xC86464ACU, 0xBA5D5DE7U, 0x3219192BU, 0xE6737395U, 0xC06060A0U,
+  0x19818198U, 0x9E4F4FD1U, 0xA3DCDC7FU, 0x44222266U, 0x542A2A7EU,
+  0x3B9090ABU, 0x0B888883U, 0x8C4646CAU, 0xC7EEEE29U, 0x6BB8B8D3U,
+  0x2814143CU, 0xA7DEDE79U, 0xBC5E5EE2U, 0x160B0B1DU, 0xADDBDB76U,
+  0xDBE0E03BU, 0x64323256U, 0x743A3A4EU, 0x140A0A1EU, 0x924949DBU,
+  0x0C06060AU, 0x4824246CU, 0xB85C5CE4U, 0x9FC2C25DU, 0xBDD3D36EU,
+  0x43ACACEFU, 0xC46262A6U, 0x399191A8U, 0x319595A4U, 0xD3E4E437U,
+  0xF279798BU, 0xD5E7E732U, 0x8BC8C843U, 0x6E373759U, 0xDA6D6DB7U,
+  0x018D8D8CU, 0xB1D5D564U, 0x9C4E4ED2U, 0x49A9A9E0U, 0xD86C6CB4U,
+  0xAC5656FAU, 0xF3F4F407U, 0xCFEAEA25U, 0xCA6565AFU, 0xF47A7A8EU,
+  0x47AEAEE9U, 0x10080818U, 0x6FBABAD5U, 0xF0787888U, 0x4A25256FU,
+  0x5C2E2E72U, 0x381C1C24U, 0x57A6A6F1U, 0x73B4B4C7U, 0x97C6C651U,
+  0xCBE8E823U, 0xA1DDDD7CU, 0xE874749CU, 0x3E1F1F21U, 0x964B4BDDU,
+  0x61BDBDDCU, 0x0D8B8B86U, 0x0F8A8A85U, 0xE0707090U, 0x7C3E3E42U,
+  0x71B5B5C4U, 0xCC6666AAU, 0x904848D8U, 0x06030305U, 0xF7F6F601U,
+  0x1C0E0E12U, 0xC26161A3U, 0x6A35355FU, 0xAE5757F9U, 0x69B9B9D0U,
+  0x17868691U, 0x99C1C158U, 0x3A1D1D27U, 0x279E9EB9U, 0xD9E1E138U,
+  0xEBF8F813U, 0x2B9898B3U, 0x22111133U, 0xD26969BBU, 0xA9D9D970U,
+  0x078E8E89U, 0x339494A7U, 0x2D9B9BB6U, 0x3C1E1E22U, 0x15878792U,
+  0xC9E9E920U, 0x87CECE49U, 0xAA5555FFU, 0x50282878U, 0xA5DFDF7AU,
+  0x038C8C8FU, 0x59A1A1F8U, 0x09898980U, 0x1A0D0D17U, 0x65BFBFDAU,
+  0xD7E6E631U, 0x844242C6U, 0xD06868B8U, 0x824141C3U, 0x299999B0U,
+  0x5A2D2D77U, 0x1E0F0F11U, 0x7BB0B0CBU, 0xA85454FCU, 0x6DBBBBD6U,
+  0x2C16163AU
+};
+
+/**
+ * @brief   AES decryption table, InvSubBytes and InvMixColumns of a byte.
+ * @note    The other three tables are byte rotations of this one.
+ */
+static const uint32_t aes_td[256] = {
+  0x51F4A750U, 0x7E416553U, 0x1A17A4C3U, 0x3A275E96U, 0x3BAB6BCBU,
+  0x1F9D45F1U, 0xACFA58ABU, 0x4BE30393U, 0x2030FA55U, 0xAD766DF6U,
+  0x88CC7691U, 0xF5024C25U, 0x4FE5D7FCU, 0xC52ACBD7U, 0x26354480U,
+  0xB562A38FU, 0xDEB15A49U, 0x25BA1B67U, 0x45EA0E98U, 0x5DFEC0E1U,
+  0xC32F7502U, 0x814CF012U, 0x8D4697A3U, 0x6BD3F9C6U, 0x038F5FE7U,
+  0x15929C95U, 0xBF6D7AEBU, 0x955259DAU, 0xD4BE832DU, 0x587421D3U,
+  0x49E06929U, 0x8EC9C844U, 0x75C2896AU, 0xF48E7978U, 0x99583E6BU,
+  0x27B971DDU, 0xBEE14FB6U, 0xF088AD17U, 0xC920AC66U, 0x7DCE3AB4U,
+  0x63DF4A18U, 0xE51A3182U, 0x97513360U, 0x62537F45U, 0xB16477E0U,
+  0xBB6BAE84U, 0xFE81A01CU, 0xF9082B94U, 0x70486858U, 0x8F45FD19U,
+  0x94DE6C87U, 0x527BF8B7U, 0xAB73D323U, 0x724B02E2U, 0xE31F8F57U,
+  0x6655AB2AU, 0xB2EB2807U, 0x2FB5C203U, 0x86C57B9AU, 0xD33708A5U,
+  0x302887F2U, 0x23BFA5B2U, 0x02036ABAU, 0xED16825CU, 0x8ACF1C2BU,
+  0xA779B492U, 0xF307F2F0U, 0x4E69E2A1U, 0x65DAF4CDU, 0x0605BED5U,
+  0xD134621FU, 0xC4A6FE8AU, 0x342E539DU, 0xA2F355A0U, 0x058AE132U,
+  0xA4F6EB75U, 0x0B83EC39U, 0x4060EFAAU, 0x5E719F06U, 0xBD6E1051U,
+  0x3E218AF9U, 0x96DD063DU, 0xDD3E05AEU, 0x4DE6BD46U, 0x91548DB5U,
+  0x71C45D05U, 0x0406D46FU, 0x605015FFU, 0x1998FB24U, 0xD6BDE997U,
+  0x894043CCU, 0x67D99E77U, 0xB0E842BDU, 0x07898B88U, 0xE7195B38U,
+  0x79C8EEDBU, 0xA17C0A47U, 0x7C420FE9U, 0xF8841EC9U, 0x00000000U,
+  0x09808683U, 0x322BED48U, 0x1E1170ACU, 0x6C5A724EU, 0xFD0EFFFBU,
+  0x0F853856U, 0x3DAED51EU, 0x362D3927U, 0x0A0FD964U, 0x685CA621U,
+  0x9B5B54D1U, 0x24362E3AU, 0x0C0A67B1U, 0x9357E70FU, 0xB4EE96D2U,
+  0x1B9B919EU, 0x80C0C54FU, 0x61DC20A2U, 0x5A774B69U, 0x1C121A16U,
+  0xE293BA0AU, 0xC0A02AE5U, 0x3C22E043U, 0x121B171DU, 0x0E090D0BU,
+  0xF28BC7ADU, 0x2DB6A8B9U, 0x141EA9C8U, 0x57F11985U, 0xAF75074CU,
+  0xEE99DDBBU, 0xA37F60FDU, 0xF701269FU, 0x5C72F5BCU, 0x44663BC5U,
+  0x5BFB7E34U, 0x8B432976U, 0xCB23C6DCU, 0xB6EDFC68U, 0xB8E4F163U,
+  0xD731DCCAU, 0x42638510U, 0x13972240U, 0x84C61120U, 0x854A247DU,
+  0xD2BB3DF8U, 0xAEF93211U, 0xC729A16DU, 0x1D9E2F4BU, 0xDCB230F3U,
+  0x0D8652ECU, 0x77C1E3D0U, 0x2BB3166CU, 0xA970B999U, 0x119448FAU,
+  0x47E96422U, 0xA8FC8CC4U, 0xA0F03F1AU, 0x567D2CD8U, 0x223390EFU,
+  0x87494EC7U, 0xD938D1C1U, 0x8CCAA2FEU, 0x98D40B36U, 0xA6F581CFU,
+  0xA57ADE28U, 0xDAB78E26U, 0x3FADBFA4U, 0x2C3A9DE4U, 0x5078920DU,
+  0x6A5FCC9BU, 0x547E4662U, 0xF68D13C2U, 0x90D8B8E8U, 0x2E39F75EU,
+  0x82C3AFF5U, 0x9F5D80BEU, 0x69D0937CU, 0x6FD52DA9U, 0xCF2512B3U,
+  0xC8AC993BU, 0x10187DA7U, 0xE89C636EU, 0xDB3BBB7BU, 0xCD267809U,
+  0x6E5918F4U, 0xEC9AB701U, 0x834F9AA8U, 0xE6956E65U, 0xAAFFE67EU,
+  0x21BCCF08U, 0xEF15E8E6U, 0xBAE79BD9U, 0x4A6F36CEU, 0xEA9F09D4U,
+  0x29B07CD6U, 0x31A4B2AFU, 0x2A3F2331U, 0xC6A59430U, 0x35A266C0U,
+  0x744EBC37U, 0xFC82CAA6U, 0xE090D0B0U, 0x33A7D815U, 0xF104984AU,
+  0x41ECDAF7U, 0x7FCD500EU, 0x1791F62FU, 0x764DD68DU, 0x43EFB04DU,
+  0xCCAA4D54U, 0xE49604DFU, 0x9ED1B5E3U, 0x4C6A881BU, 0xC12C1FB8U,
+  0x4665517FU, 0x9D5EEA04U, 0x018C355DU, 0xFA877473U, 0xFB0B412EU,
+  0xB3671D5AU, 0x92DBD252U, 0xE9105633U, 0x6DD64713U, 0x9AD7618CU,
+  0x37A10C7AU, 0x59F8148EU, 0xEB133C89U, 0xCEA927EEU, 0xB761C935U,
+  0xE11CE5EDU, 0x7A47B13CU, 0x9CD2DF59U, 0x55F2733FU, 0x1814CE79U,
+  0x73C737BFU, 0x53F7CDEAU, 0x5FFDAA5BU, 0xDF3D6F14U, 0x7844DB86U,
+  0xCAAFF381U, 0xB968C43EU, 0x3824342CU, 0xC2A3405FU, 0x161DC372U,
+  0xBCE2250CU, 0x283C498BU, 0xFF0D9541U, 0x39A80171U, 0x080CB3DEU,
+  0xD8B4E49CU, 0x6456C190U, 0x7BCB8461U, 0xD532B670U, 0x486C5C74U,
+  0xD0B85742U
+};
+#endif /* CRY_LLD_SUPPORTS_AES == FALSE */
+
+/**
+ * @brief   Reduction of the nibble shifted out of the hash state.
+ */
+static const uint16_t ghash_last4[16] = {
+  0x0000U, 0x1C20U, 0x3840U, 0x2460U, 0x7080U, 0x6CA0U, 0x48C0U, 0x54E0U,
+  0xE100U, 0xFD20U, 0xD940U, 0xC560U, 0x9180U, 0x8DA0U, 0xA9C0U, 0xB5E0U
+};
+
+#if (FALLBACK_NEEDS_HASH == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a compression function.
+ */
+typedef void (*cryhashfn_t)(void *h, const uint8_t *p, size_t n);
+#endif
+
+#if (FALLBACK_NEEDS_SHA256 == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   SHA-256 round constants.
+ */
+static const uint32_t sha256_k[64] = {
+  0x428A2F98U, 0x71374491U, 0xB5C0FBCFU, 0xE9B5DBA5U,
+  0x3956C25BU, 0x59F111F1U, 0x923F82A4U, 0xAB1C5ED5U,
+  0xD807AA98U, 0x12835B01U, 0x243185BEU, 0x550C7DC3U,
+  0x72BE5D74U, 0x80DEB1FEU, 0x9BDC06A7U, 0xC19BF174U,
+  0xE49B69C1U, 0xEFBE4786U, 0x0FC19DC6U, 0x240CA1CCU,
+  0x2DE92C6FU, 0x4A7484AAU, 0x5CB0A9DCU, 0x76F988DAU,
+  0x983E5152U, 0xA831C66DU, 0xB00327C8U, 0xBF597FC7U,
+  0xC6E00BF3U, 0xD5A79147U, 0x06CA6351U, 0x14292967U,
+  0x27B70A85U, 0x2E1B2138U, 0x4D2C6DFCU, 0x53380D13U,
+  0x650A7354U, 0x766A0ABBU, 0x81C2C92EU, 0x92722C85U,
+  0xA2BFE8A1U, 0xA81A664BU, 0xC24B8B70U, 0xC76C51A3U,
+  0xD192E819U, 0xD6990624U, 0xF40E3585U, 0x106AA070U,
+  0x19A4C116U, 0x1E376C08U, 0x2748774CU, 0x34B0BCB5U,
+  0x391C0CB3U, 0x4ED8AA4AU, 0x5B9CCA4FU, 0x682E6FF3U,
+  0x748F82EEU, 0x78A5636FU, 0x84C87814U, 0x8CC70208U,
+  0x90BEFFFAU, 0xA4506CEBU, 0xBEF9A3F7U, 0xC67178F2U
+};
+
+/**
+ * @brief   SHA-256 initial hash value.
+ */
+static const uint32_t sha256_h0[8] = {
+  0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU,
+  0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U
+};
+#endif
+
+#if (FALLBACK_NEEDS_SHA512 == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   SHA-512 round constants.
+ */
+static const uint64_t sha512_k[80] = {
+  0x428A2F98D728AE22ULL, 0x7137449123EF65CDULL,
+  0xB5C0FBCFEC4D3B2FULL, 0xE9B5DBA58189DBBCULL,
+  0x3956C25BF348B538ULL, 0x59F111F1B605D019ULL,
+  0x923F82A4AF194F9BULL, 0xAB1C5ED5DA6D8118ULL,
+  0xD807AA98A3030242ULL, 0x12835B0145706FBEULL,
+  0x243185BE4EE4B28CULL, 0x550C7DC3D5FFB4E2ULL,
+  0x72BE5D74F27B896FULL, 0x80DEB1FE3B1696B1ULL,
+  0x9BDC06A725C71235ULL, 0xC19BF174CF692694ULL,
+  0xE49B69C19EF14AD2ULL, 0xEFBE4786384F25E3ULL,
+  0x0FC19DC68B8CD5B5ULL, 0x240CA1CC77AC9C65ULL,
+  0x2DE92C6F592B0275ULL, 0x4A7484AA6EA6E483ULL,
+  0x5CB0A9DCBD41FBD4ULL, 0x76F988DA831153B5ULL,
+  0x983E5152EE66DFABULL, 0xA831C66D2DB43210ULL,
+  0xB00327C898FB213FULL, 0xBF597FC7BEEF0EE4ULL,
+  0xC6E00BF33DA88FC2ULL, 0xD5A79147930AA725ULL,
+  0x06CA6351E003826FULL, 0x142929670A0E6E70ULL,
+  0x27B70A8546D22FFCULL, 0x2E1B21385C26C926ULL,
+  0x4D2C6DFC5AC42AEDULL, 0x53380D139D95B3DFULL,
+  0x650A73548BAF63DEULL, 0x766A0ABB3C77B2A8ULL,
+  0x81C2C92E47EDAEE6ULL, 0x92722C851482353BULL,
+  0xA2BFE8A14CF10364ULL, 0xA81A664BBC423001ULL,
+  0xC24B8B70D0F89791ULL, 0xC76C51A30654BE30ULL,
+  0xD192E819D6EF5218ULL, 0xD69906245565A910ULL,
+  0xF40E35855771202AULL, 0x106AA07032BBD1B8ULL,
+  0x19A4C116B8D2D0C8ULL, 0x1E376C085141AB53ULL,
+  0x2748774CDF8EEB99ULL, 0x34B0BCB5E19B48A8ULL,
+  0x391C0CB3C5C95A63ULL, 0x4ED8AA4AE3418ACBULL,
+  0x5B9CCA4F7763E373ULL, 0x682E6FF3D6B2B8A3ULL,
+  0x748F82EE5DEFB2FCULL, 0x78A5636F43172F60ULL,
+  0x84C87814A1F0AB72ULL, 0x8CC702081A6439ECULL,
+  0x90BEFFFA23631E28ULL, 0xA4506CEBDE82BDE9ULL,
+  0xBEF9A3F7B2C67915ULL, 0xC67178F2E372532BULL,
+  0xCA273ECEEA26619CULL, 0xD186B8C721C0C207ULL,
+  0xEADA7DD6CDE0EB1EULL, 0xF57D4F7FEE6ED178ULL,
+  0x06F067AA72176FBAULL, 0x0A637DC5A2C898A6ULL,
+  0x113F9804BEF90DAEULL, 0x1B710B35131C471BULL,
+  0x28DB77F523047D84ULL, 0x32CAAB7B40C72493ULL,
+  0x3C9EBE0A15C9BEBCULL, 0x431D67C49C100D4CULL,
+  0x4CC5D4BECB3E42B6ULL, 0x597F299CFC657E2AULL,
+  0x5FCB6FAB3AD6FAECULL, 0x6C44198C4A475817ULL
+};
+
+/**
+ * @brief   SHA-512 initial hash value.
+ */
+static const uint64_t sha512_h0[8] = {
+  0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL,
+  0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+  0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL,
+  0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+#endif
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+#if (CRY_LLD_SUPPORTS_AES == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Applies the S-box to the four bytes of a word.
+ *
+ * @param[in] w         the input word
+ * @return              The substituted word.
+ *
+ * @notapi
+ */
+static uint32_t aes_subword(uint32_t w) {
+
+  return ((uint32_t)aes_sbox[w >> 24] << 24) |
+         ((uint32_t)aes_sbox[(w >> 16) & 0xFFU] << 16) |
+         ((uint32_t)aes_sbox[(w >> 8) & 0xFFU] << 8) |
+         (uint32_t)aes_sbox[w & 0xFFU];
+}
+
+/**
+ * @brief   AES key expansion.
+ *
+ * @param[out] kp       pointer to the expanded key
+ * @param[in] size      key size in bytes
+ * @param[in] keyp      pointer to the key data
+ * @return              The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_SIZE if the key size is not 16, 24 or 32.
+ *
+ * @notapi
+ */
+static cryerror_t aes_expand_key(cryaeskey_t *kp, size_t size,
+                                 const uint8_t *keyp) {
+  unsigned i, r, c, nk, nw;
+  uint32_t t, rcon;
+
+  if ((size != 16U) && (size != 24U) && (size != 32U)) {
+    return CRY_ERR_INV_KEY_SIZE;
+  }
+
+  nk = (unsigned)size / 4U;
+  kp->nr = nk + 6U;
+  nw = (kp->nr + 1U) * 4U;
+
+  /* Encryption round keys.*/
+  for (i = 0U; i < nk; i++) {
+    kp->ek[i] = GET_U32_BE(&keyp[i * 4U]);
+  }
+  rcon = 1U;
+  for (i = nk; i < nw; i++) {
+    t = kp->ek[i - 1U];
+    if ((i % nk) == 0U) {
+      t = aes_subword((t << 8) | (t >> 24)) ^ (rcon << 24);
+      rcon = (rcon << 1) ^ (((rcon >> 7) & 1U) * 0x11BU);
+    }
+    else if ((nk > 6U) && ((i % nk) == 4U)) {
+      t = aes_subword(t);
+    }
+    else {
+      /* Nothing.*/
+    }
+    kp->ek[i] = kp->ek[i - nk] ^ t;
+  }
+
+  /* Decryption round keys in reverse order, InvMixColumns is applied to the
+     inner rounds keys, Td[S[x]] is the InvMixColumns of a single byte.*/
+  for (r = 0U; r <= kp->nr; r++) {
+    for (c = 0U; c < 4U; c++) {
+      t = kp->ek[((kp->nr - r) * 4U) + c];
+      if ((r > 0U) && (r < kp->nr)) {
+        t = aes_td[aes_sbox[t >> 24]] ^
+            ROR32(aes_td[aes_sbox[(t >> 16) & 0xFFU]], 8U) ^
+            ROR32(aes_td[aes_sbox[(t >> 8) & 0xFFU]], 16U) ^
+            ROR32(aes_td[aes_sbox[t & 0xFFU]], 24U);
+      }
+      kp->dk[(r * 4U) + c] = t;
+    }
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Encryption of a single AES block.
+ *
+ * @param[in] kp        pointer to the expanded key
+ * @param[in] in        input block
+ * @param[out] out      output block, it can be the same as @p in
+ *
+ * @notapi
+ */
+static void aes_encrypt_block(const cryaeskey_t *kp,
+                              const uint8_t *in, uint8_t *out) {
+  const uint32_t *rk = kp->ek;
+  uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+  unsigned r;
+
+  s0 = GET_U32_BE(&in[0])  ^ rk[0];
+  s1 = GET_U32_BE(&in[4])  ^ rk[1];
+  s2 = GET_U32_BE(&in[8])  ^ rk[2];
+  s3 = GET_U32_BE(&in[12]) ^ rk[3];
+
+  for (r = 1U; r < kp->nr; r++) {
+    rk += 4;
+    t0 = aes_te[s0 >> 24] ^ ROR32(aes_te[(s1 >> 16) & 0xFFU], 8U) ^
+         ROR32(aes_te[(s2 >> 8) & 0xFFU], 16U) ^
+         ROR32(aes_te[s3 & 0xFFU], 24U) ^ rk[0];
+    t1 = aes_te[s1 >> 24] ^ ROR32(aes_te[(s2 >> 16) & 0xFFU], 8U) ^
+         ROR32(aes_te[(s3 >> 8) & 0xFFU], 16U) ^
+         ROR32(aes_te[s0 & 0xFFU], 24U) ^ rk[1];
+    t2 = aes_te[s2 >> 24] ^ ROR32(aes_te[(s3 >> 16) & 0xFFU], 8U) ^
+         ROR32(aes_te[(s0 >> 8) & 0xFFU], 16U) ^
+         ROR32(aes_te[s1 & 0xFFU], 24U) ^ rk[2];
+    t3 = aes_te[s3 >> 24] ^ ROR32(aes_te[(s0 >> 16) & 0xFFU], 8U) ^
+         ROR32(aes_te[(s1 >> 8) & 0xFFU], 16U) ^
+         ROR32(aes_te[s2 & 0xFFU], 24U) ^ rk[3];
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
+  }
+
+  /* Last round, no MixColumns.*/
+  rk += 4;
+  t0 = (((uint32_t)aes_sbox[s0 >> 24] << 24) |
+        ((uint32_t)aes_sbox[(s1 >> 16) & 0xFFU] << 16) |
+        ((uint32_t)aes_sbox[(s2 >> 8) & 0xFFU] << 8) |
+        (uint32_t)aes_sbox[s3 & 0xFFU]) ^ rk[0];
+  t1 = (((uint32_t)aes_sbox[s1 >> 24] << 24) |
+        ((uint32_t)aes_sbox[(s2 >> 16) & 0xFFU] << 16) |
+        ((uint32_t)aes_sbox[(s3 >> 8) & 0xFFU] << 8) |
+        (uint32_t)aes_sbox[s0 & 0xFFU]) ^ rk[1];
+  t2 = (((uint32_t)aes_sbox[s2 >> 24] << 24) |
+        ((uint32_t)aes_sbox[(s3 >> 16) & 0xFFU] << 16) |
+        ((uint32_t)aes_sbox[(s0 >> 8) & 0xFFU] << 8) |
+        (uint32_t)aes_sbox[s1 & 0xFFU]) ^ rk[2];
+  t3 = (((uint32_t)aes_sbox[s3 >> 24] << 24) |
+        ((uint32_t)aes_sbox[(s0 >> 16) & 0xFFU] << 16) |
+        ((uint32_t)aes_sbox[(s1 >> 8) & 0xFFU] << 8) |
+        (uint32_t)aes_sbox[s2 & 0xFFU]) ^ rk[3];
+
+  PUT_U32_BE(&out[0], t0);
+  PUT_U32_BE(&out[4], t1);
+  PUT_U32_BE(&out[8], t2);
+  PUT_U32_BE(&out[12], t3);
+}
+
+/**
+ * @brief   Decryption of a single AES block.
+ *
+ * @param[in] kp        pointer to the expanded key
+ * @param[in] in        input block
+ * @param[out] out      output block, it can be the same as @p in
+ *
+ * @notapi
+ */
+static void aes_decrypt_block(const cryaeskey_t *kp,
+                              const uint8_t *in, uint8_t *out) {
+  const uint32_t *rk = kp->dk;
+  uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+  unsigned r;
+
+  s0 = GET_U32_BE(&in[0])  ^ rk[0];
+  s1 = GET_U32_BE(&in[4])  ^ rk[1];
+  s2 = GET_U32_BE(&in[8])  ^ rk[2];
+  s3 = GET_U32_BE(&in[12]) ^ rk[3];
+
+  for (r = 1U; r < kp->nr; r++) {
+    rk += 4;
+    t0 = aes_td[s0 >> 24] ^ ROR32(aes_td[(s3 >> 16) & 0xFFU], 8U) ^
+         ROR32(aes_td[(s2 >> 8) & 0xFFU], 16U) ^
+         ROR32(aes_td[s1 & 0xFFU], 24U) ^ rk[0];
+    t1 = aes_td[s1 >> 24] ^ ROR32(aes_td[(s0 >> 16) & 0xFFU], 8U) ^
+         ROR32(aes_td[(s3 >> 8) & 0xFFU], 16U) ^
+         ROR32(aes_td[s2 & 0xFFU], 24U) ^ rk[1];
+    t2 = aes_td[s2 >> 24] ^ ROR32(aes_td[(s1 >> 16) & 0xFFU], 8U) ^
+         ROR32(aes_td[(s0 >> 8) & 0xFFU], 16U) ^
+         ROR32(aes_td[s3 & 0xFFU], 24U) ^ rk[2];
+    t3 = aes_td[s3 >> 24] ^ ROR32(aes_td[(s2 >> 16) & 0xFFU], 8U) ^
+         ROR32(aes_td[(s1 >> 8) & 0xFFU], 16U) ^
+         ROR32(aes_td[s0 & 0xFFU], 24U) ^ rk[3];
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
+  }
+
+  /* Last round, no InvMixColumns.*/
+  rk += 4;
+  t0 = (((uint32_t)aes_inv_sbox[s0 >> 24] << 24) |
+        ((uint32_t)aes_inv_sbox[(s3 >> 16) & 0xFFU] << 16) |
+        ((uint32_t)aes_inv_sbox[(s2 >> 8) & 0xFFU] << 8) |
+        (uint32_t)aes_inv_sbox[s1 & 0xFFU]) ^ rk[0];
+  t1 = (((uint32_t)aes_inv_sbox[s1 >> 24] << 24) |
+        ((uint32_t)aes_inv_sbox[(s0 >> 16) & 0xFFU] << 16) |
+        ((uint32_t)aes_inv_sbox[(s3 >> 8) & 0xFFU] << 8) |
+        (uint32_t)aes_inv_sbox[s2 & 0xFFU]) ^ rk[1];
+  t2 = (((uint32_t)aes_inv_sbox[s2 >> 24] << 24) |
+        ((uint32_t)aes_inv_sbox[(s1 >> 16) & 0xFFU] << 16) |
+        ((uint32_t)aes_inv_sbox[(s0 >> 8) & 0xFFU] << 8) |
+        (uint32_t)aes_inv_sbox[s3 & 0xFFU]) ^ rk[2];
+  t3 = (((uint32_t)aes_inv_sbox[s3 >> 24] << 24) |
+        ((uint32_t)aes_inv_sbox[(s2 >> 16) & 0xFFU] << 16) |
+        ((uint32_t)aes_inv_sbox[(s1 >> 8) & 0xFFU] << 8) |
+        (uint32_t)aes_inv_sbox[s0 & 0xFFU]) ^ rk[3];
+
+  PUT_U32_BE(&out[0], t0);
+  PUT_U32_BE(&out[4], t1);
+  PUT_U32_BE(&out[8], t2);
+  PUT_U32_BE(&out[12], t3);
+}
+#endif /* CRY_LLD_SUPPORTS_AES == FALSE */
+
+/**
+ * @brief   Checks the key to be used by an AES mode.
+ * @note    When the LLD implements the single block operation the key is
+ *          checked by the LLD on each block.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] key_id    the key to be used for the operation
+ * @return              The operation status.
+ * @retval CRY_NOERROR          if the key is valid.
+ * @retval CRY_ERR_INV_KEY_ID   if the key identifier is not zero or the
+ *                              transient key has not been loaded.
+ *
+ * @notapi
+ */
+static inline cryerror_t aes_check_key(CRYDriver *cryp, crykey_t key_id) {
+
+#if CRY_LLD_SUPPORTS_AES == TRUE
+  (void)cryp;
+  (void)key_id;
+
+  return CRY_NOERROR;
+#else
+  if ((key_id != (crykey_t)0) || (cryp->fb_aeskey.nr == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  return CRY_NOERROR;
+#endif
+}
+
+/**
+ * @brief   Encryption of a single AES block.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] key_id    the key to be used for the operation
+ * @param[in] in        input block
+ * @param[out] out      output block, it can be the same as @p in
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static inline cryerror_t aes_encrypt(CRYDriver *cryp, crykey_t key_id,
+                                     const uint8_t *in, uint8_t *out) {
+
+#if CRY_LLD_SUPPORTS_AES == TRUE
+  return cry_lld_encrypt_AES(cryp, key_id, in, out);
+#else
+  (void)key_id;
+
+  aes_encrypt_block(&cryp->fb_aeskey, in, out);
+
+  return CRY_NOERROR;
+#endif
+}
+
+/**
+ * @brief   Decryption of a single AES block.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] key_id    the key to be used for the operation
+ * @param[in] in        input block
+ * @param[out] out      output block, it can be the same as @p in
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static inline cryerror_t aes_decrypt(CRYDriver *cryp, crykey_t key_id,
+                                     const uint8_t *in, uint8_t *out) {
+
+#if CRY_LLD_SUPPORTS_AES == TRUE
+  return cry_lld_decrypt_AES(cryp, key_id, in, out);
+#else
+  (void)key_id;
+
+  aes_decrypt_block(&cryp->fb_aeskey, in, out);
+
+  return CRY_NOERROR;
+#endif
+}
+
+/**
+ * @brief   XORs two blocks into a third one.
+ *
+ * @param[out] out      output block, it can be the same as @p a or @p b
+ * @param[in] a         first input
+ * @param[in] b         second input
+ * @param[in] n         number of bytes, up to a block
+ *
+ * @notapi
+ */
+static inline void aes_xor(uint8_t *out, const uint8_t *a,
+                           const uint8_t *b, size_t n) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    out[i] = a[i] ^ b[i];
+  }
+}
+
+/**
+ * @brief   Increments the 32 bits big endian counter of a counter block.
+ *
+ * @param[in,out] cb    the counter block
+ *
+ * @notapi
+ */
+static inline void aes_inc32(uint8_t *cb) {
+  uint32_t ctr = GET_U32_BE(&cb[12]) + 1U;
+
+  PUT_U32_BE(&cb[12], ctr);
+}
+
+/**
+ * @brief   AES-CTR keystream application.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] key_id    the key to be used for the operation
+ * @param[in] size      size of both buffers
+ * @param[in] in        input buffer
+ * @param[out] out      output buffer, it can be the same as @p in
+ * @param[in,out] cb    counter block, incremented after each block
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static cryerror_t aes_ctr(CRYDriver *cryp, crykey_t key_id, size_t size,
+                          const uint8_t *in, uint8_t *out, uint8_t *cb) {
+  uint8_t ks[CRY_AES_BLOCK_SIZE];
+  cryerror_t err = CRY_NOERROR;
+  size_t n;
+
+  while ((size > 0U) && (err == CRY_NOERROR)) {
+    n = size < CRY_AES_BLOCK_SIZE ? size : CRY_AES_BLOCK_SIZE;
+    err = aes_encrypt(cryp, key_id, cb, ks);
+    aes_xor(out, in, ks, n);
+    aes_inc32(cb);
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Initializes a GHASH computation.
+ * @details The 16 multiples of H by all the 4 bits polynomials are
+ *          pre-computed.
+ *
+ * @param[out] gp       pointer to the GHASH object
+ * @param[in] h         the hash subkey block
+ *
+ * @notapi
+ */
+static void ghash_init(cryghash_t *gp, const uint8_t *h) {
+  uint64_t vh, vl;
+  unsigned i, j;
+
+  vh = GET_U64_BE(&h[0]);
+  vl = GET_U64_BE(&h[8]);
+
+  gp->hh[0] = 0U;
+  gp->hl[0] = 0U;
+  gp->hh[8] = vh;
+  gp->hl[8] = vl;
+  for (i = 4U; i > 0U; i >>= 1) {
+    uint64_t t = (vl & 1U) * 0xE100000000000000ULL;
+    vl = (vh << 63) | (vl >> 1);
+    vh = (vh >> 1) ^ t;
+    gp->hh[i] = vh;
+    gp->hl[i] = vl;
+  }
+  for (i = 2U; i <= 8U; i *= 2U) {
+    vh = gp->hh[i];
+    vl = gp->hl[i];
+    for (j = 1U; j < i; j++) {
+      gp->hh[i + j] = vh ^ gp->hh[j];
+      gp->hl[i + j] = vl ^ gp->hl[j];
+    }
+  }
+
+  gp->xh = 0U;
+  gp->xl = 0U;
+}
+
+/**
+ * @brief   Multiplies the hash state by H.
+ * @details The state is consumed 4 bits at time starting from the
+ *          least significant nibble.
+ *
+ * @param[in,out] gp    pointer to the GHASH object
+ *
+ * @notapi
+ */
+static void ghash_mult(cryghash_t *gp) {
+  uint64_t zh = 0U, zl = 0U, x = gp->xl;
+  unsigned i, nibble, rem;
+
+  for (i = 0U; i < 32U; i++) {
+    if (i == 16U) {
+      x = gp->xh;
+    }
+    nibble = (unsigned)x & 0xFU;
+    x >>= 4;
+    rem = (unsigned)zl & 0xFU;
+    zl = (zh << 60) | (zl >> 4);
+    zh = (zh >> 4) ^ ((uint64_t)ghash_last4[rem] << 48);
+    zh ^= gp->hh[nibble];
+    zl ^= gp->hl[nibble];
+  }
+
+  gp->xh = zh;
+  gp->xl = zl;
+}
+
+/**
+ * @brief   Adds data to a GHASH computation.
+ * @note    A partial block is zero padded, it must be the last block of
+ *          the field being hashed.
+ *
+ * @param[in,out] gp    pointer to the GHASH object
+ * @param[in] size      size of the data
+ * @param[in] p         pointer to the data
+ *
+ * @notapi
+ */
+static void ghash_update(cryghash_t *gp, size_t size, const uint8_t *p) {
+
+  while (size >= CRY_AES_BLOCK_SIZE) {
+    gp->xh ^= GET_U64_BE(&p[0]);
+    gp->xl ^= GET_U64_BE(&p[8]);
+    ghash_mult(gp);
+    p    += CRY_AES_BLOCK_SIZE;
+    size -= CRY_AES_BLOCK_SIZE;
+  }
+
+  if (size > 0U) {
+    uint8_t blk[CRY_AES_BLOCK_SIZE] = {0};
+
+    memcpy(blk, p, size);
+    gp->xh ^= GET_U64_BE(&blk[0]);
+    gp->xl ^= GET_U64_BE(&blk[8]);
+    ghash_mult(gp);
+  }
+}
+
+/**
+ * @brief   AES-GCM common part.
+ * @details Computes the hash subkey, the authentication tag mask and
+ *          hashes the additional authenticated data.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] key_id    the key to be used for the operation
+ * @param[out] gp       pointer to the GHASH object
+ * @param[in] auth_size size of the data buffer to be authenticated
+ * @param[in] auth_in   buffer containing the data to be authenticated
+ * @param[in] iv        initial counter block
+ * @param[out] cb       counter block of the first text block
+ * @param[out] mask     encrypted initial counter block
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static cryerror_t gcm_start(CRYDriver *cryp, crykey_t key_id,
+                            cryghash_t *gp, size_t auth_size,
+                            const uint8_t *auth_in, const uint8_t *iv,
+                            uint8_t *cb, uint8_t *mask) {
+  uint8_t h[CRY_AES_BLOCK_SIZE] = {0};
+  cryerror_t err;
+
+  err = aes_check_key(cryp, key_id);
+  if (err == CRY_NOERROR) {
+    err = aes_encrypt(cryp, key_id, h, h);
+  }
+  if (err == CRY_NOERROR) {
+    err = aes_encrypt(cryp, key_id, iv, mask);
+  }
+  if (err != CRY_NOERROR) {
+    return err;
+  }
+
+  ghash_init(gp, h);
+  ghash_update(gp, auth_size, auth_in);
+
+  memcpy(cb, iv, CRY_AES_BLOCK_SIZE);
+  aes_inc32(cb);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   AES-GCM tag computation.
+ *
+ * @param[in,out] gp    pointer to the GHASH object
+ * @param[in] auth_size size of the authenticated data
+ * @param[in] text_size size of the text
+ * @param[in,out] tag   on entry the encrypted initial counter block, on
+ *                      exit the full size authentication tag
+ *
+ * @notapi
+ */
+static void gcm_finish(cryghash_t *gp, size_t auth_size, size_t text_size,
+                       uint8_t *tag) {
+
+  gp->xh ^= (uint64_t)auth_size * 8U;
+  gp->xl ^= (uint64_t)text_size * 8U;
+  ghash_mult(gp);
+
+  PUT_U64_BE(&tag[0], GET_U64_BE(&tag[0]) ^ gp->xh);
+  PUT_U64_BE(&tag[8], GET_U64_BE(&tag[8]) ^ gp->xl);
+}
+
+/**
+ * @brief   AES-CTR streaming keystream application.
+ * @details The keystream left over by the previous call is consumed
+ *          first, whole blocks are processed directly, the keystream of
+ *          a trailing partial block is kept for the next call.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in,out] ctxp  pointer to the AES-CTR context
+ * @param[in] size      size of both buffers
+ * @param[in] in        input buffer
+ * @param[out] out      output buffer, it can be the same as @p in
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static cryerror_t ctr_stream(CRYDriver *cryp, AESCTRContext *ctxp,
+                             size_t size, const uint8_t *in, uint8_t *out) {
+  cryerror_t err = CRY_NOERROR;
+  size_t n;
+
+  if (ctxp->ks_pos < CRY_AES_BLOCK_SIZE) {
+    n = CRY_AES_BLOCK_SIZE - ctxp->ks_pos;
+    if (n > size) {
+      n = size;
+    }
+    aes_xor(out, in, &ctxp->ks[ctxp->ks_pos], n);
+    ctxp->ks_pos += n;
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+
+  n = size & ~(size_t)(CRY_AES_BLOCK_SIZE - 1U);
+  if (n > 0U) {
+    err = aes_ctr(cryp, ctxp->key_id, n, in, out, ctxp->cb);
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+
+  if ((size > 0U) && (err == CRY_NOERROR)) {
+    err = aes_encrypt(cryp, ctxp->key_id, ctxp->cb, ctxp->ks);
+    aes_inc32(ctxp->cb);
+    aes_xor(out, in, ctxp->ks, size);
+    ctxp->ks_pos = size;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   AES-GCM streaming hash update.
+ * @details Data is accumulated into the partial block of the context
+ *          until a whole block is available.
+ *
+ * @param[in,out] ctxp  pointer to the AES-GCM context
+ * @param[in] size      size of the data
+ * @param[in] p         pointer to the data
+ *
+ * @notapi
+ */
+static void gcm_stream_hash(AESGCMContext *ctxp, size_t size,
+                            const uint8_t *p) {
+  size_t n;
+
+  if (ctxp->buf_pos > 0U) {
+    n = CRY_AES_BLOCK_SIZE - ctxp->buf_pos;
+    if (n > size) {
+      n = size;
+    }
+    memcpy(&ctxp->buf[ctxp->buf_pos], p, n);
+    ctxp->buf_pos += n;
+    p    += n;
+    size -= n;
+    if (ctxp->buf_pos < CRY_AES_BLOCK_SIZE) {
+      return;
+    }
+    ghash_update(&ctxp->ghash, CRY_AES_BLOCK_SIZE, ctxp->buf);
+    ctxp->buf_pos = 0U;
+  }
+
+  n = size & ~(size_t)(CRY_AES_BLOCK_SIZE - 1U);
+  ghash_update(&ctxp->ghash, n, p);
+  p    += n;
+  size -= n;
+
+  if (size > 0U) {
+    memcpy(ctxp->buf, p, size);
+    ctxp->buf_pos = size;
+  }
+}
+
+/**
+ * @brief   AES-GCM streaming hash flush.
+ * @details A pending partial block is zero padded and hashed, it is
+ *          invoked at the end of the authenticated data and of the text.
+ *
+ * @param[in,out] ctxp  pointer to the AES-GCM context
+ *
+ * @notapi
+ */
+static void gcm_stream_flush(AESGCMContext *ctxp) {
+
+  if (ctxp->buf_pos > 0U) {
+    ghash_update(&ctxp->ghash, ctxp->buf_pos, ctxp->buf);
+    ctxp->buf_pos = 0U;
+  }
+}
+
+/**
+ * @brief   AES-GCM streaming text processing.
+ * @details The text is processed in chunks, each chunk is encrypted and
+ *          hashed while still in cache.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in,out] ctxp  pointer to the AES-GCM context
+ * @param[in] size      size of both buffers
+ * @param[in] in        input buffer
+ * @param[out] out      output buffer, it can be the same as @p in
+ * @param[in] encrypt   @p true for encryption, @p false for decryption
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static cryerror_t gcm_stream_text(CRYDriver *cryp, AESGCMContext *ctxp,
+                                  size_t size, const uint8_t *in,
+                                  uint8_t *out, bool encrypt) {
+  cryerror_t err = CRY_NOERROR;
+  size_t n;
+
+  if (!ctxp->text) {
+    gcm_stream_flush(ctxp);
+    ctxp->text = true;
+  }
+
+  ctxp->text_size += size;
+  while ((size > 0U) && (err == CRY_NOERROR)) {
+    n = size < FALLBACK_GCM_CHUNK_SIZE ? size : FALLBACK_GCM_CHUNK_SIZE;
+    if (encrypt) {
+      err = ctr_stream(cryp, &ctxp->ctr, n, in, out);
+      gcm_stream_hash(ctxp, n, out);
+    }
+    else {
+      gcm_stream_hash(ctxp, n, in);
+      err = ctr_stream(cryp, &ctxp->ctr, n, in, out);
+    }
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   AES-GCM streaming tag computation.
+ *
+ * @param[in,out] ctxp  pointer to the AES-GCM context
+ * @param[out] tag      the full size authentication tag
+ *
+ * @notapi
+ */
+static void gcm_stream_tag(AESGCMContext *ctxp, uint8_t *tag) {
+
+  gcm_stream_flush(ctxp);
+  memcpy(tag, ctxp->mask, CRY_AES_BLOCK_SIZE);
+  gcm_finish(&ctxp->ghash, ctxp->auth_size, ctxp->text_size, tag);
+}
+
+#if (FALLBACK_NEEDS_HASH == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Merkle-Damgard hash update.
+ * @details Whole blocks are compressed directly from the input buffer.
+ *
+ * @param[in] fn        the compression function
+ * @param[in,out] h     the intermediate hash
+ * @param[in,out] buf   the partial block buffer
+ * @param[in] bsize     the block size
+ * @param[in,out] length number of bytes processed so far
+ * @param[in] size      size of the input
+ * @param[in] in        the input data
+ *
+ * @notapi
+ */
+static void hash_update(cryhashfn_t fn, void *h, uint8_t *buf, size_t bsize,
+                        uint64_t *length, size_t size, const uint8_t *in) {
+  size_t used = (size_t)(*length % bsize);
+  size_t n;
+
+  *length += size;
+
+  /* Completing a partial block first.*/
+  if (used > 0U) {
+    n = bsize - used;
+    if (size < n) {
+      memcpy(&buf[used], in, size);
+      return;
+    }
+    memcpy(&buf[used], in, n);
+    fn(h, buf, 1U);
+    in   += n;
+    size -= n;
+  }
+
+  /* Whole blocks.*/
+  if (size >= bsize) {
+    n = size / bsize;
+    fn(h, in, n);
+    in   += n * bsize;
+    size -= n * bsize;
+  }
+
+  /* Remaining bytes.*/
+  if (size > 0U) {
+    memcpy(buf, in, size);
+  }
+}
+
+/**
+ * @brief   Merkle-Damgard hash padding.
+ *
+ * @param[in] fn        the compression function
+ * @param[in,out] h     the intermediate hash
+ * @param[in,out] buf   the partial block buffer
+ * @param[in] bsize     the block size
+ * @param[in] length    number of bytes processed
+ *
+ * @notapi
+ */
+static void hash_final(cryhashfn_t fn, void *h, uint8_t *buf, size_t bsize,
+                       uint64_t length) {
+  size_t used = (size_t)(length % bsize);
+  size_t lsize = bsize / 8U;
+
+  buf[used++] = 0x80U;
+  if (used > (bsize - lsize)) {
+    memset(&buf[used], 0, bsize - used);
+    fn(h, buf, 1U);
+    used = 0U;
+  }
+  memset(&buf[used], 0, bsize - used - 8U);
+
+  /* The length field is 64 or 128 bits, the high part is only non-zero
+     for the 128 bits field.*/
+  if (lsize > 8U) {
+    buf[bsize - 9U] = (uint8_t)(length >> 61);
+  }
+  PUT_U64_BE(&buf[bsize - 8U], length << 3);
+  fn(h, buf, 1U);
+}
+#endif /* FALLBACK_NEEDS_HASH == TRUE */
+
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   SHA-1 compression function.
+ *
+ * @param[in,out] h     the intermediate hash
+ * @param[in] p         the input blocks
+ * @param[in] n         number of blocks
+ *
+ * @notapi
+ */
+static void sha1_compress(void *h, const uint8_t *p, size_t n) {
+  uint32_t *hp = (uint32_t *)h;
+  uint32_t w[16];
+  uint32_t a, b, c, d, e, f, k, t;
+  unsigned i;
+
+  while (n > 0U) {
+    a = hp[0];
+    b = hp[1];
+    c = hp[2];
+    d = hp[3];
+    e = hp[4];
+    for (i = 0U; i < 80U; i++) {
+      if (i < 16U) {
+        w[i] = GET_U32_BE(&p[i * 4U]);
+      }
+      else {
+        t = w[(i - 3U) & 15U] ^ w[(i - 8U) & 15U] ^
+            w[(i - 14U) & 15U] ^ w[i & 15U];
+        w[i & 15U] = ROR32(t, 31U);
+      }
+      if (i < 20U) {
+        f = d ^ (b & (c ^ d));
+        k = 0x5A827999U;
+      }
+      else if (i < 40U) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1U;
+      }
+      else if (i < 60U) {
+        f = (b & c) | (d & (b | c));
+        k = 0x8F1BBCDCU;
+      }
+      else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6U;
+      }
+      t = ROR32(a, 27U) + f + e + k + w[i & 15U];
+      e = d;
+      d = c;
+      c = ROR32(b, 2U);
+      b = a;
+      a = t;
+    }
+    hp[0] += a;
+    hp[1] += b;
+    hp[2] += c;
+    hp[3] += d;
+    hp[4] += e;
+    p += CRY_SHA256_BLOCK_SIZE;
+    n--;
+  }
+}
+#endif /* CRY_LLD_SUPPORTS_SHA1 == FALSE */
+
+#if (FALLBACK_NEEDS_SHA256 == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   SHA-256 compression function.
+ *
+ * @param[in,out] h     the intermediate hash
+ * @param[in] p         the input blocks
+ * @param[in] n         number of blocks
+ *
+ * @notapi
+ */
+static void sha256_compress(void *h, const uint8_t *p, size_t n) {
+  uint32_t *hp = (uint32_t *)h;
+  uint32_t w[16];
+  uint32_t s[8];
+  uint32_t t1, t2, w15, w2;
+  unsigned i;
+
+  while (n > 0U) {
+    for (i = 0U; i < 8U; i++) {
+      s[i] = hp[i];
+    }
+    for (i = 0U; i < 64U; i++) {
+      if (i < 16U) {
+        w[i] = GET_U32_BE(&p[i * 4U]);
+      }
+      else {
+        w15 = w[(i - 15U) & 15U];
+        w2  = w[(i - 2U) & 15U];
+        w[i & 15U] += (ROR32(w15, 7U) ^ ROR32(w15, 18U) ^ (w15 >> 3)) +
+                      w[(i - 7U) & 15U] +
+                      (ROR32(w2, 17U) ^ ROR32(w2, 19U) ^ (w2 >> 10));
+      }
+      t1 = s[7] + (ROR32(s[4], 6U) ^ ROR32(s[4], 11U) ^ ROR32(s[4], 25U)) +
+           (s[6] ^ (s[4] & (s[5] ^ s[6]))) + sha256_k[i] + w[i & 15U];
+      t2 = (ROR32(s[0], 2U) ^ ROR32(s[0], 13U) ^ ROR32(s[0], 22U)) +
+           ((s[0] & s[1]) | (s[2] & (s[0] | s[1])));
+      s[7] = s[6];
+      s[6] = s[5];
+      s[5] = s[4];
+      s[4] = s[3] + t1;
+      s[3] = s[2];
+      s[2] = s[1];
+      s[1] = s[0];
+      s[0] = t1 + t2;
+    }
+    for (i = 0U; i < 8U; i++) {
+      hp[i] += s[i];
+    }
+    p += CRY_SHA256_BLOCK_SIZE;
+    n--;
+  }
+}
+
+/**
+ * @brief   SHA-256 initialization.
+ *
+ * @param[out] sp       pointer to the hash state
+ *
+ * @notapi
+ */
+static void sha256_init(crysha256state_t *sp) {
+
+  memcpy(sp->h, sha256_h0, sizeof sp->h);
+  sp->length = 0U;
+}
+
+/**
+ * @brief   SHA-256 update.
+ *
+ * @param[in,out] sp    pointer to the hash state
+ * @param[in] size      size of the input
+ * @param[in] in        the input data
+ *
+ * @notapi
+ */
+static void sha256_update(crysha256state_t *sp, size_t size,
+                          const uint8_t *in) {
+
+  hash_update(sha256_compress, sp->h, sp->buf, CRY_SHA256_BLOCK_SIZE,
+              &sp->length, size, in);
+}
+
+/**
+ * @brief   SHA-256 finalization.
+ *
+ * @param[in,out] sp    pointer to the hash state
+ * @param[out] out      the 32 bytes digest
+ *
+ * @notapi
+ */
+static void sha256_final(crysha256state_t *sp, uint8_t *out) {
+  unsigned i;
+
+  hash_final(sha256_compress, sp->h, sp->buf, CRY_SHA256_BLOCK_SIZE,
+             sp->length);
+  for (i = 0U; i < 8U; i++) {
+    PUT_U32_BE(&out[i * 4U], sp->h[i]);
+  }
+}
+#endif /* FALLBACK_NEEDS_SHA256 == TRUE */
+
+#if (FALLBACK_NEEDS_SHA512 == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   SHA-512 compression function.
+ *
+ * @param[in,out] h     the intermediate hash
+ * @param[in] p         the input blocks
+ * @param[in] n         number of blocks
+ *
+ * @notapi
+ */
+static void sha512_compress(void *h, const uint8_t *p, size_t n) {
+  uint64_t *hp = (uint64_t *)h;
+  uint64_t w[16];
+  uint64_t s[8];
+  uint64_t t1, t2, w15, w2;
+  unsigned i;
+
+  while (n > 0U) {
+    for (i = 0U; i < 8U; i++) {
+      s[i] = hp[i];
+    }
+    for (i = 0U; i < 80U; i++) {
+      if (i < 16U) {
+        w[i] = GET_U64_BE(&p[i * 8U]);
+      }
+      else {
+        w15 = w[(i - 15U) & 15U];
+        w2  = w[(i - 2U) & 15U];
+        w[i & 15U] += (ROR64(w15, 1U) ^ ROR64(w15, 8U) ^ (w15 >> 7)) +
+                      w[(i - 7U) & 15U] +
+                      (ROR64(w2, 19U) ^ ROR64(w2, 61U) ^ (w2 >> 6));
+      }
+      t1 = s[7] + (ROR64(s[4], 14U) ^ ROR64(s[4], 18U) ^ ROR64(s[4], 41U)) +
+           (s[6] ^ (s[4] & (s[5] ^ s[6]))) + sha512_k[i] + w[i & 15U];
+      t2 = (ROR64(s[0], 28U) ^ ROR64(s[0], 34U) ^ ROR64(s[0], 39U)) +
+           ((s[0] & s[1]) | (s[2] & (s[0] | s[1])));
+      s[7] = s[6];
+      s[6] = s[5];
+      s[5] = s[4];
+      s[4] = s[3] + t1;
+      s[3] = s[2];
+      s[2] = s[1];
+      s[1] = s[0];
+      s[0] = t1 + t2;
+    }
+    for (i = 0U; i < 8U; i++) {
+      hp[i] += s[i];
+    }
+    p += CRY_SHA512_BLOCK_SIZE;
+    n--;
+  }
+}
+
+/**
+ * @brief   SHA-512 initialization.
+ *
+ * @param[out] sp       pointer to the hash state
+ *
+ * @notapi
+ */
+static void sha512_init(crysha512state_t *sp) {
+
+  memcpy(sp->h, sha512_h0, sizeof sp->h);
+  sp->length = 0U;
+}
+
+/**
+ * @brief   SHA-512 update.
+ *
+ * @param[in,out] sp    pointer to the hash state
+ * @param[in] size      size of the input
+ * @param[in] in        the input data
+ *
+ * @notapi
+ */
+static void sha512_update(crysha512state_t *sp, size_t size,
+                          const uint8_t *in) {
+
+  hash_update(sha512_compress, sp->h, sp->buf, CRY_SHA512_BLOCK_SIZE,
+              &sp->length, size, in);
+}
+
+/**
+ * @brief   SHA-512 finalization.
+ *
+ * @param[in,out] sp    pointer to the hash state
+ * @param[out] out      the 64 bytes digest
+ *
+ * @notapi
+ */
+static void sha512_final(crysha512state_t *sp, uint8_t *out) {
+  unsigned i;
+
+  hash_final(sha512_compress, sp->h, sp->buf, CRY_SHA512_BLOCK_SIZE,
+             sp->length);
+  for (i = 0U; i < 8U; i++) {
+    PUT_U64_BE(&out[i * 8U], sp->h[i]);
+  }
+}
+#endif /* FALLBACK_NEEDS_SHA512 == TRUE */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Clears the fall-back transient keys.
+ * @details The keys are overwritten with zeros and marked as not loaded.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ *
+ * @notapi
+ */
+void cry_fallback_clear(CRYDriver *cryp) {
+
+#if CRY_LLD_SUPPORTS_AES == FALSE
+  memset(&cryp->fb_aeskey, 0, sizeof cryp->fb_aeskey);
+#endif
+#if FALLBACK_NEEDS_HMAC == TRUE
+  memset(&cryp->fb_hmackey, 0, sizeof cryp->fb_hmackey);
+#endif
+#if (CRY_LLD_SUPPORTS_AES == TRUE) && (FALLBACK_NEEDS_HMAC == FALSE)
+  (void)cryp;
+#endif
+}
+
+#if (CRY_LLD_SUPPORTS_AES == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes the AES transient key.
+ * @note    The previous key is cleared, it is left cleared if the new key
+ *          is invalid.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes, 16, 24 or 32
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_SIZE if the specified key size is invalid.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_aes_loadkey(CRYDriver *cryp,
+                                    size_t size,
+                                    const uint8_t *keyp) {
+
+  memset(&cryp->fb_aeskey, 0, sizeof cryp->fb_aeskey);
+
+  return aes_expand_key(&cryp->fb_aeskey, size, keyp);
+}
+
+/**
+ * @brief   Encryption of a single block using AES.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+  cryerror_t err;
+
+  err = aes_check_key(cryp, key_id);
+  if (err == CRY_NOERROR) {
+    err = aes_encrypt(cryp, key_id, in, out);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption of a single block using AES.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, only
+ *                              the transient key zero is supported
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+  cryerror_t err;
+
+  err = aes_check_key(cryp, key_id);
+  if (err == CRY_NOERROR) {
+    err = aes_decrypt(cryp, key_id, in, out);
+  }
+
+  return err;
+}
+#endif /* CRY_LLD_SUPPORTS_AES == FALSE */
+
+#if (CRY_LLD_SUPPORTS_AES_ECB == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Encryption operation using AES-ECB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+  cryerror_t err;
+
+  err = aes_check_key(cryp, key_id);
+  while ((size > 0U) && (err == CRY_NOERROR)) {
+    err = aes_encrypt(cryp, key_id, in, out);
+    in   += CRY_AES_BLOCK_SIZE;
+    out  += CRY_AES_BLOCK_SIZE;
+    size -= CRY_AES_BLOCK_SIZE;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-ECB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+  cryerror_t err;
+
+  err = aes_check_key(cryp, key_id);
+  while ((size > 0U) && (err == CRY_NOERROR)) {
+    err = aes_decrypt(cryp, key_id, in, out);
+    in   += CRY_AES_BLOCK_SIZE;
+    out  += CRY_AES_BLOCK_SIZE;
+    size -= CRY_AES_BLOCK_SIZE;
+  }
+
+  return err;
+}
+#endif /* CRY_LLD_SUPPORTS_AES_ECB == FALSE */
+
+#if (CRY_LLD_SUPPORTS_AES_CBC == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Encryption operation using AES-CBC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t blk[CRY_AES_BLOCK_SIZE];
+  const uint8_t *cv = iv;
+  cryerror_t err;
+
+  err = aes_check_key(cryp, key_id);
+  while ((size > 0U) && (err == CRY_NOERROR)) {
+    aes_xor(blk, in, cv, CRY_AES_BLOCK_SIZE);
+    err = aes_encrypt(cryp, key_id, blk, out);
+    cv    = out;
+    in   += CRY_AES_BLOCK_SIZE;
+    out  += CRY_AES_BLOCK_SIZE;
+    size -= CRY_AES_BLOCK_SIZE;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-CBC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t cv[CRY_AES_BLOCK_SIZE], blk[CRY_AES_BLOCK_SIZE];
+  cryerror_t err;
+
+  memcpy(cv, iv, CRY_AES_BLOCK_SIZE);
+  err = aes_check_key(cryp, key_id);
+  while ((size > 0U) && (err == CRY_NOERROR)) {
+    /* The ciphertext block is saved because the buffers can overlap.*/
+    memcpy(blk, in, CRY_AES_BLOCK_SIZE);
+    err = aes_decrypt(cryp, key_id, blk, out);
+    aes_xor(out, out, cv, CRY_AES_BLOCK_SIZE);
+    memcpy(cv, blk, CRY_AES_BLOCK_SIZE);
+    in   += CRY_AES_BLOCK_SIZE;
+    out  += CRY_AES_BLOCK_SIZE;
+    size -= CRY_AES_BLOCK_SIZE;
+  }
+
+  return err;
+}
+#endif /* CRY_LLD_SUPPORTS_AES_CBC == FALSE */
+
+#if (CRY_LLD_SUPPORTS_AES_CFB == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Encryption operation using AES-CFB.
+ * @note    The segment size is 128 bits, the last segment can be partial.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CFB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t ks[CRY_AES_BLOCK_SIZE];
+  const uint8_t *cv = iv;
+  cryerror_t err;
+  size_t n;
+
+  err = aes_check_key(cryp, key_id);
+  while ((size > 0U) && (err == CRY_NOERROR)) {
+    n = size < CRY_AES_BLOCK_SIZE ? size : CRY_AES_BLOCK_SIZE;
+    err = aes_encrypt(cryp, key_id, cv, ks);
+    aes_xor(out, in, ks, n);
+    cv    = out;
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-CFB.
+ * @note    The segment size is 128 bits, the last segment can be partial.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CFB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t cv[CRY_AES_BLOCK_SIZE], ks[CRY_AES_BLOCK_SIZE];
+  cryerror_t err;
+  size_t n;
+
+  memcpy(cv, iv, CRY_AES_BLOCK_SIZE);
+  err = aes_check_key(cryp, key_id);
+  while ((size > 0U) && (err == CRY_NOERROR)) {
+    n = size < CRY_AES_BLOCK_SIZE ? size : CRY_AES_BLOCK_SIZE;
+    err = aes_encrypt(cryp, key_id, cv, ks);
+    /* The ciphertext segment is saved because the buffers can overlap.*/
+    memcpy(cv, in, n);
+    aes_xor(out, cv, ks, n);
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+
+  return err;
+}
+#endif /* CRY_LLD_SUPPORTS_AES_CFB == FALSE */
+
+#if (CRY_LLD_SUPPORTS_AES_CTR == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Encryption operation using AES-CTR.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits input vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CTR(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t cb[CRY_AES_BLOCK_SIZE];
+  cryerror_t err;
+
+  err = aes_check_key(cryp, key_id);
+  if (err == CRY_NOERROR) {
+    memcpy(cb, iv, CRY_AES_BLOCK_SIZE);
+    err = aes_ctr(cryp, key_id, size, in, out, cb);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-CTR.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits input vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CTR(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+
+  return cry_fallback_encrypt_AES_CTR(cryp, key_id, size, in, out, iv);
+}
+#endif /* CRY_LLD_SUPPORTS_AES_CTR == FALSE */
+
+#if (CRY_LLD_SUPPORTS_AES_GCM == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Encryption operation using AES-GCM.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input plaintext
+ * @param[out] text_out         buffer for the output ciphertext
+ * @param[in] iv                128 bits initial counter block, for 96 bits
+ *                              IVs it is the IV followed by a 32 bits
+ *                              counter set to one
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[out] tag_out          buffer for the generated authentication tag
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_GCM(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t auth_size,
+                                        const uint8_t *auth_in,
+                                        size_t text_size,
+                                        const uint8_t *text_in,
+                                        uint8_t *text_out,
+                                        const uint8_t *iv,
+                                        size_t tag_size,
+                                        uint8_t *tag_out) {
+  uint8_t cb[CRY_AES_BLOCK_SIZE], tag[CRY_AES_BLOCK_SIZE];
+  const uint8_t *in = text_in;
+  uint8_t *out = text_out;
+  size_t size = text_size;
+  cryghash_t gh;
+  cryerror_t err;
+  size_t n;
+
+  err = gcm_start(cryp, key_id, &gh, auth_size, auth_in, iv, cb, tag);
+  while ((size > 0U) && (err == CRY_NOERROR)) {
+    n = size < CRY_AES_BLOCK_SIZE ? size : CRY_AES_BLOCK_SIZE;
+    err = aes_ctr(cryp, key_id, n, in, out, cb);
+    ghash_update(&gh, n, out);
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+
+  if (err == CRY_NOERROR) {
+    gcm_finish(&gh, auth_size, text_size, tag);
+    memcpy(tag_out, tag, tag_size);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-GCM.
+ * @note    The tag is verified before decrypting, no output is produced
+ *          if the authentication fails.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input ciphertext
+ * @param[out] text_out         buffer for the output plaintext
+ * @param[in] iv                128 bits initial counter block, for 96 bits
+ *                              IVs it is the IV followed by a 32 bits
+ *                              counter set to one
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[in] tag_in            buffer containing the authentication tag
+ * @return                      The operation status.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_GCM(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t auth_size,
+                                        const uint8_t *auth_in,
+                                        size_t text_size,
+                                        const uint8_t *text_in,
+                                        uint8_t *text_out,
+                                        const uint8_t *iv,
+                                        size_t tag_size,
+                                        const uint8_t *tag_in) {
+  uint8_t cb[CRY_AES_BLOCK_SIZE], tag[CRY_AES_BLOCK_SIZE];
+  cryghash_t gh;
+  cryerror_t err;
+  uint8_t diff;
+  size_t i;
+
+  err = gcm_start(cryp, key_id, &gh, auth_size, auth_in, iv, cb, tag);
+  if (err != CRY_NOERROR) {
+    return err;
+  }
+
+  ghash_update(&gh, text_size, text_in);
+  gcm_finish(&gh, auth_size, text_size, tag);
+
+  /* Constant time comparison.*/
+  diff = 0U;
+  for (i = 0U; i < tag_size; i++) {
+    diff |= tag[i] ^ tag_in[i];
+  }
+  if (diff != 0U) {
+    return CRY_ERR_AUTH_FAILED;
+  }
+
+  return aes_ctr(cryp, key_id, text_size, text_in, text_out, cb);
+}
+#endif /* CRY_LLD_SUPPORTS_AES_GCM == FALSE */
+
+/**
+ * @brief   AES-CTR streaming initialization.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] ctxp             pointer to the AES-CTR context
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] iv                128 bits initial counter block
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_AES_CTR_init(CRYDriver *cryp,
+                                     AESCTRContext *ctxp,
+                                     crykey_t key_id,
+                                     const uint8_t *iv) {
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = aes_check_key(cryp, key_id);
+  if (err != CRY_NOERROR) {
+    return err;
+  }
+
+  ctxp->key_id = key_id;
+  memcpy(ctxp->cb, iv, CRY_AES_BLOCK_SIZE);
+  ctxp->ks_pos = CRY_AES_BLOCK_SIZE;
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   AES-CTR streaming update.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to the AES-CTR context
+ * @param[in] size              size of both buffers
+ * @param[in] in                input buffer
+ * @param[out] out              output buffer, it can be the same as @p in
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_AES_CTR_update(CRYDriver *cryp,
+                                       AESCTRContext *ctxp,
+                                       size_t size,
+                                       const uint8_t *in,
+                                       uint8_t *out) {
+
+  return ctr_stream(cryp, ctxp, size, in, out);
+}
+
+/**
+ * @brief   AES-GCM streaming initialization.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] ctxp             pointer to the AES-GCM context
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] iv                128 bits initial counter block, for 96 bits
+ *                              IVs it is the IV followed by a 32 bits
+ *                              counter set to one
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_AES_GCM_init(CRYDriver *cryp,
+                                     AESGCMContext *ctxp,
+                                     crykey_t key_id,
+                                     const uint8_t *iv) {
+  cryerror_t err;
+
+  err = gcm_start(cryp, key_id, &ctxp->ghash, 0U, NULL, iv,
+                  ctxp->ctr.cb, ctxp->mask);
+  if (err != CRY_NOERROR) {
+    return err;
+  }
+
+  ctxp->ctr.key_id = key_id;
+  ctxp->ctr.ks_pos = CRY_AES_BLOCK_SIZE;
+  ctxp->buf_pos    = 0U;
+  ctxp->auth_size  = 0U;
+  ctxp->text_size  = 0U;
+  ctxp->text       = false;
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   AES-GCM streaming authenticated data update.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to the AES-GCM context
+ * @param[in] size              size of the data buffer
+ * @param[in] in                buffer containing the data to be
+ *                              authenticated
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_AES_GCM_update_auth(CRYDriver *cryp,
+                                            AESGCMContext *ctxp,
+                                            size_t size,
+                                            const uint8_t *in) {
+
+  (void)cryp;
+
+  osalDbgAssert(!ctxp->text, "text already processed");
+
+  ctxp->auth_size += size;
+  gcm_stream_hash(ctxp, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   AES-GCM streaming encryption update.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to the AES-GCM context
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext, it can be
+ *                              the same as @p in
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_GCM_update(CRYDriver *cryp,
+                                               AESGCMContext *ctxp,
+                                               size_t size,
+                                               const uint8_t *in,
+                                               uint8_t *out) {
+
+  return gcm_stream_text(cryp, ctxp, size, in, out, true);
+}
+
+/**
+ * @brief   AES-GCM streaming decryption update.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to the AES-GCM context
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext, it can be
+ *                              the same as @p in
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_GCM_update(CRYDriver *cryp,
+                                               AESGCMContext *ctxp,
+                                               size_t size,
+                                               const uint8_t *in,
+                                               uint8_t *out) {
+
+  return gcm_stream_text(cryp, ctxp, size, in, out, false);
+}
+
+/**
+ * @brief   AES-GCM streaming encryption finalization.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to the AES-GCM context
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[out] tag_out          buffer for the generated authentication tag
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_GCM_final(CRYDriver *cryp,
+                                              AESGCMContext *ctxp,
+                                              size_t tag_size,
+                                              uint8_t *tag_out) {
+  uint8_t tag[CRY_AES_BLOCK_SIZE];
+
+  (void)cryp;
+
+  gcm_stream_tag(ctxp, tag);
+  memcpy(tag_out, tag, tag_size);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   AES-GCM streaming decryption finalization.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] ctxp          pointer to the AES-GCM context
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[in] tag_in            buffer containing the authentication tag
+ * @return                      The operation status.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_GCM_final(CRYDriver *cryp,
+                                              AESGCMContext *ctxp,
+                                              size_t tag_size,
+                                              const uint8_t *tag_in) {
+  uint8_t tag[CRY_AES_BLOCK_SIZE];
+  uint8_t diff;
+  size_t i;
+
+  (void)cryp;
+
+  gcm_stream_tag(ctxp, tag);
+
+  /* Constant time comparison.*/
+  diff = 0U;
+  for (i = 0U; i < tag_size; i++) {
+    diff |= tag[i] ^ tag_in[i];
+  }
+  if (diff != 0U) {
+    return CRY_ERR_AUTH_FAILED;
+  }
+
+  return CRY_NOERROR;
+}
+
+#if (CRY_LLD_SUPPORTS_DES == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes the DES transient key.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_des_loadkey(CRYDriver *cryp,
+                                    size_t size,
+                                    const uint8_t *keyp) {
+
+  (void)cryp;
+  (void)size;
+  (void)keyp;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Encryption of a single block using (T)DES.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Decryption of a single block using (T)DES.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+#endif /* CRY_LLD_SUPPORTS_DES == FALSE */
+
+#if (CRY_LLD_SUPPORTS_DES_ECB == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Encryption operation using (T)DES-ECB.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Decryption operation using (T)DES-ECB.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+#endif /* CRY_LLD_SUPPORTS_DES_ECB == FALSE */
+
+#if (CRY_LLD_SUPPORTS_DES_CBC == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Encryption operation using (T)DES-CBC.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                64 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+  (void)iv;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Decryption operation using (T)DES-CBC.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                64 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     if the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+  (void)iv;
+
+  return CRY_ERR_INV_ALGO;
+}
+#endif /* CRY_LLD_SUPPORTS_DES_CBC == FALSE */
+
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using SHA1.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] sha1ctxp         pointer to a SHA1 context to be initialized
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_init(CRYDriver *cryp, SHA1Context *sha1ctxp) {
+  static const uint32_t sha1_h0[5] = {
+    0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U, 0xC3D2E1F0U
+  };
+
+  (void)cryp;
+
+  memcpy(sha1ctxp->state.h, sha1_h0, sizeof sha1ctxp->state.h);
+  sha1ctxp->state.length = 0U;
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using SHA1.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha1ctxp          pointer to a SHA1 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_update(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                    size_t size, const uint8_t *in) {
+
+  (void)cryp;
+
+  hash_update(sha1_compress, sha1ctxp->state.h, sha1ctxp->state.buf,
+              CRY_SHA256_BLOCK_SIZE, &sha1ctxp->state.length, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using SHA1.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha1ctxp          pointer to a SHA1 context
+ * @param[out] out              20 bytes output buffer
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_final(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                   uint8_t *out) {
+  unsigned i;
+
+  (void)cryp;
+
+  hash_final(sha1_compress, sha1ctxp->state.h, sha1ctxp->state.buf,
+             CRY_SHA256_BLOCK_SIZE, sha1ctxp->state.length);
+  for (i = 0U; i < 5U; i++) {
+    PUT_U32_BE(&out[i * 4U], sha1ctxp->state.h[i]);
+  }
+
+  return CRY_NOERROR;
+}
+#endif /* CRY_LLD_SUPPORTS_SHA1 == FALSE */
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] sha256ctxp       pointer to a SHA256 context to be
+ *                              initialized
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_init(CRYDriver *cryp,
+                                    SHA256Context *sha256ctxp) {
+
+  (void)cryp;
+
+  sha256_init(&sha256ctxp->state);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha256ctxp        pointer to a SHA256 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_update(CRYDriver *cryp,
+                                      SHA256Context *sha256ctxp,
+                                      size_t size, const uint8_t *in) {
+
+  (void)cryp;
+
+  sha256_update(&sha256ctxp->state, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha256ctxp        pointer to a SHA256 context
+ * @param[out] out              32 bytes output buffer
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_final(CRYDriver *cryp,
+                                     SHA256Context *sha256ctxp,
+                                     uint8_t *out) {
+
+  (void)cryp;
+
+  sha256_final(&sha256ctxp->state, out);
+
+  return CRY_NOERROR;
+}
+#endif /* CRY_LLD_SUPPORTS_SHA256 == FALSE */
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] sha512ctxp       pointer to a SHA512 context to be
+ *                              initialized
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_init(CRYDriver *cryp,
+                                    SHA512Context *sha512ctxp) {
+
+  (void)cryp;
+
+  sha512_init(&sha512ctxp->state);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha512ctxp        pointer to a SHA512 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_update(CRYDriver *cryp,
+                                      SHA512Context *sha512ctxp,
+                                      size_t size, const uint8_t *in) {
+
+  (void)cryp;
+
+  sha512_update(&sha512ctxp->state, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha512ctxp        pointer to a SHA512 context
+ * @param[out] out              64 bytes output buffer
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_final(CRYDriver *cryp,
+                                     SHA512Context *sha512ctxp,
+                                     uint8_t *out) {
+
+  (void)cryp;
+
+  sha512_final(&sha512ctxp->state, out);
+
+  return CRY_NOERROR;
+}
+#endif /* CRY_LLD_SUPPORTS_SHA512 == FALSE */
+
+#if (FALLBACK_NEEDS_HMAC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes the HMAC transient key.
+ * @details Keys of any size are accepted, keys longer than the hash block
+ *          size are replaced by their digest as specified by RFC 2104.
+ * @note    The previous key is cleared before loading the new one.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_hmac_loadkey(CRYDriver *cryp,
+                                     size_t size,
+                                     const uint8_t *keyp) {
+
+  memset(&cryp->fb_hmackey, 0, sizeof cryp->fb_hmackey);
+
+#if CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE
+  if (size > CRY_SHA256_BLOCK_SIZE) {
+    crysha256state_t st;
+
+    sha256_init(&st);
+    sha256_update(&st, size, keyp);
+    sha256_final(&st, cryp->fb_hmackey.k256);
+  }
+  else {
+    memcpy(cryp->fb_hmackey.k256, keyp, size);
+  }
+#endif
+
+#if CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE
+  if (size > CRY_SHA512_BLOCK_SIZE) {
+    crysha512state_t st;
+
+    sha512_init(&st);
+    sha512_update(&st, size, keyp);
+    sha512_final(&st, cryp->fb_hmackey.k512);
+  }
+  else {
+    memcpy(cryp->fb_hmackey.k512, keyp, size);
+  }
+#endif
+
+  cryp->fb_hmackey.loaded = true;
+
+  return CRY_NOERROR;
+}
+#endif /* FALLBACK_NEEDS_HMAC == TRUE */
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using HMAC_SHA256.
+ * @details The key blocks are hashed here, the inner and outer states are
+ *          kept in the context.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] hmacsha256ctxp   pointer to a HMAC_SHA256 context to be
+ *                              initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the HMAC transient key has not been
+ *                              loaded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_init(CRYDriver *cryp,
+                                        HMACSHA256Context *hmacsha256ctxp) {
+  uint8_t blk[CRY_SHA256_BLOCK_SIZE];
+  unsigned i;
+
+  if (!cryp->fb_hmackey.loaded) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  for (i = 0U; i < CRY_SHA256_BLOCK_SIZE; i++) {
+    blk[i] = cryp->fb_hmackey.k256[i] ^ 0x36U;
+  }
+  sha256_init(&hmacsha256ctxp->inner);
+  sha256_update(&hmacsha256ctxp->inner, CRY_SHA256_BLOCK_SIZE, blk);
+
+  for (i = 0U; i < CRY_SHA256_BLOCK_SIZE; i++) {
+    blk[i] = cryp->fb_hmackey.k256[i] ^ 0x5CU;
+  }
+  sha256_init(&hmacsha256ctxp->outer);
+  sha256_update(&hmacsha256ctxp->outer, CRY_SHA256_BLOCK_SIZE, blk);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using HMAC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha256ctxp    pointer to a HMAC_SHA256 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_update(CRYDriver *cryp,
+                                          HMACSHA256Context *hmacsha256ctxp,
+                                          size_t size,
+                                          const uint8_t *in) {
+
+  (void)cryp;
+
+  sha256_update(&hmacsha256ctxp->inner, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using HMAC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha256ctxp    pointer to a HMAC_SHA256 context
+ * @param[out] out              32 bytes output buffer
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_final(CRYDriver *cryp,
+                                         HMACSHA256Context *hmacsha256ctxp,
+                                         uint8_t *out) {
+  uint8_t digest[CRY_SHA256_SIZE];
+
+  (void)cryp;
+
+  sha256_final(&hmacsha256ctxp->inner, digest);
+  sha256_update(&hmacsha256ctxp->outer, CRY_SHA256_SIZE, digest);
+  sha256_final(&hmacsha256ctxp->outer, out);
+
+  return CRY_NOERROR;
+}
+#endif /* CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE */
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using HMAC_SHA512.
+ * @details The key blocks are hashed here, the inner and outer states are
+ *          kept in the context.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] hmacsha512ctxp   pointer to a HMAC_SHA512 context to be
+ *                              initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the HMAC transient key has not been
+ *                              loaded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_init(CRYDriver *cryp,
+                                        HMACSHA512Context *hmacsha512ctxp) {
+  uint8_t blk[CRY_SHA512_BLOCK_SIZE];
+  unsigned i;
+
+  if (!cryp->fb_hmackey.loaded) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  for (i = 0U; i < CRY_SHA512_BLOCK_SIZE; i++) {
+    blk[i] = cryp->fb_hmackey.k512[i] ^ 0x36U;
+  }
+  sha512_init(&hmacsha512ctxp->inner);
+  sha512_update(&hmacsha512ctxp->inner, CRY_SHA512_BLOCK_SIZE, blk);
+
+  for (i = 0U; i < CRY_SHA512_BLOCK_SIZE; i++) {
+    blk[i] = cryp->fb_hmackey.k512[i] ^ 0x5CU;
+  }
+  sha512_init(&hmacsha512ctxp->outer);
+  sha512_update(&hmacsha512ctxp->outer, CRY_SHA512_BLOCK_SIZE, blk);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using HMAC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha512ctxp    pointer to a HMAC_SHA512 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_update(CRYDriver *cryp,
+                                          HMACSHA512Context *hmacsha512ctxp,
+                                          size_t size,
+                                          const uint8_t *in) {
+
+  (void)cryp;
+
+  sha512_update(&hmacsha512ctxp->inner, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using HMAC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha512ctxp    pointer to a HMAC_SHA512 context
+ * @param[out] out              64 bytes output buffer
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_final(CRYDriver *cryp,
+                                         HMACSHA512Context *hmacsha512ctxp,
+                                         uint8_t *out) {
+  uint8_t digest[CRY_SHA512_SIZE];
+
+  (void)cryp;
+
+  sha512_final(&hmacsha512ctxp->inner, digest);
+  sha512_update(&hmacsha512ctxp->outer, CRY_SHA512_SIZE, digest);
+  sha512_final(&hmacsha512ctxp->outer, out);
+
+  return CRY_NOERROR;
+}
+#endif /* CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE */
+
+#endif /* (HAL_USE_CRY == TRUE) && (HAL_CRY_USE_FALLBACK == TRUE) */
+
+/** @} */
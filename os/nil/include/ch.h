@@ -220,6 +220,12 @@
 #error "CH_CFG_USE_MUTEXES not defined in chconf.h"
 #endif
 
+/* Options introduced after the configuration file version 4.0, defaulted
+   to disabled if missing.*/
+#if !defined(CH_CFG_USE_TIMEOUTS_LIST)
+#define CH_CFG_USE_TIMEOUTS_LIST            FALSE
+#endif
+
 #if !defined(CH_DBG_STATISTICS) || defined(__DOXYGEN__)
 #error "CH_DBG_STATISTICS not defined in chconf.h"
 #endif
@@ -481,7 +487,15 @@ struct nil_thread {
 #endif
   } u1;
   volatile sysinterval_t timeout;   /**< @brief Timeout counter, zero
-                                                if disabled.                */
+                                                if disabled. In the timeouts
+                                                list it is relative to the
+                                                previous thread.            */
+#if (CH_CFG_USE_TIMEOUTS_LIST == TRUE) || defined(__DOXYGEN__)
+  thread_t              *tonext;    /**< @brief Next thread in the
+                                                timeouts list.              */
+  thread_t              *toprev;    /**< @brief Previous thread in the
+                                                timeouts list.              */
+#endif
 #if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
   eventmask_t           epmask;     /**< @brief Pending events mask.        */
 #endif
@@ -527,6 +541,15 @@ struct nil_system {
    */
   systime_t             nexttime;
 #endif
+#if (CH_CFG_USE_TIMEOUTS_LIST == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Threads waiting with a timeout, ordered by deadline.
+   * @note    The @p timeout field of each thread is relative to the
+   *          previous thread in the list, the first one is relative to
+   *          the last tick event.
+   */
+  thread_t              *timeouts;
+#endif
 #if (CH_DBG_SYSTEM_STATE_CHECK == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   ISR nesting level.
@@ -48,6 +48,97 @@ nil_system_t nil;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TIMEOUTS_LIST == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Inserts a thread in the timeouts list.
+ *
+ * @param[in] tp        pointer to the @p thread_t object
+ * @param[in] delta     timeout relative to the start of the list
+ */
+static void timeout_insert(thread_t *tp, sysinterval_t delta) {
+  thread_t *ptp = NULL;
+  thread_t *ntp = nil.timeouts;
+
+  /* Threads with the same deadline are kept in insertion order.*/
+  while ((ntp != NULL) && (ntp->timeout <= delta)) {
+    delta -= ntp->timeout;
+    ptp = ntp;
+    ntp = ntp->tonext;
+  }
+
+  tp->timeout = delta;
+  tp->toprev  = ptp;
+  tp->tonext  = ntp;
+  if (ntp != NULL) {
+    ntp->timeout -= delta;
+    ntp->toprev = tp;
+  }
+  if (ptp != NULL) {
+    ptp->tonext = tp;
+  }
+  else {
+    nil.timeouts = tp;
+  }
+}
+
+/**
+ * @brief   Removes a thread from the timeouts list.
+ * @details The thread timeout is added to the following thread in order
+ *          to preserve its deadline.
+ *
+ * @param[in] tp        pointer to the @p thread_t object
+ */
+static void timeout_remove(thread_t *tp) {
+
+  if (tp->tonext != NULL) {
+    tp->tonext->timeout += tp->timeout;
+    tp->tonext->toprev = tp->toprev;
+  }
+  if (tp->toprev != NULL) {
+    tp->toprev->tonext = tp->tonext;
+  }
+  else {
+    nil.timeouts = tp->tonext;
+  }
+  tp->tonext  = NULL;
+  tp->toprev  = NULL;
+  tp->timeout = (sysinterval_t)0;
+}
+
+/**
+ * @brief   Wakes up the threads at the start of the timeouts list whose
+ *          timeout reached zero.
+ */
+static void timeout_expire(void) {
+  thread_t *tp = nil.timeouts;
+
+  while ((tp != NULL) && (tp->timeout == (sysinterval_t)0)) {
+
+    chDbgAssert(!NIL_THD_IS_READY(tp), "is ready");
+
+    /* Timeout on thread queues requires a special handling because the
+       counter must be incremented.*/
+    if (NIL_THD_IS_WTQUEUE(tp)) {
+      tp->u1.tqp->cnt++;
+    }
+    else {
+      if (NIL_THD_IS_SUSPENDED(tp)) {
+        *tp->u1.trp = NULL;
+      }
+    }
+
+    /* The thread is also removed from the list.*/
+    (void) chSchReadyI(tp, MSG_TIMEOUT);
+
+    /* Lock released in order to give a preemption chance on those
+       architectures supporting IRQ preemption.*/
+    chSysUnlockFromISR();
+    chSysLockFromISR();
+    tp = nil.timeouts;
+  }
+}
+#endif /* CH_CFG_USE_TIMEOUTS_LIST == TRUE */
+
 /*===========================================================================*/
 /* Module interrupt handlers.                                                */
 /*===========================================================================*/
@@ -356,7 +447,19 @@ void chSysTimerHandlerI(void) {
 
   chDbgCheckClassI();
 
-#if CH_CFG_ST_TIMEDELTA == 0
+#if (CH_CFG_ST_TIMEDELTA == 0) && (CH_CFG_USE_TIMEOUTS_LIST == TRUE)
+  nil.systime++;
+
+  /* Only the first thread in the list is updated, the following ones are
+     relative to it.*/
+  if (nil.timeouts != NULL) {
+
+    chDbgAssert(nil.timeouts->timeout > (sysinterval_t)0, "skipped one");
+
+    nil.timeouts->timeout--;
+    timeout_expire();
+  }
+#elif CH_CFG_ST_TIMEDELTA == 0
   thread_t *tp = &nil.threads[0];
   nil.systime++;
   do {
@@ -389,6 +492,30 @@ void chSysTimerHandlerI(void) {
     tp++;
     chSysLockFromISR();
   } while (tp < &nil.threads[CH_CFG_MAX_THREADS]);
+#elif CH_CFG_USE_TIMEOUTS_LIST == TRUE
+  chDbgAssert(nil.nexttime == port_timer_get_alarm(), "time mismatch");
+
+  /* Only the first thread in the list is updated, the following ones are
+     relative to it.*/
+  if (nil.timeouts != NULL) {
+    sysinterval_t elapsed = chTimeDiffX(nil.lasttime, nil.nexttime);
+
+    chDbgAssert(nil.timeouts->timeout >= elapsed, "skipped one");
+
+    nil.timeouts->timeout -= elapsed;
+    timeout_expire();
+  }
+
+  /* The next event is the deadline of the first thread in the list.*/
+  nil.lasttime = nil.nexttime;
+  if (nil.timeouts != NULL) {
+    nil.nexttime = chTimeAddX(nil.nexttime, nil.timeouts->timeout);
+    port_timer_set_alarm(nil.nexttime);
+  }
+  else {
+    /* No tick event needed.*/
+    port_timer_stop_alarm();
+  }
 #else
   thread_t *tp = &nil.threads[0];
   sysinterval_t next = (sysinterval_t)0;
@@ -587,7 +714,13 @@ thread_t *chSchReadyI(thread_t *tp, msg_t msg) {
 
   tp->u1.msg = msg;
   tp->state = NIL_STATE_READY;
+#if CH_CFG_USE_TIMEOUTS_LIST == TRUE
+  if ((tp->toprev != NULL) || (nil.timeouts == tp)) {
+    timeout_remove(tp);
+  }
+#else
   tp->timeout = (sysinterval_t)0;
+#endif
   if (tp < nil.next) {
     nil.next = tp;
   }
@@ -699,7 +832,17 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
     }
 
     /* Timeout settings.*/
+#if CH_CFG_USE_TIMEOUTS_LIST == TRUE
+    timeout_insert(otp, abstime - nil.lasttime);
+#else
     otp->timeout = abstime - nil.lasttime;
+#endif
+  }
+#elif CH_CFG_USE_TIMEOUTS_LIST == TRUE
+
+  /* Timeout settings.*/
+  if (timeout != TIME_INFINITE) {
+    timeout_insert(otp, timeout);
   }
 #else
 
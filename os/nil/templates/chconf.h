@@ -97,6 +97,20 @@
 #define CH_CFG_ST_TIMEDELTA                 0
 #endif
 
+/**
+ * @brief   Timeouts list.
+ * @details If enabled then the threads waiting with a timeout are kept in
+ *          a list ordered by deadline, the system tick handler only
+ *          processes the threads whose timeout expires instead of scanning
+ *          all threads. In tick-less mode the next alarm is taken from the
+ *          head of the list.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_TIMEOUTS_LIST)
+#define CH_CFG_USE_TIMEOUTS_LIST            FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -217,6 +231,29 @@
 #define CH_CFG_USE_HEAP                     TRUE
 #endif
 
+/**
+ * @brief   Segregated-fit heap allocator.
+ * @details If enabled the heaps use a two levels segregated-fit (TLSF)
+ *          allocator instead of the first-fit one, allocation and release
+ *          times do not depend on the heap fragmentation.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_HEAP.
+ */
+#if !defined(CH_CFG_USE_HEAP_TLSF)
+#define CH_CFG_USE_HEAP_TLSF                FALSE
+#endif
+
+/**
+ * @brief   Number of first level size classes of the TLSF allocator.
+ *
+ * @note    The default is 16.
+ * @note    Requires @p CH_CFG_USE_HEAP_TLSF.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_LEVELS)
+#define CH_CFG_HEAP_TLSF_LEVELS             16
+#endif
+
 /**
  * @brief   Memory Pools Allocator APIs.
  * @details If enabled then the memory pools allocator APIs are included
@@ -239,6 +276,17 @@
 #define CH_CFG_USE_OBJ_FIFOS                TRUE
 #endif
 
+/**
+ * @brief   Single producer single consumer objects FIFOs.
+ * @details If enabled then the objects FIFOs are lock-free rings, each
+ *          FIFO must have at most one sender and one receiver.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_OBJ_FIFOS_SPSC)
+#define CH_CFG_OBJ_FIFOS_SPSC               FALSE
+#endif
+
 /**
  * @brief   Pipes APIs.
  * @details If enabled then the pipes APIs are included
@@ -250,6 +298,17 @@
 #define CH_CFG_USE_PIPES                    TRUE
 #endif
 
+/**
+ * @brief   Single producer single consumer pipes.
+ * @details If enabled then the pipes are lock-free rings, each pipe must
+ *          have at most one writer and one reader.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_PIPES_SPSC)
+#define CH_CFG_PIPES_SPSC                   FALSE
+#endif
+
 /**
  * @brief   Objects Caches APIs.
  * @details If enabled then the objects caches APIs are included
@@ -261,6 +320,26 @@
 #define CH_CFG_USE_OBJ_CACHES               TRUE
 #endif
 
+/**
+ * @brief   Maximum number of objects in a clustered write.
+ *
+ * @note    The default is 8.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_CLUSTER_MAX)
+#define CH_CFG_OBJ_CACHES_CLUSTER_MAX       8
+#endif
+
+/**
+ * @brief   Objects Caches statistics.
+ * @details If enabled then hits, misses, evictions, writes and prefetches
+ *          are counted for each cache.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_STATS)
+#define CH_CFG_OBJ_CACHES_STATS             FALSE
+#endif
+
 /**
  * @brief   Delegate threads APIs.
  * @details If enabled then the delegate threads APIs are included
@@ -283,6 +362,27 @@
 #define CH_CFG_USE_JOBS                     TRUE
 #endif
 
+/**
+ * @brief   Jobs Pools APIs.
+ * @details If enabled then the work-stealing jobs pools APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_JOBS.
+ */
+#if !defined(CH_CFG_USE_JOBS_POOLS)
+#define CH_CFG_USE_JOBS_POOLS               FALSE
+#endif
+
+/**
+ * @brief   Number of jobs priority levels in jobs pools.
+ *
+ * @note    The default is 2.
+ */
+#if !defined(CH_CFG_JOBS_PRIORITIES)
+#define CH_CFG_JOBS_PRIORITIES              2
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -312,6 +412,19 @@
 #define CH_CFG_FACTORY_MAX_NAMES_LENGTH     8
 #endif
 
+/**
+ * @brief   Size of the hashed names index.
+ * @details If greater than zero then each objects list is split in the
+ *          specified number of hash buckets and lookups by name, and by
+ *          pointer for registered objects, take constant time on average.
+ *
+ * @note    The default is 0, no index.
+ * @note    The value must be zero or a power of two.
+ */
+#if !defined(CH_CFG_FACTORY_HASH_SIZE)
+#define CH_CFG_FACTORY_HASH_SIZE            0
+#endif
+
 /**
  * @brief   Enables the registry of generic objects.
  */
@@ -47,6 +47,18 @@
 #define CH_CFG_FACTORY_MAX_NAMES_LENGTH     8
 #endif
 
+/**
+ * @brief   Size of the hashed names index.
+ * @details If greater than zero then each objects list is split in the
+ *          specified number of hash buckets and lookups by name, and by
+ *          pointer for registered objects, take constant time on average.
+ *          If zero then objects lists are scanned linearly.
+ * @note    The value must be zero or a power of two.
+ */
+#if !defined(CH_CFG_FACTORY_HASH_SIZE) || defined(__DOXYGEN__)
+#define CH_CFG_FACTORY_HASH_SIZE            0
+#endif
+
 /**
  * @brief   Enables the registry of generic objects.
  */
@@ -143,6 +155,15 @@
 #error "invalid CH_CFG_FACTORY_MAX_NAMES_LENGTH value"
 #endif
 
+#if (CH_CFG_FACTORY_HASH_SIZE < 0) ||                                       \
+    ((CH_CFG_FACTORY_HASH_SIZE & (CH_CFG_FACTORY_HASH_SIZE - 1)) != 0)
+#error "invalid CH_CFG_FACTORY_HASH_SIZE value"
+#endif
+
+#if (CH_CFG_FACTORY_HASH_SIZE > 0) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH == 0)
+#error "CH_CFG_FACTORY_HASH_SIZE requires CH_CFG_FACTORY_MAX_NAMES_LENGTH > 0"
+#endif
+
 #if (CH_CFG_USE_MUTEXES == FALSE) && (CH_CFG_USE_SEMAPHORES == FALSE)
 #error "CH_CFG_USE_FACTORY requires CH_CFG_USE_MUTEXES and/or CH_CFG_USE_SEMAPHORES"
 #endif
@@ -169,6 +190,8 @@
 typedef struct ch_dyn_element {
   /**
    * @brief   Next dynamic object in the list.
+   * @note    If the names index is enabled then this is the next object
+   *          in the same hash bucket.
    */
   struct ch_dyn_element *next;
   /**
@@ -186,7 +209,18 @@ typedef struct ch_dyn_element {
  * @brief   Type of a dynamic object list.
  */
 typedef struct ch_dyn_list {
-    dyn_element_t       *next;
+#if (CH_CFG_FACTORY_HASH_SIZE == 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   First dynamic object in the list.
+   */
+  dyn_element_t         *next;
+#endif
+#if (CH_CFG_FACTORY_HASH_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Hash buckets of the names index.
+   */
+  dyn_element_t         *buckets[CH_CFG_FACTORY_HASH_SIZE];
+#endif
 } dyn_list_t;
 
 #if (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) || defined(__DOXYGEN__)
@@ -203,6 +237,12 @@ typedef struct ch_registered_static_object {
    * @note    The type of the object is not stored in anyway.
    */
   void                  *objp;
+#if (CH_CFG_FACTORY_HASH_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Next registered object in the same pointers index bucket.
+   */
+  struct ch_registered_static_object *pnext;
+#endif
 } registered_object_t;
 #endif
 
@@ -302,6 +342,12 @@ typedef struct ch_objects_factory {
    * @brief   Pool of the available registered objects.
    */
   memory_pool_t         obj_pool;
+#if (CH_CFG_FACTORY_HASH_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Hash buckets of the registered objects pointers index.
+   */
+  registered_object_t   *obj_ptr_buckets[CH_CFG_FACTORY_HASH_SIZE];
+#endif
 #if (CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   List of the allocated buffer objects.
@@ -28,6 +28,9 @@
  *          - <b>Post</b>: A job is posted to the queue, it will be
  *            returned to the pool after execution.
  *          .
+ *          Optionally jobs can be posted to a jobs pool, a set of worker
+ *          threads each one owning a deque of jobs, idle workers steal
+ *          jobs from the deques of the other workers.
  *
  * @addtogroup oslib_jobs_queues
  * @{
@@ -51,6 +54,26 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Jobs pools APIs.
+ * @details If enabled then the jobs pools APIs are included, a jobs pool
+ *          distributes jobs among several worker threads with work
+ *          stealing.
+ * @note    The default is @p FALSE.
+ * @note    Jobs descriptors are larger when this option is enabled.
+ */
+#if !defined(CH_CFG_USE_JOBS_POOLS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_JOBS_POOLS               FALSE
+#endif
+
+/**
+ * @brief   Number of jobs priority levels in jobs pools.
+ * @note    The default is 2, priorities 0 (normal) and 1 (high).
+ */
+#if !defined(CH_CFG_JOBS_PRIORITIES) || defined(__DOXYGEN__)
+#define CH_CFG_JOBS_PRIORITIES              2
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -67,6 +90,17 @@
 #error "CH_CFG_USE_JOBS requires CH_CFG_USE_MAILBOXES"
 #endif
 
+#if (CH_CFG_JOBS_PRIORITIES < 1) || (CH_CFG_JOBS_PRIORITIES > 16)
+#error "invalid CH_CFG_JOBS_PRIORITIES value specified"
+#endif
+
+/* The workers deques are protected by the local critical zone only.*/
+#if (CH_CFG_USE_JOBS_POOLS == TRUE) && defined(CH_CFG_SMP_MODE)
+#if CH_CFG_SMP_MODE == TRUE
+#error "CH_CFG_USE_JOBS_POOLS is not compatible with CH_CFG_SMP_MODE"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -102,8 +136,138 @@ typedef struct ch_job_descriptor {
    * @brief   Argument to be passed to the job function.
    */
   void                      *jobarg;
+#if (CH_CFG_USE_JOBS_POOLS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Job priority, only used by jobs pools.
+   * @note    Must be lower than @p CH_CFG_JOBS_PRIORITIES, higher values
+   *          mean higher priorities.
+   * @note    Reset to zero when the object is allocated from a pool.
+   */
+  unsigned                  jobprio;
+  /**
+   * @brief   Next job in the worker deque.
+   */
+  struct ch_job_descriptor  *next;
+  /**
+   * @brief   Previous job in the worker deque.
+   */
+  struct ch_job_descriptor  *prev;
+  /**
+   * @brief   System time of the job posting.
+   */
+  systime_t                 time;
+#endif
 } job_descriptor_t;
 
+#if (CH_CFG_USE_JOBS_POOLS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a jobs pool.
+ */
+typedef struct ch_jobs_pool jobs_pool_t;
+
+/**
+ * @brief   Type of a jobs pool worker.
+ */
+typedef struct ch_jobs_worker {
+  /**
+   * @brief   Owner jobs pool.
+   */
+  jobs_pool_t               *pool;
+  /**
+   * @brief   Worker thread, set on the first dispatch.
+   */
+  thread_t                  *thread;
+  /**
+   * @brief   Reference to the worker thread while waiting for jobs.
+   */
+  thread_reference_t        tr;
+  /**
+   * @brief   Deques bottom, the end used by the owner worker.
+   */
+  job_descriptor_t          *bottom[CH_CFG_JOBS_PRIORITIES];
+  /**
+   * @brief   Deques top, the end used by the stealing workers.
+   */
+  job_descriptor_t          *top[CH_CFG_JOBS_PRIORITIES];
+  /**
+   * @brief   Number of jobs in the deques.
+   */
+  size_t                    depth;
+  /**
+   * @brief   Number of jobs executed by this worker.
+   */
+  ucnt_t                    executed;
+  /**
+   * @brief   Number of jobs stolen by this worker.
+   */
+  ucnt_t                    steals;
+} jobs_worker_t;
+
+/**
+ * @brief   Structure representing a jobs pool.
+ */
+struct ch_jobs_pool {
+  /**
+   * @brief   Pool of the free jobs.
+   */
+  guarded_memory_pool_t     free;
+  /**
+   * @brief   Array of the workers.
+   */
+  jobs_worker_t             *workers;
+  /**
+   * @brief   Number of workers.
+   */
+  size_t                    n;
+  /**
+   * @brief   Next worker receiving an external post.
+   */
+  size_t                    next;
+  /**
+   * @brief   Number of posted jobs.
+   */
+  ucnt_t                    posted;
+  /**
+   * @brief   Worst posting to execution latency.
+   */
+  sysinterval_t             worst;
+  /**
+   * @brief   Cumulative posting to execution latency.
+   */
+  uint64_t                  cumulative;
+};
+
+/**
+ * @brief   Type of a jobs pool statistics snapshot.
+ */
+typedef struct {
+  /**
+   * @brief   Jobs posted and not yet started.
+   */
+  size_t                    depth;
+  /**
+   * @brief   Number of posted jobs.
+   */
+  ucnt_t                    posted;
+  /**
+   * @brief   Number of executed jobs.
+   */
+  ucnt_t                    executed;
+  /**
+   * @brief   Number of stolen jobs.
+   */
+  ucnt_t                    steals;
+  /**
+   * @brief   Worst posting to execution latency.
+   */
+  sysinterval_t             worst;
+  /**
+   * @brief   Cumulative posting to execution latency.
+   */
+  uint64_t                  cumulative;
+} jobs_pool_stats_t;
+#endif /* CH_CFG_USE_JOBS_POOLS == TRUE */
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -115,7 +279,20 @@ typedef struct ch_job_descriptor {
 #ifdef __cplusplus
 extern "C" {
 #endif
-
+#if CH_CFG_USE_JOBS_POOLS == TRUE
+  void chJobPoolObjectInit(jobs_pool_t *jpp,
+                           size_t jobsn, job_descriptor_t *jobsbuf,
+                           size_t n, jobs_worker_t *workers);
+  void chJobPoolPostI(jobs_pool_t *jpp, job_descriptor_t *jp);
+  void chJobPoolPostS(jobs_pool_t *jpp, job_descriptor_t *jp);
+  void chJobPoolPost(jobs_pool_t *jpp, job_descriptor_t *jp);
+  void chJobPoolPostBatchI(jobs_pool_t *jpp,
+                           job_descriptor_t * const *jps, size_t n);
+  void chJobPoolPostBatch(jobs_pool_t *jpp,
+                          job_descriptor_t * const *jps, size_t n);
+  msg_t chJobPoolDispatchTimeout(jobs_worker_t *jwp, sysinterval_t timeout);
+  void chJobPoolGetStats(jobs_pool_t *jpp, jobs_pool_stats_t *jpsp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -390,6 +567,90 @@ static inline msg_t chJobDispatchTimeout(jobs_queue_t *jqp,
   return msg;
 }
 
+#if (CH_CFG_USE_JOBS_POOLS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Allocates a free job object from a jobs pool.
+ * @note    The job priority is reset to zero.
+ *
+ * @param[in] jpp       pointer to a @p jobs_pool_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the allocated job object.
+ * @retval NULL         if a job object is not available within the specified
+ *                      timeout.
+ *
+ * @api
+ */
+static inline job_descriptor_t *chJobPoolGetTimeout(jobs_pool_t *jpp,
+                                                    sysinterval_t timeout) {
+  job_descriptor_t *jp;
+
+  jp = (job_descriptor_t *)chGuardedPoolAllocTimeout(&jpp->free, timeout);
+  if (jp != NULL) {
+    jp->jobprio = 0U;
+  }
+
+  return jp;
+}
+
+/**
+ * @brief   Allocates a free job object from a jobs pool.
+ * @note    The job priority is reset to zero.
+ *
+ * @param[in] jpp       pointer to a @p jobs_pool_t structure
+ * @return              The pointer to the allocated job object.
+ *
+ * @api
+ */
+static inline job_descriptor_t *chJobPoolGet(jobs_pool_t *jpp) {
+
+  return chJobPoolGetTimeout(jpp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Allocates a free job object from a jobs pool.
+ * @note    The job priority is reset to zero.
+ *
+ * @param[in] jpp       pointer to a @p jobs_pool_t structure
+ * @return              The pointer to the allocated job object.
+ * @retval NULL         if a job object is not immediately available.
+ *
+ * @iclass
+ */
+static inline job_descriptor_t *chJobPoolGetI(jobs_pool_t *jpp) {
+  job_descriptor_t *jp;
+
+  jp = (job_descriptor_t *)chGuardedPoolAllocI(&jpp->free);
+  if (jp != NULL) {
+    jp->jobprio = 0U;
+  }
+
+  return jp;
+}
+
+/**
+ * @brief   Waits for a job from a jobs pool then executes it.
+ * @details The worker executes the highest priority job available, its
+ *          own deque is checked first then jobs are stolen from the deques
+ *          of the other workers.
+ *
+ * @param[in] jwp       pointer to the @p jobs_worker_t structure of the
+ *                      calling worker thread
+ * @return              The function outcome.
+ * @retval MSG_OK       if a job has been executed.
+ * @retval MSG_JOB_NULL if a @p JOB_NULL has been received.
+ *
+ * @api
+ */
+static inline msg_t chJobPoolDispatch(jobs_worker_t *jwp) {
+
+  return chJobPoolDispatchTimeout(jwp, TIME_INFINITE);
+}
+#endif /* CH_CFG_USE_JOBS_POOLS == TRUE */
+
 #endif /* CH_CFG_USE_JOBS == TRUE */
 
 #endif /* CHJOBS_H */
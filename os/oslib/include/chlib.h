@@ -216,6 +216,18 @@
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Memory barrier used by the lock-free objects.
+ * @details Orders the accesses to a shared buffer with respect to the
+ *          updates of its indexes, it can be redefined in @p chconf.h for
+ *          compilers not supported here.
+ */
+#if !defined(CH_OSLIB_MEMORY_BARRIER) || defined(__DOXYGEN__)
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+#define CH_OSLIB_MEMORY_BARRIER()   __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
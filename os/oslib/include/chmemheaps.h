@@ -38,7 +38,9 @@
  * @brief   Minimum alignment used for heap.
  * @note    Cannot use the sizeof operator in this macro.
  */
-#if (SIZEOF_PTR == 4) || defined(__DOXYGEN__)
+#if (SIZEOF_PTR == 8)
+#define CH_HEAP_ALIGNMENT   16U
+#elif (SIZEOF_PTR == 4) || defined(__DOXYGEN__)
 #define CH_HEAP_ALIGNMENT   8U
 #elif (SIZEOF_PTR == 2)
 #define CH_HEAP_ALIGNMENT   4U
@@ -50,10 +52,61 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Segregated-fit heap allocator.
+ * @details If enabled the heaps use a two levels segregated-fit (TLSF)
+ *          allocator instead of the first-fit free list. Allocation and
+ *          release take constant time and free blocks are coalesced
+ *          immediately with their neighbors.
+ * @note    The default is @p FALSE.
+ * @note    Block headers are twice the size and each heap descriptor
+ *          contains the free lists heads array.
+ * @note    Requests are rounded up to the next size class, free lists are
+ *          only scanned for blocks exceeding the largest class and, as a
+ *          fallback, in the class of the unrounded request size. Scans are
+ *          limited to @p CH_HEAP_TLSF_SCAN_MAX blocks so an allocation can
+ *          fail even if a large enough block exists deeper in a list.
+ */
+#if !defined(CH_CFG_USE_HEAP_TLSF) || defined(__DOXYGEN__)
+#define CH_CFG_USE_HEAP_TLSF                FALSE
+#endif
+
+/**
+ * @brief   Number of first level size classes in TLSF mode.
+ * @details The first level class of a block is the position of the most
+ *          significant bit of its size, blocks exceeding the largest class
+ *          are kept together in the last one.
+ * @note    The default is 16, classes up to 2^18 allocation units.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_LEVELS) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_TLSF_LEVELS             16
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of bits of the TLSF second level index.
+ */
+#define CH_HEAP_TLSF_SL_BITS    3U
+
+/**
+ * @brief   Number of second level size classes in TLSF mode.
+ */
+#define CH_HEAP_TLSF_SL_COUNT   (1U << CH_HEAP_TLSF_SL_BITS)
+
+/**
+ * @brief   Maximum number of blocks examined by a free list scan.
+ */
+#define CH_HEAP_TLSF_SCAN_MAX   4U
+
+#if (CH_CFG_HEAP_TLSF_LEVELS < 2) || (CH_CFG_HEAP_TLSF_LEVELS > 31)
+#error "invalid CH_CFG_HEAP_TLSF_LEVELS value specified"
+#endif
+#endif
+
 #if CH_CFG_USE_MEMCORE == FALSE
 #error "CH_CFG_USE_HEAP requires CH_CFG_USE_MEMCORE"
 #endif
@@ -76,6 +129,7 @@ typedef struct memory_heap memory_heap_t;
  */
 typedef union heap_header heap_header_t;
 
+#if (CH_CFG_USE_HEAP_TLSF == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Memory heap block header.
  */
@@ -89,6 +143,24 @@ union heap_header {
     size_t              size;       /**< @brief Size of the area in bytes.  */
   } used;
 };
+#else /* CH_CFG_USE_HEAP_TLSF == TRUE */
+/**
+ * @brief   Memory heap block header.
+ * @note    The header is shared by free and used blocks, a block is free
+ *          when its owner heap is @p NULL. The links of free blocks into
+ *          the free lists are stored in the block area.
+ */
+union heap_header {
+  struct {
+    heap_header_t       *prev;      /**< @brief Previous block in the same
+                                                memory area or @p NULL.     */
+    size_t              pages;      /**< @brief Size of the area in pages.  */
+    memory_heap_t       *heap;      /**< @brief Block owner heap or
+                                                @p NULL if free.            */
+    size_t              size;       /**< @brief Size of the area in bytes.  */
+  } used;
+};
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
 
 /**
  * @brief   Structure describing a memory heap.
@@ -96,7 +168,23 @@ union heap_header {
 struct memory_heap {
   memgetfunc2_t         provider;   /**< @brief Memory blocks provider for
                                                 this heap.                  */
+#if (CH_CFG_USE_HEAP_TLSF == FALSE) || defined(__DOXYGEN__)
   heap_header_t         header;     /**< @brief Free blocks list header.    */
+#endif
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Mask of the first level classes with free blocks.
+   */
+  uint32_t              flmap;
+  /**
+   * @brief   Masks of the second level classes with free blocks.
+   */
+  uint8_t               slmap[CH_CFG_HEAP_TLSF_LEVELS];
+  /**
+   * @brief   Free lists, one for each size class.
+   */
+  heap_header_t         *lists[CH_CFG_HEAP_TLSF_LEVELS][CH_HEAP_TLSF_SL_COUNT];
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   mutex_t               mtx;        /**< @brief Heap access mutex.          */
 #else
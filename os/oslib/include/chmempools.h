@@ -77,10 +77,36 @@ typedef struct {
 typedef struct {
   semaphore_t           sem;            /**< @brief Counter semaphore guarding
                                                     the memory pool.        */
+  threads_queue_t       batch_queue;    /**< @brief Threads waiting for a
+                                                    batch of objects.       */
   memory_pool_t         pool;           /**< @brief The memory pool itself. */
 } guarded_memory_pool_t;
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+/**
+ * @brief   Memory pool magazine descriptor.
+ * @details A magazine is a small cache of objects placed in front of a
+ *          memory pool, or of a guarded memory pool, and owned by a single
+ *          thread. Objects are allocated from and released into the
+ *          magazine without entering a critical zone, the backing pool is
+ *          accessed only in order to refill an empty magazine or to drain
+ *          a full one, half a magazine at time. The backing pool acts as
+ *          depot for the magazines of all threads using it.
+ * @note    A magazine is not protected by any lock so it must be used by
+ *          a single thread and never from ISRs.
+ */
+typedef struct {
+  memory_pool_t         *pool;          /**< @brief Backing memory pool.    */
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+  guarded_memory_pool_t *gmp;           /**< @brief Backing guarded pool or
+                                                    @p NULL.                */
+#endif
+  void                  **objs;         /**< @brief Cached objects array.   */
+  size_t                size;           /**< @brief Magazine capacity.      */
+  size_t                cnt;            /**< @brief Number of objects in
+                                                    the magazine.           */
+} pool_magazine_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -124,6 +150,7 @@ typedef struct {
  */
 #define _GUARDEDMEMORYPOOL_DATA(name, size, align) {                        \
   _SEMAPHORE_DATA(name.sem, (cnt_t)0),                                      \
+  _THREADS_QUEUE_DATA(name.batch_queue),                                    \
   _MEMORYPOOL_DATA(NULL, size, align, NULL)                                 \
 }
 
@@ -154,6 +181,10 @@ extern "C" {
   void *chPoolAlloc(memory_pool_t *mp);
   void chPoolFreeI(memory_pool_t *mp, void *objp);
   void chPoolFree(memory_pool_t *mp, void *objp);
+  size_t chPoolAllocBatchI(memory_pool_t *mp, void **objs, size_t n);
+  size_t chPoolAllocBatch(memory_pool_t *mp, void **objs, size_t n);
+  void chPoolFreeBatchI(memory_pool_t *mp, void * const *objs, size_t n);
+  void chPoolFreeBatch(memory_pool_t *mp, void * const *objs, size_t n);
 #if CH_CFG_USE_SEMAPHORES == TRUE
   void chGuardedPoolObjectInitAligned(guarded_memory_pool_t *gmp,
                                       size_t size,
@@ -164,6 +195,30 @@ extern "C" {
   void *chGuardedPoolAllocTimeout(guarded_memory_pool_t *gmp,
                                   sysinterval_t timeout);
   void chGuardedPoolFree(guarded_memory_pool_t *gmp, void *objp);
+  size_t chGuardedPoolAllocBatchI(guarded_memory_pool_t *gmp,
+                                  void **objs, size_t n);
+  msg_t chGuardedPoolAllocBatchTimeoutS(guarded_memory_pool_t *gmp,
+                                        void **objs, size_t n,
+                                        sysinterval_t timeout);
+  msg_t chGuardedPoolAllocBatchTimeout(guarded_memory_pool_t *gmp,
+                                       void **objs, size_t n,
+                                       sysinterval_t timeout);
+  void chGuardedPoolFreeBatchI(guarded_memory_pool_t *gmp,
+                               void * const *objs, size_t n);
+  void chGuardedPoolFreeBatch(guarded_memory_pool_t *gmp,
+                              void * const *objs, size_t n);
+#endif
+  void chPoolMagazineObjectInit(pool_magazine_t *pmp, memory_pool_t *mp,
+                                void **objs, size_t size);
+  void *chPoolMagazineAlloc(pool_magazine_t *pmp);
+  void chPoolMagazineFree(pool_magazine_t *pmp, void *objp);
+  void chPoolMagazineFlush(pool_magazine_t *pmp);
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  void chGuardedPoolMagazineObjectInit(pool_magazine_t *pmp,
+                                       guarded_memory_pool_t *gmp,
+                                       void **objs, size_t size);
+  void *chGuardedPoolMagazineAllocTimeout(pool_magazine_t *pmp,
+                                          sysinterval_t timeout);
 #endif
 #ifdef __cplusplus
 }
@@ -300,6 +355,7 @@ static inline void chGuardedPoolFreeI(guarded_memory_pool_t *gmp, void *objp) {
 
   chPoolFreeI(&gmp->pool, objp);
   chSemSignalI(&gmp->sem);
+  chThdDequeueAllI(&gmp->batch_queue, MSG_OK);
 }
 
 /**
@@ -378,6 +434,19 @@ static inline void chGuardedPoolAddS(guarded_memory_pool_t *gmp, void *objp) {
 }
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+/**
+ * @brief   Returns the number of objects cached in a magazine.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @return              The number of cached objects.
+ *
+ * @xclass
+ */
+static inline size_t chPoolMagazineGetCountX(const pool_magazine_t *pmp) {
+
+  return pmp->cnt;
+}
+
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
 
 #endif /* CHMEMPOOLS_H */
@@ -44,16 +44,43 @@
 #define OC_FLAG_NOTSYNC                     0x00000008U
 #define OC_FLAG_LAZYWRITE                   0x00000010U
 #define OC_FLAG_FORGET                      0x00000020U
+#define OC_FLAG_READAHEAD                   0x00000040U
 /** @} */
 
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Maximum number of objects in a clustered write.
+ * @details Dirty objects with adjacent keys are written together using
+ *          the cluster writer function, if specified.
+ * @note    The default is 8.
+ * @note    An array of pointers of this size is allocated on the stack
+ *          of the threads evicting or flushing objects.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_CLUSTER_MAX) || defined(__DOXYGEN__)
+#define CH_CFG_OBJ_CACHES_CLUSTER_MAX       8
+#endif
+
+/**
+ * @brief   Objects caches statistics.
+ * @details If enabled then hits, misses, evictions, writes and prefetches
+ *          are counted for each cache.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_STATS) || defined(__DOXYGEN__)
+#define CH_CFG_OBJ_CACHES_STATS             FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_OBJ_CACHES_CLUSTER_MAX < 1
+#error "invalid CH_CFG_OBJ_CACHES_CLUSTER_MAX value specified"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -107,6 +134,57 @@ typedef bool (*oc_writef_t)(objects_cache_t *ocp,
                             oc_object_t *objp,
                             bool async);
 
+/**
+ * @brief   Objects cluster write function.
+ * @details Writes objects belonging to the same group and having
+ *          consecutive keys in a single operation, objects are passed in
+ *          ascending keys order.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objs      array of pointers to the objects to be written
+ * @param[in] n         number of objects in the array
+ * @param[in] async     requests an asynchronous operation if supported, the
+ *                      function is then responsible for releasing all the
+ *                      objects
+ */
+typedef bool (*oc_writevf_t)(objects_cache_t *ocp,
+                             oc_object_t * const *objs,
+                             ucnt_t n,
+                             bool async);
+
+#if (CH_CFG_OBJ_CACHES_STATS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a cache statistics structure.
+ */
+typedef struct {
+  /**
+   * @brief   Number of objects found in cache.
+   */
+  ucnt_t                hits;
+  /**
+   * @brief   Number of objects not found in cache.
+   */
+  ucnt_t                misses;
+  /**
+   * @brief   Number of cached objects discarded in order to reuse their
+   *          buffer.
+   */
+  ucnt_t                evictions;
+  /**
+   * @brief   Number of write operations performed by the cache.
+   */
+  ucnt_t                writes;
+  /**
+   * @brief   Number of objects written by the cache.
+   */
+  ucnt_t                written;
+  /**
+   * @brief   Number of read-ahead operations.
+   */
+  ucnt_t                prefetches;
+} oc_stats_t;
+#endif
+
 /**
  * @brief   Structure representing an hash table element.
  */
@@ -231,6 +309,29 @@ struct ch_objects_cache {
    * @brief   Writer functions for cached objects.
    */
   oc_writef_t           writef;
+  /**
+   * @brief   Cluster writer function for cached objects.
+   * @note    If @p NULL then dirty objects are written one at time.
+   */
+  oc_writevf_t          writevf;
+  /**
+   * @brief   Number of objects read ahead on sequential misses.
+   */
+  ucnt_t                readahead;
+  /**
+   * @brief   Group of the last retrieved object.
+   */
+  uint32_t              last_group;
+  /**
+   * @brief   Key of the last retrieved object.
+   */
+  uint32_t              last_key;
+#if (CH_CFG_OBJ_CACHES_STATS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Cache statistics.
+   */
+  oc_stats_t            stats;
+#endif
 };
 
 /*===========================================================================*/
@@ -263,6 +364,10 @@ extern "C" {
   bool chCacheWriteObject(objects_cache_t *ocp,
                           oc_object_t *objp,
                           bool async);
+  bool chCacheFlush(objects_cache_t *ocp);
+#if CH_CFG_OBJ_CACHES_STATS == TRUE
+  void chCacheGetStats(objects_cache_t *ocp, oc_stats_t *ocsp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -297,6 +402,42 @@ static inline void chCacheReleaseObject(objects_cache_t *ocp,
   chSysUnlock();
 }
 
+/**
+ * @brief   Sets the cluster writer function of a cache.
+ * @details If specified, dirty objects with adjacent keys are written in
+ *          a single operation when evicted or flushed.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] writevf   pointer to an objects cluster writer function or
+ *                      @p NULL
+ *
+ * @init
+ */
+static inline void chCacheSetClusterWriter(objects_cache_t *ocp,
+                                           oc_writevf_t writevf) {
+
+  ocp->writevf = writevf;
+}
+
+/**
+ * @brief   Sets the read-ahead depth of a cache.
+ * @details When an object following the previously retrieved one is
+ *          missing from the cache then reading it also triggers
+ *          asynchronous reads of the next @p n objects of the same group.
+ * @note    Read-ahead only uses free or clean buffers, dirty objects are
+ *          never written in order to make space for prefetched ones.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] n         number of objects to be read ahead, zero disables
+ *                      the read-ahead
+ *
+ * @init
+ */
+static inline void chCacheSetReadAhead(objects_cache_t *ocp, ucnt_t n) {
+
+  ocp->readahead = n;
+}
+
 #endif /* CH_CFG_USE_OBJ_CACHES == TRUE */
 
 #endif /* CHOBJCACHES_H */
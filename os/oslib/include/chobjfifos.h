@@ -36,6 +36,9 @@
  *          - <b>Receive</b>: An object is received from the mailbox,
  *            can be blocking.
  *          .
+ *          In SPSC mode the pool and the mailbox are replaced by two
+ *          lock-free rings of objects pointers, one for the free objects
+ *          and one for the sent objects.
  *
  * @addtogroup oslib_objects_fifos
  * @{
@@ -54,10 +57,29 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Single producer single consumer objects FIFOs.
+ * @details If enabled the objects FIFOs use lock-free rings instead of a
+ *          guarded pool and a mailbox, the kernel is entered only in order
+ *          to wait on an empty ring or to wake up the peer.
+ * @note    The default is @p FALSE.
+ * @note    In this mode each FIFO must have at most one sender and one
+ *          receiver, the messages buffer must be able to hold
+ *          @p CH_FIFO_MSGBUF_SIZE() messages and the "ahead" send
+ *          functions are not available.
+ */
+#if !defined(CH_CFG_OBJ_FIFOS_SPSC) || defined(__DOXYGEN__)
+#define CH_CFG_OBJ_FIFOS_SPSC               FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_OBJ_FIFOS_SPSC == TRUE) && !defined(CH_OSLIB_MEMORY_BARRIER)
+#error "CH_CFG_OBJ_FIFOS_SPSC requires CH_OSLIB_MEMORY_BARRIER()"
+#endif
+
 #if CH_CFG_USE_MEMPOOLS == FALSE
 #error "CH_CFG_USE_OBJ_FIFOS requires CH_CFG_USE_MEMPOOLS"
 #endif
@@ -74,10 +96,30 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+#if (CH_CFG_OBJ_FIFOS_SPSC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a lock-free ring of objects.
+ * @note    The write side and the read side are owned by different threads,
+ *          only the reader can wait on the ring.
+ */
+typedef struct {
+  msg_t                     *buffer;    /**< @brief Pointer to the ring
+                                                    buffer.                 */
+  msg_t                     *top;       /**< @brief Pointer to the location
+                                                    after the buffer.       */
+  msg_t                     *wrptr;     /**< @brief Write pointer.          */
+  msg_t                     *rdptr;     /**< @brief Read pointer.           */
+  volatile size_t           wrcnt;      /**< @brief Objects written.        */
+  volatile size_t           rdcnt;      /**< @brief Objects read.           */
+  thread_reference_t        tr;         /**< @brief Waiting reader.         */
+} objects_ring_t;
+#endif
+
 /**
  * @brief   Type of an objects FIFO.
  */
 typedef struct ch_objects_fifo {
+#if (CH_CFG_OBJ_FIFOS_SPSC == FALSE) || defined(__DOXYGEN__)
   /**
    * @brief   Pool of the free objects.
    */
@@ -86,12 +128,35 @@ typedef struct ch_objects_fifo {
    * @brief   Mailbox of the sent objects.
    */
   mailbox_t                 mbx;
+#endif
+#if (CH_CFG_OBJ_FIFOS_SPSC == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Ring of the free objects.
+   */
+  objects_ring_t            freering;
+  /**
+   * @brief   Ring of the sent objects.
+   */
+  objects_ring_t            sentring;
+#endif
 } objects_fifo_t;
 
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Size of the messages buffer of a FIFO.
+ *
+ * @param[in] objn      number of objects in the FIFO
+ * @return              The number of messages to be allocated.
+ */
+#if (CH_CFG_OBJ_FIFOS_SPSC == FALSE) || defined(__DOXYGEN__)
+#define CH_FIFO_MSGBUF_SIZE(objn)   (objn)
+#else
+#define CH_FIFO_MSGBUF_SIZE(objn)   ((objn) * 2U)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -108,6 +173,150 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
+#if (CH_CFG_OBJ_FIFOS_SPSC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes an objects ring.
+ *
+ * @param[out] orp      pointer to a @p objects_ring_t structure
+ * @param[in] buf       pointer to the ring buffer
+ * @param[in] n         number of elements in the ring buffer
+ *
+ * @notapi
+ */
+static inline void _fifo_ring_init(objects_ring_t *orp, msg_t *buf, size_t n) {
+
+  orp->buffer = buf;
+  orp->top    = &buf[n];
+  orp->wrptr  = buf;
+  orp->rdptr  = buf;
+  orp->wrcnt  = (size_t)0;
+  orp->rdcnt  = (size_t)0;
+  orp->tr     = NULL;
+}
+
+/**
+ * @brief   Writes an object into a ring.
+ * @note    Can only be called by the ring writer, the ring cannot be full
+ *          by design.
+ *
+ * @param[in] orp       pointer to a @p objects_ring_t structure
+ * @param[in] objp      pointer to the object
+ *
+ * @notapi
+ */
+static inline void _fifo_ring_put(objects_ring_t *orp, void *objp) {
+
+  chDbgAssert(orp->wrcnt - orp->rdcnt < (size_t)(orp->top - orp->buffer),
+              "ring full");
+
+  *orp->wrptr = (msg_t)objp;
+  if (++orp->wrptr >= orp->top) {
+    orp->wrptr = orp->buffer;
+  }
+
+  /* The object must be written before being published, the reader is
+     checked after publishing the object.*/
+  CH_OSLIB_MEMORY_BARRIER();
+  orp->wrcnt++;
+  CH_OSLIB_MEMORY_BARRIER();
+}
+
+/**
+ * @brief   Reads an object from a ring.
+ * @note    Can only be called by the ring reader.
+ *
+ * @param[in] orp       pointer to a @p objects_ring_t structure
+ * @return              The pointer to the object.
+ * @retval NULL         if the ring is empty.
+ *
+ * @notapi
+ */
+static inline void *_fifo_ring_get(objects_ring_t *orp) {
+  void *objp;
+
+  if (orp->wrcnt == orp->rdcnt) {
+    return NULL;
+  }
+
+  /* The object must be read after checking the counters and before
+     releasing the slot.*/
+  CH_OSLIB_MEMORY_BARRIER();
+  objp = (void *)*orp->rdptr;
+  if (++orp->rdptr >= orp->top) {
+    orp->rdptr = orp->buffer;
+  }
+  CH_OSLIB_MEMORY_BARRIER();
+  orp->rdcnt++;
+
+  return objp;
+}
+
+/**
+ * @brief   Reads an object from a ring waiting if it is empty.
+ *
+ * @param[in] orp       pointer to a @p objects_ring_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The pointer to the object.
+ * @retval NULL         if the operation timed out.
+ *
+ * @sclass
+ */
+static inline void *_fifo_ring_get_timeout_s(objects_ring_t *orp,
+                                             sysinterval_t timeout) {
+  void *objp;
+
+  objp = _fifo_ring_get(orp);
+  while (objp == NULL) {
+    if (chThdSuspendTimeoutS(&orp->tr, timeout) != MSG_OK) {
+      break;
+    }
+    objp = _fifo_ring_get(orp);
+  }
+
+  return objp;
+}
+
+/**
+ * @brief   Reads an object from a ring waiting if it is empty.
+ * @note    The kernel is entered only if the ring is empty.
+ *
+ * @param[in] orp       pointer to a @p objects_ring_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The pointer to the object.
+ * @retval NULL         if the operation timed out.
+ *
+ * @api
+ */
+static inline void *_fifo_ring_get_timeout(objects_ring_t *orp,
+                                           sysinterval_t timeout) {
+  void *objp;
+
+  objp = _fifo_ring_get(orp);
+  if (objp == NULL) {
+    chSysLock();
+    objp = _fifo_ring_get_timeout_s(orp, timeout);
+    chSysUnlock();
+  }
+
+  return objp;
+}
+
+/**
+ * @brief   Resumes the ring reader, if waiting.
+ * @note    The kernel is entered only if the reader is waiting.
+ *
+ * @param[in] orp       pointer to a @p objects_ring_t structure
+ *
+ * @api
+ */
+static inline void _fifo_ring_wakeup(objects_ring_t *orp) {
+
+  if (orp->tr != NULL) {
+    chThdResume(&orp->tr, MSG_OK);
+  }
+}
+#endif /* CH_CFG_OBJ_FIFOS_SPSC == TRUE */
+
 /**
  * @brief   Initializes a FIFO object.
  * @pre     The messages size must be a multiple of the alignment
@@ -121,7 +330,7 @@ extern "C" {
  *                      to hold @p objn objects of @p objsize size with
  *                      @p objalign alignment
  * @param[in] msgbuf    pointer to the buffer of messages, it must be able
- *                      to hold @p objn messages
+ *                      to hold @p CH_FIFO_MSGBUF_SIZE(objn) messages
  *
  * @init
  */
@@ -131,9 +340,19 @@ static inline void chFifoObjectInitAligned(objects_fifo_t *ofp, size_t objsize,
 
   chDbgCheck((objsize >= objalign) && ((objsize % objalign) == 0U));
 
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   chGuardedPoolObjectInitAligned(&ofp->free, objsize, objalign);
   chGuardedPoolLoadArray(&ofp->free, objbuf, objn);
   chMBObjectInit(&ofp->mbx, msgbuf, objn);
+#else
+  _fifo_ring_init(&ofp->freering, msgbuf, objn);
+  _fifo_ring_init(&ofp->sentring, &msgbuf[objn], objn);
+  while (objn > (size_t)0) {
+    _fifo_ring_put(&ofp->freering, objbuf);
+    objbuf = (void *)((uint8_t *)objbuf + objsize);
+    objn--;
+  }
+#endif
 }
 
 /**
@@ -147,7 +366,7 @@ static inline void chFifoObjectInitAligned(objects_fifo_t *ofp, size_t objsize,
  * @param[in] objbuf    pointer to the buffer of objects, it must be able
  *                      to hold @p objn objects of @p objsize size
  * @param[in] msgbuf    pointer to the buffer of messages, it must be able
- *                      to hold @p objn messages
+ *                      to hold @p CH_FIFO_MSGBUF_SIZE(objn) messages
  *
  * @init
  */
@@ -171,7 +390,13 @@ static inline void chFifoObjectInit(objects_fifo_t *ofp, size_t objsize,
  */
 static inline void *chFifoTakeObjectI(objects_fifo_t *ofp) {
 
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   return chGuardedPoolAllocI(&ofp->free);
+#else
+  chDbgCheckClassI();
+
+  return _fifo_ring_get(&ofp->freering);
+#endif
 }
 
 /**
@@ -192,7 +417,11 @@ static inline void *chFifoTakeObjectI(objects_fifo_t *ofp) {
 static inline void *chFifoTakeObjectTimeoutS(objects_fifo_t *ofp,
                                              sysinterval_t timeout) {
 
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   return chGuardedPoolAllocTimeoutS(&ofp->free, timeout);
+#else
+  return _fifo_ring_get_timeout_s(&ofp->freering, timeout);
+#endif
 }
 
 /**
@@ -213,7 +442,11 @@ static inline void *chFifoTakeObjectTimeoutS(objects_fifo_t *ofp,
 static inline void *chFifoTakeObjectTimeout(objects_fifo_t *ofp,
                                             sysinterval_t timeout) {
 
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   return chGuardedPoolAllocTimeout(&ofp->free, timeout);
+#else
+  return _fifo_ring_get_timeout(&ofp->freering, timeout);
+#endif
 }
 
 /**
@@ -227,7 +460,12 @@ static inline void *chFifoTakeObjectTimeout(objects_fifo_t *ofp,
 static inline void chFifoReturnObjectI(objects_fifo_t *ofp,
                                        void *objp) {
 
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   chGuardedPoolFreeI(&ofp->free, objp);
+#else
+  _fifo_ring_put(&ofp->freering, objp);
+  chThdResumeI(&ofp->freering.tr, MSG_OK);
+#endif
 }
 
 /**
@@ -241,7 +479,12 @@ static inline void chFifoReturnObjectI(objects_fifo_t *ofp,
 static inline void chFifoReturnObjectS(objects_fifo_t *ofp,
                                        void *objp) {
 
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   chGuardedPoolFreeS(&ofp->free, objp);
+#else
+  _fifo_ring_put(&ofp->freering, objp);
+  chThdResumeS(&ofp->freering.tr, MSG_OK);
+#endif
 }
 
 /**
@@ -255,7 +498,12 @@ static inline void chFifoReturnObjectS(objects_fifo_t *ofp,
 static inline void chFifoReturnObject(objects_fifo_t *ofp,
                                       void *objp) {
 
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   chGuardedPoolFree(&ofp->free, objp);
+#else
+  _fifo_ring_put(&ofp->freering, objp);
+  _fifo_ring_wakeup(&ofp->freering);
+#endif
 }
 
 /**
@@ -269,10 +517,17 @@ static inline void chFifoReturnObject(objects_fifo_t *ofp,
  */
 static inline void chFifoSendObjectI(objects_fifo_t *ofp,
                                      void *objp) {
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   msg_t msg;
 
   msg = chMBPostI(&ofp->mbx, (msg_t)objp);
   chDbgAssert(msg == MSG_OK, "post failed");
+#else
+  chDbgCheckClassI();
+
+  _fifo_ring_put(&ofp->sentring, objp);
+  chThdResumeI(&ofp->sentring.tr, MSG_OK);
+#endif
 }
 
 /**
@@ -286,10 +541,15 @@ static inline void chFifoSendObjectI(objects_fifo_t *ofp,
  */
 static inline void chFifoSendObjectS(objects_fifo_t *ofp,
                                      void *objp) {
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   msg_t msg;
 
   msg = chMBPostTimeoutS(&ofp->mbx, (msg_t)objp, TIME_IMMEDIATE);
   chDbgAssert(msg == MSG_OK, "post failed");
+#else
+  _fifo_ring_put(&ofp->sentring, objp);
+  chThdResumeS(&ofp->sentring.tr, MSG_OK);
+#endif
 }
 
 /**
@@ -303,12 +563,18 @@ static inline void chFifoSendObjectS(objects_fifo_t *ofp,
  */
 static inline void chFifoSendObject(objects_fifo_t *ofp, void *objp) {
 
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   msg_t msg;
 
   msg = chMBPostTimeout(&ofp->mbx, (msg_t)objp, TIME_IMMEDIATE);
   chDbgAssert(msg == MSG_OK, "post failed");
+#else
+  _fifo_ring_put(&ofp->sentring, objp);
+  _fifo_ring_wakeup(&ofp->sentring);
+#endif
 }
 
+#if (CH_CFG_OBJ_FIFOS_SPSC == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Posts an high priority object.
  * @note    By design the object can be always immediately posted.
@@ -359,6 +625,7 @@ static inline void chFifoSendObjectAhead(objects_fifo_t *ofp, void *objp) {
   msg = chMBPostAheadTimeout(&ofp->mbx, (msg_t)objp, TIME_IMMEDIATE);
   chDbgAssert(msg == MSG_OK, "post failed");
 }
+#endif /* CH_CFG_OBJ_FIFOS_SPSC == FALSE */
 
 /**
  * @brief   Fetches an object.
@@ -374,7 +641,14 @@ static inline void chFifoSendObjectAhead(objects_fifo_t *ofp, void *objp) {
 static inline msg_t chFifoReceiveObjectI(objects_fifo_t *ofp,
                                          void **objpp) {
 
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   return chMBFetchI(&ofp->mbx, (msg_t *)objpp);
+#else
+  chDbgCheckClassI();
+
+  *objpp = _fifo_ring_get(&ofp->sentring);
+  return *objpp != NULL ? MSG_OK : MSG_TIMEOUT;
+#endif
 }
 
 /**
@@ -397,7 +671,12 @@ static inline msg_t chFifoReceiveObjectTimeoutS(objects_fifo_t *ofp,
                                                 void **objpp,
                                                 sysinterval_t timeout) {
 
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   return chMBFetchTimeoutS(&ofp->mbx, (msg_t *)objpp, timeout);
+#else
+  *objpp = _fifo_ring_get_timeout_s(&ofp->sentring, timeout);
+  return *objpp != NULL ? MSG_OK : MSG_TIMEOUT;
+#endif
 }
 
 /**
@@ -420,7 +699,12 @@ static inline msg_t chFifoReceiveObjectTimeout(objects_fifo_t *ofp,
                                                void **objpp,
                                                sysinterval_t timeout) {
 
+#if CH_CFG_OBJ_FIFOS_SPSC == FALSE
   return chMBFetchTimeout(&ofp->mbx, (msg_t *)objpp, timeout);
+#else
+  *objpp = _fifo_ring_get_timeout(&ofp->sentring, timeout);
+  return *objpp != NULL ? MSG_OK : MSG_TIMEOUT;
+#endif
 }
 
 #endif /* CH_CFG_USE_OBJ_FIFOS == TRUE */
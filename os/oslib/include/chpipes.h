@@ -38,10 +38,28 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Single producer single consumer pipes.
+ * @details If enabled the pipes are lock-free rings, the writer and the
+ *          reader only enter the kernel in order to wait on a full or empty
+ *          pipe or to wake up the peer.
+ * @note    The default is @p FALSE.
+ * @note    In this mode each pipe must have at most one writer and one
+ *          reader, also the I-class functions @p chPipeWriteI() and
+ *          @p chPipeReadI() become available.
+ */
+#if !defined(CH_CFG_PIPES_SPSC) || defined(__DOXYGEN__)
+#define CH_CFG_PIPES_SPSC                   FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_PIPES_SPSC == TRUE) && !defined(CH_OSLIB_MEMORY_BARRIER)
+#error "CH_CFG_PIPES_SPSC requires CH_OSLIB_MEMORY_BARRIER()"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -56,11 +74,20 @@ typedef struct {
                                                     after the buffer.       */
   uint8_t               *wrptr;         /**< @brief Write pointer.          */
   uint8_t               *rdptr;         /**< @brief Read pointer.           */
+#if (CH_CFG_PIPES_SPSC == FALSE) || defined(__DOXYGEN__)
   size_t                cnt;            /**< @brief Bytes in the pipe.      */
+#endif
+#if (CH_CFG_PIPES_SPSC == TRUE) || defined(__DOXYGEN__)
+  volatile size_t       wrcnt;          /**< @brief Bytes written, only
+                                                    updated by the writer.  */
+  volatile size_t       rdcnt;          /**< @brief Bytes read, only
+                                                    updated by the reader.  */
+#endif
   bool                  reset;          /**< @brief True if in reset state. */
   thread_reference_t    wtr;            /**< @brief Waiting writer.         */
   thread_reference_t    rtr;            /**< @brief Waiting reader.         */
-#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+#if CH_CFG_PIPES_SPSC == TRUE
+#elif (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   mutex_t               cmtx;           /**< @brief Common access mutex.    */
   mutex_t               wmtx;           /**< @brief Write access mutex.     */
   mutex_t               rmtx;           /**< @brief Read access mutex.      */
@@ -71,6 +98,19 @@ typedef struct {
 #endif
 } pipe_t;
 
+/**
+ * @brief   Structure describing a region of a pipe buffer.
+ * @details Because of the circular buffer, a region is made of up to two
+ *          contiguous spans, the second span is empty if the region does
+ *          not wrap around the buffer end.
+ */
+typedef struct {
+  uint8_t               *buf1;          /**< @brief First span start.       */
+  size_t                n1;             /**< @brief First span size.        */
+  uint8_t               *buf2;          /**< @brief Second span start.      */
+  size_t                n2;             /**< @brief Second span size.       */
+} pipe_span_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -84,7 +124,19 @@ typedef struct {
  * @param[in] buffer    pointer to the pipe buffer array of @p uint8_t
  * @param[in] size      number of @p uint8_t elements in the buffer array
  */
-#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+#if (CH_CFG_PIPES_SPSC == TRUE) || defined(__DOXYGEN__)
+#define _PIPE_DATA(name, buffer, size) {                                    \
+  (uint8_t *)(buffer),                                                      \
+  (uint8_t *)(buffer) + size,                                               \
+  (uint8_t *)(buffer),                                                      \
+  (uint8_t *)(buffer),                                                      \
+  (size_t)0,                                                                \
+  (size_t)0,                                                                \
+  false,                                                                    \
+  NULL,                                                                     \
+  NULL,                                                                     \
+}
+#elif CH_CFG_USE_MUTEXES == TRUE
 #define _PIPE_DATA(name, buffer, size) {                                    \
   (uint8_t *)(buffer),                                                      \
   (uint8_t *)(buffer) + size,                                               \
@@ -139,6 +191,16 @@ extern "C" {
                             size_t n, sysinterval_t timeout);
   size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
                            size_t n, sysinterval_t timeout);
+  size_t chPipeWriteReserve(pipe_t *pp, size_t n, pipe_span_t *spp,
+                            sysinterval_t timeout);
+  void chPipeWriteCommit(pipe_t *pp, size_t n);
+  size_t chPipeReadPeek(pipe_t *pp, size_t n, pipe_span_t *spp,
+                        sysinterval_t timeout);
+  void chPipeReadConsume(pipe_t *pp, size_t n);
+#if CH_CFG_PIPES_SPSC == TRUE
+  size_t chPipeWriteI(pipe_t *pp, const uint8_t *bp, size_t n);
+  size_t chPipeReadI(pipe_t *pp, uint8_t *bp, size_t n);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -173,7 +235,11 @@ static inline size_t chPipeGetSize(const pipe_t *pp) {
  */
 static inline size_t chPipeGetUsedCount(const pipe_t *pp) {
 
+#if CH_CFG_PIPES_SPSC == FALSE
   return pp->cnt;
+#else
+  return pp->wrcnt - pp->rdcnt;
+#endif
 }
 
 /**
@@ -31,6 +31,10 @@
  *          Allocated OS objects are handled using a reference counter, only
  *          when all references have been released then the object memory is
  *          freed in a pool.<br>
+ *          Objects are found by name scanning the objects lists, if the
+ *          option @p CH_CFG_FACTORY_HASH_SIZE is greater than zero then
+ *          the lists are hashed by name and lookups take constant time
+ *          on average.<br>
  * @pre     This subsystem requires the @p CH_CFG_USE_MEMCORE and
  *          @p CH_CFG_USE_MEMPOOLS options to be set to @p TRUE. The
  *          option @p CH_CFG_USE_HEAP is also required if the support
@@ -83,11 +87,18 @@ objects_factory_t ch_factory;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_FACTORY_HASH_SIZE == 0) || defined(__DOXYGEN__)
 static inline void dyn_list_init(dyn_list_t *dlp) {
 
   dlp->next = (dyn_element_t *)dlp;
 }
 
+static inline void dyn_list_link(dyn_element_t *element, dyn_list_t *dlp) {
+
+  element->next = dlp->next;
+  dlp->next = element;
+}
+
 static dyn_element_t *dyn_list_find(const char *name, dyn_list_t *dlp) {
   dyn_element_t *p = dlp->next;
 
@@ -120,6 +131,85 @@ static dyn_element_t *dyn_list_unlink(dyn_element_t *element,
   return NULL;
 }
 
+#else /* CH_CFG_FACTORY_HASH_SIZE > 0 */
+static unsigned dyn_hash_name(const char *name) {
+  uint32_t h = 2166136261U;
+  size_t i = 0U;
+
+  /* FNV-1a hash over the significant part of the name.*/
+  while ((i < (size_t)CH_CFG_FACTORY_MAX_NAMES_LENGTH) && (name[i] != '\0')) {
+    h ^= (uint32_t)(uint8_t)name[i];
+    h *= 16777619U;
+    i++;
+  }
+
+  return (unsigned)(h & ((uint32_t)CH_CFG_FACTORY_HASH_SIZE - 1U));
+}
+
+static inline void dyn_list_init(dyn_list_t *dlp) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)CH_CFG_FACTORY_HASH_SIZE; i++) {
+    dlp->buckets[i] = NULL;
+  }
+}
+
+static inline void dyn_list_link(dyn_element_t *element, dyn_list_t *dlp) {
+  dyn_element_t **bpp = &dlp->buckets[dyn_hash_name(element->name)];
+
+  element->next = *bpp;
+  *bpp = element;
+}
+
+static dyn_element_t *dyn_list_find(const char *name, dyn_list_t *dlp) {
+  dyn_element_t *p = dlp->buckets[dyn_hash_name(name)];
+
+  while (p != NULL) {
+    if (strncmp(p->name, name, CH_CFG_FACTORY_MAX_NAMES_LENGTH) == 0) {
+      return p;
+    }
+    p = p->next;
+  }
+
+  return NULL;
+}
+
+static dyn_element_t *dyn_list_unlink(dyn_element_t *element,
+                                      dyn_list_t *dlp) {
+  dyn_element_t **pp = &dlp->buckets[dyn_hash_name(element->name)];
+
+  /* Scanning the bucket.*/
+  while (*pp != NULL) {
+    if (*pp == element) {
+      /* Found.*/
+      *pp = element->next;
+      return element;
+    }
+
+    /* Next element in the bucket.*/
+    pp = &(*pp)->next;
+  }
+
+  return NULL;
+}
+
+#if (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) || defined(__DOXYGEN__)
+static registered_object_t **obj_ptr_bucket(void *objp) {
+  uint32_t h;
+
+  /*lint -save -e923 [11.6] Pointer converted to integer for hashing.*/
+  h = (uint32_t)((uintptr_t)objp >> 2);
+  /*lint -restore*/
+  h ^= h >> 16;
+  h *= 0x45D9F3BU;
+  h ^= h >> 16;
+  h &= (uint32_t)CH_CFG_FACTORY_HASH_SIZE - 1U;
+
+  return &ch_factory.obj_ptr_buckets[h];
+}
+#endif
+#endif /* CH_CFG_FACTORY_HASH_SIZE > 0 */
+
 #if CH_FACTORY_REQUIRES_HEAP || defined(__DOXYGEN__)
 static dyn_element_t *dyn_create_object_heap(const char *name,
                                              dyn_list_t *dlp,
@@ -146,10 +236,9 @@ static dyn_element_t *dyn_create_object_heap(const char *name,
   strncpy(dep->name, name, CH_CFG_FACTORY_MAX_NAMES_LENGTH);
   /*lint -restore*/
   dep->refs = (ucnt_t)1;
-  dep->next = dlp->next;
 
   /* Updating factory list.*/
-  dlp->next = dep;
+  dyn_list_link(dep, dlp);
 
   return dep;
 }
@@ -194,10 +283,9 @@ static dyn_element_t *dyn_create_object_pool(const char *name,
   strncpy(dep->name, name, CH_CFG_FACTORY_MAX_NAMES_LENGTH);
   /*lint -restore*/
   dep->refs = (ucnt_t)1;
-  dep->next = dlp->next;
 
   /* Updating factory list.*/
-  dlp->next = (dyn_element_t *)dep;
+  dyn_list_link(dep, dlp);
 
   return dep;
 }
@@ -254,6 +342,15 @@ void _factory_init(void) {
   chPoolObjectInit(&ch_factory.obj_pool,
                    sizeof (registered_object_t),
                    chCoreAllocAlignedI);
+#if CH_CFG_FACTORY_HASH_SIZE > 0
+  {
+    unsigned i;
+
+    for (i = 0U; i < (unsigned)CH_CFG_FACTORY_HASH_SIZE; i++) {
+      ch_factory.obj_ptr_buckets[i] = NULL;
+    }
+  }
+#endif
 #endif
 #if CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE
   dyn_list_init(&ch_factory.buf_list);
@@ -302,6 +399,15 @@ registered_object_t *chFactoryRegisterObject(const char *name,
   if (rop != NULL) {
     /* Initializing registered object data.*/
     rop->objp = objp;
+#if CH_CFG_FACTORY_HASH_SIZE > 0
+    {
+      registered_object_t **bpp = obj_ptr_bucket(objp);
+
+      /* Adding the object to the pointers index.*/
+      rop->pnext = *bpp;
+      *bpp = rop;
+    }
+#endif
   }
 
   F_UNLOCK();
@@ -348,6 +454,24 @@ registered_object_t *chFactoryFindObject(const char *name) {
  * @api
  */
 registered_object_t *chFactoryFindObjectByPointer(void *objp) {
+#if CH_CFG_FACTORY_HASH_SIZE > 0
+  registered_object_t *rop;
+
+  F_LOCK();
+
+  rop = *obj_ptr_bucket(objp);
+  while (rop != NULL) {
+    if (rop->objp == objp) {
+      rop->element.refs++;
+      break;
+    }
+    rop = rop->pnext;
+  }
+
+  F_UNLOCK();
+
+  return rop;
+#else
   registered_object_t *rop = (registered_object_t *)ch_factory.obj_list.next;
 
   F_LOCK();
@@ -366,6 +490,7 @@ registered_object_t *chFactoryFindObjectByPointer(void *objp) {
   F_UNLOCK();
 
   return NULL;
+#endif
 }
 
 /**
@@ -384,6 +509,19 @@ void chFactoryReleaseObject(registered_object_t *rop) {
 
   F_LOCK();
 
+#if CH_CFG_FACTORY_HASH_SIZE > 0
+  if (rop->element.refs == (ucnt_t)1) {
+    registered_object_t **pp = obj_ptr_bucket(rop->objp);
+
+    /* Last reference, removing the object from the pointers index.*/
+    while (*pp != rop) {
+      chDbgAssert(*pp != NULL, "not in index");
+      pp = &(*pp)->pnext;
+    }
+    *pp = rop->pnext;
+  }
+#endif
+
   dyn_release_object_pool(&rop->element,
                           &ch_factory.obj_list,
                           &ch_factory.obj_pool);
@@ -415,7 +553,7 @@ dyn_buffer_t *chFactoryCreateBuffer(const char *name, size_t size) {
 
   dbp = (dyn_buffer_t *)dyn_create_object_heap(name,
                                                &ch_factory.buf_list,
-                                               size);
+                                               sizeof (dyn_buffer_t) + size);
   if (dbp != NULL) {
     /* Initializing buffer object data.*/
     memset((void *)(dbp + 1), 0, size);
@@ -663,14 +801,16 @@ dyn_objects_fifo_t *chFactoryCreateObjectsFIFO(const char *name,
   dofp = (dyn_objects_fifo_t *)dyn_create_object_heap(name,
                                                       &ch_factory.fifo_list,
                                                       sizeof (dyn_objects_fifo_t) +
-                                                      (objn * sizeof (msg_t)) +
+                                                      (CH_FIFO_MSGBUF_SIZE(objn) *
+                                                       sizeof (msg_t)) +
                                                       (objn * objsize));
   if (dofp != NULL) {
     msg_t *msgbuf = (msg_t *)(dofp + 1);
 
     /* Initializing mailbox object data.*/
     chFifoObjectInitAligned(&dofp->fifo, objsize, objn, objalign,
-                            (void *)&msgbuf[objn], msgbuf);
+                            (void *)&msgbuf[CH_FIFO_MSGBUF_SIZE(objn)],
+                            msgbuf);
   }
 
   F_UNLOCK();
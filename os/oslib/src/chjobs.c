@@ -0,0 +1,523 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/src/chjobs.c
+ * @brief   Jobs pools code.
+ * @details Jobs pools.
+ *          <h2>Operation mode</h2>
+ *          A jobs pool is a set of worker threads, each worker owns a
+ *          deque of jobs for each priority level:
+ *          - Jobs posted by a worker from thread context are pushed on
+ *            the bottom of its own deques, the worker executes them in
+ *            LIFO order while the data they touch is still hot.
+ *          - Jobs posted by other threads and all the jobs posted using
+ *            the I-class functions are distributed among the workers in
+ *            round-robin order and pushed on the top of the deques, they
+ *            are executed in FIFO order. The current thread is not
+ *            meaningful in ISR context so it is never used by I-class
+ *            posts.
+ *          - An idle worker steals jobs from the top of the deques of
+ *            the other workers.
+ *          .
+ *          The highest priority job available in the whole pool is always
+ *          executed first.
+ * @pre     In order to use the jobs pools APIs the @p CH_CFG_USE_JOBS and
+ *          @p CH_CFG_USE_JOBS_POOLS options must be enabled in
+ *          @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ *
+ * @addtogroup oslib_jobs_queues
+ * @{
+ */
+
+#include "ch.h"
+
+#if ((CH_CFG_USE_JOBS == TRUE) && (CH_CFG_USE_JOBS_POOLS == TRUE)) ||       \
+    defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Pushes a job on the bottom of a worker deque.
+ *
+ * @param[in] jwp       pointer to a @p jobs_worker_t structure
+ * @param[in] jp        pointer to the job object
+ *
+ * @notapi
+ */
+static void jobs_push_bottom(jobs_worker_t *jwp, job_descriptor_t *jp) {
+  unsigned prio = jp->jobprio;
+
+  jp->prev = NULL;
+  jp->next = jwp->bottom[prio];
+  if (jp->next != NULL) {
+    jp->next->prev = jp;
+  }
+  else {
+    jwp->top[prio] = jp;
+  }
+  jwp->bottom[prio] = jp;
+  jwp->depth++;
+}
+
+/**
+ * @brief   Pushes a job on the top of a worker deque.
+ *
+ * @param[in] jwp       pointer to a @p jobs_worker_t structure
+ * @param[in] jp        pointer to the job object
+ *
+ * @notapi
+ */
+static void jobs_push_top(jobs_worker_t *jwp, job_descriptor_t *jp) {
+  unsigned prio = jp->jobprio;
+
+  jp->next = NULL;
+  jp->prev = jwp->top[prio];
+  if (jp->prev != NULL) {
+    jp->prev->next = jp;
+  }
+  else {
+    jwp->bottom[prio] = jp;
+  }
+  jwp->top[prio] = jp;
+  jwp->depth++;
+}
+
+/**
+ * @brief   Pops a job from the bottom of a worker deque.
+ *
+ * @param[in] jwp       pointer to a @p jobs_worker_t structure
+ * @param[in] prio      priority of the deque
+ * @return              The pointer to the job object.
+ * @retval NULL         if the deque is empty.
+ *
+ * @notapi
+ */
+static job_descriptor_t *jobs_pop_bottom(jobs_worker_t *jwp, unsigned prio) {
+  job_descriptor_t *jp = jwp->bottom[prio];
+
+  if (jp != NULL) {
+    jwp->bottom[prio] = jp->next;
+    if (jp->next != NULL) {
+      jp->next->prev = NULL;
+    }
+    else {
+      jwp->top[prio] = NULL;
+    }
+    jwp->depth--;
+  }
+
+  return jp;
+}
+
+/**
+ * @brief   Pops a job from the top of a worker deque.
+ *
+ * @param[in] jwp       pointer to a @p jobs_worker_t structure
+ * @param[in] prio      priority of the deque
+ * @return              The pointer to the job object.
+ * @retval NULL         if the deque is empty.
+ *
+ * @notapi
+ */
+static job_descriptor_t *jobs_pop_top(jobs_worker_t *jwp, unsigned prio) {
+  job_descriptor_t *jp = jwp->top[prio];
+
+  if (jp != NULL) {
+    jwp->top[prio] = jp->prev;
+    if (jp->prev != NULL) {
+      jp->prev->next = NULL;
+    }
+    else {
+      jwp->bottom[prio] = NULL;
+    }
+    jwp->depth--;
+  }
+
+  return jp;
+}
+
+/**
+ * @brief   Fetches the highest priority job available to a worker.
+ * @details The worker own deque is checked first, then the deques of the
+ *          other workers starting from the next one.
+ *
+ * @param[in] jwp       pointer to a @p jobs_worker_t structure
+ * @return              The pointer to the job object.
+ * @retval NULL         if there are no jobs in the pool.
+ *
+ * @notapi
+ */
+static job_descriptor_t *jobs_fetch(jobs_worker_t *jwp) {
+  jobs_pool_t *jpp = jwp->pool;
+  unsigned prio = (unsigned)CH_CFG_JOBS_PRIORITIES;
+
+  while (prio > 0U) {
+    jobs_worker_t *vp = jwp;
+    job_descriptor_t *jp;
+    size_t i;
+
+    prio--;
+
+    jp = jobs_pop_bottom(jwp, prio);
+    if (jp != NULL) {
+      return jp;
+    }
+
+    /* Trying to steal a job of the same priority.*/
+    for (i = 1U; i < jpp->n; i++) {
+      vp++;
+      if (vp >= &jpp->workers[jpp->n]) {
+        vp = &jpp->workers[0];
+      }
+
+      jp = jobs_pop_top(vp, prio);
+      if (jp != NULL) {
+        jwp->steals++;
+        return jp;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Posts a job to a jobs pool.
+ *
+ * @param[in] jpp       pointer to a @p jobs_pool_t structure
+ * @param[in] jp        pointer to the job object to be posted
+ * @param[in] tp        posting thread or @p NULL if the job is posted from
+ *                      an I-class function
+ *
+ * @notapi
+ */
+static void jobs_post(jobs_pool_t *jpp, job_descriptor_t *jp, thread_t *tp) {
+  jobs_worker_t *jwp;
+  size_t i;
+
+  chDbgCheck(jp != NULL);
+  chDbgAssert(jp->jobprio < (unsigned)CH_CFG_JOBS_PRIORITIES,
+              "invalid priority");
+
+  jp->time = chVTGetSystemTimeX();
+  jpp->posted++;
+
+  /* Jobs posted by a worker go in its own deque.*/
+  jwp = NULL;
+  for (i = 0U; (tp != NULL) && (i < jpp->n); i++) {
+    if (jpp->workers[i].thread == tp) {
+      jwp = &jpp->workers[i];
+      jobs_push_bottom(jwp, jp);
+      break;
+    }
+  }
+
+  /* External jobs are distributed among the workers.*/
+  if (jwp == NULL) {
+    jwp = &jpp->workers[jpp->next];
+    if (++jpp->next >= jpp->n) {
+      jpp->next = 0U;
+    }
+    jobs_push_top(jwp, jp);
+  }
+
+  /* Waking up the deque owner if idle, else any idle worker, it will
+     steal the job.*/
+  if (jwp->tr == NULL) {
+    for (i = 0U; i < jpp->n; i++) {
+      if (jpp->workers[i].tr != NULL) {
+        jwp = &jpp->workers[i];
+        break;
+      }
+    }
+  }
+  chThdResumeI(&jwp->tr, MSG_OK);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a jobs pool object.
+ *
+ * @param[out] jpp      pointer to a @p jobs_pool_t structure
+ * @param[in] jobsn     number of jobs available
+ * @param[in] jobsbuf   pointer to the buffer of jobs, it must be able
+ *                      to hold @p jobsn @p job_descriptor_t structures
+ * @param[in] n         number of workers
+ * @param[in] workers   pointer to an array of @p n @p jobs_worker_t
+ *                      structures, one for each worker thread
+ *
+ * @init
+ */
+void chJobPoolObjectInit(jobs_pool_t *jpp,
+                         size_t jobsn, job_descriptor_t *jobsbuf,
+                         size_t n, jobs_worker_t *workers) {
+  size_t i;
+
+  chDbgCheck((jpp != NULL) && (jobsn > 0U) && (jobsbuf != NULL) &&
+             (n > 0U) && (workers != NULL));
+
+  chGuardedPoolObjectInit(&jpp->free, sizeof (job_descriptor_t));
+  chGuardedPoolLoadArray(&jpp->free, (void *)jobsbuf, jobsn);
+  jpp->workers    = workers;
+  jpp->n          = n;
+  jpp->next       = 0U;
+  jpp->posted     = (ucnt_t)0;
+  jpp->worst      = (sysinterval_t)0;
+  jpp->cumulative = (uint64_t)0;
+
+  for (i = 0U; i < n; i++) {
+    unsigned prio;
+
+    workers[i].pool     = jpp;
+    workers[i].thread   = NULL;
+    workers[i].tr       = NULL;
+    workers[i].depth    = (size_t)0;
+    workers[i].executed = (ucnt_t)0;
+    workers[i].steals   = (ucnt_t)0;
+    for (prio = 0U; prio < (unsigned)CH_CFG_JOBS_PRIORITIES; prio++) {
+      workers[i].bottom[prio] = NULL;
+      workers[i].top[prio]    = NULL;
+    }
+  }
+}
+
+/**
+ * @brief   Posts a job object to a jobs pool.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jpp       pointer to a @p jobs_pool_t structure
+ * @param[in] jp        pointer to the job object to be posted
+ *
+ * @iclass
+ */
+void chJobPoolPostI(jobs_pool_t *jpp, job_descriptor_t *jp) {
+
+  chDbgCheckClassI();
+
+  jobs_post(jpp, jp, NULL);
+}
+
+/**
+ * @brief   Posts a job object to a jobs pool.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jpp       pointer to a @p jobs_pool_t structure
+ * @param[in] jp        pointer to the job object to be posted
+ *
+ * @sclass
+ */
+void chJobPoolPostS(jobs_pool_t *jpp, job_descriptor_t *jp) {
+
+  chDbgCheckClassS();
+
+  jobs_post(jpp, jp, chThdGetSelfX());
+  chSchRescheduleS();
+}
+
+/**
+ * @brief   Posts a job object to a jobs pool.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jpp       pointer to a @p jobs_pool_t structure
+ * @param[in] jp        pointer to the job object to be posted
+ *
+ * @api
+ */
+void chJobPoolPost(jobs_pool_t *jpp, job_descriptor_t *jp) {
+
+  chSysLock();
+  chJobPoolPostS(jpp, jp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Posts an array of job objects to a jobs pool.
+ *
+ * @param[in] jpp       pointer to a @p jobs_pool_t structure
+ * @param[in] jps       array of pointers to the job objects to be posted
+ * @param[in] n         number of job objects
+ *
+ * @iclass
+ */
+void chJobPoolPostBatchI(jobs_pool_t *jpp,
+                         job_descriptor_t * const *jps, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck((jps != NULL) || (n == 0U));
+
+  while (n > 0U) {
+    jobs_post(jpp, *jps, NULL);
+    jps++;
+    n--;
+  }
+}
+
+/**
+ * @brief   Posts an array of job objects to a jobs pool.
+ * @details All the jobs are posted within a single critical zone.
+ *
+ * @param[in] jpp       pointer to a @p jobs_pool_t structure
+ * @param[in] jps       array of pointers to the job objects to be posted
+ * @param[in] n         number of job objects
+ *
+ * @api
+ */
+void chJobPoolPostBatch(jobs_pool_t *jpp,
+                        job_descriptor_t * const *jps, size_t n) {
+  thread_t *tp = chThdGetSelfX();
+
+  chDbgCheck((jps != NULL) || (n == 0U));
+
+  chSysLock();
+  while (n > 0U) {
+    jobs_post(jpp, *jps, tp);
+    jps++;
+    n--;
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Waits for a job from a jobs pool then executes it.
+ * @details The worker executes the highest priority job available, its
+ *          own deque is checked first then jobs are stolen from the deques
+ *          of the other workers.
+ * @note    The timeout is restarted if the worker is woken up but the
+ *          job is taken by another worker.
+ *
+ * @param[in] jwp       pointer to the @p jobs_worker_t structure of the
+ *                      calling worker thread
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The function outcome.
+ * @retval MSG_OK       if a job has been executed.
+ * @retval MSG_TIMEOUT  if a timeout occurred.
+ * @retval MSG_JOB_NULL if a @p JOB_NULL has been received.
+ *
+ * @api
+ */
+msg_t chJobPoolDispatchTimeout(jobs_worker_t *jwp, sysinterval_t timeout) {
+  jobs_pool_t *jpp = jwp->pool;
+  job_descriptor_t *jp;
+  sysinterval_t latency;
+
+  chSysLock();
+
+  /* The worker thread is identified by posts from within jobs.*/
+  jwp->thread = chThdGetSelfX();
+
+  /* Waiting for a job or a timeout.*/
+  jp = jobs_fetch(jwp);
+  while (jp == NULL) {
+    msg_t msg;
+
+    msg = chThdSuspendTimeoutS(&jwp->tr, timeout);
+    if (msg != MSG_OK) {
+      chSysUnlock();
+
+      return msg;
+    }
+    jp = jobs_fetch(jwp);
+  }
+
+  /* Latency statistics.*/
+  latency = chTimeDiffX(jp->time, chVTGetSystemTimeX());
+  if (latency > jpp->worst) {
+    jpp->worst = latency;
+  }
+  jpp->cumulative += (uint64_t)latency;
+
+  chSysUnlock();
+
+  if (jp->jobfunc == NULL) {
+    chGuardedPoolFree(&jpp->free, (void *)jp);
+
+    return MSG_JOB_NULL;
+  }
+
+  /* Invoking the job function.*/
+  jp->jobfunc(jp->jobarg);
+
+  /* Returning the job descriptor object.*/
+  chSysLock();
+  jwp->executed++;
+  chGuardedPoolFreeS(&jpp->free, (void *)jp);
+  chSysUnlock();
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Returns a snapshot of the jobs pool statistics.
+ *
+ * @param[in] jpp       pointer to a @p jobs_pool_t structure
+ * @param[out] jpsp     pointer to a @p jobs_pool_stats_t structure
+ *
+ * @api
+ */
+void chJobPoolGetStats(jobs_pool_t *jpp, jobs_pool_stats_t *jpsp) {
+  size_t i;
+
+  chDbgCheck((jpp != NULL) && (jpsp != NULL));
+
+  chSysLock();
+  jpsp->depth      = (size_t)0;
+  jpsp->posted     = jpp->posted;
+  jpsp->executed   = (ucnt_t)0;
+  jpsp->steals     = (ucnt_t)0;
+  jpsp->worst      = jpp->worst;
+  jpsp->cumulative = jpp->cumulative;
+  for (i = 0U; i < jpp->n; i++) {
+    jpsp->depth    += jpp->workers[i].depth;
+    jpsp->executed += jpp->workers[i].executed;
+    jpsp->steals   += jpp->workers[i].steals;
+  }
+  chSysUnlock();
+}
+
+#endif /* (CH_CFG_USE_JOBS == TRUE) && (CH_CFG_USE_JOBS_POOLS == TRUE) */
+
+/** @} */
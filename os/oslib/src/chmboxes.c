@@ -54,6 +54,15 @@
 
 #if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
 
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/* Kernels without objects tracing support.*/
+#if !defined(CH_TRACE_TYPE_OBJECT)
+#define _trace_object(op, objp, arg)
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -210,6 +219,7 @@ msg_t chMBPostTimeoutS(mailbox_t *mbp, msg_t msg, sysinterval_t timeout) {
         mbp->wrptr = mbp->buffer;
       }
       mbp->cnt++;
+      _trace_object(CH_TRACE_OP_MB_POST, mbp, (uintptr_t)msg);
 
       /* If there is a reader waiting then makes it ready.*/
       chThdDequeueNextI(&mbp->qr, MSG_OK);
@@ -257,6 +267,7 @@ msg_t chMBPostI(mailbox_t *mbp, msg_t msg) {
       mbp->wrptr = mbp->buffer;
     }
     mbp->cnt++;
+    _trace_object(CH_TRACE_OP_MB_POST, mbp, (uintptr_t)msg);
 
     /* If there is a reader waiting then makes it ready.*/
     chThdDequeueNextI(&mbp->qr, MSG_OK);
@@ -335,6 +346,7 @@ msg_t chMBPostAheadTimeoutS(mailbox_t *mbp, msg_t msg, sysinterval_t timeout) {
       }
       *mbp->rdptr = msg;
       mbp->cnt++;
+      _trace_object(CH_TRACE_OP_MB_POST, mbp, (uintptr_t)msg);
 
       /* If there is a reader waiting then makes it ready.*/
       chThdDequeueNextI(&mbp->qr, MSG_OK);
@@ -382,6 +394,7 @@ msg_t chMBPostAheadI(mailbox_t *mbp, msg_t msg) {
     }
     *mbp->rdptr = msg;
     mbp->cnt++;
+    _trace_object(CH_TRACE_OP_MB_POST, mbp, (uintptr_t)msg);
 
     /* If there is a reader waiting then makes it ready.*/
     chThdDequeueNextI(&mbp->qr, MSG_OK);
@@ -460,6 +473,7 @@ msg_t chMBFetchTimeoutS(mailbox_t *mbp, msg_t *msgp, sysinterval_t timeout) {
         mbp->rdptr = mbp->buffer;
       }
       mbp->cnt--;
+      _trace_object(CH_TRACE_OP_MB_FETCH, mbp, (uintptr_t)*msgp);
 
       /* If there is a writer waiting then makes it ready.*/
       chThdDequeueNextI(&mbp->qw, MSG_OK);
@@ -507,6 +521,7 @@ msg_t chMBFetchI(mailbox_t *mbp, msg_t *msgp) {
       mbp->rdptr = mbp->buffer;
     }
     mbp->cnt--;
+    _trace_object(CH_TRACE_OP_MB_FETCH, mbp, (uintptr_t)*msgp);
 
     /* If there is a writer waiting then makes it ready.*/
     chThdDequeueNextI(&mbp->qw, MSG_OK);
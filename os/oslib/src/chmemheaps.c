@@ -29,6 +29,11 @@
  *          library functions. The main difference is that the OS heap APIs
  *          are guaranteed to be thread safe and there is the ability to
  *          return memory blocks aligned to arbitrary powers of two.<br>
+ *          If the @p CH_CFG_USE_HEAP_TLSF option is enabled then the
+ *          allocator uses a two levels segregated-fit strategy instead,
+ *          free blocks are kept in per-size-class lists indexed by bitmaps
+ *          and allocation and release do not depend on the number of
+ *          fragments in the heap.<br>
  * @pre     In order to use the heap APIs the @p CH_CFG_USE_HEAP option must
  *          be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -54,6 +59,7 @@
 #define H_UNLOCK(h)     chSemSignal(&(h)->sem)
 #endif
 
+#if (CH_CFG_USE_HEAP_TLSF == FALSE) || defined(__DOXYGEN__)
 #define H_BLOCK(hp)     ((hp) + 1U)
 
 #define H_LIMIT(hp)     (H_BLOCK(hp) + H_PAGES(hp))
@@ -74,6 +80,50 @@
   ((size_t)((p1) - (p2)))                                                   \
   /*lint -restore*/
 
+#else /* CH_CFG_USE_HEAP_TLSF == TRUE */
+#define H_BLOCK(hp)     ((hp) + 1U)
+
+#define H_LIMIT(hp)                                                         \
+  ((heap_header_t *)(void *)((uint8_t *)H_BLOCK(hp) +                       \
+                             (H_PAGES(hp) * CH_HEAP_ALIGNMENT)))
+
+#define H_PREV(hp)      ((hp)->used.prev)
+
+#define H_PAGES(hp)     ((hp)->used.pages)
+
+#define H_HEAP(hp)      ((hp)->used.heap)
+
+#define H_SIZE(hp)      ((hp)->used.size)
+
+#define H_LINKS(hp)     ((heap_links_t *)(void *)H_BLOCK(hp))
+
+/*
+ * Size of a block header in pages.
+ */
+#define H_HDR_PAGES     (sizeof (heap_header_t) / CH_HEAP_ALIGNMENT)
+
+/*
+ * Minimum size of a block in pages, it must be able to contain the free
+ * list links.
+ */
+#define H_LINK_PAGES                                                        \
+  (MEM_ALIGN_NEXT(sizeof (heap_links_t), CH_HEAP_ALIGNMENT) /               \
+   CH_HEAP_ALIGNMENT)
+
+/*
+ * Minimum size of a free fragment in pages, header included.
+ */
+#define H_MIN_PAGES     (H_HDR_PAGES + H_LINK_PAGES)
+
+/*
+ * Number of pages between two pointers in a MISRA-compatible way.
+ */
+#define NPAGES(p1, p2)                                                      \
+  /*lint -save -e9033 [10.8] The cast is safe.*/                            \
+  ((size_t)((uint8_t *)(p1) - (uint8_t *)(p2)) / CH_HEAP_ALIGNMENT)         \
+  /*lint -restore*/
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -82,6 +132,16 @@
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Free list links stored in the area of a free block.
+ */
+typedef struct {
+  heap_header_t         *next;      /**< @brief Next block in the list.     */
+  heap_header_t         *prev;      /**< @brief Previous block in the list. */
+} heap_links_t;
+#endif
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
@@ -95,6 +155,270 @@ static memory_heap_t default_heap;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the position of the most significant bit set in a size.
+ * @pre     The size must not be zero.
+ *
+ * @param[in] n         the size to be scanned
+ * @return              The bit position.
+ *
+ * @notapi
+ */
+static inline unsigned heap_msb(size_t n) {
+
+#if defined(__GNUC__)
+  return ((unsigned)sizeof (unsigned long) * 8U) - 1U -
+         (unsigned)__builtin_clzl((unsigned long)n);
+#else
+  unsigned i = 0U;
+
+  while ((n >>= 1) != 0U) {
+    i++;
+  }
+
+  return i;
+#endif
+}
+
+/**
+ * @brief   Returns the position of the least significant bit set in a word.
+ * @pre     The word must not be zero.
+ *
+ * @param[in] w         the word to be scanned
+ * @return              The bit position, from 0 to 31.
+ *
+ * @notapi
+ */
+static inline unsigned heap_lsb(uint32_t w) {
+
+#if defined(__GNUC__)
+  return (unsigned)__builtin_ctzl((unsigned long)w);
+#else
+  unsigned i = 0U;
+
+  while ((w & 1U) == 0U) {
+    w >>= 1;
+    i++;
+  }
+
+  return i;
+#endif
+}
+
+/**
+ * @brief   Initializes the free lists of a heap.
+ *
+ * @param[out] heapp    pointer to the heap
+ *
+ * @notapi
+ */
+static void heap_lists_init(memory_heap_t *heapp) {
+  unsigned fl, sl;
+
+  heapp->flmap = 0U;
+  for (fl = 0U; fl < (unsigned)CH_CFG_HEAP_TLSF_LEVELS; fl++) {
+    heapp->slmap[fl] = 0U;
+    for (sl = 0U; sl < CH_HEAP_TLSF_SL_COUNT; sl++) {
+      heapp->lists[fl][sl] = NULL;
+    }
+  }
+}
+
+/**
+ * @brief   Writes the end sentinel of a memory area.
+ * @details The sentinel is an empty block marked as used, it stops the
+ *          merging of free blocks at the area boundary.
+ *
+ * @param[in] heapp     pointer to the heap
+ * @param[in] hp        pointer to the last block of the area
+ *
+ * @notapi
+ */
+static void heap_area_end(memory_heap_t *heapp, heap_header_t *hp) {
+  heap_header_t *ep = H_LIMIT(hp);
+
+  H_PREV(ep) = hp;
+  H_PAGES(ep) = 0U;
+  H_HEAP(ep) = heapp;
+  H_SIZE(ep) = 0U;
+}
+
+/**
+ * @brief   Size class of a free block.
+ * @details Sizes below @p CH_HEAP_TLSF_SL_COUNT pages have a class each,
+ *          larger sizes are classified by their most significant bit and
+ *          by the following @p CH_HEAP_TLSF_SL_BITS bits.
+ *
+ * @param[in] pages     the block size in pages
+ * @param[out] flp      first level index
+ * @param[out] slp      second level index
+ *
+ * @notapi
+ */
+static void heap_mapping(size_t pages, unsigned *flp, unsigned *slp) {
+
+  if (pages < (size_t)CH_HEAP_TLSF_SL_COUNT) {
+    *flp = 0U;
+    *slp = (unsigned)pages;
+  }
+  else {
+    unsigned msb = heap_msb(pages);
+
+    *flp = (msb - CH_HEAP_TLSF_SL_BITS) + 1U;
+    *slp = (unsigned)(pages >> (msb - CH_HEAP_TLSF_SL_BITS)) -
+           CH_HEAP_TLSF_SL_COUNT;
+
+    /* Blocks exceeding the largest class are kept in the last list.*/
+    if (*flp >= (unsigned)CH_CFG_HEAP_TLSF_LEVELS) {
+      *flp = (unsigned)CH_CFG_HEAP_TLSF_LEVELS - 1U;
+      *slp = CH_HEAP_TLSF_SL_COUNT - 1U;
+    }
+  }
+}
+
+/**
+ * @brief   Inserts a free block in the list of its class.
+ *
+ * @param[in] heapp     pointer to the heap
+ * @param[in] hp        pointer to the free block header
+ *
+ * @notapi
+ */
+static void heap_insert(memory_heap_t *heapp, heap_header_t *hp) {
+  unsigned fl, sl;
+
+  heap_mapping(H_PAGES(hp), &fl, &sl);
+
+  H_HEAP(hp) = NULL;
+  H_LINKS(hp)->prev = NULL;
+  H_LINKS(hp)->next = heapp->lists[fl][sl];
+  if (heapp->lists[fl][sl] != NULL) {
+    H_LINKS(heapp->lists[fl][sl])->prev = hp;
+  }
+  heapp->lists[fl][sl] = hp;
+  heapp->slmap[fl] |= (uint8_t)(1U << sl);
+  heapp->flmap |= (uint32_t)1U << fl;
+}
+
+/**
+ * @brief   Removes a free block from the list of its class.
+ *
+ * @param[in] heapp     pointer to the heap
+ * @param[in] hp        pointer to the free block header
+ *
+ * @notapi
+ */
+static void heap_remove(memory_heap_t *heapp, heap_header_t *hp) {
+  heap_header_t *next = H_LINKS(hp)->next;
+  heap_header_t *prev = H_LINKS(hp)->prev;
+
+  if (next != NULL) {
+    H_LINKS(next)->prev = prev;
+  }
+  if (prev != NULL) {
+    H_LINKS(prev)->next = next;
+  }
+  else {
+    unsigned fl, sl;
+
+    /* The block was the list head, the class masks are updated if the
+       list becomes empty.*/
+    heap_mapping(H_PAGES(hp), &fl, &sl);
+    heapp->lists[fl][sl] = next;
+    if (next == NULL) {
+      heapp->slmap[fl] &= (uint8_t)~(1U << sl);
+      if (heapp->slmap[fl] == 0U) {
+        heapp->flmap &= ~((uint32_t)1U << fl);
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Scans a free list for a block of the specified size.
+ * @note    At most @p CH_HEAP_TLSF_SCAN_MAX blocks are examined in order
+ *          to keep the allocation time bounded.
+ *
+ * @param[in] hp        first block in the list or @p NULL
+ * @param[in] pages     required size in pages
+ * @return              The first block large enough.
+ * @retval NULL         if there is no such block.
+ *
+ * @notapi
+ */
+static heap_header_t *heap_scan(heap_header_t *hp, size_t pages) {
+  unsigned n = CH_HEAP_TLSF_SCAN_MAX;
+
+  while ((hp != NULL) && (n > 0U)) {
+    if (H_PAGES(hp) >= pages) {
+      return hp;
+    }
+    hp = H_LINKS(hp)->next;
+    n--;
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Finds a free block of at least the specified size.
+ * @details The size is rounded up to the next class boundary so that any
+ *          block in the selected class is large enough, the search is done
+ *          using the class masks. Only the last class, which contains
+ *          blocks of unbounded size, and the fallback on the exact class
+ *          of the request require a scan, both scans are bounded.
+ *
+ * @param[in] heapp     pointer to the heap
+ * @param[in] pages     required size in pages
+ * @return              The free block, still linked in its list.
+ * @retval NULL         if there is no block large enough.
+ *
+ * @notapi
+ */
+static heap_header_t *heap_find(memory_heap_t *heapp, size_t pages) {
+  unsigned fl, sl;
+  size_t rpages = pages;
+  uint32_t map;
+
+  if (pages >= (size_t)CH_HEAP_TLSF_SL_COUNT) {
+    rpages += ((size_t)1 << (heap_msb(pages) - CH_HEAP_TLSF_SL_BITS)) - 1U;
+    if (rpages < pages) {
+      /* Overflow, no block can be that large.*/
+      return NULL;
+    }
+  }
+  heap_mapping(rpages, &fl, &sl);
+
+  /* First non-empty class starting from the rounded one.*/
+  map = (uint32_t)heapp->slmap[fl] & ~(((uint32_t)1U << sl) - 1U);
+  if (map == 0U) {
+    map = heapp->flmap & ~(((uint32_t)2U << fl) - 1U);
+    if (map != 0U) {
+      fl = heap_lsb(map);
+      map = (uint32_t)heapp->slmap[fl];
+    }
+  }
+
+  if (map != 0U) {
+    sl = heap_lsb(map);
+
+    /* The last class is the only one with blocks of unbounded size.*/
+    if ((fl == (unsigned)CH_CFG_HEAP_TLSF_LEVELS - 1U) &&
+        (sl == CH_HEAP_TLSF_SL_COUNT - 1U)) {
+      return heap_scan(heapp->lists[fl][sl], pages);
+    }
+
+    return heapp->lists[fl][sl];
+  }
+
+  /* Fallback on the class of the unrounded size, it can contain blocks
+     large enough.*/
+  heap_mapping(pages, &fl, &sl);
+  return heap_scan(heapp->lists[fl][sl], pages);
+}
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -107,8 +431,12 @@ static memory_heap_t default_heap;
 void _heap_init(void) {
 
   default_heap.provider = chCoreAllocAlignedWithOffset;
+#if CH_CFG_USE_HEAP_TLSF == FALSE
   H_NEXT(&default_heap.header) = NULL;
   H_PAGES(&default_heap.header) = 0;
+#else
+  heap_lists_init(&default_heap);
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   chMtxObjectInit(&default_heap.mtx);
 #else
@@ -141,10 +469,23 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
 
   /* Initializing the heap header.*/
   heapp->provider = NULL;
+#if CH_CFG_USE_HEAP_TLSF == FALSE
   H_NEXT(&heapp->header) = hp;
   H_PAGES(&heapp->header) = 0;
   H_NEXT(hp) = NULL;
   H_PAGES(hp) = (size - sizeof (heap_header_t)) / CH_HEAP_ALIGNMENT;
+#else
+  chDbgAssert(size >= (sizeof (heap_header_t) * 2U) +
+                      (H_LINK_PAGES * CH_HEAP_ALIGNMENT),
+              "heap too small");
+
+  /* The whole area is a single free block followed by the end sentinel.*/
+  heap_lists_init(heapp);
+  H_PREV(hp) = NULL;
+  H_PAGES(hp) = (size / CH_HEAP_ALIGNMENT) - (H_HDR_PAGES * 2U);
+  heap_area_end(heapp, hp);
+  heap_insert(heapp, hp);
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   chMtxObjectInit(&heapp->mtx);
 #else
@@ -152,6 +493,7 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
 #endif
 }
 
+#if (CH_CFG_USE_HEAP_TLSF == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Allocates a block of memory from the heap by using the first-fit
  *          algorithm.
@@ -343,6 +685,9 @@ void chHeapFree(void *p) {
  * @brief   Reports the heap status.
  * @note    This function is meant to be used in the test suite, it should
  *          not be really useful for the application code.
+ * @note    The fragmentation of the free space can be measured as the ratio
+ *          between the largest free block and the total free space, a ratio
+ *          of one means that the free space is not fragmented.
  *
  * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
  *                      access the default heap.
@@ -394,6 +739,245 @@ size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp) {
   return n;
 }
 
+#else /* CH_CFG_USE_HEAP_TLSF == TRUE */
+/**
+ * @brief   Allocates a block of memory from the heap by using the
+ *          segregated-fit algorithm.
+ * @details The allocated block is guaranteed to be properly aligned to the
+ *          specified alignment.
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @param[in] size      the size of the block to be allocated. Note that the
+ *                      allocated block may be a bit bigger than the requested
+ *                      size for alignment and fragmentation reasons.
+ * @param[in] align     desired memory alignment
+ * @return              A pointer to the aligned allocated block.
+ * @retval NULL         if the block cannot be allocated.
+ *
+ * @api
+ */
+void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
+  heap_header_t *hp, *ahp;
+  size_t pages, rpages;
+
+  chDbgCheck((size > 0U) && MEM_IS_VALID_ALIGNMENT(align));
+
+  /* If an heap is not specified then the default system header is used.*/
+  if (heapp == NULL) {
+    heapp = &default_heap;
+  }
+
+  /* Minimum alignment is constrained by the heap header structure size.*/
+  if (align < CH_HEAP_ALIGNMENT) {
+    align = CH_HEAP_ALIGNMENT;
+  }
+
+  /* Size is converted in number of elementary allocation units, the block
+     must be able to contain the free list links once released.*/
+  pages = MEM_ALIGN_NEXT(size, CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
+  if (pages < H_LINK_PAGES) {
+    pages = H_LINK_PAGES;
+  }
+
+  /* Stricter alignments require room for a free fragment in front of the
+     aligned block.*/
+  rpages = pages;
+  if (align > CH_HEAP_ALIGNMENT) {
+    rpages += ((size_t)align / CH_HEAP_ALIGNMENT) + H_MIN_PAGES;
+  }
+
+  /* Taking heap mutex/semaphore.*/
+  H_LOCK(heapp);
+
+  hp = heap_find(heapp, rpages);
+  if (hp != NULL) {
+    heap_remove(heapp, hp);
+
+    /* Pointer aligned to the requested alignment.*/
+    ahp = (heap_header_t *)MEM_ALIGN_NEXT(H_BLOCK(hp), align) - 1U;
+
+    if (ahp > hp) {
+      /* The block is not properly aligned, the leading part becomes a free
+         fragment, it must be large enough to contain its links.*/
+      while (NPAGES(ahp, hp) < H_MIN_PAGES) {
+        /*lint -save -e9087 [11.3] Safe cast.*/
+        ahp = (heap_header_t *)((uint8_t *)ahp + align);
+        /*lint -restore*/
+      }
+
+      H_PREV(ahp) = hp;
+      H_PAGES(ahp) = H_PAGES(hp) - NPAGES(ahp, hp);
+      H_PREV(H_LIMIT(ahp)) = ahp;
+      H_PAGES(hp) = NPAGES(ahp, H_BLOCK(hp));
+      heap_insert(heapp, hp);
+
+      hp = ahp;
+    }
+
+    if (H_PAGES(hp) >= pages + H_MIN_PAGES) {
+      /* The block is bigger than required, must split the excess.*/
+      heap_header_t *fp;
+
+      fp = (heap_header_t *)((uint8_t *)H_BLOCK(hp) +
+                             (pages * CH_HEAP_ALIGNMENT));
+      H_PREV(fp) = hp;
+      H_PAGES(fp) = (H_PAGES(hp) - pages) - H_HDR_PAGES;
+      H_PREV(H_LIMIT(fp)) = fp;
+      H_PAGES(hp) = pages;
+      heap_insert(heapp, fp);
+    }
+
+    /* Setting in the block owner heap and size.*/
+    H_SIZE(hp) = size;
+    H_HEAP(hp) = heapp;
+
+    /* Releasing heap mutex/semaphore.*/
+    H_UNLOCK(heapp);
+
+    /*lint -save -e9087 [11.3] Safe cast.*/
+    return (void *)H_BLOCK(hp);
+    /*lint -restore*/
+  }
+
+  /* Releasing heap mutex/semaphore.*/
+  H_UNLOCK(heapp);
+
+  /* More memory is required, tries to get it from the associated provider
+     else fails. The new area is a single block followed by its end
+     sentinel.*/
+  if (heapp->provider != NULL) {
+    ahp = heapp->provider((pages * CH_HEAP_ALIGNMENT) + sizeof (heap_header_t),
+                          align,
+                          sizeof (heap_header_t));
+    if (ahp != NULL) {
+      hp = ahp - 1U;
+      H_PREV(hp) = NULL;
+      H_PAGES(hp) = pages;
+      heap_area_end(heapp, hp);
+      H_HEAP(hp) = heapp;
+      H_SIZE(hp) = size;
+
+      /*lint -save -e9087 [11.3] Safe cast.*/
+      return (void *)ahp;
+      /*lint -restore*/
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Frees a previously allocated memory block.
+ * @note    The block is merged with its adjacent free blocks, if any.
+ *
+ * @param[in] p         pointer to the memory block to be freed
+ *
+ * @api
+ */
+void chHeapFree(void *p) {
+  heap_header_t *qp, *hp;
+  memory_heap_t *heapp;
+
+  chDbgCheck((p != NULL) && MEM_IS_ALIGNED(p, CH_HEAP_ALIGNMENT));
+
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  hp = (heap_header_t *)p - 1U;
+  /*lint -restore*/
+  heapp = H_HEAP(hp);
+  chDbgAssert(heapp != NULL, "not allocated");
+
+  /* Taking heap mutex/semaphore.*/
+  H_LOCK(heapp);
+
+  /* Merge with the next block.*/
+  qp = H_LIMIT(hp);
+  if (H_HEAP(qp) == NULL) {
+    heap_remove(heapp, qp);
+    H_PAGES(hp) += H_PAGES(qp) + H_HDR_PAGES;
+  }
+
+  /* Merge with the previous block.*/
+  qp = H_PREV(hp);
+  if ((qp != NULL) && (H_HEAP(qp) == NULL)) {
+    heap_remove(heapp, qp);
+    H_PAGES(qp) += H_PAGES(hp) + H_HDR_PAGES;
+    hp = qp;
+  }
+
+  H_PREV(H_LIMIT(hp)) = hp;
+  heap_insert(heapp, hp);
+
+  /* Releasing heap mutex/semaphore.*/
+  H_UNLOCK(heapp);
+
+  return;
+}
+
+/**
+ * @brief   Reports the heap status.
+ * @note    This function is meant to be used in the test suite, it should
+ *          not be really useful for the application code.
+ * @note    The fragmentation of the free space can be measured as the ratio
+ *          between the largest free block and the total free space, a ratio
+ *          of one means that the free space is not fragmented.
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @param[in] totalp    pointer to a variable that will receive the total
+ *                      fragmented free space or @p NULL
+ * @param[in] largestp  pointer to a variable that will receive the largest
+ *                      free free block found space or @p NULL
+ * @return              The number of fragments in the heap.
+ *
+ * @api
+ */
+size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp) {
+  size_t n, tpages, lpages;
+  unsigned fl, sl;
+
+  if (heapp == NULL) {
+    heapp = &default_heap;
+  }
+
+  H_LOCK(heapp);
+  tpages = 0U;
+  lpages = 0U;
+  n = 0U;
+  for (fl = 0U; fl < (unsigned)CH_CFG_HEAP_TLSF_LEVELS; fl++) {
+    for (sl = 0U; sl < CH_HEAP_TLSF_SL_COUNT; sl++) {
+      heap_header_t *hp = heapp->lists[fl][sl];
+
+      while (hp != NULL) {
+        size_t pages = H_PAGES(hp);
+
+        /* Updating counters.*/
+        n++;
+        tpages += pages;
+        if (pages > lpages) {
+          lpages = pages;
+        }
+
+        hp = H_LINKS(hp)->next;
+      }
+    }
+  }
+
+  /* Writing out fragmented free memory.*/
+  if (totalp != NULL) {
+    *totalp = tpages * CH_HEAP_ALIGNMENT;
+  }
+
+  /* Writing out unfragmented free memory.*/
+  if (largestp != NULL) {
+    *largestp = lpages * CH_HEAP_ALIGNMENT;
+  }
+  H_UNLOCK(heapp);
+
+  return n;
+}
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
 #endif /* CH_CFG_USE_HEAP == TRUE */
 
 /** @} */
@@ -29,7 +29,10 @@
  *          problems.<br>
  *          Memory Pools do not enforce any alignment constraint on the
  *          contained object however the objects must be properly aligned
- *          to contain a pointer to void.
+ *          to contain a pointer to void.<br>
+ *          Threads performing many allocations and releases on a shared
+ *          pool can put a magazine in front of it, a per-thread cache of
+ *          objects that is accessed without locking.
  * @pre     In order to use the memory pools APIs the @p CH_CFG_USE_MEMPOOLS option
  *          must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -40,6 +43,19 @@
 
 #if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
 
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*
+ * Checks if the pool behind a magazine is a guarded pool.
+ */
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+#define MAGAZINE_IS_GUARDED(pmp)    ((pmp)->gmp != NULL)
+#else
+#define MAGAZINE_IS_GUARDED(pmp)    false
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -56,6 +72,63 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Moves objects from the backing pool into a magazine.
+ * @details The magazine is filled up to half of its capacity, or less if
+ *          the backing pool has not enough objects. Objects reserved for
+ *          threads waiting on a guarded pool are not taken.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ *
+ * @notapi
+ */
+static void magazine_refill_i(pool_magazine_t *pmp) {
+  memory_pool_t *mp = pmp->pool;
+  size_t n = (pmp->size + 1U) / 2U;
+
+  while ((pmp->cnt < n) && (mp->next != NULL)) {
+#if CH_CFG_USE_SEMAPHORES == TRUE
+    if (pmp->gmp != NULL) {
+      if (chSemGetCounterI(&pmp->gmp->sem) <= (cnt_t)0) {
+        break;
+      }
+      chSemFastWaitI(&pmp->gmp->sem);
+    }
+#endif
+    pmp->objs[pmp->cnt] = (void *)mp->next;
+    mp->next = mp->next->next;
+    pmp->cnt++;
+  }
+}
+
+/**
+ * @brief   Moves objects from a magazine back into the backing pool.
+ * @note    If the backing pool is guarded then waiting threads can be
+ *          made ready, a reschedule is required after this function.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @param[in] n         number of objects to be left in the magazine
+ *
+ * @notapi
+ */
+static void magazine_drain_i(pool_magazine_t *pmp, size_t n) {
+
+  while (pmp->cnt > n) {
+    pmp->cnt--;
+    chPoolFreeI(pmp->pool, pmp->objs[pmp->cnt]);
+#if CH_CFG_USE_SEMAPHORES == TRUE
+    if (pmp->gmp != NULL) {
+      chSemSignalI(&pmp->gmp->sem);
+    }
+#endif
+  }
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  if (pmp->gmp != NULL) {
+    chThdDequeueAllI(&pmp->gmp->batch_queue, MSG_OK);
+  }
+#endif
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -211,6 +284,127 @@ void chPoolFree(memory_pool_t *mp, void *objp) {
   chSysUnlock();
 }
 
+/**
+ * @brief   Allocates a batch of objects from a memory pool.
+ * @details Objects are taken from the pool and, if the pool becomes empty,
+ *          from its provider. Less than @p n objects are returned if the
+ *          pool runs out of objects.
+ * @pre     The memory pool must already be initialized.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure
+ * @param[out] objs     array receiving the pointers to the allocated objects
+ * @param[in] n         number of objects to be allocated
+ * @return              The number of allocated objects.
+ *
+ * @iclass
+ */
+size_t chPoolAllocBatchI(memory_pool_t *mp, void **objs, size_t n) {
+  struct pool_header *php;
+  size_t i;
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (objs != NULL));
+
+  /* Detaching the first objects from the list in a single pass.*/
+  i = 0U;
+  php = mp->next;
+  while ((i < n) && (php != NULL)) {
+    objs[i] = (void *)php;
+    php = php->next;
+    i++;
+  }
+  mp->next = php;
+
+  /* Remaining objects are requested to the provider, if any.*/
+  while ((i < n) && (mp->provider != NULL)) {
+    void *objp = mp->provider(mp->object_size, mp->align);
+
+    if (objp == NULL) {
+      break;
+    }
+
+    chDbgAssert(MEM_IS_ALIGNED(objp, mp->align),
+                "returned object not aligned");
+
+    objs[i] = objp;
+    i++;
+  }
+
+  return i;
+}
+
+/**
+ * @brief   Allocates a batch of objects from a memory pool.
+ * @details Objects are taken from the pool and, if the pool becomes empty,
+ *          from its provider. Less than @p n objects are returned if the
+ *          pool runs out of objects.
+ * @pre     The memory pool must already be initialized.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure
+ * @param[out] objs     array receiving the pointers to the allocated objects
+ * @param[in] n         number of objects to be allocated
+ * @return              The number of allocated objects.
+ *
+ * @api
+ */
+size_t chPoolAllocBatch(memory_pool_t *mp, void **objs, size_t n) {
+
+  chSysLock();
+  n = chPoolAllocBatchI(mp, objs, n);
+  chSysUnlock();
+
+  return n;
+}
+
+/**
+ * @brief   Releases a batch of objects into a memory pool.
+ * @pre     The memory pool must already be initialized.
+ * @pre     The freed objects must be of the right size for the specified
+ *          memory pool.
+ * @pre     The freed objects must be properly aligned.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure
+ * @param[in] objs      array of pointers to the objects to be released
+ * @param[in] n         number of objects to be released
+ *
+ * @iclass
+ */
+void chPoolFreeBatchI(memory_pool_t *mp, void * const *objs, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (objs != NULL));
+
+  while (n > 0U) {
+    struct pool_header *php = objs[n - 1U];
+
+    chDbgCheck((php != NULL) && MEM_IS_ALIGNED(php, mp->align));
+
+    php->next = mp->next;
+    mp->next = php;
+    n--;
+  }
+}
+
+/**
+ * @brief   Releases a batch of objects into a memory pool.
+ * @pre     The memory pool must already be initialized.
+ * @pre     The freed objects must be of the right size for the specified
+ *          memory pool.
+ * @pre     The freed objects must be properly aligned.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure
+ * @param[in] objs      array of pointers to the objects to be released
+ * @param[in] n         number of objects to be released
+ *
+ * @api
+ */
+void chPoolFreeBatch(memory_pool_t *mp, void * const *objs, size_t n) {
+
+  chSysLock();
+  chPoolFreeBatchI(mp, objs, n);
+  chSysUnlock();
+}
+
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Initializes an empty guarded memory pool.
@@ -229,6 +423,7 @@ void chGuardedPoolObjectInitAligned(guarded_memory_pool_t *gmp,
 
   chPoolObjectInitAligned(&gmp->pool, size, align, NULL);
   chSemObjectInit(&gmp->sem, (cnt_t)0);
+  chThdQueueObjectInit(&gmp->batch_queue);
 }
 
 /**
@@ -329,6 +524,373 @@ void chGuardedPoolFree(guarded_memory_pool_t *gmp, void *objp) {
   chSchRescheduleS();
   chSysUnlock();
 }
+
+/**
+ * @brief   Allocates a batch of objects from a guarded memory pool.
+ * @details Less than @p n objects are returned if the pool does not
+ *          contain enough objects, this function does not wait.
+ * @pre     The guarded memory pool must already be initialized.
+ *
+ * @param[in] gmp       pointer to a @p guarded_memory_pool_t structure
+ * @param[out] objs     array receiving the pointers to the allocated objects
+ * @param[in] n         number of objects to be allocated
+ * @return              The number of allocated objects.
+ *
+ * @iclass
+ */
+size_t chGuardedPoolAllocBatchI(guarded_memory_pool_t *gmp,
+                                void **objs, size_t n) {
+  cnt_t cnt;
+  size_t i;
+
+  chDbgCheckClassI();
+  chDbgCheck(gmp != NULL);
+
+  /* Objects reserved for waiting threads are not available.*/
+  cnt = chSemGetCounterI(&gmp->sem);
+  if (cnt <= (cnt_t)0) {
+    return 0U;
+  }
+  if ((size_t)cnt < n) {
+    n = (size_t)cnt;
+  }
+
+  n = chPoolAllocBatchI(&gmp->pool, objs, n);
+  for (i = 0U; i < n; i++) {
+    chSemFastWaitI(&gmp->sem);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Allocates a batch of objects from a guarded memory pool.
+ * @details The function waits until all the @p n objects are available,
+ *          on timeout no object is allocated.
+ * @note    The objects are taken all together, no object is held while
+ *          waiting so concurrent batch allocations cannot deadlock. Threads
+ *          waiting for single objects are served first.
+ * @pre     The guarded memory pool must already be initialized.
+ *
+ * @param[in] gmp       pointer to a @p guarded_memory_pool_t structure
+ * @param[out] objs     array receiving the pointers to the allocated objects
+ * @param[in] n         number of objects to be allocated
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if all the objects have been allocated.
+ * @retval MSG_TIMEOUT  if the objects have not been allocated within the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+msg_t chGuardedPoolAllocBatchTimeoutS(guarded_memory_pool_t *gmp,
+                                      void **objs, size_t n,
+                                      sysinterval_t timeout) {
+  systime_t start = chVTGetSystemTimeX();
+  size_t i;
+
+  chDbgCheckClassS();
+  chDbgCheck((gmp != NULL) && (objs != NULL));
+
+  /* Waiting for enough objects to be available, the queue is woken up
+     each time objects are returned to the pool. The wait deadline is the
+     same for all the iterations.*/
+  while (chSemGetCounterI(&gmp->sem) < (cnt_t)n) {
+    sysinterval_t remaining = timeout;
+    msg_t msg;
+
+    if ((timeout != TIME_INFINITE) && (timeout != TIME_IMMEDIATE)) {
+      sysinterval_t elapsed = chTimeDiffX(start, chVTGetSystemTimeX());
+
+      if (elapsed >= timeout) {
+        return MSG_TIMEOUT;
+      }
+      remaining = timeout - elapsed;
+    }
+
+    msg = chThdEnqueueTimeoutS(&gmp->batch_queue, remaining);
+    if (msg != MSG_OK) {
+      return msg;
+    }
+  }
+
+  /* Reserving and taking all the objects at once.*/
+  for (i = 0U; i < n; i++) {
+    chSemFastWaitI(&gmp->sem);
+  }
+  i = chPoolAllocBatchI(&gmp->pool, objs, n);
+  chDbgAssert(i == n, "pool out of sync");
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Allocates a batch of objects from a guarded memory pool.
+ * @details The function waits until all the @p n objects are available,
+ *          on timeout no object is allocated.
+ * @pre     The guarded memory pool must already be initialized.
+ *
+ * @param[in] gmp       pointer to a @p guarded_memory_pool_t structure
+ * @param[out] objs     array receiving the pointers to the allocated objects
+ * @param[in] n         number of objects to be allocated
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if all the objects have been allocated.
+ * @retval MSG_TIMEOUT  if the objects have not been allocated within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+msg_t chGuardedPoolAllocBatchTimeout(guarded_memory_pool_t *gmp,
+                                     void **objs, size_t n,
+                                     sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chGuardedPoolAllocBatchTimeoutS(gmp, objs, n, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Releases a batch of objects into a guarded memory pool.
+ * @pre     The guarded memory pool must already be initialized.
+ * @pre     The freed objects must be of the right size for the specified
+ *          guarded memory pool.
+ * @pre     The freed objects must be properly aligned.
+ *
+ * @param[in] gmp       pointer to a @p guarded_memory_pool_t structure
+ * @param[in] objs      array of pointers to the objects to be released
+ * @param[in] n         number of objects to be released
+ *
+ * @iclass
+ */
+void chGuardedPoolFreeBatchI(guarded_memory_pool_t *gmp,
+                             void * const *objs, size_t n) {
+
+  chPoolFreeBatchI(&gmp->pool, objs, n);
+  while (n > 0U) {
+    chSemSignalI(&gmp->sem);
+    n--;
+  }
+  chThdDequeueAllI(&gmp->batch_queue, MSG_OK);
+}
+
+/**
+ * @brief   Releases a batch of objects into a guarded memory pool.
+ * @pre     The guarded memory pool must already be initialized.
+ * @pre     The freed objects must be of the right size for the specified
+ *          guarded memory pool.
+ * @pre     The freed objects must be properly aligned.
+ *
+ * @param[in] gmp       pointer to a @p guarded_memory_pool_t structure
+ * @param[in] objs      array of pointers to the objects to be released
+ * @param[in] n         number of objects to be released
+ *
+ * @api
+ */
+void chGuardedPoolFreeBatch(guarded_memory_pool_t *gmp,
+                            void * const *objs, size_t n) {
+
+  chSysLock();
+  chGuardedPoolFreeBatchI(gmp, objs, n);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+#endif
+
+/**
+ * @brief   Initializes a magazine in front of a memory pool.
+ *
+ * @param[out] pmp      pointer to a @p pool_magazine_t structure
+ * @param[in] mp        pointer to the backing @p memory_pool_t structure
+ * @param[in] objs      pointer to an array of pointers used as objects
+ *                      storage
+ * @param[in] size      number of elements in the array
+ *
+ * @init
+ */
+void chPoolMagazineObjectInit(pool_magazine_t *pmp, memory_pool_t *mp,
+                              void **objs, size_t size) {
+
+  chDbgCheck((pmp != NULL) && (mp != NULL) &&
+             (objs != NULL) && (size > 0U));
+
+  pmp->pool = mp;
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  pmp->gmp  = NULL;
+#endif
+  pmp->objs = objs;
+  pmp->size = size;
+  pmp->cnt  = 0U;
+}
+
+/**
+ * @brief   Allocates an object using a magazine.
+ * @details The object is taken from the magazine, the backing pool is
+ *          accessed only if the magazine is empty.
+ * @note    If the backing pool is guarded then this function does not
+ *          wait for objects to become available.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if the magazine and the backing pool are empty.
+ *
+ * @api
+ */
+void *chPoolMagazineAlloc(pool_magazine_t *pmp) {
+  void *objp = NULL;
+
+  chDbgCheck(pmp != NULL);
+
+  if (pmp->cnt == 0U) {
+    chSysLock();
+    magazine_refill_i(pmp);
+    if ((pmp->cnt == 0U) && !MAGAZINE_IS_GUARDED(pmp)) {
+      /* The pool is empty, trying its provider, if any.*/
+      objp = chPoolAllocI(pmp->pool);
+    }
+    chSysUnlock();
+
+    if (pmp->cnt == 0U) {
+      return objp;
+    }
+  }
+
+  pmp->cnt--;
+  return pmp->objs[pmp->cnt];
+}
+
+/**
+ * @brief   Releases an object using a magazine.
+ * @details The object is put in the magazine, if the magazine is full then
+ *          half of its objects are returned to the backing pool first.
+ * @pre     The freed object must be of the right size for the backing
+ *          memory pool.
+ * @pre     The freed object must be properly aligned.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @param[in] objp      the pointer to the object to be released
+ *
+ * @api
+ */
+void chPoolMagazineFree(pool_magazine_t *pmp, void *objp) {
+
+  chDbgCheck((pmp != NULL) &&
+             (objp != NULL) &&
+             MEM_IS_ALIGNED(objp, pmp->pool->align));
+
+  if (pmp->cnt >= pmp->size) {
+    chSysLock();
+    magazine_drain_i(pmp, pmp->size / 2U);
+    if (MAGAZINE_IS_GUARDED(pmp)) {
+      chSchRescheduleS();
+    }
+    chSysUnlock();
+  }
+
+  pmp->objs[pmp->cnt] = objp;
+  pmp->cnt++;
+}
+
+/**
+ * @brief   Returns all the objects in a magazine to the backing pool.
+ * @note    This function should be invoked before a thread stops using
+ *          a magazine, cached objects are not available to other threads.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ *
+ * @api
+ */
+void chPoolMagazineFlush(pool_magazine_t *pmp) {
+
+  chDbgCheck(pmp != NULL);
+
+  chSysLock();
+  magazine_drain_i(pmp, 0U);
+  if (MAGAZINE_IS_GUARDED(pmp)) {
+    chSchRescheduleS();
+  }
+  chSysUnlock();
+}
+
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a magazine in front of a guarded memory pool.
+ * @note    Objects cached in the magazine are not counted by the guard
+ *          semaphore of the backing pool.
+ *
+ * @param[out] pmp      pointer to a @p pool_magazine_t structure
+ * @param[in] gmp       pointer to the backing @p guarded_memory_pool_t
+ *                      structure
+ * @param[in] objs      pointer to an array of pointers used as objects
+ *                      storage
+ * @param[in] size      number of elements in the array
+ *
+ * @init
+ */
+void chGuardedPoolMagazineObjectInit(pool_magazine_t *pmp,
+                                     guarded_memory_pool_t *gmp,
+                                     void **objs, size_t size) {
+
+  chDbgCheck(gmp != NULL);
+
+  chPoolMagazineObjectInit(pmp, &gmp->pool, objs, size);
+  pmp->gmp = gmp;
+}
+
+/**
+ * @brief   Allocates an object using a magazine in front of a guarded
+ *          memory pool.
+ * @details The object is taken from the magazine, if the magazine is empty
+ *          then it is refilled from the backing pool. If the backing pool
+ *          is empty too then the function waits for an object.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if the operation timed out.
+ *
+ * @api
+ */
+void *chGuardedPoolMagazineAllocTimeout(pool_magazine_t *pmp,
+                                        sysinterval_t timeout) {
+  void *objp = NULL;
+
+  chDbgCheck((pmp != NULL) && (pmp->gmp != NULL));
+
+  if (pmp->cnt == 0U) {
+    chSysLock();
+    magazine_refill_i(pmp);
+    if (pmp->cnt == 0U) {
+      /* The pool is empty, waiting for an object.*/
+      if (chSemWaitTimeoutS(&pmp->gmp->sem, timeout) == MSG_OK) {
+        objp = chPoolAllocI(pmp->pool);
+      }
+    }
+    chSysUnlock();
+
+    if (pmp->cnt == 0U) {
+      return objp;
+    }
+  }
+
+  pmp->cnt--;
+  return pmp->objs[pmp->cnt];
+}
 #endif
 
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
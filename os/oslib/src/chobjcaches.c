@@ -42,7 +42,11 @@
  *            media.
  *          - <b>Release Object</b>: Releases an object to the cache handling
  *            the media update, if required.
+ *          - <b>Flush</b>: Writes all the dirty objects to the media.
  *          .
+ *          Optionally, dirty objects with adjacent keys can be written
+ *          using a single cluster write operation and sequential accesses
+ *          can trigger asynchronous reads of the following objects.
  * @pre     In order to use the pipes APIs the @p CH_CFG_USE_OBJ_CACHES
  *          option must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -103,6 +107,13 @@
   (objp)->lru_next->lru_prev = (objp)->lru_prev;                            \
 }
 
+/* Statistics update.*/
+#if (CH_CFG_OBJ_CACHES_STATS == TRUE) || defined(__DOXYGEN__)
+#define OC_STATS_ADD(ocp, field, n) ((ocp)->stats.field += (ucnt_t)(n))
+#else
+#define OC_STATS_ADD(ocp, field, n)
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -154,6 +165,96 @@ static oc_object_t *hash_get_s(objects_cache_t *ocp,
   return NULL;
 }
 
+/**
+ * @brief   Checks if an object is an idle dirty object.
+ *
+ * @param[in] objp      pointer to the @p oc_object_t structure or @p NULL
+ * @return              The check result.
+ *
+ * @notapi
+ */
+static bool lru_is_dirty_s(oc_object_t *objp) {
+
+  return (objp != NULL) &&
+         ((objp->obj_flags & (OC_FLAG_INLRU | OC_FLAG_LAZYWRITE)) ==
+          (OC_FLAG_INLRU | OC_FLAG_LAZYWRITE));
+}
+
+/**
+ * @brief   Removes an object from the LRU list and takes ownership of it.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to the @p oc_object_t structure
+ *
+ * @notapi
+ */
+static void lru_take_s(objects_cache_t *ocp, oc_object_t *objp) {
+
+  chDbgAssert(chSemGetCounterI(&objp->obj_sem) == (cnt_t)1,
+              "semaphore counter not 1");
+
+  LRU_REMOVE(objp);
+  objp->obj_flags &= ~OC_FLAG_INLRU;
+
+  /* There are objects in the LRU so there are no waiting threads on
+     both semaphores, using the "fast" variants.*/
+  chSemFastWaitI(&ocp->lru_sem);
+  chSemFastWaitI(&objp->obj_sem);
+}
+
+/**
+ * @brief   Gathers a cluster of dirty objects with adjacent keys.
+ * @details Idle dirty objects of the same group and with keys adjacent
+ *          to the key of the specified object are taken from the LRU
+ *          list.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to an owned dirty object
+ * @param[out] objs     array receiving the objects in ascending keys order
+ * @return              The number of objects in the cluster.
+ *
+ * @notapi
+ */
+static ucnt_t lru_get_cluster_s(objects_cache_t *ocp,
+                                oc_object_t *objp,
+                                oc_object_t **objs) {
+  uint32_t group = objp->obj_group;
+  uint32_t key, first = objp->obj_key;
+  ucnt_t n = (ucnt_t)1;
+
+  /* Finding the first key of the cluster.*/
+  while ((n < (ucnt_t)CH_CFG_OBJ_CACHES_CLUSTER_MAX) && (first > 0U) &&
+         lru_is_dirty_s(hash_get_s(ocp, group, first - 1U))) {
+    first--;
+    n++;
+  }
+
+  /* Taking the objects preceding the specified one.*/
+  n = (ucnt_t)0;
+  for (key = first; key != objp->obj_key; key++) {
+    oc_object_t *op = hash_get_s(ocp, group, key);
+
+    lru_take_s(ocp, op);
+    objs[n++] = op;
+  }
+  objs[n++] = objp;
+
+  /* Taking the objects following the specified one.*/
+  key++;
+  while ((n < (ucnt_t)CH_CFG_OBJ_CACHES_CLUSTER_MAX) && (key != 0U)) {
+    oc_object_t *op = hash_get_s(ocp, group, key);
+
+    if (!lru_is_dirty_s(op)) {
+      break;
+    }
+    lru_take_s(ocp, op);
+    objs[n++] = op;
+    key++;
+  }
+
+  return n;
+}
+
 /**
  * @brief   Gets the least recently used object buffer from the LRU list.
  *
@@ -192,6 +293,7 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
       /* Removing from hash table if required.*/
       if ((objp->obj_flags & OC_FLAG_INHASH) != 0U) {
         HASH_REMOVE(objp);
+        OC_STATS_ADD(ocp, evictions, 1);
       }
 
       /* Removing all flags, it is "new" now.*/
@@ -200,21 +302,126 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
       return objp;
     }
 
+    if (ocp->writevf != NULL) {
+      oc_object_t *objs[CH_CFG_OBJ_CACHES_CLUSTER_MAX];
+      ucnt_t i, n;
 
-    /* Out of critical section.*/
-    chSysUnlock();
+      /* Dirty objects adjacent to this one are written together.*/
+      n = lru_get_cluster_s(ocp, objp, objs);
+      for (i = (ucnt_t)0; i < n; i++) {
+        objs[i]->obj_flags = OC_FLAG_INHASH | OC_FLAG_FORGET;
+      }
+      OC_STATS_ADD(ocp, writes, 1);
+      OC_STATS_ADD(ocp, written, n);
+
+      /* Out of critical section.*/
+      chSysUnlock();
+
+      /* Invoking the cluster writer asynchronously, it is responsibility
+         of the write function to release the buffers.*/
+      (void) ocp->writevf(ocp, objs, n, true);
+    }
+    else {
+      OC_STATS_ADD(ocp, writes, 1);
+      OC_STATS_ADD(ocp, written, 1);
 
-   /* Invoking the writer asynchronously, it will release the buffer once it
-      is written. It is responsibility of the write function to release
-      the buffer.*/
-    objp->obj_flags = OC_FLAG_INHASH | OC_FLAG_FORGET;
-    (void) ocp->writef(ocp, objp, true);
+      /* Out of critical section.*/
+      chSysUnlock();
+
+     /* Invoking the writer asynchronously, it will release the buffer once it
+        is written. It is responsibility of the write function to release
+        the buffer.*/
+      objp->obj_flags = OC_FLAG_INHASH | OC_FLAG_FORGET;
+      (void) ocp->writef(ocp, objp, true);
+    }
 
     /* Critical section enter again.*/
     chSysLock();
   }
 }
 
+/**
+ * @brief   Gets a free or clean object buffer from the LRU list tail.
+ * @details This function never waits and never writes objects.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @return              The pointer to the retrieved object.
+ * @retval NULL         if the LRU list tail is not immediately usable.
+ *
+ * @notapi
+ */
+static oc_object_t *lru_get_clean_s(objects_cache_t *ocp) {
+  oc_object_t *objp;
+
+  if (chSemGetCounterI(&ocp->lru_sem) <= (cnt_t)0) {
+    return NULL;
+  }
+
+  objp = ocp->lru.lru_prev;
+  if ((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U) {
+    return NULL;
+  }
+
+  lru_take_s(ocp, objp);
+
+  /* Removing from hash table if required.*/
+  if ((objp->obj_flags & OC_FLAG_INHASH) != 0U) {
+    HASH_REMOVE(objp);
+    OC_STATS_ADD(ocp, evictions, 1);
+  }
+  objp->obj_flags = 0U;
+
+  return objp;
+}
+
+/**
+ * @brief   Reads ahead a series of objects.
+ * @details Objects already in cache are skipped, the operation stops
+ *          when there are no free or clean buffers available.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] group     object group identifier
+ * @param[in] key       identifier of the first object within the group
+ * @param[in] n         number of objects to be read
+ *
+ * @notapi
+ */
+static void cache_read_ahead(objects_cache_t *ocp,
+                             uint32_t group,
+                             uint32_t key,
+                             ucnt_t n) {
+
+  while (n > (ucnt_t)0) {
+    oc_object_t *objp;
+
+    chSysLock();
+    if (hash_get_s(ocp, group, key) == NULL) {
+      objp = lru_get_clean_s(ocp);
+      if (objp == NULL) {
+        chSysUnlock();
+        return;
+      }
+
+      /* Naming this object and publishing it in the hash table.*/
+      objp->obj_group = group;
+      objp->obj_key   = key;
+      objp->obj_flags = OC_FLAG_INHASH | OC_FLAG_NOTSYNC;
+      HASH_INSERT(ocp, objp, group, key);
+      OC_STATS_ADD(ocp, prefetches, 1);
+      chSysUnlock();
+
+      /* Asynchronous read, the reader releases the object.*/
+      (void) ocp->readf(ocp, objp, true);
+    }
+    else {
+      chSysUnlock();
+    }
+
+    key++;
+    n--;
+  }
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -258,9 +465,22 @@ void chCacheObjectInit(objects_cache_t *ocp,
   ocp->hashn            = hashn;
   ocp->hashp            = hashp;
   ocp->objn             = objn;
+  ocp->objsz            = objsz;
   ocp->objvp            = objvp;
   ocp->readf            = readf;
   ocp->writef           = writef;
+  ocp->writevf          = NULL;
+  ocp->readahead        = (ucnt_t)0;
+  ocp->last_group       = 0U;
+  ocp->last_key         = 0U;
+#if CH_CFG_OBJ_CACHES_STATS == TRUE
+  ocp->stats.hits       = (ucnt_t)0;
+  ocp->stats.misses     = (ucnt_t)0;
+  ocp->stats.evictions  = (ucnt_t)0;
+  ocp->stats.writes     = (ucnt_t)0;
+  ocp->stats.written    = (ucnt_t)0;
+  ocp->stats.prefetches = (ucnt_t)0;
+#endif
   ocp->lru.hash_next    = NULL;
   ocp->lru.hash_prev    = NULL;
   ocp->lru.lru_next     = (oc_object_t *)&ocp->lru;
@@ -293,6 +513,9 @@ void chCacheObjectInit(objects_cache_t *ocp,
  * @note    If the object is not in cache then the returned object is marked
  *          as @p OC_FLAG_NOTSYNC meaning that its data contains garbage and
  *          must be initialized.
+ * @note    If the object is not in cache and it follows the previously
+ *          retrieved object then it is also marked as
+ *          @p OC_FLAG_READAHEAD, reading it triggers the read-ahead.
  *
  * @param[in] ocp       pointer to the @p objects_cache_t structure
  * @param[in] group     object group identifier
@@ -316,6 +539,8 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     chDbgAssert((objp->obj_flags & OC_FLAG_INHASH) == OC_FLAG_INHASH,
                 "not in hash");
 
+    OC_STATS_ADD(ocp, hits, 1);
+
     /* Cache hit, checking if the buffer is owned by some
        other thread.*/
     if (chSemGetCounterI(&objp->obj_sem) > (cnt_t)0) {
@@ -343,6 +568,8 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     }
   }
   else {
+    OC_STATS_ADD(ocp, misses, 1);
+
     /* Cache miss, getting an object buffer from the LRU list.*/
     objp = lru_get_last_s(ocp);
 
@@ -351,7 +578,15 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     objp->obj_key   = key;
     objp->obj_flags = OC_FLAG_INHASH | OC_FLAG_NOTSYNC;
     HASH_INSERT(ocp, objp, group, key);
+
+    /* Sequential access detection.*/
+    if ((ocp->readahead > (ucnt_t)0) && (group == ocp->last_group) &&
+        (key == ocp->last_key + 1U)) {
+      objp->obj_flags |= OC_FLAG_READAHEAD;
+    }
   }
+  ocp->last_group = group;
+  ocp->last_key   = key;
 
   /* Out of critical section and returning the object.*/
   chSysUnlock();
@@ -449,13 +684,28 @@ void chCacheReleaseObjectI(objects_cache_t *ocp,
 bool chCacheReadObject(objects_cache_t *ocp,
                        oc_object_t *objp,
                        bool async) {
+  uint32_t group = objp->obj_group;
+  uint32_t key = objp->obj_key;
+  bool readahead, error;
+
+  /* Read-ahead is triggered once for sequential misses.*/
+  readahead = (objp->obj_flags & OC_FLAG_READAHEAD) != 0U;
+  objp->obj_flags &= ~OC_FLAG_READAHEAD;
 
   /* Marking it as OC_FLAG_NOTSYNC because the read operation is going
      to corrupt it in case of failure. It is responsibility of the read
      implementation to clear it if the operation succeeds.*/
   objp->obj_flags |= OC_FLAG_NOTSYNC;
 
-  return ocp->readf(ocp, objp, async);
+  error = ocp->readf(ocp, objp, async);
+
+  /* The following objects are read asynchronously, note that the object
+     could have been already released by an asynchronous read.*/
+  if (readahead) {
+    cache_read_ahead(ocp, group, key + 1U, ocp->readahead);
+  }
+
+  return error;
 }
 
 /**
@@ -486,6 +736,100 @@ bool chCacheWriteObject(objects_cache_t *ocp,
   return ocp->writef(ocp, objp, async);
 }
 
+/**
+ * @brief   Writes all the dirty objects back to storage.
+ * @details Dirty objects in the LRU list are written synchronously, if a
+ *          cluster writer function has been specified then objects with
+ *          adjacent keys are written in a single operation.
+ * @note    Objects owned by threads are not written.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @return              The operation status.
+ * @retval false        if the operation succeeded.
+ * @retval true         if a write operation failed, the objects involved
+ *                      in the failed operation are left dirty.
+ *
+ * @api
+ */
+bool chCacheFlush(objects_cache_t *ocp) {
+  oc_object_t *objs[CH_CFG_OBJ_CACHES_CLUSTER_MAX];
+  bool error = false;
+
+  while (!error) {
+    oc_object_t *objp;
+    ucnt_t i, n;
+
+    chSysLock();
+
+    /* Searching for the most recently used dirty object.*/
+    objp = ocp->lru.lru_next;
+    while ((objp != (oc_object_t *)&ocp->lru) &&
+           ((objp->obj_flags & OC_FLAG_LAZYWRITE) == 0U)) {
+      objp = objp->lru_next;
+    }
+    if (objp == (oc_object_t *)&ocp->lru) {
+      chSysUnlock();
+      break;
+    }
+
+    /* Taking the object and the adjacent ones, if possible.*/
+    lru_take_s(ocp, objp);
+    if (ocp->writevf != NULL) {
+      n = lru_get_cluster_s(ocp, objp, objs);
+    }
+    else {
+      objs[0] = objp;
+      n = (ucnt_t)1;
+    }
+    for (i = (ucnt_t)0; i < n; i++) {
+      objs[i]->obj_flags &= ~OC_FLAG_LAZYWRITE;
+    }
+    OC_STATS_ADD(ocp, writes, 1);
+    OC_STATS_ADD(ocp, written, n);
+    chSysUnlock();
+
+    /* Synchronous write.*/
+    if (ocp->writevf != NULL) {
+      error = ocp->writevf(ocp, objs, n, false);
+    }
+    else {
+      error = ocp->writef(ocp, objp, false);
+    }
+
+    /* Releasing the objects, they are still dirty in case of error.*/
+    chSysLock();
+    for (i = (ucnt_t)0; i < n; i++) {
+      if (error) {
+        objs[i]->obj_flags |= OC_FLAG_LAZYWRITE;
+      }
+      chCacheReleaseObjectI(ocp, objs[i]);
+    }
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+
+  return error;
+}
+
+#if (CH_CFG_OBJ_CACHES_STATS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a snapshot of the cache statistics.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[out] ocsp     pointer to a @p oc_stats_t structure
+ *
+ * @api
+ */
+void chCacheGetStats(objects_cache_t *ocp, oc_stats_t *ocsp) {
+
+  chDbgCheck((ocp != NULL) && (ocsp != NULL));
+
+  chSysLock();
+  *ocsp = ocp->stats;
+  chSysUnlock();
+}
+#endif
+
 #endif /* CH_CFG_USE_OBJ_CACHES == TRUE */
 
 /** @} */
@@ -48,9 +48,21 @@
 /*===========================================================================*/
 
 /*
- * Defaults on the best synchronization mechanism available.
+ * Defaults on the best synchronization mechanism available, in SPSC mode
+ * there is a single writer and a single reader so no serialization is
+ * required and the common data is updated lock-free.
  */
-#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+#if CH_CFG_PIPES_SPSC == TRUE
+#define PC_INIT(p)
+#define PC_LOCK(p)
+#define PC_UNLOCK(p)
+#define PW_INIT(p)
+#define PW_LOCK(p)
+#define PW_UNLOCK(p)
+#define PR_INIT(p)
+#define PR_LOCK(p)
+#define PR_UNLOCK(p)
+#elif (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
 #define PC_INIT(p)       chMtxObjectInit(&(p)->cmtx)
 #define PC_LOCK(p)       chMtxLock(&(p)->cmtx)
 #define PC_UNLOCK(p)     chMtxUnlock(&(p)->cmtx)
@@ -111,7 +123,12 @@ static size_t pipe_write(pipe_t *pp, const uint8_t *bp, size_t n) {
   if (n > chPipeGetFreeCount(pp)) {
     n = chPipeGetFreeCount(pp);
   }
+#if CH_CFG_PIPES_SPSC == FALSE
   pp->cnt += n;
+#else
+  /* The free space must be evaluated before writing into it.*/
+  CH_OSLIB_MEMORY_BARRIER();
+#endif
 
   /* Number of bytes before buffer limit.*/
   /*lint -save -e9033 [10.8] Checked to be safe.*/
@@ -134,6 +151,12 @@ static size_t pipe_write(pipe_t *pp, const uint8_t *bp, size_t n) {
     pp->wrptr = pp->buffer;
   }
 
+#if CH_CFG_PIPES_SPSC == TRUE
+  /* The data must be written before being published.*/
+  CH_OSLIB_MEMORY_BARRIER();
+  pp->wrcnt += n;
+#endif
+
   PC_UNLOCK(pp);
 
   return n;
@@ -162,7 +185,12 @@ static size_t pipe_read(pipe_t *pp, uint8_t *bp, size_t n) {
   if (n > chPipeGetUsedCount(pp)) {
     n = chPipeGetUsedCount(pp);
   }
+#if CH_CFG_PIPES_SPSC == FALSE
   pp->cnt -= n;
+#else
+  /* The available data must be evaluated before reading it.*/
+  CH_OSLIB_MEMORY_BARRIER();
+#endif
 
   /* Number of bytes before buffer limit.*/
   /*lint -save -e9033 [10.8] Checked to be safe.*/
@@ -185,11 +213,93 @@ static size_t pipe_read(pipe_t *pp, uint8_t *bp, size_t n) {
     pp->rdptr = pp->buffer;
   }
 
+#if CH_CFG_PIPES_SPSC == TRUE
+  /* The data must be read before the space is released.*/
+  CH_OSLIB_MEMORY_BARRIER();
+  pp->rdcnt += n;
+#endif
+
   PC_UNLOCK(pp);
 
   return n;
 }
 
+/**
+ * @brief   Resumes a thread waiting on a pipe, if any.
+ * @note    In SPSC mode the kernel is entered only if there is a waiting
+ *          thread, the barrier orders the check after the counters update.
+ *
+ * @param[in] trp       pointer to the thread reference
+ *
+ * @notapi
+ */
+static void pipe_wakeup(thread_reference_t *trp) {
+
+#if CH_CFG_PIPES_SPSC == TRUE
+  CH_OSLIB_MEMORY_BARRIER();
+  if (*trp == NULL) {
+    return;
+  }
+#endif
+
+  chThdResume(trp, MSG_OK);
+}
+
+/**
+ * @brief   Describes a pipe buffer region as spans.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] p         pointer to the region start inside the buffer
+ * @param[in] n         size of the region
+ * @param[out] spp      pointer to the spans descriptor
+ *
+ * @notapi
+ */
+static void pipe_spans(pipe_t *pp, uint8_t *p, size_t n, pipe_span_t *spp) {
+  size_t s1;
+
+  /* Number of bytes before buffer limit.*/
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(pp->top - p);
+  /*lint -restore*/
+
+  spp->buf1 = p;
+  if (n <= s1) {
+    spp->n1   = n;
+    spp->buf2 = NULL;
+    spp->n2   = (size_t)0;
+  }
+  else {
+    spp->n1   = s1;
+    spp->buf2 = pp->buffer;
+    spp->n2   = n - s1;
+  }
+}
+
+/**
+ * @brief   Advances a pipe buffer pointer.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] p         pointer inside the buffer
+ * @param[in] n         number of bytes
+ * @return              The advanced pointer.
+ *
+ * @notapi
+ */
+static uint8_t *pipe_advance(pipe_t *pp, uint8_t *p, size_t n) {
+  size_t s1;
+
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(pp->top - p);
+  /*lint -restore*/
+
+  if (n < s1) {
+    return p + n;
+  }
+
+  return pp->buffer + (n - s1);
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -212,7 +322,12 @@ void chPipeObjectInit(pipe_t *pp, uint8_t *buf, size_t n) {
   pp->rdptr  = buf;
   pp->wrptr  = buf;
   pp->top    = &buf[n];
+#if CH_CFG_PIPES_SPSC == FALSE
   pp->cnt    = (size_t)0;
+#else
+  pp->wrcnt  = (size_t)0;
+  pp->rdcnt  = (size_t)0;
+#endif
   pp->reset  = false;
   pp->wtr    = NULL;
   pp->rtr    = NULL;
@@ -228,6 +343,8 @@ void chPipeObjectInit(pipe_t *pp, uint8_t *buf, size_t n) {
  * @post    The pipe is in reset state, all operations will fail and
  *          return @p MSG_RESET until the mailbox is enabled again using
  *          @p chPipeResumeX().
+ * @note    In SPSC mode the pipe must not be reset while a transfer is in
+ *          progress, waiting peers are allowed.
  *
  * @param[in] pp        the pointer to an initialized @p pipe_t object
  *
@@ -241,7 +358,12 @@ void chPipeReset(pipe_t *pp) {
 
   pp->wrptr = pp->buffer;
   pp->rdptr = pp->buffer;
+#if CH_CFG_PIPES_SPSC == FALSE
   pp->cnt   = (size_t)0;
+#else
+  pp->wrcnt = (size_t)0;
+  pp->rdcnt = (size_t)0;
+#endif
   pp->reset = true;
 
   chSysLock();
@@ -296,7 +418,13 @@ size_t chPipeWriteTimeout(pipe_t *pp, const uint8_t *bp,
       msg_t msg;
 
       chSysLock();
-      msg = chThdSuspendTimeoutS(&pp->wtr, timeout);
+      /* The peer could have operated on the pipe after the check.*/
+      if (chPipeGetFreeCount(pp) == (size_t)0) {
+        msg = chThdSuspendTimeoutS(&pp->wtr, timeout);
+      }
+      else {
+        msg = MSG_OK;
+      }
       chSysUnlock();
 
       /* Anything except MSG_OK causes the operation to stop.*/
@@ -309,7 +437,7 @@ size_t chPipeWriteTimeout(pipe_t *pp, const uint8_t *bp,
       bp += done;
 
       /* Resuming the reader, if present.*/
-      chThdResume(&pp->rtr, MSG_OK);
+      pipe_wakeup(&pp->rtr);
     }
   }
 
@@ -361,7 +489,13 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
       msg_t msg;
 
       chSysLock();
-      msg = chThdSuspendTimeoutS(&pp->rtr, timeout);
+      /* The peer could have operated on the pipe after the check.*/
+      if (chPipeGetUsedCount(pp) == (size_t)0) {
+        msg = chThdSuspendTimeoutS(&pp->rtr, timeout);
+      }
+      else {
+        msg = MSG_OK;
+      }
       chSysUnlock();
 
       /* Anything except MSG_OK causes the operation to stop.*/
@@ -374,7 +508,7 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
       bp += done;
 
       /* Resuming the writer, if present.*/
-      chThdResume(&pp->wtr, MSG_OK);
+      pipe_wakeup(&pp->wtr);
     }
   }
 
@@ -383,6 +517,291 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Reserves space for writing in place into a pipe.
+ * @details The function waits until @p n bytes are free in the pipe then
+ *          returns the free region as up to two contiguous spans, the
+ *          caller fills the spans then makes the data available to readers
+ *          using @p chPipeWriteCommit(). On timeout the free region
+ *          available at that time is returned.
+ * @note    If the returned size is not zero then the pipe write side stays
+ *          locked, other writers are blocked until the reservation is
+ *          committed.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes to be reserved, the value 0 is
+ *                      reserved, it must not exceed the pipe size
+ * @param[out] spp      pointer to the spans descriptor
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively reserved. A number
+ *                      lower than @p n means that a timeout occurred, zero
+ *                      also means that the pipe went in reset state, in
+ *                      this case the reservation must not be committed.
+ *
+ * @api
+ */
+size_t chPipeWriteReserve(pipe_t *pp, size_t n, pipe_span_t *spp,
+                          sysinterval_t timeout) {
+
+  chDbgCheck((n > 0U) && (n <= chPipeGetSize(pp)) && (spp != NULL));
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return (size_t)0;
+  }
+
+  PW_LOCK(pp);
+
+  /* Waiting for enough free space, the free counter is checked within the
+     critical zone so that a wakeup from the reader cannot be lost.*/
+  chSysLock();
+  while (chPipeGetFreeCount(pp) < n) {
+    if (chThdSuspendTimeoutS(&pp->wtr, timeout) != MSG_OK) {
+      if (pp->reset) {
+        n = (size_t)0;
+      }
+      else if (n > chPipeGetFreeCount(pp)) {
+        n = chPipeGetFreeCount(pp);
+      }
+      break;
+    }
+  }
+  chSysUnlock();
+
+  if (n == (size_t)0) {
+    PW_UNLOCK(pp);
+    return (size_t)0;
+  }
+
+  PC_LOCK(pp);
+  pipe_spans(pp, pp->wrptr, n, spp);
+  PC_UNLOCK(pp);
+
+  return n;
+}
+
+/**
+ * @brief   Commits data written in place into a pipe.
+ * @details The first @p n bytes of the region returned by
+ *          @p chPipeWriteReserve() become available to readers and the
+ *          write side of the pipe is unlocked.
+ * @note    If the pipe has been reset after the reservation then the data
+ *          is discarded.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes to be committed, it can be zero
+ *                      and must not exceed the reserved size
+ *
+ * @api
+ */
+void chPipeWriteCommit(pipe_t *pp, size_t n) {
+
+  PC_LOCK(pp);
+
+  if (!pp->reset) {
+    chDbgCheck(n <= chPipeGetFreeCount(pp));
+
+#if CH_CFG_PIPES_SPSC == FALSE
+    pp->cnt  += n;
+#else
+    /* The data must be written before being published.*/
+    CH_OSLIB_MEMORY_BARRIER();
+    pp->wrcnt += n;
+#endif
+    pp->wrptr = pipe_advance(pp, pp->wrptr, n);
+  }
+
+  PC_UNLOCK(pp);
+
+  /* Resuming the reader, if present.*/
+  if (n > (size_t)0) {
+    pipe_wakeup(&pp->rtr);
+  }
+
+  PW_UNLOCK(pp);
+}
+
+/**
+ * @brief   Accesses data in place into a pipe.
+ * @details The function waits until @p n bytes are available in the pipe
+ *          then returns the data region as up to two contiguous spans, the
+ *          caller processes the data then frees it using
+ *          @p chPipeReadConsume(). On timeout the data available at that
+ *          time is returned.
+ * @note    If the returned size is not zero then the pipe read side stays
+ *          locked, other readers are blocked until the data is consumed.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes to be accessed, the value 0 is
+ *                      reserved, it must not exceed the pipe size
+ * @param[out] spp      pointer to the spans descriptor
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively accessible. A number
+ *                      lower than @p n means that a timeout occurred, zero
+ *                      also means that the pipe went in reset state, in
+ *                      this case the data must not be consumed.
+ *
+ * @api
+ */
+size_t chPipeReadPeek(pipe_t *pp, size_t n, pipe_span_t *spp,
+                      sysinterval_t timeout) {
+
+  chDbgCheck((n > 0U) && (n <= chPipeGetSize(pp)) && (spp != NULL));
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return (size_t)0;
+  }
+
+  PR_LOCK(pp);
+
+  /* Waiting for enough data, the used counter is checked within the
+     critical zone so that a wakeup from the writer cannot be lost.*/
+  chSysLock();
+  while (chPipeGetUsedCount(pp) < n) {
+    if (chThdSuspendTimeoutS(&pp->rtr, timeout) != MSG_OK) {
+      if (pp->reset) {
+        n = (size_t)0;
+      }
+      else if (n > chPipeGetUsedCount(pp)) {
+        n = chPipeGetUsedCount(pp);
+      }
+      break;
+    }
+  }
+  chSysUnlock();
+
+  if (n == (size_t)0) {
+    PR_UNLOCK(pp);
+    return (size_t)0;
+  }
+
+  PC_LOCK(pp);
+  pipe_spans(pp, pp->rdptr, n, spp);
+  PC_UNLOCK(pp);
+
+  return n;
+}
+
+/**
+ * @brief   Consumes data accessed in place into a pipe.
+ * @details The first @p n bytes of the region returned by
+ *          @p chPipeReadPeek() are removed from the pipe, the space becomes
+ *          available to writers and the read side of the pipe is unlocked.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes to be consumed, it can be zero
+ *                      and must not exceed the accessed size
+ *
+ * @api
+ */
+void chPipeReadConsume(pipe_t *pp, size_t n) {
+
+  PC_LOCK(pp);
+
+  if (!pp->reset) {
+    chDbgCheck(n <= chPipeGetUsedCount(pp));
+
+#if CH_CFG_PIPES_SPSC == FALSE
+    pp->cnt  -= n;
+#else
+    /* The data must be read before the space is released.*/
+    CH_OSLIB_MEMORY_BARRIER();
+    pp->rdcnt += n;
+#endif
+    pp->rdptr = pipe_advance(pp, pp->rdptr, n);
+  }
+
+  PC_UNLOCK(pp);
+
+  /* Resuming the writer, if present.*/
+  if (n > (size_t)0) {
+    pipe_wakeup(&pp->wtr);
+  }
+
+  PR_UNLOCK(pp);
+}
+
+#if (CH_CFG_PIPES_SPSC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Pipe non-blocking write.
+ * @details The function writes data from a buffer to a pipe. The
+ *          operation completes when the specified amount of data has been
+ *          transferred or when the pipe buffer has been filled.
+ * @note    This function is only available in SPSC mode, it can be used
+ *          by an ISR feeding a thread.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @return              The number of bytes effectively transferred.
+ *
+ * @iclass
+ */
+size_t chPipeWriteI(pipe_t *pp, const uint8_t *bp, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck(n > 0U);
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return (size_t)0;
+  }
+
+  n = pipe_write(pp, bp, n);
+  if (n > (size_t)0) {
+    /* Resuming the reader, if present.*/
+    chThdResumeI(&pp->rtr, MSG_OK);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Pipe non-blocking read.
+ * @details The function reads data from a pipe into a buffer. The
+ *          operation completes when the specified amount of data has been
+ *          transferred or when the pipe buffer has been emptied.
+ * @note    This function is only available in SPSC mode, it can be used
+ *          by an ISR draining a pipe fed by a thread.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @return              The number of bytes effectively transferred.
+ *
+ * @iclass
+ */
+size_t chPipeReadI(pipe_t *pp, uint8_t *bp, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck(n > 0U);
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return (size_t)0;
+  }
+
+  n = pipe_read(pp, bp, n);
+  if (n > (size_t)0) {
+    /* Resuming the writer, if present.*/
+    chThdResumeI(&pp->wtr, MSG_OK);
+  }
+
+  return n;
+}
+#endif /* CH_CFG_PIPES_SPSC == TRUE */
+
 #endif /* CH_CFG_USE_PIPES == TRUE */
 
 /** @} */
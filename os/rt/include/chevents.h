@@ -41,10 +41,33 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Event listeners flags index.
+ * @details If enabled then an event source keeps a chain of listeners for
+ *          each flag, a listener is linked in the chains of all the flags
+ *          in its mask. @p chEvtBroadcastFlagsI() only visits the chains
+ *          of the broadcasted flags.
+ * @note    In this mode the flags are only added to the listeners that are
+ *          signaled, the flags not matching the listener mask are not
+ *          accumulated.
+ * @note    The index requires one pointer per flag in both the event source
+ *          and the event listener structures.
+ */
+#if !defined(CH_CFG_USE_EVENTS_INDEX) || defined(__DOXYGEN__)
+#define CH_CFG_USE_EVENTS_INDEX             FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of chains in the event flags index, one for each flag.
+ */
+#define CH_EVT_INDEX_SIZE   (sizeof (eventflags_t) * 8U)
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -66,6 +89,11 @@ struct event_listener {
                                                     by the event source.    */
   eventflags_t          wflags;         /**< @brief Flags that this listener
                                                     interested in.          */
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+  event_listener_t      *inext[CH_EVT_INDEX_SIZE]; /**< @brief Next listener
+                                                    in the chain of each
+                                                    flag.                   */
+#endif
 };
 
 /**
@@ -75,6 +103,11 @@ typedef struct event_source {
   event_listener_t      *next;          /**< @brief First Event Listener
                                                     registered on the Event
                                                     Source.                 */
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+  event_listener_t      *index[CH_EVT_INDEX_SIZE]; /**< @brief First listener
+                                                    in the chain of each
+                                                    flag.                   */
+#endif
 } event_source_t;
 
 /**
@@ -102,7 +135,11 @@ typedef void (*evhandler_t)(eventid_t id);
  *          source that is part of a bigger structure.
  * @param name          the name of the event source variable
  */
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+#define _EVENTSOURCE_DATA(name) {(event_listener_t *)(&name), {NULL}}
+#else
 #define _EVENTSOURCE_DATA(name) {(event_listener_t *)(&name)}
+#endif
 
 /**
  * @brief   Static event source initializer.
@@ -169,6 +206,13 @@ extern "C" {
  * @init
  */
 static inline void chEvtObjectInit(event_source_t *esp) {
+#if CH_CFG_USE_EVENTS_INDEX == TRUE
+  unsigned i;
+
+  for (i = 0U; i < CH_EVT_INDEX_SIZE; i++) {
+    esp->index[i] = NULL;
+  }
+#endif
 
   esp->next = (event_listener_t *)esp;
 }
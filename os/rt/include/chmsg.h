@@ -46,6 +46,17 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Message descriptor.
+ * @details The descriptor is located on the sender stack and is valid until
+ *          the sender is released, the payload is not copied.
+ */
+typedef struct ch_msg_payload {
+  msg_t                 msg;        /**< @brief Message.                    */
+  void                  *buf;       /**< @brief Payload buffer or @p NULL.  */
+  size_t                size;       /**< @brief Payload size.               */
+} msg_payload_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -58,10 +69,15 @@
 extern "C" {
 #endif
   msg_t chMsgSend(thread_t *tp, msg_t msg);
+  msg_t chMsgSendPayload(thread_t *tp, msg_t msg, void *buf, size_t size);
   thread_t *chMsgWaitS(void);
   thread_t *chMsgWaitTimeoutS(sysinterval_t timeout);
   thread_t *chMsgPollS(void);
+  size_t chMsgWaitBatchTimeoutS(thread_t **tpp, size_t n,
+                                sysinterval_t timeout);
   void chMsgRelease(thread_t *tp, msg_t msg);
+  void chMsgReleaseBatch(thread_t **tpp, const msg_t *msgs, size_t n);
+  void chMsgReleaseBatchS(thread_t **tpp, const msg_t *msgs, size_t n);
 #ifdef __cplusplus
 }
 #endif
@@ -156,6 +172,62 @@ static inline thread_t *chMsgPoll(void) {
   return tp;
 }
 
+/**
+ * @brief   Suspends the thread and waits for incoming messages.
+ * @details The function waits for at least one message then all the
+ *          pending messages are received, up to the specified number.
+ * @post    The function @p chMsgReleaseBatch() or @p chMsgRelease() must
+ *          be invoked for each received message in order to acknowledge
+ *          the reception and send the answer.
+ * @note    The reference counters of the sender threads are not increased,
+ *          the returned pointers are temporary references.
+ *
+ * @param[out] tpp      array receiving the pointers to the threads
+ *                      carrying the messages
+ * @param[in] n         size of the array, must be greater than zero
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of received messages.
+ * @retval 0            if a timeout occurred.
+ *
+ * @api
+ */
+static inline size_t chMsgWaitBatchTimeout(thread_t **tpp, size_t n,
+                                           sysinterval_t timeout) {
+  size_t received;
+
+  chSysLock();
+  received = chMsgWaitBatchTimeoutS(tpp, n, timeout);
+  chSysUnlock();
+
+  return received;
+}
+
+/**
+ * @brief   Suspends the thread and waits for incoming messages.
+ * @details The function waits for at least one message then all the
+ *          pending messages are received, up to the specified number.
+ * @post    The function @p chMsgReleaseBatch() or @p chMsgRelease() must
+ *          be invoked for each received message in order to acknowledge
+ *          the reception and send the answer.
+ * @note    The reference counters of the sender threads are not increased,
+ *          the returned pointers are temporary references.
+ *
+ * @param[out] tpp      array receiving the pointers to the threads
+ *                      carrying the messages
+ * @param[in] n         size of the array, must be greater than zero
+ * @return              The number of received messages.
+ *
+ * @api
+ */
+static inline size_t chMsgWaitBatch(thread_t **tpp, size_t n) {
+
+  return chMsgWaitBatchTimeout(tpp, n, TIME_INFINITE);
+}
+
 /**
  * @brief   Evaluates to @p true if the thread has pending messages.
  *
@@ -185,7 +257,30 @@ static inline msg_t chMsgGet(thread_t *tp) {
 
   chDbgAssert(tp->state == CH_STATE_SNDMSG, "invalid state");
 
-  return tp->u.sentmsg;
+  return tp->u.sentpayload->msg;
+}
+
+/**
+ * @brief   Returns the payload carried by the specified thread.
+ * @details The payload buffer belongs to the sender, it can be accessed
+ *          in place, for reading or writing, until the sender is released.
+ * @pre     This function must be invoked after receiving the message and
+ *          before releasing the sender.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[out] sizep    pointer to a variable receiving the payload size
+ * @return              Pointer to the payload buffer.
+ * @retval NULL         if the message has no payload.
+ *
+ * @api
+ */
+static inline void *chMsgGetPayload(thread_t *tp, size_t *sizep) {
+
+  chDbgAssert(tp->state == CH_STATE_SNDMSG, "invalid state");
+
+  *sizep = tp->u.sentpayload->size;
+
+  return tp->u.sentpayload->buf;
 }
 
 /**
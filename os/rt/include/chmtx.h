@@ -38,10 +38,27 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Mutexes spin count.
+ * @details In multi-core mode @p chMtxLock() polls a mutex owned by a
+ *          thread running on another core up to this number of times
+ *          before queuing the calling thread, short critical zones are
+ *          waited without context switches.
+ * @note    Zero disables spinning, the option has no effect in single
+ *          core mode.
+ */
+#if !defined(CH_CFG_MUTEXES_SPIN_COUNT) || defined(__DOXYGEN__)
+#define CH_CFG_MUTEXES_SPIN_COUNT           0
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_MUTEXES_SPIN_COUNT < 0
+#error "invalid CH_CFG_MUTEXES_SPIN_COUNT value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -99,6 +116,11 @@ struct ch_mutex {
 #ifdef __cplusplus
 extern "C" {
 #endif
+#if ((CH_CFG_SMP_MODE == TRUE) && (CH_CFG_MUTEXES_SPIN_COUNT > 0)) ||        \
+    defined(__DOXYGEN__)
+  void _mtx_spin(mutex_t *mp);
+#endif
+  void _mtx_boost_priority(thread_t *tp, tprio_t prio);
   void chMtxObjectInit(mutex_t *mp);
   void chMtxLock(mutex_t *mp);
   void chMtxLockS(mutex_t *mp);
@@ -70,6 +70,20 @@ typedef struct {
   uint8_t   off_time;               /**< @brief Offset of @p time field.    */
 } chdebug_t;
 
+#if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a thread statistics snapshot.
+ * @note    Times are expressed in realtime counter cycles.
+ */
+typedef struct {
+  rttime_t  cumulative;             /**< @brief Cumulative run time.        */
+  rtcnt_t   worst_run;              /**< @brief Longest run slice.          */
+  rtcnt_t   worst_lat;              /**< @brief Worst scheduling latency.   */
+  ucnt_t    n_switches;             /**< @brief Number of switch-ins.       */
+  size_t    stack_unused;           /**< @brief Never used stack space.     */
+} thread_stats_t;
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -92,10 +106,10 @@ typedef struct {
  * @param[in] tp        thread to add to the registry
  */
 #define REG_INSERT(tp) {                                                    \
-  (tp)->newer = (thread_t *)&ch.rlist;                                      \
-  (tp)->older = ch.rlist.older;                                             \
+  (tp)->newer = (thread_t *)&currcore->rlist;                               \
+  (tp)->older = currcore->rlist.older;                                      \
   (tp)->older->newer = (tp);                                                \
-  ch.rlist.older = (tp);                                                    \
+  currcore->rlist.older = (tp);                                             \
 }
 
 /*===========================================================================*/
@@ -111,6 +125,9 @@ extern "C" {
   thread_t *chRegFindThreadByName(const char *name);
   thread_t *chRegFindThreadByPointer(thread_t *tp);
   thread_t *chRegFindThreadByWorkingArea(stkalign_t *wa);
+#if CH_DBG_STATISTICS == TRUE
+  void chRegGetThreadStatsX(thread_t *tp, thread_stats_t *tsp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -133,7 +150,7 @@ extern "C" {
 static inline void chRegSetThreadName(const char *name) {
 
 #if CH_CFG_USE_REGISTRY == TRUE
-  ch.rlist.current->name = name;
+  currcore->rlist.current->name = name;
 #else
   (void)name;
 #endif
@@ -0,0 +1,187 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    rt/include/chrwlock.h
+ * @brief   Readers-writer locks macros and structures.
+ *
+ * @addtogroup rwlocks
+ * @{
+ */
+
+#ifndef CHRWLOCK_H
+#define CHRWLOCK_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Readers-writer locks APIs.
+ * @details If enabled then the readers-writer locks APIs are included in
+ *          the kernel.
+ * @note    Requires @p CH_CFG_USE_MUTEXES.
+ */
+#if !defined(CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_RWLOCKS                  FALSE
+#endif
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_MUTEXES == FALSE
+#error "CH_CFG_USE_RWLOCKS requires CH_CFG_USE_MUTEXES"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a readers-writer lock structure.
+ */
+typedef struct ch_rwlock rwlock_t;
+
+/**
+ * @brief   Reader structure.
+ * @details A reader structure is provided by the caller for each read
+ *          access, it links the reader thread to the lock in order to
+ *          allow a waiting writer to boost its priority.
+ */
+typedef struct ch_rwlock_reader {
+  struct ch_rwlock_reader *next;    /**< @brief Next reader of the lock.   */
+  struct ch_rwlock_reader *tnext;   /**< @brief Next read lock held by the
+                                                reader thread.              */
+  thread_t              *tp;        /**< @brief Reader thread.              */
+  rwlock_t              *rwp;       /**< @brief The locked readers-writer
+                                                lock.                       */
+} rwlock_reader_t;
+
+/**
+ * @brief   Readers-writer lock structure.
+ */
+struct ch_rwlock {
+  mutex_t               mtx;        /**< @brief Mutex owned by the writer,
+                                                readers are queued on it
+                                                while a writer is active.   */
+  threads_queue_t       queue;      /**< @brief Writer waiting for the
+                                                readers to leave.           */
+  cnt_t                 readers;    /**< @brief Number of active readers.   */
+  rwlock_reader_t       *rdlist;    /**< @brief List of the active
+                                                readers.                    */
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static readers-writer lock initializer.
+ * @details This macro should be used when statically initializing a
+ *          readers-writer lock that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the readers-writer lock variable
+ */
+#define _RWLOCK_DATA(name) {_MUTEX_DATA(name.mtx),                          \
+                            _THREADS_QUEUE_DATA(name.queue),                \
+                            (cnt_t)0,                                       \
+                            NULL}
+
+/**
+ * @brief   Static readers-writer lock initializer.
+ * @details Statically initialized readers-writer locks require no explicit
+ *          initialization using @p chRWLockObjectInit().
+ *
+ * @param[in] name      the name of the readers-writer lock variable
+ */
+#define RWLOCK_DECL(name) rwlock_t name = _RWLOCK_DATA(name)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  tprio_t _rwlock_inherited_prio(thread_t *tp, tprio_t prio);
+  void chRWLockObjectInit(rwlock_t *rwp);
+  void chRWLockReadLock(rwlock_t *rwp, rwlock_reader_t *rdp);
+  void chRWLockReadLockS(rwlock_t *rwp, rwlock_reader_t *rdp);
+  bool chRWLockTryReadLock(rwlock_t *rwp, rwlock_reader_t *rdp);
+  bool chRWLockTryReadLockS(rwlock_t *rwp, rwlock_reader_t *rdp);
+  void chRWLockReadUnlock(rwlock_t *rwp, rwlock_reader_t *rdp);
+  void chRWLockReadUnlockS(rwlock_t *rwp, rwlock_reader_t *rdp);
+  void chRWLockWriteLock(rwlock_t *rwp);
+  void chRWLockWriteLockS(rwlock_t *rwp);
+  bool chRWLockTryWriteLock(rwlock_t *rwp);
+  bool chRWLockTryWriteLockS(rwlock_t *rwp);
+  void chRWLockWriteUnlock(rwlock_t *rwp);
+  void chRWLockWriteUnlockS(rwlock_t *rwp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the number of active readers.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @return              The number of threads holding the read lock.
+ *
+ * @iclass
+ */
+static inline cnt_t chRWLockGetReadersI(rwlock_t *rwp) {
+
+  chDbgCheckClassI();
+
+  return rwp->readers;
+}
+
+/**
+ * @brief   Returns the writer thread.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @return              The thread owning the write lock or waiting for the
+ *                      readers to leave.
+ * @retval NULL         if there is no writer.
+ *
+ * @iclass
+ */
+static inline thread_t *chRWLockGetWriterI(rwlock_t *rwp) {
+
+  chDbgCheckClassI();
+
+  return rwp->mtx.owner;
+}
+
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+#endif /* CHRWLOCK_H */
+
+/** @} */
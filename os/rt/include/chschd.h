@@ -110,10 +110,117 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Bitmap-indexed ready list.
+ * @details If enabled the ready list is implemented as an array of FIFO
+ *          queues, one for each priority level, plus a bitmap of the
+ *          non-empty levels. Insertion, removal and preemption checks take
+ *          constant time regardless of the number of ready threads.
+ * @note    The default is @p FALSE.
+ * @note    The system structure grows by one queue header for each
+ *          priority level, this is a RAM/speed trade-off. With few ready
+ *          threads the linear ready list is usually faster.
+ */
+#if !defined(CH_CFG_USE_READY_BITMAP) || defined(__DOXYGEN__)
+#define CH_CFG_USE_READY_BITMAP             FALSE
+#endif
+
+/**
+ * @brief   Multi-core mode.
+ * @details If enabled the kernel runs one instance on each core, every
+ *          instance has its own ready list, virtual timers, main and idle
+ *          threads. Threads run on the core that created them, kernel
+ *          objects can be shared among cores and a thread can be awakened
+ *          by another core.
+ * @note    The default is @p FALSE.
+ * @note    Requires a port supporting SMP, the kernel lock becomes a
+ *          spinlock shared by all cores.
+ * @note    Virtual timers must be armed and disarmed by the core owning
+ *          them.
+ */
+#if !defined(CH_CFG_SMP_MODE) || defined(__DOXYGEN__)
+#define CH_CFG_SMP_MODE                     FALSE
+#endif
+
+/**
+ * @brief   Hierarchical timing wheel for virtual timers.
+ * @details If enabled the virtual timers are kept in a hierarchical timing
+ *          wheel instead of a delta list. Arming and disarming a timer
+ *          take constant time regardless of the number of armed timers,
+ *          timers are moved toward the lower levels of the wheel as time
+ *          passes.
+ * @note    The default is @p FALSE.
+ * @note    Each wheel level requires 32 list headers, this is a RAM/speed
+ *          trade-off. With few armed timers the delta list is usually
+ *          faster.
+ */
+#if !defined(CH_CFG_USE_TIMER_WHEEL) || defined(__DOXYGEN__)
+#define CH_CFG_USE_TIMER_WHEEL              FALSE
+#endif
+
+/**
+ * @brief   Number of levels in the timing wheel.
+ * @details Each level covers 32 times the range of the previous one, the
+ *          first level has a resolution of one tick. Delays exceeding the
+ *          wheel range are served in multiple rounds.
+ * @note    The default is 4 or 3 if intervals are 16 bits wide.
+ */
+#if !defined(CH_CFG_VT_WHEEL_LEVELS) || defined(__DOXYGEN__)
+#if (CH_CFG_INTERVALS_SIZE == 16) && !defined(__DOXYGEN__)
+#define CH_CFG_VT_WHEEL_LEVELS              3
+#else
+#define CH_CFG_VT_WHEEL_LEVELS              4
+#endif
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_SMP_MODE == TRUE
+#if !defined(PORT_SUPPORTS_SMP) || (PORT_SUPPORTS_SMP == FALSE)
+#error "CH_CFG_SMP_MODE requires a port supporting SMP"
+#endif
+
+#if !defined(PORT_CORES_NUMBER) || (PORT_CORES_NUMBER < 1)
+#error "invalid PORT_CORES_NUMBER value"
+#endif
+#endif
+
+#if (CH_CFG_USE_READY_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of priority levels in the ready list bitmap.
+ */
+#define CH_RLIST_LEVELS     ((unsigned)HIGHPRIO + 1U)
+
+/**
+ * @brief   Number of 32 bits words in the ready list bitmap.
+ */
+#define CH_RLIST_WORDS      (CH_RLIST_LEVELS / 32U)
+#endif
+
+#if (CH_CFG_USE_TIMER_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of bits of wheel time covered by each wheel level.
+ */
+#define CH_VT_WHEEL_BITS    5U
+
+/**
+ * @brief   Number of slots in each wheel level.
+ */
+#define CH_VT_WHEEL_SLOTS   (1U << CH_VT_WHEEL_BITS)
+
+/**
+ * @brief   Mask of the slot index in a wheel level.
+ */
+#define CH_VT_WHEEL_MASK    (CH_VT_WHEEL_SLOTS - 1U)
+
+#if (CH_CFG_VT_WHEEL_LEVELS < 2) ||                                         \
+    ((CH_CFG_VT_WHEEL_LEVELS * CH_VT_WHEEL_BITS) >= CH_CFG_INTERVALS_SIZE)
+#error "invalid CH_CFG_VT_WHEEL_LEVELS value specified"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -176,6 +283,12 @@ struct ch_thread {
    * @brief   References to this thread.
    */
   trefs_t               refs;
+#endif
+#if (CH_CFG_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Kernel instance owning this thread.
+   */
+  ch_system_t           *owner;
 #endif
   /**
    * @brief   Number of ticks remaining to this thread.
@@ -226,9 +339,12 @@ struct ch_thread {
     thread_reference_t  *wttrp;
 #if (CH_CFG_USE_MESSAGES == TRUE) || defined(__DOXYGEN__)
     /**
-     * @brief   Thread sent message.
+     * @brief   Thread sent message and payload.
+     * @note    This field is valid while the thread is in the
+     *          @p CH_STATE_SNDMSGQ or @p CH_STATE_SNDMSG states, the
+     *          descriptor is located on the sender stack.
      */
-    msg_t               sentmsg;
+    struct ch_msg_payload *sentpayload;
 #endif
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
     /**
@@ -286,6 +402,14 @@ struct ch_thread {
    */
   tprio_t               realprio;
 #endif
+#if (defined(CH_CFG_USE_RWLOCKS) && (CH_CFG_USE_RWLOCKS == TRUE)) ||        \
+    defined(__DOXYGEN__)
+  /**
+   * @brief   List of the read locks held by this thread.
+   * @note    The list is terminated by a @p NULL in this field.
+   */
+  struct ch_rwlock_reader *rdlist;
+#endif
 #if ((CH_CFG_USE_DYNAMIC == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE)) ||      \
     defined(__DOXYGEN__)
   /**
@@ -298,6 +422,10 @@ struct ch_thread {
    * @brief   Thread statistics.
    */
   time_measurement_t    stats;
+  /**
+   * @brief   Thread scheduling statistics.
+   */
+  sched_stats_t         sched_stats;
 #endif
 #if defined(CH_CFG_THREAD_EXTRA_FIELDS)
   /* Extra fields defined in chconf.h.*/
@@ -318,20 +446,63 @@ struct ch_virtual_timer {
                                                 pointer.                    */
   void                  *par;       /**< @brief Timer callback function
                                                 parameter.                  */
+#if (CH_CFG_USE_TIMER_WHEEL == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Delay still to be served after the wheel expiration.
+   * @note    In wheel mode the @p delta field contains the expiration
+   *          time in wheel time units.
+   */
+  sysinterval_t         residual;
+#endif
 };
 
+#if (CH_CFG_USE_TIMER_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Timing wheel slot header.
+ */
+struct ch_virtual_timers_slot {
+  virtual_timer_t       *next;      /**< @brief First timer in the slot.    */
+  virtual_timer_t       *prev;      /**< @brief Last timer in the slot.     */
+};
+#endif
+
 /**
  * @brief   Virtual timers list header.
  * @note    The timers list is implemented as a double link bidirectional list
  *          in order to make the unlink time constant, the reset of a virtual
  *          timer is often used in the code.
+ * @note    In timing wheel mode the delta list is replaced by the wheel
+ *          slots, each slot is a double link list of timers.
  */
 struct ch_virtual_timers_list {
+#if (CH_CFG_USE_TIMER_WHEEL == FALSE) || defined(__DOXYGEN__)
   virtual_timer_t       *next;      /**< @brief Next timer in the delta
                                                 list.                       */
   virtual_timer_t       *prev;      /**< @brief Last timer in the delta
                                                 list.                       */
   sysinterval_t         delta;      /**< @brief Must be initialized to -1.  */
+#endif
+#if (CH_CFG_USE_TIMER_WHEEL == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Wheel time, it advances together with the system time.
+   */
+  sysinterval_t         wtime;
+#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Interval between @p wtime and the next wheel event.
+   * @note    It is zero while the wheel is being processed.
+   */
+  sysinterval_t         nextdelta;
+#endif
+  /**
+   * @brief   Masks of the non-empty slots, one for each level.
+   */
+  uint32_t              wmap[CH_CFG_VT_WHEEL_LEVELS];
+  /**
+   * @brief   Wheel slots.
+   */
+  virtual_timers_slot_t slots[CH_CFG_VT_WHEEL_LEVELS][CH_VT_WHEEL_SLOTS];
+#endif
 #if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
   volatile systime_t    systime;    /**< @brief System Time counter.        */
 #endif
@@ -360,6 +531,21 @@ struct ch_ready_list {
   /* End of the fields shared with the thread_t structure.*/
   thread_t              *current;   /**< @brief The currently running
                                                 thread.                     */
+#if (CH_CFG_USE_READY_BITMAP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Mask of the non-zero words in @p prmap.
+   */
+  uint32_t              prsummary;
+  /**
+   * @brief   Mask of the non-empty priority levels.
+   */
+  uint32_t              prmap[CH_RLIST_WORDS];
+  /**
+   * @brief   FIFO queues of ready threads, one for each priority level.
+   * @note    In this mode the @p queue field is not used.
+   */
+  threads_queue_t       prqueues[CH_RLIST_LEVELS];
+#endif
 };
 
 /**
@@ -425,6 +611,12 @@ struct ch_system {
    * @brief   Global kernel statistics.
    */
   kernel_stats_t        kernel_stats;
+#endif
+#if (CH_CFG_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Identifier of the core running this instance.
+   */
+  unsigned              core_id;
 #endif
   CH_CFG_SYSTEM_EXTRA_FIELDS
 };
@@ -440,20 +632,46 @@ struct ch_system {
  */
 #define firstprio(rlp)  ((rlp)->next->prio)
 
+/**
+ * @brief   Current kernel instance pointer access macro.
+ * @note    This macro is not meant to be used in the application code but
+ *          only from within the kernel.
+ */
+#if (CH_CFG_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+#define currcore (&ch_cores[port_get_core_id()])
+#else
+#define currcore (&ch)
+#endif
+
+/**
+ * @brief   Kernel instance owning a thread.
+ *
+ * @notapi
+ */
+#if (CH_CFG_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+#define threadcore(tp) ((tp)->owner)
+#else
+#define threadcore(tp) (&ch)
+#endif
+
 /**
  * @brief   Current thread pointer access macro.
  * @note    This macro is not meant to be used in the application code but
  *          only from within the kernel, use @p chThdGetSelfX() instead.
  */
-#define currp ch.rlist.current
+#define currp currcore->rlist.current
 
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
 
 #if !defined(__DOXYGEN__)
+#if CH_CFG_SMP_MODE == TRUE
+extern ch_system_t ch_cores[PORT_CORES_NUMBER];
+#else
 extern ch_system_t ch;
 #endif
+#endif
 
 /*
  * Scheduler APIs.
@@ -464,6 +682,7 @@ extern "C" {
   void _scheduler_init(void);
   thread_t *chSchReadyI(thread_t *tp);
   thread_t *chSchReadyAheadI(thread_t *tp);
+  thread_t *chSchDequeueReadyI(thread_t *tp);
   void chSchGoSleepS(tstate_t newstate);
   msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout);
   void chSchWakeupS(thread_t *ntp, msg_t msg);
@@ -630,6 +849,73 @@ static inline thread_t *queue_dequeue(thread_t *tp) {
 }
 #endif /* CH_CFG_OPTIMIZE_SPEED == TRUE */
 
+#if (CH_CFG_USE_READY_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the position of the most significant bit set in a word.
+ * @pre     The word must not be zero.
+ *
+ * @param[in] w         the word to be scanned
+ * @return              The bit position, from 0 to 31.
+ *
+ * @notapi
+ */
+static inline unsigned ready_bitmap_msb(uint32_t w) {
+
+#if defined(__GNUC__)
+  return ((unsigned)sizeof (unsigned long) * 8U) - 1U -
+         (unsigned)__builtin_clzl((unsigned long)w);
+#else
+  unsigned n = 0U;
+
+  if ((w & 0xFFFF0000U) != 0U) {
+    w >>= 16;
+    n += 16U;
+  }
+  if ((w & 0x0000FF00U) != 0U) {
+    w >>= 8;
+    n += 8U;
+  }
+  if ((w & 0x000000F0U) != 0U) {
+    w >>= 4;
+    n += 4U;
+  }
+  if ((w & 0x0000000CU) != 0U) {
+    w >>= 2;
+    n += 2U;
+  }
+  if ((w & 0x00000002U) != 0U) {
+    n += 1U;
+  }
+
+  return n;
+#endif
+}
+#endif /* CH_CFG_USE_READY_BITMAP == TRUE */
+
+/**
+ * @brief   Returns the priority of the first thread in the ready list.
+ *
+ * @return              The highest priority among the ready threads or
+ *                      @p NOPRIO if the ready list is empty.
+ *
+ * @notapi
+ */
+static inline tprio_t ready_list_firstprio(void) {
+
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  unsigned i;
+
+  if (currcore->rlist.prsummary == 0U) {
+    return NOPRIO;
+  }
+  i = ready_bitmap_msb(currcore->rlist.prsummary);
+
+  return (tprio_t)((i << 5) | ready_bitmap_msb(currcore->rlist.prmap[i]));
+#else
+  return firstprio(&currcore->rlist.queue);
+#endif
+}
+
 /**
  * @brief   Determines if the current thread must reschedule.
  * @details This function returns @p true if there is a ready thread with
@@ -645,7 +931,7 @@ static inline bool chSchIsRescRequiredI(void) {
 
   chDbgCheckClassI();
 
-  return firstprio(&ch.rlist.queue) > currp->prio;
+  return ready_list_firstprio() > currp->prio;
 }
 
 /**
@@ -663,7 +949,7 @@ static inline bool chSchCanYieldS(void) {
 
   chDbgCheckClassS();
 
-  return firstprio(&ch.rlist.queue) >= currp->prio;
+  return ready_list_firstprio() >= currp->prio;
 }
 
 /**
@@ -690,7 +976,7 @@ static inline void chSchDoYieldS(void) {
  * @special
  */
 static inline void chSchPreemption(void) {
-  tprio_t p1 = firstprio(&ch.rlist.queue);
+  tprio_t p1 = ready_list_firstprio();
   tprio_t p2 = currp->prio;
 
 #if CH_CFG_TIME_QUANTUM > 0
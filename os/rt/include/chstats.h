@@ -60,8 +60,25 @@ typedef struct {
                                                 critical zones duration.    */
   time_measurement_t    m_crit_isr; /**< @brief Measurement of ISRs critical
                                                 zones duration.             */
+#if (CH_CFG_USE_TM_HISTOGRAMS == TRUE) || defined(__DOXYGEN__)
+  tm_histogram_t        h_crit_thd; /**< @brief Distribution of threads
+                                                critical zones duration.    */
+  tm_histogram_t        h_crit_isr; /**< @brief Distribution of ISRs
+                                                critical zones duration.    */
+#endif
 } kernel_stats_t;
 
+/**
+ * @brief   Type of a thread scheduling statistics structure.
+ */
+typedef struct {
+  ucnt_t                n_switches; /**< @brief Number of switch-ins.       */
+  rtcnt_t               t_ready;    /**< @brief Time stamp of the last
+                                                transition to ready state.  */
+  rtcnt_t               worst_lat;  /**< @brief Worst time between ready
+                                                state and running state.    */
+} sched_stats_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -75,6 +92,7 @@ extern "C" {
 #endif
   void _stats_init(void);
   void _stats_increase_irq(void);
+  void _stats_ready(thread_t *tp);
   void _stats_ctxswc(thread_t *ntp, thread_t *otp);
   void _stats_start_measure_crit_thd(void);
   void _stats_stop_measure_crit_thd(void);
@@ -92,6 +110,7 @@ extern "C" {
 
 /* Stub functions for when the statistics module is disabled. */
 #define _stats_increase_irq()
+#define _stats_ready(tp)
 #define _stats_ctxswc(old, new)
 #define _stats_start_measure_crit_thd()
 #define _stats_stop_measure_crit_thd()
@@ -275,7 +275,7 @@
 /* External declarations.                                                    */
 /*===========================================================================*/
 
-#if !defined(__DOXYGEN__)
+#if !defined(__DOXYGEN__) && (CH_CFG_SMP_MODE == FALSE)
 extern stkalign_t ch_idle_thread_wa[];
 #endif
 
@@ -370,10 +370,12 @@ static inline void chSysUnlock(void) {
   /* The following condition can be triggered by the use of i-class functions
      in a critical section not followed by a chSchRescheduleS(), this means
      that the current thread has a lower priority than the next thread in
-     the ready list.*/
-  chDbgAssert((ch.rlist.queue.next == (thread_t *)&ch.rlist.queue) ||
-              (ch.rlist.current->prio >= ch.rlist.queue.next->prio),
+     the ready list. In multi-core mode threads can be made ready by other
+     cores at any time, the core is notified and reschedules later.*/
+#if CH_CFG_SMP_MODE == FALSE
+  chDbgAssert(currcore->rlist.current->prio >= ready_list_firstprio(),
               "priority order violation");
+#endif
 
   port_unlock();
 }
@@ -460,7 +462,11 @@ static inline void chSysUnconditionalUnlock(void) {
  */
 static inline thread_t *chSysGetIdleThreadX(void) {
 
-  return ch.rlist.queue.prev;
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  return currcore->rlist.prqueues[IDLEPRIO].prev;
+#else
+  return currcore->rlist.queue.prev;
+#endif
 }
 #endif /* CH_CFG_NO_IDLE_THREAD == FALSE */
 
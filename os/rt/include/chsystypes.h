@@ -90,6 +90,11 @@ typedef struct ch_virtual_timer virtual_timer_t;
  */
 typedef struct ch_virtual_timers_list  virtual_timers_list_t;
 
+/**
+ * @brief   Type of a timing wheel slot header.
+ */
+typedef struct ch_virtual_timers_slot  virtual_timers_slot_t;
+
 /**
  * @brief   Type of a system debug structure.
  */
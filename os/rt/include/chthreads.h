@@ -271,7 +271,7 @@ extern "C" {
   */
 static inline thread_t *chThdGetSelfX(void) {
 
-  return ch.rlist.current;
+  return currcore->rlist.current;
 }
 
 /**
@@ -38,6 +38,26 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Time measurement histograms.
+ * @details If enabled then the @p tm_histogram_t measurement object is
+ *          available, it records the distribution of the measured values
+ *          and allows percentile queries.
+ */
+#if !defined(CH_CFG_USE_TM_HISTOGRAMS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_TM_HISTOGRAMS            FALSE
+#endif
+
+/**
+ * @brief   Time measurement histograms precision.
+ * @details Each power of two range of values is divided in
+ *          2^CH_CFG_TM_HISTOGRAM_PRECISION linear buckets, the relative
+ *          error of percentiles is below 1/2^CH_CFG_TM_HISTOGRAM_PRECISION.
+ */
+#if !defined(CH_CFG_TM_HISTOGRAM_PRECISION) || defined(__DOXYGEN__)
+#define CH_CFG_TM_HISTOGRAM_PRECISION       3
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -46,6 +66,28 @@
 #error "CH_CFG_USE_TM requires PORT_SUPPORTS_RT"
 #endif
 
+#if (CH_CFG_TM_HISTOGRAM_PRECISION < 1) ||                                  \
+    (CH_CFG_TM_HISTOGRAM_PRECISION > 8)
+#error "invalid CH_CFG_TM_HISTOGRAM_PRECISION value"
+#endif
+
+/**
+ * @brief   Number of linear buckets in each power of two range.
+ */
+#define CH_TM_HISTOGRAM_SUB_BUCKETS                                         \
+  (1U << (unsigned)CH_CFG_TM_HISTOGRAM_PRECISION)
+
+/**
+ * @brief   Number of buckets in a histogram.
+ * @details Values below @p CH_TM_HISTOGRAM_SUB_BUCKETS have their own
+ *          bucket, each following power of two range is split in
+ *          @p CH_TM_HISTOGRAM_SUB_BUCKETS buckets.
+ */
+#define CH_TM_HISTOGRAM_BUCKETS                                             \
+  ((((unsigned)sizeof (rtcnt_t) * 8U) -                                     \
+    (unsigned)CH_CFG_TM_HISTOGRAM_PRECISION + 1U) *                         \
+   CH_TM_HISTOGRAM_SUB_BUCKETS)
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -77,6 +119,24 @@ typedef struct {
   rttime_t              cumulative;     /**< @brief Cumulative measurement. */
 } time_measurement_t;
 
+#if (CH_CFG_USE_TM_HISTOGRAMS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of an histogram-backed Time Measurement object.
+ * @note    Recording a measurement takes constant time, it can be done
+ *          from any context.
+ */
+typedef struct {
+  /**
+   * @brief   Measurement statistics.
+   */
+  time_measurement_t    tm;
+  /**
+   * @brief   Measurements counters.
+   */
+  ucnt_t                buckets[CH_TM_HISTOGRAM_BUCKETS];
+} tm_histogram_t;
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -94,6 +154,16 @@ extern "C" {
   NOINLINE void chTMStopMeasurementX(time_measurement_t *tmp);
   NOINLINE void chTMChainMeasurementToX(time_measurement_t *tmp1,
                                         time_measurement_t *tmp2);
+#if CH_CFG_USE_TM_HISTOGRAMS == TRUE
+  void chTMHistogramObjectInit(tm_histogram_t *hp);
+  void chTMHistogramResetX(tm_histogram_t *hp);
+  NOINLINE void chTMHistogramStartX(tm_histogram_t *hp);
+  NOINLINE void chTMHistogramStopX(tm_histogram_t *hp);
+  void chTMHistogramAddX(tm_histogram_t *hp, rtcnt_t value);
+  void chTMHistogramMergeX(tm_histogram_t *dhp, const tm_histogram_t *shp);
+  rtcnt_t chTMHistogramGetPercentileX(const tm_histogram_t *hp,
+                                      uint32_t ppm);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -42,6 +42,24 @@
 #define CH_TRACE_TYPE_ISR_LEAVE             3U
 #define CH_TRACE_TYPE_HALT                  4U
 #define CH_TRACE_TYPE_USER                  5U
+#define CH_TRACE_TYPE_OBJECT                6U
+#define CH_TRACE_TYPE_DROP                  7U
+/** @} */
+
+/**
+ * @name    Kernel object operations
+ * @note    Stored in the @p state field of @p CH_TRACE_TYPE_OBJECT records.
+ * @{
+ */
+#define CH_TRACE_OP_SEM_WAIT                0U
+#define CH_TRACE_OP_SEM_SIGNAL              1U
+#define CH_TRACE_OP_MTX_LOCK                2U
+#define CH_TRACE_OP_MTX_UNLOCK              3U
+#define CH_TRACE_OP_MB_POST                 4U
+#define CH_TRACE_OP_MB_FETCH                5U
+#define CH_TRACE_OP_VT_SET                  6U
+#define CH_TRACE_OP_VT_RESET                7U
+#define CH_TRACE_OP_VT_FIRE                 8U
 /** @} */
 
 /**
@@ -54,6 +72,7 @@
 #define CH_DBG_TRACE_MASK_ISR               2U
 #define CH_DBG_TRACE_MASK_HALT              4U
 #define CH_DBG_TRACE_MASK_USER              8U
+#define CH_DBG_TRACE_MASK_OBJECTS           16U
 #define CH_DBG_TRACE_MASK_SLOW              (CH_DBG_TRACE_MASK_SWITCH |     \
                                              CH_DBG_TRACE_MASK_HALT |       \
                                              CH_DBG_TRACE_MASK_USER)
@@ -61,6 +80,8 @@
                                              CH_DBG_TRACE_MASK_ISR |        \
                                              CH_DBG_TRACE_MASK_HALT |       \
                                              CH_DBG_TRACE_MASK_USER)
+#define CH_DBG_TRACE_MASK_FULL              (CH_DBG_TRACE_MASK_ALL |        \
+                                             CH_DBG_TRACE_MASK_OBJECTS)
 /** @} */
 
 /*===========================================================================*/
@@ -86,12 +107,47 @@
 #if !defined(CH_DBG_TRACE_BUFFER_SIZE) || defined(__DOXYGEN__)
 #define CH_DBG_TRACE_BUFFER_SIZE            128
 #endif
+
+/**
+ * @brief   Streaming trace mode.
+ * @details If enabled the trace buffer is handled as a FIFO drained by
+ *          @p chDbgReadTrace() or @p chDbgDrainTrace(), records are never
+ *          overwritten. When the FIFO is full new records are discarded and
+ *          a @p CH_TRACE_TYPE_DROP record reports the number of lost
+ *          records in the stream.
+ */
+#if !defined(CH_DBG_TRACE_STREAM) || defined(__DOXYGEN__)
+#define CH_DBG_TRACE_STREAM                 FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_DBG_TRACE_STREAM == TRUE) && (CH_DBG_TRACE_BUFFER_SIZE < 4)
+#error "CH_DBG_TRACE_STREAM requires CH_DBG_TRACE_BUFFER_SIZE >= 4"
+#endif
+
+/**
+ * @name    Trace stream format
+ * @{
+ */
+/**
+ * @brief   Trace stream format version.
+ */
+#define CH_TRACE_STREAM_VERSION             1U
+
+/**
+ * @brief   Maximum size of an encoded trace record.
+ * @note    Records are made of an header byte followed by up to four
+ *          variable length integers.
+ */
+#define CH_TRACE_STREAM_RECORD_SIZE         (1U + (4U *                     \
+                                             (((sizeof (uintptr_t) * 8U) +  \
+                                               6U) / 7U)))
+/** @} */
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -165,6 +221,28 @@ typedef struct {
        */
       void                  *up2;
     } user;
+    /**
+     * @brief   Kernel object operation structure.
+     */
+    struct {
+      /**
+       * @brief   Object pointer.
+       */
+      void                  *objp;
+      /**
+       * @brief   Operation argument.
+       */
+      uintptr_t             arg;
+    } obj;
+    /**
+     * @brief   Lost records structure.
+     */
+    struct {
+      /**
+       * @brief   Number of records discarded because the FIFO was full.
+       */
+      ucnt_t                n;
+    } drop;
   } u;
 } ch_trace_event_t;
 /*lint -restore*/
@@ -185,11 +263,51 @@ typedef struct {
    * @brief   Pointer to the buffer front.
    */
   ch_trace_event_t      *ptr;
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Pointer to the oldest record not yet read.
+   */
+  ch_trace_event_t      *rdptr;
+  /**
+   * @brief   Records lost and not yet reported in the FIFO.
+   */
+  ucnt_t                lost;
+  /**
+   * @brief   Total number of lost records.
+   */
+  ucnt_t                drops;
+  /**
+   * @brief   System time of the last record read.
+   */
+  systime_t             rdtime;
+  /**
+   * @brief   Accurate time stamp of the last record read.
+   */
+  uint32_t              rdrtstamp;
+  /**
+   * @brief   Stream header already sent.
+   */
+  bool                  rdstarted;
+#endif
   /**
    * @brief   Ring buffer.
    */
   ch_trace_event_t      buffer[CH_DBG_TRACE_BUFFER_SIZE];
 } ch_trace_buffer_t;
+
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Trace stream sink function.
+ * @note    It has the same signature of the streams @p write() method so
+ *          a @p BaseSequentialStream can be used as sink.
+ *
+ * @param[in] obj       sink object
+ * @param[in] bp        pointer to the encoded data
+ * @param[in] n         number of bytes to be written
+ * @return              The number of bytes written.
+ */
+typedef size_t (*ch_trace_sink_t)(void *obj, const uint8_t *bp, size_t n);
+#endif
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 
 /*===========================================================================*/
@@ -223,6 +341,15 @@ typedef struct {
 #endif
 #endif /* CH_DBG_TRACE_MASK == CH_DBG_TRACE_MASK_DISABLED */
 
+/* Kernel objects records are only compiled in if explicitly selected in
+   the trace mask, they are not part of CH_DBG_TRACE_MASK_ALL.*/
+#if (CH_DBG_TRACE_MASK == CH_DBG_TRACE_MASK_DISABLED) ||                    \
+    ((CH_DBG_TRACE_MASK & CH_DBG_TRACE_MASK_OBJECTS) == 0U)
+#if !defined(_trace_object)
+#define _trace_object(op, objp, arg)
+#endif
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -236,12 +363,21 @@ extern "C" {
   void _trace_isr_enter(const char *isr);
   void _trace_isr_leave(const char *isr);
   void _trace_halt(const char *reason);
+#if ((CH_DBG_TRACE_MASK & CH_DBG_TRACE_MASK_OBJECTS) != 0U) ||              \
+    defined(__DOXYGEN__)
+  void _trace_object(unsigned op, void *objp, uintptr_t arg);
+#endif
   void chDbgWriteTraceI(void *up1, void *up2);
   void chDbgWriteTrace(void *up1, void *up2);
   void chDbgSuspendTraceI(uint16_t mask);
   void chDbgSuspendTrace(uint16_t mask);
   void chDbgResumeTraceI(uint16_t mask);
   void chDbgResumeTrace(uint16_t mask);
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+  size_t chDbgReadTrace(uint8_t *bp, size_t n);
+  size_t chDbgDrainTrace(ch_trace_sink_t sink, void *obj);
+  ucnt_t chDbgGetTraceDropsX(void);
+#endif
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 #ifdef __cplusplus
 }
@@ -76,6 +76,9 @@ extern "C" {
                   vtfunc_t vtfunc, void *par);
   void chVTDoResetI(virtual_timer_t *vtp);
   void chVTDoTickI(void);
+#if CH_CFG_USE_TIMER_WHEEL == TRUE
+  bool chVTGetTimersStateI(sysinterval_t *timep);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -116,7 +119,7 @@ static inline void chVTObjectInit(virtual_timer_t *vtp) {
 static inline systime_t chVTGetSystemTimeX(void) {
 
 #if CH_CFG_ST_TIMEDELTA == 0
-  return ch.vtlist.systime;
+  return currcore->vtlist.systime;
 #else /* CH_CFG_ST_TIMEDELTA > 0 */
   return port_timer_get_time();
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
@@ -191,6 +194,7 @@ static inline bool chVTIsSystemTimeWithin(systime_t start, systime_t end) {
   return chTimeIsInRangeX(chVTGetSystemTime(), start, end);
 }
 
+#if (CH_CFG_USE_TIMER_WHEEL == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Returns the time interval until the next timer event.
  * @note    The return value is not perfectly accurate and can report values
@@ -211,21 +215,23 @@ static inline bool chVTGetTimersStateI(sysinterval_t *timep) {
 
   chDbgCheckClassI();
 
-  if (&ch.vtlist == (virtual_timers_list_t *)ch.vtlist.next) {
+  if (&currcore->vtlist == (virtual_timers_list_t *)currcore->vtlist.next) {
     return false;
   }
 
   if (timep != NULL) {
 #if CH_CFG_ST_TIMEDELTA == 0
-    *timep = ch.vtlist.next->delta;
+    *timep = currcore->vtlist.next->delta;
 #else
-    *timep = (ch.vtlist.next->delta + (sysinterval_t)CH_CFG_ST_TIMEDELTA) -
-             chTimeDiffX(ch.vtlist.lasttime, chVTGetSystemTimeX());
+    *timep = (currcore->vtlist.next->delta +
+              (sysinterval_t)CH_CFG_ST_TIMEDELTA) -
+             chTimeDiffX(currcore->vtlist.lasttime, chVTGetSystemTimeX());
 #endif
   }
 
   return true;
 }
+#endif /* CH_CFG_USE_TIMER_WHEEL == FALSE */
 
 /**
  * @brief   Returns @p true if the specified timer is armed.
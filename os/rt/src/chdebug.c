@@ -111,7 +111,8 @@
  */
 void _dbg_check_disable(void) {
 
-  if ((ch.dbg.isr_cnt != (cnt_t)0) || (ch.dbg.lock_cnt != (cnt_t)0)) {
+  if ((currcore->dbg.isr_cnt != (cnt_t)0) ||
+      (currcore->dbg.lock_cnt != (cnt_t)0)) {
     chSysHalt("SV#1");
   }
 }
@@ -123,7 +124,8 @@ void _dbg_check_disable(void) {
  */
 void _dbg_check_suspend(void) {
 
-  if ((ch.dbg.isr_cnt != (cnt_t)0) || (ch.dbg.lock_cnt != (cnt_t)0)) {
+  if ((currcore->dbg.isr_cnt != (cnt_t)0) ||
+      (currcore->dbg.lock_cnt != (cnt_t)0)) {
     chSysHalt("SV#2");
   }
 }
@@ -135,7 +137,8 @@ void _dbg_check_suspend(void) {
  */
 void _dbg_check_enable(void) {
 
-  if ((ch.dbg.isr_cnt != (cnt_t)0) || (ch.dbg.lock_cnt != (cnt_t)0)) {
+  if ((currcore->dbg.isr_cnt != (cnt_t)0) ||
+      (currcore->dbg.lock_cnt != (cnt_t)0)) {
     chSysHalt("SV#3");
   }
 }
@@ -147,7 +150,8 @@ void _dbg_check_enable(void) {
  */
 void _dbg_check_lock(void) {
 
-  if ((ch.dbg.isr_cnt != (cnt_t)0) || (ch.dbg.lock_cnt != (cnt_t)0)) {
+  if ((currcore->dbg.isr_cnt != (cnt_t)0) ||
+      (currcore->dbg.lock_cnt != (cnt_t)0)) {
     chSysHalt("SV#4");
   }
   _dbg_enter_lock();
@@ -160,7 +164,8 @@ void _dbg_check_lock(void) {
  */
 void _dbg_check_unlock(void) {
 
-  if ((ch.dbg.isr_cnt != (cnt_t)0) || (ch.dbg.lock_cnt <= (cnt_t)0)) {
+  if ((currcore->dbg.isr_cnt != (cnt_t)0) ||
+      (currcore->dbg.lock_cnt <= (cnt_t)0)) {
     chSysHalt("SV#5");
   }
   _dbg_leave_lock();
@@ -173,7 +178,8 @@ void _dbg_check_unlock(void) {
  */
 void _dbg_check_lock_from_isr(void) {
 
-  if ((ch.dbg.isr_cnt <= (cnt_t)0) || (ch.dbg.lock_cnt != (cnt_t)0)) {
+  if ((currcore->dbg.isr_cnt <= (cnt_t)0) ||
+      (currcore->dbg.lock_cnt != (cnt_t)0)) {
     chSysHalt("SV#6");
   }
   _dbg_enter_lock();
@@ -186,7 +192,8 @@ void _dbg_check_lock_from_isr(void) {
  */
 void _dbg_check_unlock_from_isr(void) {
 
-  if ((ch.dbg.isr_cnt <= (cnt_t)0) || (ch.dbg.lock_cnt <= (cnt_t)0)) {
+  if ((currcore->dbg.isr_cnt <= (cnt_t)0) ||
+      (currcore->dbg.lock_cnt <= (cnt_t)0)) {
     chSysHalt("SV#7");
   }
   _dbg_leave_lock();
@@ -200,10 +207,11 @@ void _dbg_check_unlock_from_isr(void) {
 void _dbg_check_enter_isr(void) {
 
   port_lock_from_isr();
-  if ((ch.dbg.isr_cnt < (cnt_t)0) || (ch.dbg.lock_cnt != (cnt_t)0)) {
+  if ((currcore->dbg.isr_cnt < (cnt_t)0) ||
+      (currcore->dbg.lock_cnt != (cnt_t)0)) {
     chSysHalt("SV#8");
   }
-  ch.dbg.isr_cnt++;
+  currcore->dbg.isr_cnt++;
   port_unlock_from_isr();
 }
 
@@ -215,10 +223,11 @@ void _dbg_check_enter_isr(void) {
 void _dbg_check_leave_isr(void) {
 
   port_lock_from_isr();
-  if ((ch.dbg.isr_cnt <= (cnt_t)0) || (ch.dbg.lock_cnt != (cnt_t)0)) {
+  if ((currcore->dbg.isr_cnt <= (cnt_t)0) ||
+      (currcore->dbg.lock_cnt != (cnt_t)0)) {
     chSysHalt("SV#9");
   }
-  ch.dbg.isr_cnt--;
+  currcore->dbg.isr_cnt--;
   port_unlock_from_isr();
 }
 
@@ -232,7 +241,8 @@ void _dbg_check_leave_isr(void) {
  */
 void chDbgCheckClassI(void) {
 
-  if ((ch.dbg.isr_cnt < (cnt_t)0) || (ch.dbg.lock_cnt <= (cnt_t)0)) {
+  if ((currcore->dbg.isr_cnt < (cnt_t)0) ||
+      (currcore->dbg.lock_cnt <= (cnt_t)0)) {
     chSysHalt("SV#10");
   }
 }
@@ -247,7 +257,8 @@ void chDbgCheckClassI(void) {
  */
 void chDbgCheckClassS(void) {
 
-  if ((ch.dbg.isr_cnt != (cnt_t)0) || (ch.dbg.lock_cnt <= (cnt_t)0)) {
+  if ((currcore->dbg.isr_cnt != (cnt_t)0) ||
+      (currcore->dbg.lock_cnt <= (cnt_t)0)) {
     chSysHalt("SV#11");
   }
 }
@@ -91,6 +91,8 @@
  *          will be notified of all events broadcasted there.
  * @note    Multiple Event Listeners can specify the same bits to be ORed to
  *          different threads.
+ * @note    If @p CH_CFG_USE_EVENTS_INDEX is enabled then the listener is
+ *          also linked in the index chain of each flag in @p wflags.
  *
  * @param[in] esp       pointer to the  @p event_source_t structure
  * @param[in] elp       pointer to the @p event_listener_t structure
@@ -110,6 +112,20 @@ void chEvtRegisterMaskWithFlags(event_source_t *esp,
   chSysLock();
   elp->next     = esp->next;
   esp->next     = elp;
+#if CH_CFG_USE_EVENTS_INDEX == TRUE
+  {
+    unsigned i;
+
+    /* The listener is put on top of the chain of each flag it is
+       interested in.*/
+    for (i = 0U; i < CH_EVT_INDEX_SIZE; i++) {
+      if ((wflags & ((eventflags_t)1 << i)) != (eventflags_t)0) {
+        elp->inext[i] = esp->index[i];
+        esp->index[i] = elp;
+      }
+    }
+  }
+#endif
   elp->listener = currp;
   elp->events   = events;
   elp->flags    = (eventflags_t)0;
@@ -144,6 +160,24 @@ void chEvtUnregister(event_source_t *esp, event_listener_t *elp) {
   /*lint -restore*/
     if (p->next == elp) {
       p->next = elp->next;
+#if CH_CFG_USE_EVENTS_INDEX == TRUE
+      {
+        unsigned i;
+
+        /* Removing the listener from the chain of each flag it is
+           interested in.*/
+        for (i = 0U; i < CH_EVT_INDEX_SIZE; i++) {
+          if ((elp->wflags & ((eventflags_t)1 << i)) != (eventflags_t)0) {
+            event_listener_t **ipp = &esp->index[i];
+
+            while (*ipp != elp) {
+              ipp = &(*ipp)->inext[i];
+            }
+            *ipp = elp->inext[i];
+          }
+        }
+      }
+#endif
       break;
     }
     p = p->next;
@@ -212,6 +246,8 @@ eventmask_t chEvtAddEvents(eventmask_t events) {
  *          threads registered on the @p event_source_t in addition to the
  *          event flags specified by the threads themselves in the
  *          @p event_listener_t objects.
+ * @note    If @p CH_CFG_USE_EVENTS_INDEX is enabled then the flags are
+ *          only added to the listeners being signaled.
  * @post    This function does not reschedule so a call to a rescheduling
  *          function must be performed before unlocking the kernel. Note that
  *          interrupt handlers always reschedule on exit so an explicit
@@ -228,6 +264,38 @@ void chEvtBroadcastFlagsI(event_source_t *esp, eventflags_t flags) {
   chDbgCheckClassI();
   chDbgCheck(esp != NULL);
 
+#if CH_CFG_USE_EVENTS_INDEX == TRUE
+  if (flags != (eventflags_t)0) {
+    eventflags_t f = flags;
+    unsigned i = 0U;
+
+    /* Only the chains of the broadcasted flags are visited, a listener
+       interested in more than one of them is signaled once per flag.*/
+    do {
+      if ((f & (eventflags_t)1) != (eventflags_t)0) {
+        elp = esp->index[i];
+        while (elp != NULL) {
+          elp->flags |= flags;
+          chEvtSignalI(elp->listener, elp->events);
+          elp = elp->inext[i];
+        }
+      }
+      f >>= 1;
+      i++;
+    } while (f != (eventflags_t)0);
+  }
+  else {
+    /* When flags == 0 all the threads are signaled because the source
+       does not emit any flag.*/
+    elp = esp->next;
+    /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
+    while (elp != (event_listener_t *)esp) {
+    /*lint -restore*/
+      chEvtSignalI(elp->listener, elp->events);
+      elp = elp->next;
+    }
+  }
+#else
   elp = esp->next;
   /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
   while (elp != (event_listener_t *)esp) {
@@ -241,6 +309,7 @@ void chEvtBroadcastFlagsI(event_source_t *esp, eventflags_t flags) {
     }
     elp = elp->next;
   }
+#endif
 }
 
 /**
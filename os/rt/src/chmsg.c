@@ -36,6 +36,14 @@
  *          Messages are usually processed in FIFO order but it is possible to
  *          process them in priority order by enabling the
  *          @p CH_CFG_USE_MESSAGES_PRIORITY option in @p chconf.h.<br>
+ *          A message can carry a payload, a pointer and a size describing a
+ *          buffer owned by the sender, the buffer is accessed in place by
+ *          the server until the message is released.<br>
+ *          A server can receive all the pending messages at once using
+ *          @p chMsgWaitBatch() and release them using
+ *          @p chMsgReleaseBatch(), the cost of the critical zones and of
+ *          the context switches is shared among the messages in the
+ *          batch.<br>
  * @pre     In order to use the message APIs the @p CH_CFG_USE_MESSAGES option
  *          must be enabled in @p chconf.h.
  * @post    Enabling messages requires 6-12 (depending on the architecture)
@@ -69,6 +77,32 @@
 #define msg_insert(tp, qp) queue_insert(tp, qp)
 #endif
 
+/**
+ * @brief   Sends a message descriptor to the specified thread.
+ *
+ * @param[in] tp        the pointer to the thread
+ * @param[in] plp       pointer to the message descriptor
+ * @return              The answer message from @p chMsgRelease().
+ *
+ * @notapi
+ */
+static msg_t msg_send(thread_t *tp, msg_payload_t *plp) {
+  thread_t *ctp = currp;
+  msg_t msg;
+
+  chSysLock();
+  ctp->u.sentpayload = plp;
+  msg_insert(ctp, &tp->msgqueue);
+  if (tp->state == CH_STATE_WTMSG) {
+    (void) chSchReadyI(tp);
+  }
+  chSchGoSleepS(CH_STATE_SNDMSGQ);
+  msg = ctp->u.rdymsg;
+  chSysUnlock();
+
+  return msg;
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -85,21 +119,42 @@
  * @api
  */
 msg_t chMsgSend(thread_t *tp, msg_t msg) {
-  thread_t *ctp = currp;
+  msg_payload_t pl;
 
   chDbgCheck(tp != NULL);
 
-  chSysLock();
-  ctp->u.sentmsg = msg;
-  msg_insert(ctp, &tp->msgqueue);
-  if (tp->state == CH_STATE_WTMSG) {
-    (void) chSchReadyI(tp);
-  }
-  chSchGoSleepS(CH_STATE_SNDMSGQ);
-  msg = ctp->u.rdymsg;
-  chSysUnlock();
+  pl.msg  = msg;
+  pl.buf  = NULL;
+  pl.size = (size_t)0;
 
-  return msg;
+  return msg_send(tp, &pl);
+}
+
+/**
+ * @brief   Sends a message with a payload to the specified thread.
+ * @details The sender is stopped until the receiver executes a
+ *          @p chMsgRelease() after receiving the message. The payload is
+ *          not copied, the receiver accesses the buffer in place using
+ *          @p chMsgGetPayload() and can also write an answer into it.
+ *
+ * @param[in] tp        the pointer to the thread
+ * @param[in] msg       the message
+ * @param[in] buf       pointer to the payload buffer
+ * @param[in] size      size of the payload
+ * @return              The answer message from @p chMsgRelease().
+ *
+ * @api
+ */
+msg_t chMsgSendPayload(thread_t *tp, msg_t msg, void *buf, size_t size) {
+  msg_payload_t pl;
+
+  chDbgCheck(tp != NULL);
+
+  pl.msg  = msg;
+  pl.buf  = buf;
+  pl.size = size;
+
+  return msg_send(tp, &pl);
 }
 
 /**
@@ -198,6 +253,64 @@ thread_t *chMsgPollS(void) {
   return tp;
 }
 
+/**
+ * @brief   Waits for incoming messages or a timeout to occur.
+ * @details The function waits for at least one message then all the
+ *          pending messages are received, up to the specified number. The
+ *          senders are returned in the order they would have been returned
+ *          by @p chMsgWaitS().
+ * @post    The function @p chMsgReleaseBatchS() or @p chMsgReleaseS() must
+ *          be invoked for each received message in order to acknowledge
+ *          the reception and send the answer.
+ * @note    The reference counters of the sender threads are not increased,
+ *          the returned pointers are temporary references.
+ *
+ * @param[out] tpp      array receiving the pointers to the threads
+ *                      carrying the messages
+ * @param[in] n         size of the array, must be greater than zero
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of received messages.
+ * @retval 0            if a timeout occurred.
+ *
+ * @sclass
+ */
+size_t chMsgWaitBatchTimeoutS(thread_t **tpp, size_t n,
+                              sysinterval_t timeout) {
+  thread_t *ctp = currp;
+  size_t i;
+
+  chDbgCheckClassS();
+  chDbgCheck((tpp != NULL) && (n > (size_t)0));
+
+  if (!chMsgIsPendingI(ctp)) {
+    if (TIME_IMMEDIATE == timeout) {
+      return (size_t)0;
+    }
+    /* Checking the queue rather than the wakeup message, a sender could
+       have arrived after the timeout.*/
+    (void) chSchGoSleepTimeoutS(CH_STATE_WTMSG, timeout);
+    if (!chMsgIsPendingI(ctp)) {
+      return (size_t)0;
+    }
+  }
+
+  /* Draining the pending senders.*/
+  i = (size_t)0;
+  do {
+    thread_t *tp = queue_fifo_remove(&ctp->msgqueue);
+
+    tp->state = CH_STATE_SNDMSG;
+    tpp[i] = tp;
+    i++;
+  } while ((i < n) && chMsgIsPendingI(ctp));
+
+  return i;
+}
+
 /**
  * @brief   Releases a sender thread specifying a response message.
  * @pre     Invoke this function only after a message has been received
@@ -216,6 +329,56 @@ void chMsgRelease(thread_t *tp, msg_t msg) {
   chSysUnlock();
 }
 
+/**
+ * @brief   Releases a set of sender threads specifying the response messages.
+ * @details The senders are made ready in a single critical zone and a single
+ *          rescheduling is performed.
+ * @pre     Invoke this function only after the messages have been received
+ *          using @p chMsgWaitBatch() or @p chMsgWait().
+ *
+ * @param[in] tpp       array of pointers to the threads
+ * @param[in] msgs      array of messages to be returned to the senders
+ * @param[in] n         number of threads to be released
+ *
+ * @api
+ */
+void chMsgReleaseBatch(thread_t **tpp, const msg_t *msgs, size_t n) {
+
+  chSysLock();
+  chMsgReleaseBatchS(tpp, msgs, n);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases a set of sender threads specifying the response messages.
+ * @pre     Invoke this function only after the messages have been received
+ *          using @p chMsgWaitBatch() or @p chMsgWait().
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] tpp       array of pointers to the threads
+ * @param[in] msgs      array of messages to be returned to the senders
+ * @param[in] n         number of threads to be released
+ *
+ * @sclass
+ */
+void chMsgReleaseBatchS(thread_t **tpp, const msg_t *msgs, size_t n) {
+  size_t i;
+
+  chDbgCheckClassS();
+  chDbgCheck((tpp != NULL) && (msgs != NULL));
+
+  for (i = (size_t)0; i < n; i++) {
+    thread_t *tp = tpp[i];
+
+    chDbgAssert(tp->state == CH_STATE_SNDMSG, "invalid state");
+
+    tp->u.rdymsg = msgs[i];
+    (void) chSchReadyI(tp);
+  }
+}
+
 #endif /* CH_CFG_USE_MESSAGES == TRUE */
 
 /** @} */
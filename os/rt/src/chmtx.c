@@ -93,6 +93,98 @@
 /* Module exported functions.                                                */
 /*===========================================================================*/
 
+#if ((CH_CFG_SMP_MODE == TRUE) && (CH_CFG_MUTEXES_SPIN_COUNT > 0)) ||        \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Polls a mutex owned by a thread running on another core.
+ * @details The kernel lock is released between polls so that the owner is
+ *          able to unlock the mutex. The function returns when the mutex
+ *          is free, when its owner is no more running or after
+ *          @p CH_CFG_MUTEXES_SPIN_COUNT polls.
+ *
+ * @param[in] mp        pointer to the @p mutex_t structure
+ *
+ * @notapi
+ */
+void _mtx_spin(mutex_t *mp) {
+  unsigned n = (unsigned)CH_CFG_MUTEXES_SPIN_COUNT;
+
+  while (n > 0U) {
+    thread_t *tp = mp->owner;
+
+    if ((tp == NULL) || (tp == currp) || (tp->state != CH_STATE_CURRENT)) {
+      break;
+    }
+    chSysUnlock();
+    n--;
+    chSysLock();
+  }
+}
+#endif
+
+/**
+ * @brief   Boosts the priority of a thread and of the threads it depends on.
+ * @details The priority of the specified thread is raised to the specified
+ *          priority, if lower, then the mutex owners the thread is waiting
+ *          for are boosted too.
+ * @note    Must be invoked from within a critical zone.
+ *
+ * @param[in] tp        pointer to the thread to be boosted
+ * @param[in] prio      the priority to be inherited
+ *
+ * @notapi
+ */
+void _mtx_boost_priority(thread_t *tp, tprio_t prio) {
+
+  /* Explores the thread-mutex dependencies boosting the priority of all
+     the affected threads.*/
+  while (tp->prio < prio) {
+    /* Make priority of thread tp match the specified priority.*/
+    tp->prio = prio;
+
+    /* The following states need priority queues reordering.*/
+    switch (tp->state) {
+    case CH_STATE_WTMTX:
+      /* Re-enqueues the mutex owner with its new priority.*/
+      queue_prio_insert(queue_dequeue(tp), &tp->u.wtmtxp->queue);
+      tp = tp->u.wtmtxp->owner;
+      /*lint -e{9042} [16.1] Continues the while.*/
+      continue;
+#if (CH_CFG_USE_CONDVARS == TRUE) ||                                        \
+    ((CH_CFG_USE_SEMAPHORES == TRUE) &&                                     \
+     (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)) ||                           \
+    ((CH_CFG_USE_MESSAGES == TRUE) &&                                       \
+     (CH_CFG_USE_MESSAGES_PRIORITY == TRUE))
+#if CH_CFG_USE_CONDVARS == TRUE
+    case CH_STATE_WTCOND:
+#endif
+#if (CH_CFG_USE_SEMAPHORES == TRUE) &&                                      \
+    (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)
+    case CH_STATE_WTSEM:
+#endif
+#if (CH_CFG_USE_MESSAGES == TRUE) && (CH_CFG_USE_MESSAGES_PRIORITY == TRUE)
+    case CH_STATE_SNDMSGQ:
+#endif
+      /* Re-enqueues tp with its new priority on the queue.*/
+      queue_prio_insert(queue_dequeue(tp), &tp->u.wtmtxp->queue);
+      break;
+#endif
+    case CH_STATE_READY:
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+      /* Prevents an assertion in chSchReadyI().*/
+      tp->state = CH_STATE_CURRENT;
+#endif
+      /* Re-enqueues tp with its new priority on the ready list.*/
+      (void) chSchReadyI(chSchDequeueReadyI(tp));
+      break;
+    default:
+      /* Nothing to do for other states.*/
+      break;
+    }
+    break;
+  }
+}
+
 /**
  * @brief   Initializes s @p mutex_t structure.
  *
@@ -113,6 +205,9 @@ void chMtxObjectInit(mutex_t *mp) {
 
 /**
  * @brief   Locks the specified mutex.
+ * @details If @p CH_CFG_MUTEXES_SPIN_COUNT is greater than zero then the
+ *          mutex is polled while its owner is running on another core
+ *          before queuing the calling thread.
  * @post    The mutex is locked and inserted in the per-thread stack of owned
  *          mutexes.
  *
@@ -123,6 +218,9 @@ void chMtxObjectInit(mutex_t *mp) {
 void chMtxLock(mutex_t *mp) {
 
   chSysLock();
+#if (CH_CFG_SMP_MODE == TRUE) && (CH_CFG_MUTEXES_SPIN_COUNT > 0)
+  _mtx_spin(mp);
+#endif
   chMtxLockS(mp);
   chSysUnlock();
 }
@@ -142,6 +240,8 @@ void chMtxLockS(mutex_t *mp) {
   chDbgCheckClassS();
   chDbgCheck(mp != NULL);
 
+  _trace_object(CH_TRACE_OP_MTX_LOCK, mp, (uintptr_t)0);
+
   /* Is the mutex already locked? */
   if (mp->owner != NULL) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
@@ -158,55 +258,7 @@ void chMtxLockS(mutex_t *mp) {
       /* Priority inheritance protocol; explores the thread-mutex dependencies
          boosting the priority of all the affected threads to equal the
          priority of the running thread requesting the mutex.*/
-      thread_t *tp = mp->owner;
-
-      /* Does the running thread have higher priority than the mutex
-         owning thread? */
-      while (tp->prio < ctp->prio) {
-        /* Make priority of thread tp match the running thread's priority.*/
-        tp->prio = ctp->prio;
-
-        /* The following states need priority queues reordering.*/
-        switch (tp->state) {
-        case CH_STATE_WTMTX:
-          /* Re-enqueues the mutex owner with its new priority.*/
-          queue_prio_insert(queue_dequeue(tp), &tp->u.wtmtxp->queue);
-          tp = tp->u.wtmtxp->owner;
-          /*lint -e{9042} [16.1] Continues the while.*/
-          continue;
-#if (CH_CFG_USE_CONDVARS == TRUE) ||                                        \
-    ((CH_CFG_USE_SEMAPHORES == TRUE) &&                                     \
-     (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)) ||                           \
-    ((CH_CFG_USE_MESSAGES == TRUE) &&                                       \
-     (CH_CFG_USE_MESSAGES_PRIORITY == TRUE))
-#if CH_CFG_USE_CONDVARS == TRUE
-        case CH_STATE_WTCOND:
-#endif
-#if (CH_CFG_USE_SEMAPHORES == TRUE) &&                                      \
-    (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)
-        case CH_STATE_WTSEM:
-#endif
-#if (CH_CFG_USE_MESSAGES == TRUE) && (CH_CFG_USE_MESSAGES_PRIORITY == TRUE)
-        case CH_STATE_SNDMSGQ:
-#endif
-          /* Re-enqueues tp with its new priority on the queue.*/
-          queue_prio_insert(queue_dequeue(tp), &tp->u.wtmtxp->queue);
-          break;
-#endif
-        case CH_STATE_READY:
-#if CH_DBG_ENABLE_ASSERTS == TRUE
-          /* Prevents an assertion in chSchReadyI().*/
-          tp->state = CH_STATE_CURRENT;
-#endif
-          /* Re-enqueues tp with its new priority on the ready list.*/
-          (void) chSchReadyI(queue_dequeue(tp));
-          break;
-        default:
-          /* Nothing to do for other states.*/
-          break;
-        }
-        break;
-      }
+      _mtx_boost_priority(mp->owner, ctp->prio);
 
       /* Sleep on the mutex.*/
       queue_prio_insert(ctp, &mp->queue);
@@ -291,6 +343,7 @@ bool chMtxTryLockS(mutex_t *mp) {
 
     if (mp->owner == currp) {
       mp->cnt++;
+      _trace_object(CH_TRACE_OP_MTX_LOCK, mp, (uintptr_t)0);
       return true;
     }
 #endif
@@ -305,6 +358,7 @@ bool chMtxTryLockS(mutex_t *mp) {
   mp->owner = currp;
   mp->next = currp->mtxlist;
   currp->mtxlist = mp;
+  _trace_object(CH_TRACE_OP_MTX_LOCK, mp, (uintptr_t)0);
   return true;
 }
 
@@ -330,6 +384,7 @@ void chMtxUnlock(mutex_t *mp) {
 
   chDbgAssert(ctp->mtxlist != NULL, "owned mutexes list empty");
   chDbgAssert(ctp->mtxlist->owner == ctp, "ownership failure");
+  _trace_object(CH_TRACE_OP_MTX_UNLOCK, mp, (uintptr_t)0);
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
   chDbgAssert(mp->cnt >= (cnt_t)1, "counter is not positive");
 
@@ -361,6 +416,11 @@ void chMtxUnlock(mutex_t *mp) {
         }
         lmp = lmp->next;
       }
+#if CH_CFG_USE_RWLOCKS == TRUE
+
+      /* Writers waiting on the read locks held by the thread.*/
+      newprio = _rwlock_inherited_prio(ctp, newprio);
+#endif
 
       /* Assigns to the current thread the highest priority among all the
          waiting threads.*/
@@ -416,6 +476,7 @@ void chMtxUnlockS(mutex_t *mp) {
 
   chDbgAssert(ctp->mtxlist != NULL, "owned mutexes list empty");
   chDbgAssert(ctp->mtxlist->owner == ctp, "ownership failure");
+  _trace_object(CH_TRACE_OP_MTX_UNLOCK, mp, (uintptr_t)0);
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
   chDbgAssert(mp->cnt >= (cnt_t)1, "counter is not positive");
 
@@ -447,6 +508,11 @@ void chMtxUnlockS(mutex_t *mp) {
         }
         lmp = lmp->next;
       }
+#if CH_CFG_USE_RWLOCKS == TRUE
+
+      /* Writers waiting on the read locks held by the thread.*/
+      newprio = _rwlock_inherited_prio(ctp, newprio);
+#endif
 
       /* Assigns to the current thread the highest priority among all the
          waiting threads.*/
@@ -509,7 +575,11 @@ void chMtxUnlockAllS(void) {
         mp->owner = NULL;
       }
     } while (ctp->mtxlist != NULL);
+#if CH_CFG_USE_RWLOCKS == TRUE
+    ctp->prio = _rwlock_inherited_prio(ctp, ctp->realprio);
+#else
     ctp->prio = ctp->realprio;
+#endif
     chSchRescheduleS();
   }
 }
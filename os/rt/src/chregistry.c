@@ -135,7 +135,7 @@ thread_t *chRegFirstThread(void) {
   thread_t *tp;
 
   chSysLock();
-  tp = ch.rlist.newer;
+  tp = currcore->rlist.newer;
 #if CH_CFG_USE_DYNAMIC == TRUE
   tp->refs++;
 #endif
@@ -161,7 +161,7 @@ thread_t *chRegNextThread(thread_t *tp) {
   chSysLock();
   ntp = tp->newer;
   /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
-  if (ntp == (thread_t *)&ch.rlist) {
+  if (ntp == (thread_t *)&currcore->rlist) {
   /*lint -restore*/
     ntp = NULL;
   }
@@ -263,6 +263,55 @@ thread_t *chRegFindThreadByWorkingArea(stkalign_t *wa) {
 }
 #endif
 
+#if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a snapshot of the statistics of a thread.
+ * @details The run time and scheduling counters are sampled atomically, the
+ *          never used stack space is measured by scanning the working area
+ *          for the fill pattern.
+ * @note    The run time of a running thread does not include the slice in
+ *          progress.
+ * @note    The stack space is only measured if @p CH_DBG_FILL_THREADS is
+ *          enabled and the working area base is known, else it is zero.
+ * @pre     The caller must hold a reference to the thread, for example
+ *          while iterating with @p chRegFirstThread() and
+ *          @p chRegNextThread().
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[out] tsp      pointer to a @p thread_stats_t structure
+ *
+ * @xclass
+ */
+void chRegGetThreadStatsX(thread_t *tp, thread_stats_t *tsp) {
+  syssts_t sts;
+
+  chDbgCheck((tp != NULL) && (tsp != NULL));
+
+  sts = chSysGetStatusAndLockX();
+  tsp->cumulative = tp->stats.cumulative;
+  tsp->worst_run  = tp->stats.worst;
+  tsp->worst_lat  = tp->sched_stats.worst_lat;
+  tsp->n_switches = tp->sched_stats.n_switches;
+  chSysRestoreStatusX(sts);
+
+  tsp->stack_unused = (size_t)0;
+#if (CH_DBG_FILL_THREADS == TRUE) &&                                        \
+    ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))
+  if (tp->wabase != NULL) {
+    const uint8_t *p = (const uint8_t *)tp->wabase;
+
+    /* The stack grows downward, the scan starts from the working area
+       base and stops at the first byte ever touched.*/
+    while ((p < (const uint8_t *)tp) &&
+           (*p == (uint8_t)CH_DBG_STACK_FILL_VALUE)) {
+      p++;
+    }
+    tsp->stack_unused = (size_t)(p - (const uint8_t *)tp->wabase);
+  }
+#endif
+}
+#endif
+
 #endif /* CH_CFG_USE_REGISTRY == TRUE */
 
 /** @} */
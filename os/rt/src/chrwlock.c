@@ -0,0 +1,501 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    rt/src/chrwlock.c
+ * @brief   Readers-writer locks code.
+ *
+ * @addtogroup rwlocks
+ * @details Readers-writer locks related APIs and services.
+ *          <h2>Operation mode</h2>
+ *          A readers-writer lock allows any number of readers or a single
+ *          writer to access the protected resource. Readers-writer locks
+ *          are an extension to the mutex subsystem, the writer owns a
+ *          mutex for the whole duration of the write access.<br>
+ *          The following properties derive from this implementation:
+ *          - Writers are preferred, when a writer is waiting for the
+ *            active readers to leave the new readers are queued.
+ *          - A writer inherits the priority of the readers and writers
+ *            queued on the lock, the priority inheritance works with nested
+ *            mutexes like for normal mutexes.
+ *          - The active readers inherit the priority of a writer waiting
+ *            for them to leave, each reader provides a
+ *            @p rwlock_reader_t structure linking it to the lock for the
+ *            duration of the read access. The inherited priority is
+ *            released when the read lock is released.
+ *          - The write lock must be released in reverse lock order
+ *            relative to other mutexes, the read lock does not hold any
+ *            mutex and can be released in any order.
+ *          .
+ * @pre     In order to use the readers-writer locks APIs the
+ *          @p CH_CFG_USE_RWLOCKS option must be enabled in @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Boosts the priority of the active readers.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @param[in] prio      the priority to be inherited
+ *
+ * @notapi
+ */
+static void rwlock_boost_readers(rwlock_t *rwp, tprio_t prio) {
+  rwlock_reader_t *rdp = rwp->rdlist;
+
+  while (rdp != NULL) {
+    _mtx_boost_priority(rdp->tp, prio);
+    rdp = rdp->next;
+  }
+}
+
+/**
+ * @brief   Boosts the active readers before queuing on the writer mutex.
+ * @details If the writer is waiting for the active readers to leave then
+ *          the priority the writer is going to inherit is propagated to
+ *          the readers.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ *
+ * @notapi
+ */
+static void rwlock_boost_waiting(rwlock_t *rwp) {
+
+  if (queue_notempty(&rwp->queue)) {
+    rwlock_boost_readers(rwp, currp->prio);
+  }
+}
+
+/**
+ * @brief   Links a reader to the lock and to the current thread.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @param[out] rdp      pointer to a @p rwlock_reader_t structure
+ *
+ * @notapi
+ */
+static void rwlock_add_reader(rwlock_t *rwp, rwlock_reader_t *rdp) {
+  thread_t *ctp = currp;
+
+  rdp->tp     = ctp;
+  rdp->rwp    = rwp;
+  rdp->next   = rwp->rdlist;
+  rwp->rdlist = rdp;
+  rdp->tnext  = ctp->rdlist;
+  ctp->rdlist = rdp;
+  rwp->readers++;
+}
+
+/**
+ * @brief   Unlinks a reader from the lock and from the current thread.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @param[in] rdp       pointer to a @p rwlock_reader_t structure
+ *
+ * @notapi
+ */
+static void rwlock_remove_reader(rwlock_t *rwp, rwlock_reader_t *rdp) {
+  rwlock_reader_t **rdpp;
+
+  rdpp = &rwp->rdlist;
+  while (*rdpp != rdp) {
+    chDbgAssert(*rdpp != NULL, "not a reader");
+    rdpp = &(*rdpp)->next;
+  }
+  *rdpp = rdp->next;
+
+  rdpp = &rdp->tp->rdlist;
+  while (*rdpp != rdp) {
+    chDbgAssert(*rdpp != NULL, "not held");
+    rdpp = &(*rdpp)->tnext;
+  }
+  *rdpp = rdp->tnext;
+
+  rwp->readers--;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the priority inherited through the held read locks.
+ * @details The result is the highest between the specified priority and
+ *          the priorities of the writers waiting on the read locks held
+ *          by the thread.
+ * @note    Must be invoked from within a critical zone.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] prio      the priority inherited from other sources
+ * @return              The inherited priority.
+ *
+ * @notapi
+ */
+tprio_t _rwlock_inherited_prio(thread_t *tp, tprio_t prio) {
+  rwlock_reader_t *rdp = tp->rdlist;
+
+  while (rdp != NULL) {
+    if (queue_notempty(&rdp->rwp->queue) &&
+        (rdp->rwp->queue.next->prio > prio)) {
+      prio = rdp->rwp->queue.next->prio;
+    }
+    rdp = rdp->tnext;
+  }
+
+  return prio;
+}
+
+/**
+ * @brief   Initializes a @p rwlock_t structure.
+ *
+ * @param[out] rwp      pointer to a @p rwlock_t structure
+ *
+ * @init
+ */
+void chRWLockObjectInit(rwlock_t *rwp) {
+
+  chDbgCheck(rwp != NULL);
+
+  chMtxObjectInit(&rwp->mtx);
+  queue_init(&rwp->queue);
+  rwp->readers = (cnt_t)0;
+  rwp->rdlist  = NULL;
+}
+
+/**
+ * @brief   Acquires the lock for reading.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @param[out] rdp      pointer to a @p rwlock_reader_t structure, it must
+ *                      be kept until the read lock is released
+ *
+ * @api
+ */
+void chRWLockReadLock(rwlock_t *rwp, rwlock_reader_t *rdp) {
+
+  chSysLock();
+  chRWLockReadLockS(rwp, rdp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Acquires the lock for reading.
+ * @details If a writer owns the lock, or is waiting for the active readers
+ *          to leave, then the calling thread is queued and the writer
+ *          inherits its priority.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @param[out] rdp      pointer to a @p rwlock_reader_t structure, it must
+ *                      be kept until the read lock is released
+ *
+ * @sclass
+ */
+void chRWLockReadLockS(rwlock_t *rwp, rwlock_reader_t *rdp) {
+
+  chDbgCheckClassS();
+  chDbgCheck((rwp != NULL) && (rdp != NULL));
+  chDbgAssert(rwp->mtx.owner != currp, "write lock owner");
+
+  /* Readers go through the writer mutex, when a reader leaves the mutex
+     it is passed to the next queued thread, if any.*/
+  rwlock_boost_waiting(rwp);
+  chMtxLockS(&rwp->mtx);
+  rwlock_add_reader(rwp, rdp);
+  chMtxUnlockS(&rwp->mtx);
+}
+
+/**
+ * @brief   Tries to acquire the lock for reading.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @param[out] rdp      pointer to a @p rwlock_reader_t structure, it must
+ *                      be kept until the read lock is released
+ * @return              The operation status.
+ * @retval true         if the read lock has been acquired.
+ * @retval false        if there is a writer.
+ *
+ * @api
+ */
+bool chRWLockTryReadLock(rwlock_t *rwp, rwlock_reader_t *rdp) {
+  bool b;
+
+  chSysLock();
+  b = chRWLockTryReadLockS(rwp, rdp);
+  chSysUnlock();
+
+  return b;
+}
+
+/**
+ * @brief   Tries to acquire the lock for reading.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @param[out] rdp      pointer to a @p rwlock_reader_t structure, it must
+ *                      be kept until the read lock is released
+ * @return              The operation status.
+ * @retval true         if the read lock has been acquired.
+ * @retval false        if there is a writer.
+ *
+ * @sclass
+ */
+bool chRWLockTryReadLockS(rwlock_t *rwp, rwlock_reader_t *rdp) {
+
+  chDbgCheckClassS();
+  chDbgCheck((rwp != NULL) && (rdp != NULL));
+  chDbgAssert(rwp->mtx.owner != currp, "write lock owner");
+
+  if (!chMtxTryLockS(&rwp->mtx)) {
+    return false;
+  }
+  rwlock_add_reader(rwp, rdp);
+
+  /* No threads can be queued on the mutex at this point.*/
+  chMtxUnlockS(&rwp->mtx);
+
+  return true;
+}
+
+/**
+ * @brief   Releases the read lock.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @param[in] rdp       pointer to the @p rwlock_reader_t structure used
+ *                      for acquiring the read lock
+ *
+ * @api
+ */
+void chRWLockReadUnlock(rwlock_t *rwp, rwlock_reader_t *rdp) {
+
+  chSysLock();
+  chRWLockReadUnlockS(rwp, rdp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases the read lock.
+ * @details The last leaving reader wakes up the waiting writer, if any.
+ *          The priority inherited from the writer, if any, is released.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @param[in] rdp       pointer to the @p rwlock_reader_t structure used
+ *                      for acquiring the read lock
+ *
+ * @sclass
+ */
+void chRWLockReadUnlockS(rwlock_t *rwp, rwlock_reader_t *rdp) {
+  thread_t *ctp = currp;
+
+  chDbgCheckClassS();
+  chDbgCheck((rwp != NULL) && (rdp != NULL));
+  chDbgAssert(rwp->readers > (cnt_t)0, "not locked");
+  chDbgAssert((rdp->rwp == rwp) && (rdp->tp == ctp), "not the reader");
+
+  rwlock_remove_reader(rwp, rdp);
+  if (rwp->readers == (cnt_t)0) {
+    chThdDequeueNextI(&rwp->queue, MSG_OK);
+  }
+
+  /* Recalculates the thread priority if it has been boosted, the inherited
+     priority is the highest among the threads waiting on the owned
+     mutexes and the writers waiting on the other held read locks.*/
+  if (ctp->prio != ctp->realprio) {
+    tprio_t newprio = ctp->realprio;
+    mutex_t *lmp = ctp->mtxlist;
+
+    while (lmp != NULL) {
+      if (chMtxQueueNotEmptyS(lmp) &&
+          (lmp->queue.next->prio > newprio)) {
+        newprio = lmp->queue.next->prio;
+      }
+      lmp = lmp->next;
+    }
+    ctp->prio = _rwlock_inherited_prio(ctp, newprio);
+  }
+}
+
+/**
+ * @brief   Acquires the lock for writing.
+ * @post    The writer mutex is inserted in the per-thread stack of owned
+ *          mutexes.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ *
+ * @api
+ */
+void chRWLockWriteLock(rwlock_t *rwp) {
+
+  chDbgCheck(rwp != NULL);
+
+  chSysLock();
+#if (CH_CFG_SMP_MODE == TRUE) && (CH_CFG_MUTEXES_SPIN_COUNT > 0)
+  /* Spinning on the mutex like chMtxLock(), readers cannot enter after
+     the mutex has been acquired.*/
+  _mtx_spin(&rwp->mtx);
+#endif
+  chRWLockWriteLockS(rwp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Acquires the lock for writing.
+ * @details The writer mutex is locked first, then the calling thread waits
+ *          for the active readers to leave. New readers and writers are
+ *          queued on the mutex meanwhile. The active readers inherit the
+ *          priority of the waiting writer.
+ * @post    The writer mutex is inserted in the per-thread stack of owned
+ *          mutexes.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ *
+ * @sclass
+ */
+void chRWLockWriteLockS(rwlock_t *rwp) {
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL);
+
+  rwlock_boost_waiting(rwp);
+  chMtxLockS(&rwp->mtx);
+  if (rwp->readers > (cnt_t)0) {
+    rwlock_boost_readers(rwp, currp->prio);
+    (void) chThdEnqueueTimeoutS(&rwp->queue, TIME_INFINITE);
+  }
+
+  chDbgAssert(rwp->readers == (cnt_t)0, "active readers");
+}
+
+/**
+ * @brief   Tries to acquire the lock for writing.
+ * @post    The writer mutex is inserted in the per-thread stack of owned
+ *          mutexes if the lock has been acquired.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @return              The operation status.
+ * @retval true         if the write lock has been acquired.
+ * @retval false        if there are readers or another writer.
+ *
+ * @api
+ */
+bool chRWLockTryWriteLock(rwlock_t *rwp) {
+  bool b;
+
+  chSysLock();
+  b = chRWLockTryWriteLockS(rwp);
+  chSysUnlock();
+
+  return b;
+}
+
+/**
+ * @brief   Tries to acquire the lock for writing.
+ * @post    The writer mutex is inserted in the per-thread stack of owned
+ *          mutexes if the lock has been acquired.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ * @return              The operation status.
+ * @retval true         if the write lock has been acquired.
+ * @retval false        if there are readers or another writer.
+ *
+ * @sclass
+ */
+bool chRWLockTryWriteLockS(rwlock_t *rwp) {
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL);
+
+  if (!chMtxTryLockS(&rwp->mtx)) {
+    return false;
+  }
+  if (rwp->readers > (cnt_t)0) {
+    /* No threads can be queued on the mutex at this point.*/
+    chMtxUnlockS(&rwp->mtx);
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Releases the write lock.
+ * @pre     The write lock must be the last mutex acquired by the calling
+ *          thread.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ *
+ * @api
+ */
+void chRWLockWriteUnlock(rwlock_t *rwp) {
+
+  chDbgCheck(rwp != NULL);
+
+  chMtxUnlock(&rwp->mtx);
+}
+
+/**
+ * @brief   Releases the write lock.
+ * @pre     The write lock must be the last mutex acquired by the calling
+ *          thread.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] rwp       pointer to a @p rwlock_t structure
+ *
+ * @sclass
+ */
+void chRWLockWriteUnlockS(rwlock_t *rwp) {
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL);
+
+  chMtxUnlockS(&rwp->mtx);
+}
+
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+/** @} */
@@ -39,7 +39,11 @@
 /**
  * @brief   System data structures.
  */
+#if (CH_CFG_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+ch_system_t ch_cores[PORT_CORES_NUMBER];
+#else
 ch_system_t ch;
+#endif
 
 /*===========================================================================*/
 /* Module local types.                                                       */
@@ -53,6 +57,79 @@ ch_system_t ch;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_READY_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Marks a priority level as non-empty.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] prio      the priority level
+ */
+static inline void ready_bitmap_set(ready_list_t *rlp, tprio_t prio) {
+
+  rlp->prmap[prio >> 5] |= (uint32_t)1U << (prio & 31U);
+  rlp->prsummary        |= (uint32_t)1U << (prio >> 5);
+}
+
+/**
+ * @brief   Marks a priority level as empty.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] prio      the priority level
+ */
+static inline void ready_bitmap_clear(ready_list_t *rlp, tprio_t prio) {
+
+  rlp->prmap[prio >> 5] &= ~((uint32_t)1U << (prio & 31U));
+  if (rlp->prmap[prio >> 5] == 0U) {
+    rlp->prsummary &= ~((uint32_t)1U << (prio >> 5));
+  }
+}
+#endif /* CH_CFG_USE_READY_BITMAP == TRUE */
+
+/**
+ * @brief   Removes the first thread from the ready list and returns it.
+ * @pre     The ready list must not be empty.
+ *
+ * @return              The removed thread pointer.
+ */
+static inline thread_t *ready_list_remove_first(void) {
+  ready_list_t *rlp = &currcore->rlist;
+
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  unsigned i = ready_bitmap_msb(rlp->prsummary);
+  unsigned b = ready_bitmap_msb(rlp->prmap[i]);
+  threads_queue_t *tqp = &rlp->prqueues[(i << 5) | b];
+  thread_t *tp = queue_fifo_remove(tqp);
+
+  /* Clearing the level if it is now empty.*/
+  if (queue_isempty(tqp)) {
+    rlp->prmap[i] &= ~((uint32_t)1U << b);
+    if (rlp->prmap[i] == 0U) {
+      rlp->prsummary &= ~((uint32_t)1U << i);
+    }
+  }
+
+  return tp;
+#else
+  return queue_fifo_remove(&rlp->queue);
+#endif
+}
+
+#if (CH_CFG_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Notifies the core owning a thread made ready.
+ * @details If the thread belongs to another instance then its core is
+ *          notified in order to reschedule.
+ *
+ * @param[in] tp        the thread made ready
+ */
+static inline void ready_notify(thread_t *tp) {
+
+  if (tp->owner != currcore) {
+    port_notify_core(tp->owner->core_id);
+  }
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -64,11 +141,27 @@ ch_system_t ch;
  */
 void _scheduler_init(void) {
 
-  queue_init(&ch.rlist.queue);
-  ch.rlist.prio = NOPRIO;
+#if CH_CFG_SMP_MODE == TRUE
+  currcore->core_id = port_get_core_id();
+#endif
+  queue_init(&currcore->rlist.queue);
+  currcore->rlist.prio = NOPRIO;
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  {
+    unsigned i;
+
+    currcore->rlist.prsummary = 0U;
+    for (i = 0U; i < CH_RLIST_WORDS; i++) {
+      currcore->rlist.prmap[i] = 0U;
+    }
+    for (i = 0U; i < CH_RLIST_LEVELS; i++) {
+      queue_init(&currcore->rlist.prqueues[i]);
+    }
+  }
+#endif
 #if CH_CFG_USE_REGISTRY == TRUE
-  ch.rlist.newer = (thread_t *)&ch.rlist;
-  ch.rlist.older = (thread_t *)&ch.rlist;
+  currcore->rlist.newer = (thread_t *)&currcore->rlist;
+  currcore->rlist.older = (thread_t *)&currcore->rlist;
 #endif
 }
 
@@ -216,7 +309,10 @@ thread_t *list_remove(threads_list_t *tlp) {
  * @iclass
  */
 thread_t *chSchReadyI(thread_t *tp) {
+  ready_list_t *rlp = &threadcore(tp)->rlist;
+#if CH_CFG_USE_READY_BITMAP == FALSE
   thread_t *cp;
+#endif
 
   chDbgCheckClassI();
   chDbgCheck(tp != NULL);
@@ -225,7 +321,13 @@ thread_t *chSchReadyI(thread_t *tp) {
               "invalid state");
 
   tp->state = CH_STATE_READY;
-  cp = (thread_t *)&ch.rlist.queue;
+  _stats_ready(tp);
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  /* Insertion at the tail of the priority level queue.*/
+  queue_insert(tp, &rlp->prqueues[tp->prio]);
+  ready_bitmap_set(rlp, tp->prio);
+#else
+  cp = (thread_t *)&rlp->queue;
   do {
     cp = cp->queue.next;
   } while (cp->prio >= tp->prio);
@@ -234,6 +336,10 @@ thread_t *chSchReadyI(thread_t *tp) {
   tp->queue.prev             = cp->queue.prev;
   tp->queue.prev->queue.next = tp;
   cp->queue.prev             = tp;
+#endif
+#if CH_CFG_SMP_MODE == TRUE
+  ready_notify(tp);
+#endif
 
   return tp;
 }
@@ -255,6 +361,7 @@ thread_t *chSchReadyI(thread_t *tp) {
  * @iclass
  */
 thread_t *chSchReadyAheadI(thread_t *tp) {
+  ready_list_t *rlp = &threadcore(tp)->rlist;
   thread_t *cp;
 
   chDbgCheckClassI();
@@ -264,15 +371,63 @@ thread_t *chSchReadyAheadI(thread_t *tp) {
               "invalid state");
 
   tp->state = CH_STATE_READY;
-  cp = (thread_t *)&ch.rlist.queue;
+  _stats_ready(tp);
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  /* Insertion at the head of the priority level queue.*/
+  cp = rlp->prqueues[tp->prio].next;
+  ready_bitmap_set(rlp, tp->prio);
+#else
+  cp = (thread_t *)&rlp->queue;
   do {
     cp = cp->queue.next;
   } while (cp->prio > tp->prio);
+#endif
   /* Insertion on prev.*/
   tp->queue.next             = cp;
   tp->queue.prev             = cp->queue.prev;
   tp->queue.prev->queue.next = tp;
   cp->queue.prev             = tp;
+#if CH_CFG_SMP_MODE == TRUE
+  ready_notify(tp);
+#endif
+
+  return tp;
+}
+
+/**
+ * @brief   Removes a thread from the Ready List.
+ * @details The thread is removed regardless of its position in the ready
+ *          list, the function is meant to be used when the priority of a
+ *          ready thread has to be changed, the thread must then be
+ *          re-inserted using @p chSchReadyI().
+ * @note    The thread priority field is not used for removal so it can be
+ *          modified before calling this function.
+ *
+ * @param[in] tp        the thread to be removed
+ * @return              The thread pointer.
+ *
+ * @iclass
+ */
+thread_t *chSchDequeueReadyI(thread_t *tp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(tp != NULL);
+
+  (void) queue_dequeue(tp);
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  {
+    /* If the thread was the last one in its level then the "next" link
+       now points to an empty queue header, its position in the array
+       identifies the level to be cleared.*/
+    threads_queue_t *tqp = (threads_queue_t *)tp->queue.next;
+
+    if (queue_isempty(tqp)) {
+      ready_list_t *rlp = &threadcore(tp)->rlist;
+
+      ready_bitmap_clear(rlp, (tprio_t)(tqp - &rlp->prqueues[0]));
+    }
+  }
+#endif
 
   return tp;
 }
@@ -301,7 +456,7 @@ void chSchGoSleepS(tstate_t newstate) {
 #endif
 
   /* Next thread in ready list becomes current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = ready_list_remove_first();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-enter hook.*/
@@ -414,14 +569,24 @@ void chSchWakeupS(thread_t *ntp, msg_t msg) {
 
   chDbgCheckClassS();
 
-  chDbgAssert((ch.rlist.queue.next == (thread_t *)&ch.rlist.queue) ||
-              (ch.rlist.current->prio >= ch.rlist.queue.next->prio),
+#if CH_CFG_SMP_MODE == FALSE
+  chDbgAssert(currcore->rlist.current->prio >= ready_list_firstprio(),
               "priority order violation");
+#endif
 
   /* Storing the message to be retrieved by the target thread when it will
      restart execution.*/
   ntp->u.rdymsg = msg;
 
+#if CH_CFG_SMP_MODE == TRUE
+  /* A thread owned by another core is just made ready there, its core is
+     notified and will reschedule.*/
+  if (ntp->owner != currcore) {
+    (void) chSchReadyI(ntp);
+    return;
+  }
+#endif
+
   /* If the waken thread has a not-greater priority than the current
      one then it is just inserted in the ready list else it made
      running immediately and the invoking thread goes in the ready
@@ -437,9 +602,11 @@ void chSchWakeupS(thread_t *ntp, msg_t msg) {
       CH_CFG_IDLE_LEAVE_HOOK();
     }
 
-    /* The extracted thread is marked as current.*/
+    /* The extracted thread is marked as current, it does not go through
+       the ready list.*/
     currp = ntp;
     ntp->state = CH_STATE_CURRENT;
+    _stats_ready(ntp);
 
     /* Swap operation as tail call.*/
     chSysSwitch(ntp, otp);
@@ -477,7 +644,7 @@ void chSchRescheduleS(void) {
  * @special
  */
 bool chSchIsPreemptionRequired(void) {
-  tprio_t p1 = firstprio(&ch.rlist.queue);
+  tprio_t p1 = ready_list_firstprio();
   tprio_t p2 = currp->prio;
 
 #if CH_CFG_TIME_QUANTUM > 0
@@ -508,7 +675,7 @@ void chSchDoRescheduleBehind(void) {
   thread_t *otp = currp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = ready_list_remove_first();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-leave hook.*/
@@ -541,7 +708,7 @@ void chSchDoRescheduleAhead(void) {
   thread_t *otp = currp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = ready_list_remove_first();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-leave hook.*/
@@ -571,7 +738,7 @@ void chSchDoReschedule(void) {
   thread_t *otp = currp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = ready_list_remove_first();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-leave hook.*/
@@ -196,6 +196,8 @@ msg_t chSemWaitS(semaphore_t *sp) {
               ((sp->cnt < (cnt_t)0) && queue_notempty(&sp->queue)),
               "inconsistent semaphore");
 
+  _trace_object(CH_TRACE_OP_SEM_WAIT, sp, (uintptr_t)0);
+
   if (--sp->cnt < (cnt_t)0) {
     currp->u.wtsemp = sp;
     sem_insert(currp, &sp->queue);
@@ -263,6 +265,8 @@ msg_t chSemWaitTimeoutS(semaphore_t *sp, sysinterval_t timeout) {
               ((sp->cnt < (cnt_t)0) && queue_notempty(&sp->queue)),
               "inconsistent semaphore");
 
+  _trace_object(CH_TRACE_OP_SEM_WAIT, sp, (uintptr_t)0);
+
   if (--sp->cnt < (cnt_t)0) {
     if (TIME_IMMEDIATE == timeout) {
       sp->cnt++;
@@ -293,6 +297,7 @@ void chSemSignal(semaphore_t *sp) {
   chDbgAssert(((sp->cnt >= (cnt_t)0) && queue_isempty(&sp->queue)) ||
               ((sp->cnt < (cnt_t)0) && queue_notempty(&sp->queue)),
               "inconsistent semaphore");
+  _trace_object(CH_TRACE_OP_SEM_SIGNAL, sp, (uintptr_t)0);
   if (++sp->cnt <= (cnt_t)0) {
     chSchWakeupS(queue_fifo_remove(&sp->queue), MSG_OK);
   }
@@ -318,6 +323,8 @@ void chSemSignalI(semaphore_t *sp) {
               ((sp->cnt < (cnt_t)0) && queue_notempty(&sp->queue)),
               "inconsistent semaphore");
 
+  _trace_object(CH_TRACE_OP_SEM_SIGNAL, sp, (uintptr_t)0);
+
   if (++sp->cnt <= (cnt_t)0) {
     /* Note, it is done this way in order to allow a tail call on
              chSchReadyI().*/
@@ -381,9 +388,11 @@ msg_t chSemSignalWait(semaphore_t *sps, semaphore_t *spw) {
   chDbgAssert(((spw->cnt >= (cnt_t)0) && queue_isempty(&spw->queue)) ||
               ((spw->cnt < (cnt_t)0) && queue_notempty(&spw->queue)),
               "inconsistent semaphore");
+  _trace_object(CH_TRACE_OP_SEM_SIGNAL, sps, (uintptr_t)0);
   if (++sps->cnt <= (cnt_t)0) {
     chSchReadyI(queue_fifo_remove(&sps->queue))->u.rdymsg = MSG_OK;
   }
+  _trace_object(CH_TRACE_OP_SEM_WAIT, spw, (uintptr_t)0);
   if (--spw->cnt < (cnt_t)0) {
     thread_t *ctp = currp;
     sem_insert(ctp, &spw->queue);
@@ -61,10 +61,14 @@
  */
 void _stats_init(void) {
 
-  ch.kernel_stats.n_irq = (ucnt_t)0;
-  ch.kernel_stats.n_ctxswc = (ucnt_t)0;
-  chTMObjectInit(&ch.kernel_stats.m_crit_thd);
-  chTMObjectInit(&ch.kernel_stats.m_crit_isr);
+  currcore->kernel_stats.n_irq = (ucnt_t)0;
+  currcore->kernel_stats.n_ctxswc = (ucnt_t)0;
+  chTMObjectInit(&currcore->kernel_stats.m_crit_thd);
+  chTMObjectInit(&currcore->kernel_stats.m_crit_isr);
+#if CH_CFG_USE_TM_HISTOGRAMS == TRUE
+  chTMHistogramObjectInit(&currcore->kernel_stats.h_crit_thd);
+  chTMHistogramObjectInit(&currcore->kernel_stats.h_crit_isr);
+#endif
 }
 
 /**
@@ -73,10 +77,20 @@ void _stats_init(void) {
 void _stats_increase_irq(void) {
 
   port_lock_from_isr();
-  ch.kernel_stats.n_irq++;
+  currcore->kernel_stats.n_irq++;
   port_unlock_from_isr();
 }
 
+/**
+ * @brief   Marks the time a thread becomes ready.
+ *
+ * @param[in] tp        the thread entering the ready state
+ */
+void _stats_ready(thread_t *tp) {
+
+  tp->sched_stats.t_ready = chSysGetRealtimeCounterX();
+}
+
 /**
  * @brief   Updates context switch related statistics.
  *
@@ -84,9 +98,18 @@ void _stats_increase_irq(void) {
  * @param[in] otp       the thread to be switched out
  */
 void _stats_ctxswc(thread_t *ntp, thread_t *otp) {
+  rtcnt_t lat;
 
-  ch.kernel_stats.n_ctxswc++;
+  currcore->kernel_stats.n_ctxswc++;
   chTMChainMeasurementToX(&otp->stats, &ntp->stats);
+
+  /* The chained measurement left the switch time stamp in the "last"
+     field, the scheduling latency is computed from it.*/
+  lat = ntp->stats.last - ntp->sched_stats.t_ready;
+  if (lat > ntp->sched_stats.worst_lat) {
+    ntp->sched_stats.worst_lat = lat;
+  }
+  ntp->sched_stats.n_switches++;
 }
 
 /**
@@ -94,7 +117,7 @@ void _stats_ctxswc(thread_t *ntp, thread_t *otp) {
  */
 void _stats_start_measure_crit_thd(void) {
 
-  chTMStartMeasurementX(&ch.kernel_stats.m_crit_thd);
+  chTMStartMeasurementX(&currcore->kernel_stats.m_crit_thd);
 }
 
 /**
@@ -102,7 +125,11 @@ void _stats_start_measure_crit_thd(void) {
  */
 void _stats_stop_measure_crit_thd(void) {
 
-  chTMStopMeasurementX(&ch.kernel_stats.m_crit_thd);
+  chTMStopMeasurementX(&currcore->kernel_stats.m_crit_thd);
+#if CH_CFG_USE_TM_HISTOGRAMS == TRUE
+  chTMHistogramAddX(&currcore->kernel_stats.h_crit_thd,
+                    currcore->kernel_stats.m_crit_thd.last);
+#endif
 }
 
 /**
@@ -110,7 +137,7 @@ void _stats_stop_measure_crit_thd(void) {
  */
 void _stats_start_measure_crit_isr(void) {
 
-  chTMStartMeasurementX(&ch.kernel_stats.m_crit_isr);
+  chTMStartMeasurementX(&currcore->kernel_stats.m_crit_isr);
 }
 
 /**
@@ -118,7 +145,11 @@ void _stats_start_measure_crit_isr(void) {
  */
 void _stats_stop_measure_crit_isr(void) {
 
-  chTMStopMeasurementX(&ch.kernel_stats.m_crit_isr);
+  chTMStopMeasurementX(&currcore->kernel_stats.m_crit_isr);
+#if CH_CFG_USE_TM_HISTOGRAMS == TRUE
+  chTMHistogramAddX(&currcore->kernel_stats.h_crit_isr,
+                    currcore->kernel_stats.m_crit_isr.last);
+#endif
 }
 
 #endif /* CH_DBG_STATISTICS == TRUE */
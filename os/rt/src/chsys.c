@@ -42,9 +42,15 @@
 #if (CH_CFG_NO_IDLE_THREAD == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Idle thread working area.
+ * @note    In multi-core mode there is an idle thread for each core.
  */
+#if CH_CFG_SMP_MODE == TRUE
+static stkalign_t ch_idle_thread_wa[PORT_CORES_NUMBER][
+    THD_WORKING_AREA_SIZE(PORT_IDLE_THREAD_STACK_SIZE) / sizeof (stkalign_t)];
+#else
 THD_WORKING_AREA(ch_idle_thread_wa, PORT_IDLE_THREAD_STACK_SIZE);
 #endif
+#endif
 
 /*===========================================================================*/
 /* Module local types.                                                       */
@@ -91,6 +97,9 @@ static void _idle_thread(void *p) {
  * @brief   ChibiOS/RT initialization.
  * @details After executing this function the current instructions stream
  *          becomes the main thread.
+ * @note    In multi-core mode this function must be invoked on each core,
+ *          the first core initializes the shared services and must be
+ *          started before the others.
  * @pre     Interrupts must disabled before invoking this function.
  * @post    The main thread is created with priority @p NORMALPRIO and
  *          interrupts are enabled.
@@ -102,11 +111,17 @@ void chSysInit(void) {
   _scheduler_init();
   _vt_init();
   _trace_init();
+#if CH_CFG_SMP_MODE == TRUE
+  if (port_get_core_id() == 0U) {
+    _oslib_init();
+  }
+#else
   _oslib_init();
+#endif
 
 #if CH_DBG_SYSTEM_STATE_CHECK == TRUE
-  ch.dbg.isr_cnt  = (cnt_t)0;
-  ch.dbg.lock_cnt = (cnt_t)0;
+  currcore->dbg.isr_cnt  = (cnt_t)0;
+  currcore->dbg.lock_cnt = (cnt_t)0;
 #endif
 #if CH_CFG_USE_TM == TRUE
   _tm_init();
@@ -118,13 +133,14 @@ void chSysInit(void) {
 #if CH_CFG_NO_IDLE_THREAD == FALSE
   /* Now this instructions flow becomes the main thread.*/
 #if CH_CFG_USE_REGISTRY == TRUE
-  currp = _thread_init(&ch.mainthread, (const char *)&ch_debug, NORMALPRIO);
+  currp = _thread_init(&currcore->mainthread, (const char *)&ch_debug,
+                       NORMALPRIO);
 #else
-  currp = _thread_init(&ch.mainthread, "main", NORMALPRIO);
+  currp = _thread_init(&currcore->mainthread, "main", NORMALPRIO);
 #endif
 #else
   /* Now this instructions flow becomes the idle thread.*/
-  currp = _thread_init(&ch.mainthread, "idle", IDLEPRIO);
+  currp = _thread_init(&currcore->mainthread, "idle", IDLEPRIO);
 #endif
 
 #if CH_DBG_ENABLE_STACK_CHECK == TRUE
@@ -133,6 +149,12 @@ void chSysInit(void) {
        symbol must be provided externally.*/
     extern stkalign_t __main_thread_stack_base__;
     currp->wabase = &__main_thread_stack_base__;
+#if CH_CFG_SMP_MODE == TRUE
+    /* Only the first core runs on the static main thread stack.*/
+    if (port_get_core_id() != 0U) {
+      currp->wabase = NULL;
+    }
+#endif
   }
 #elif CH_CFG_USE_DYNAMIC == TRUE
   currp->wabase = NULL;
@@ -158,6 +180,16 @@ void chSysInit(void) {
 
 #if CH_CFG_NO_IDLE_THREAD == FALSE
   {
+#if CH_CFG_SMP_MODE == TRUE
+    const thread_descriptor_t idle_descriptor = {
+      "idle",
+      THD_WORKING_AREA_BASE(ch_idle_thread_wa[port_get_core_id()]),
+      THD_WORKING_AREA_END(ch_idle_thread_wa[port_get_core_id()]),
+      IDLEPRIO,
+      _idle_thread,
+      NULL
+    };
+#else
     static const thread_descriptor_t idle_descriptor = {
       "idle",
       THD_WORKING_AREA_BASE(ch_idle_thread_wa),
@@ -166,6 +198,7 @@ void chSysInit(void) {
       _idle_thread,
       NULL
     };
+#endif
 
     /* This thread has the lowest priority in the system, its role is just to
        serve interrupts in its context while keeping the lowest energy saving
@@ -195,7 +228,7 @@ void chSysHalt(const char *reason) {
   _trace_halt(reason);
 
   /* Pointing to the passed message.*/
-  ch.dbg.panic_msg = reason;
+  currcore->dbg.panic_msg = reason;
 
   /* Halt hook code, usually empty.*/
   CH_CFG_SYSTEM_HALT_HOOK(reason);
@@ -236,19 +269,65 @@ bool chSysIntegrityCheckI(unsigned testmask) {
 
   /* Ready List integrity check.*/
   if ((testmask & CH_INTEGRITY_RLIST) != 0U) {
+#if CH_CFG_USE_READY_BITMAP == TRUE
+    unsigned i;
+
+    for (i = 0U; i < CH_RLIST_LEVELS; i++) {
+      threads_queue_t *tqp = &currcore->rlist.prqueues[i];
+      uint32_t mask = (uint32_t)1U << (i & 31U);
+      thread_t *tp;
+
+      /* Scanning the level queue forward.*/
+      n = (cnt_t)0;
+      tp = tqp->next;
+      while (tp != (thread_t *)tqp) {
+        /* All threads in a level must have the same priority.*/
+        if (tp->prio != (tprio_t)i) {
+          return true;
+        }
+        n++;
+        tp = tp->queue.next;
+      }
+
+      /* The bitmap must reflect the level queue state.*/
+      if ((n != (cnt_t)0) != ((currcore->rlist.prmap[i >> 5] & mask) != 0U)) {
+        return true;
+      }
+
+      /* Scanning the level queue backward.*/
+      tp = tqp->prev;
+      while (tp != (thread_t *)tqp) {
+        n--;
+        tp = tp->queue.prev;
+      }
+
+      /* The number of elements must match.*/
+      if (n != (cnt_t)0) {
+        return true;
+      }
+    }
+
+    /* The summary word must reflect the bitmap state.*/
+    for (i = 0U; i < CH_RLIST_WORDS; i++) {
+      if ((currcore->rlist.prmap[i] != 0U) !=
+          ((currcore->rlist.prsummary & ((uint32_t)1U << i)) != 0U)) {
+        return true;
+      }
+    }
+#else
     thread_t *tp;
 
     /* Scanning the ready list forward.*/
     n = (cnt_t)0;
-    tp = ch.rlist.queue.next;
-    while (tp != (thread_t *)&ch.rlist.queue) {
+    tp = currcore->rlist.queue.next;
+    while (tp != (thread_t *)&currcore->rlist.queue) {
       n++;
       tp = tp->queue.next;
     }
 
     /* Scanning the ready list backward.*/
-    tp = ch.rlist.queue.prev;
-    while (tp != (thread_t *)&ch.rlist.queue) {
+    tp = currcore->rlist.queue.prev;
+    while (tp != (thread_t *)&currcore->rlist.queue) {
       n--;
       tp = tp->queue.prev;
     }
@@ -257,23 +336,25 @@ bool chSysIntegrityCheckI(unsigned testmask) {
     if (n != (cnt_t)0) {
       return true;
     }
+#endif
   }
 
   /* Timers list integrity check.*/
   if ((testmask & CH_INTEGRITY_VTLIST) != 0U) {
     virtual_timer_t * vtp;
+#if CH_CFG_USE_TIMER_WHEEL == FALSE
 
     /* Scanning the timers list forward.*/
     n = (cnt_t)0;
-    vtp = ch.vtlist.next;
-    while (vtp != (virtual_timer_t *)&ch.vtlist) {
+    vtp = currcore->vtlist.next;
+    while (vtp != (virtual_timer_t *)&currcore->vtlist) {
       n++;
       vtp = vtp->next;
     }
 
     /* Scanning the timers list backward.*/
-    vtp = ch.vtlist.prev;
-    while (vtp != (virtual_timer_t *)&ch.vtlist) {
+    vtp = currcore->vtlist.prev;
+    while (vtp != (virtual_timer_t *)&currcore->vtlist) {
       n--;
       vtp = vtp->prev;
     }
@@ -282,6 +363,41 @@ bool chSysIntegrityCheckI(unsigned testmask) {
     if (n != (cnt_t)0) {
       return true;
     }
+#else /* CH_CFG_USE_TIMER_WHEEL == TRUE */
+    unsigned level, slot;
+
+    for (level = 0U; level < (unsigned)CH_CFG_VT_WHEEL_LEVELS; level++) {
+      for (slot = 0U; slot < CH_VT_WHEEL_SLOTS; slot++) {
+        virtual_timers_slot_t *sp = &currcore->vtlist.slots[level][slot];
+
+        /* Scanning the slot forward.*/
+        n = (cnt_t)0;
+        vtp = sp->next;
+        while (vtp != (virtual_timer_t *)sp) {
+          n++;
+          vtp = vtp->next;
+        }
+
+        /* The slot bit must match the slot state.*/
+        if ((n != (cnt_t)0) !=
+            ((currcore->vtlist.wmap[level] & ((uint32_t)1U << slot)) != 0U)) {
+          return true;
+        }
+
+        /* Scanning the slot backward.*/
+        vtp = sp->prev;
+        while (vtp != (virtual_timer_t *)sp) {
+          n--;
+          vtp = vtp->prev;
+        }
+
+        /* The number of elements must match.*/
+        if (n != (cnt_t)0) {
+          return true;
+        }
+      }
+    }
+#endif /* CH_CFG_USE_TIMER_WHEEL == TRUE */
   }
 
 #if CH_CFG_USE_REGISTRY == TRUE
@@ -290,15 +406,15 @@ bool chSysIntegrityCheckI(unsigned testmask) {
 
     /* Scanning the ready list forward.*/
     n = (cnt_t)0;
-    tp = ch.rlist.newer;
-    while (tp != (thread_t *)&ch.rlist) {
+    tp = currcore->rlist.newer;
+    while (tp != (thread_t *)&currcore->rlist) {
       n++;
       tp = tp->newer;
     }
 
     /* Scanning the ready list backward.*/
-    tp = ch.rlist.older;
-    while (tp != (thread_t *)&ch.rlist) {
+    tp = currcore->rlist.older;
+    while (tp != (thread_t *)&currcore->rlist) {
       n--;
       tp = tp->older;
     }
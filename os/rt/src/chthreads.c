@@ -96,6 +96,9 @@ thread_t *_thread_init(thread_t *tp, const char *name, tprio_t prio) {
 #if CH_CFG_USE_MUTEXES == TRUE
   tp->realprio  = prio;
   tp->mtxlist   = NULL;
+#if CH_CFG_USE_RWLOCKS == TRUE
+  tp->rdlist    = NULL;
+#endif
 #endif
 #if CH_CFG_USE_EVENTS == TRUE
   tp->epending  = (eventmask_t)0;
@@ -103,6 +106,9 @@ thread_t *_thread_init(thread_t *tp, const char *name, tprio_t prio) {
 #if CH_DBG_THREADS_PROFILING == TRUE
   tp->time      = (systime_t)0;
 #endif
+#if CH_CFG_SMP_MODE == TRUE
+  tp->owner     = currcore;
+#endif
 #if CH_CFG_USE_REGISTRY == TRUE
   tp->refs      = (trefs_t)1;
   tp->name      = name;
@@ -118,6 +124,9 @@ thread_t *_thread_init(thread_t *tp, const char *name, tprio_t prio) {
 #endif
 #if CH_DBG_STATISTICS == TRUE
   chTMObjectInit(&tp->stats);
+  tp->sched_stats.n_switches = (ucnt_t)0;
+  tp->sched_stats.t_ready    = (rtcnt_t)0;
+  tp->sched_stats.worst_lat  = (rtcnt_t)0;
 #endif
   CH_CFG_THREAD_INIT_HOOK(tp);
   return tp;
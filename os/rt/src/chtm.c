@@ -57,21 +57,98 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+static inline void tm_add(time_measurement_t *tmp, rtcnt_t value) {
+
+  tmp->n++;
+  tmp->last = value;
+  tmp->cumulative += (rttime_t)value;
+  if (value > tmp->worst) {
+    tmp->worst = value;
+  }
+  if (value < tmp->best) {
+    tmp->best = value;
+  }
+}
+
 static inline void tm_stop(time_measurement_t *tmp,
                            rtcnt_t now,
                            rtcnt_t offset) {
 
-  tmp->n++;
-  tmp->last = (now - tmp->last) - offset;
-  tmp->cumulative += (rttime_t)tmp->last;
-  if (tmp->last > tmp->worst) {
-    tmp->worst = tmp->last;
+  tm_add(tmp, (now - tmp->last) - offset);
+}
+
+#if (CH_CFG_USE_TM_HISTOGRAMS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the position of the most significant bit set in a value.
+ * @pre     The value must not be zero.
+ *
+ * @param[in] value     the value to be scanned
+ * @return              The bit position.
+ *
+ * @notapi
+ */
+static inline unsigned tm_msb(rtcnt_t value) {
+
+#if defined(__GNUC__)
+  return ((unsigned)sizeof (unsigned long) * 8U) - 1U -
+         (unsigned)__builtin_clzl((unsigned long)value);
+#else
+  unsigned n = 0U;
+
+  while (value > (rtcnt_t)1) {
+    value >>= 1;
+    n++;
   }
-  if (tmp->last < tmp->best) {
-    tmp->best = tmp->last;
+
+  return n;
+#endif
+}
+
+/**
+ * @brief   Returns the histogram bucket of a value.
+ * @details Values below @p CH_TM_HISTOGRAM_SUB_BUCKETS are mapped one to one,
+ *          larger values are mapped in the linear sub-bucket of their power
+ *          of two range.
+ *
+ * @param[in] value     the measured value
+ * @return              The bucket index.
+ *
+ * @notapi
+ */
+static inline unsigned tm_bucket(rtcnt_t value) {
+  unsigned shift;
+
+  if (value < (rtcnt_t)CH_TM_HISTOGRAM_SUB_BUCKETS) {
+    return (unsigned)value;
   }
+
+  shift = tm_msb(value) - (unsigned)CH_CFG_TM_HISTOGRAM_PRECISION;
+
+  return ((shift + 1U) << (unsigned)CH_CFG_TM_HISTOGRAM_PRECISION) +
+         ((unsigned)(value >> shift) - CH_TM_HISTOGRAM_SUB_BUCKETS);
 }
 
+/**
+ * @brief   Returns the greatest value mapped in a bucket.
+ *
+ * @param[in] bucket    the bucket index
+ * @return              The greatest value of the bucket.
+ *
+ * @notapi
+ */
+static rtcnt_t tm_bucket_top(unsigned bucket) {
+  unsigned range = bucket >> (unsigned)CH_CFG_TM_HISTOGRAM_PRECISION;
+  unsigned sub = bucket & (CH_TM_HISTOGRAM_SUB_BUCKETS - 1U);
+
+  if (range == 0U) {
+    return (rtcnt_t)bucket;
+  }
+
+  return (((rtcnt_t)CH_TM_HISTOGRAM_SUB_BUCKETS + (rtcnt_t)sub) <<
+          (range - 1U)) + (((rtcnt_t)1 << (range - 1U)) - (rtcnt_t)1);
+}
+#endif /* CH_CFG_USE_TM_HISTOGRAMS == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -88,7 +165,7 @@ void _tm_init(void) {
   /* Time Measurement subsystem calibration, it does a null measurement
      and calculates the call overhead which is subtracted to real
      measurements.*/
-  ch.tm.offset = (rtcnt_t)0;
+  currcore->tm.offset = (rtcnt_t)0;
   chTMObjectInit(&tm);
   i = TM_CALIBRATION_LOOP;
   do {
@@ -96,7 +173,7 @@ void _tm_init(void) {
     chTMStopMeasurementX(&tm);
     i--;
   } while (i > 0U);
-  ch.tm.offset = tm.best;
+  currcore->tm.offset = tm.best;
 }
 
 /**
@@ -138,7 +215,7 @@ NOINLINE void chTMStartMeasurementX(time_measurement_t *tmp) {
  */
 NOINLINE void chTMStopMeasurementX(time_measurement_t *tmp) {
 
-  tm_stop(tmp, chSysGetRealtimeCounterX(), ch.tm.offset);
+  tm_stop(tmp, chSysGetRealtimeCounterX(), currcore->tm.offset);
 }
 
 /**
@@ -163,6 +240,152 @@ NOINLINE void chTMChainMeasurementToX(time_measurement_t *tmp1,
   tm_stop(tmp1, tmp2->last, (rtcnt_t)0);
 }
 
+#if (CH_CFG_USE_TM_HISTOGRAMS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a @p tm_histogram_t object.
+ *
+ * @param[out] hp       pointer to a @p tm_histogram_t structure
+ *
+ * @init
+ */
+void chTMHistogramObjectInit(tm_histogram_t *hp) {
+
+  chTMHistogramResetX(hp);
+}
+
+/**
+ * @brief   Clears all the measurements of an histogram.
+ * @note    Measurements must not be recorded in the histogram while it is
+ *          being reset.
+ *
+ * @param[out] hp       pointer to a @p tm_histogram_t structure
+ *
+ * @xclass
+ */
+void chTMHistogramResetX(tm_histogram_t *hp) {
+  unsigned i;
+
+  chTMObjectInit(&hp->tm);
+  for (i = 0U; i < CH_TM_HISTOGRAM_BUCKETS; i++) {
+    hp->buckets[i] = (ucnt_t)0;
+  }
+}
+
+/**
+ * @brief   Starts a measurement.
+ * @pre     The @p tm_histogram_t structure must be initialized.
+ *
+ * @param[in,out] hp    pointer to a @p tm_histogram_t structure
+ *
+ * @xclass
+ */
+NOINLINE void chTMHistogramStartX(tm_histogram_t *hp) {
+
+  hp->tm.last = chSysGetRealtimeCounterX();
+}
+
+/**
+ * @brief   Stops a measurement and records it in the histogram.
+ * @pre     The @p tm_histogram_t structure must be initialized.
+ *
+ * @param[in,out] hp    pointer to a @p tm_histogram_t structure
+ *
+ * @xclass
+ */
+NOINLINE void chTMHistogramStopX(tm_histogram_t *hp) {
+
+  tm_stop(&hp->tm, chSysGetRealtimeCounterX(), currcore->tm.offset);
+  hp->buckets[tm_bucket(hp->tm.last)]++;
+}
+
+/**
+ * @brief   Records a value measured externally.
+ * @pre     The @p tm_histogram_t structure must be initialized.
+ *
+ * @param[in,out] hp    pointer to a @p tm_histogram_t structure
+ * @param[in] value     the measured value
+ *
+ * @xclass
+ */
+void chTMHistogramAddX(tm_histogram_t *hp, rtcnt_t value) {
+
+  tm_add(&hp->tm, value);
+  hp->buckets[tm_bucket(value)]++;
+}
+
+/**
+ * @brief   Adds the measurements of an histogram to another histogram.
+ * @note    The last measurement of the destination histogram is not
+ *          modified.
+ *
+ * @param[in,out] dhp   pointer to the destination @p tm_histogram_t
+ * @param[in] shp       pointer to the source @p tm_histogram_t
+ *
+ * @xclass
+ */
+void chTMHistogramMergeX(tm_histogram_t *dhp, const tm_histogram_t *shp) {
+  unsigned i;
+
+  dhp->tm.n          += shp->tm.n;
+  dhp->tm.cumulative += shp->tm.cumulative;
+  if (shp->tm.worst > dhp->tm.worst) {
+    dhp->tm.worst = shp->tm.worst;
+  }
+  if (shp->tm.best < dhp->tm.best) {
+    dhp->tm.best = shp->tm.best;
+  }
+  for (i = 0U; i < CH_TM_HISTOGRAM_BUCKETS; i++) {
+    dhp->buckets[i] += shp->buckets[i];
+  }
+}
+
+/**
+ * @brief   Returns a percentile of the recorded measurements.
+ * @details The returned value is the upper bound of the bucket containing
+ *          the percentile, it is never greater than the worst measurement.
+ *
+ * @param[in] hp        pointer to a @p tm_histogram_t structure
+ * @param[in] ppm       the percentile in parts per million, for example
+ *                      990000 is the 99th percentile and 999000 is the
+ *                      99.9th percentile
+ * @return              The percentile value.
+ * @retval 0            if there are no measurements.
+ *
+ * @xclass
+ */
+rtcnt_t chTMHistogramGetPercentileX(const tm_histogram_t *hp, uint32_t ppm) {
+  uint64_t rank, count;
+  rtcnt_t top;
+  unsigned i;
+
+  chDbgCheck(ppm <= 1000000U);
+
+  if (hp->tm.n == (ucnt_t)0) {
+    return (rtcnt_t)0;
+  }
+
+  /* Rank of the measurement corresponding to the percentile, rounded up.*/
+  rank = (((uint64_t)hp->tm.n * (uint64_t)ppm) + 999999U) / 1000000U;
+  if (rank == 0U) {
+    rank = 1U;
+  }
+
+  top = hp->tm.worst;
+  count = 0U;
+  for (i = 0U; i < CH_TM_HISTOGRAM_BUCKETS; i++) {
+    count += (uint64_t)hp->buckets[i];
+    if (count >= rank) {
+      if (tm_bucket_top(i) < top) {
+        top = tm_bucket_top(i);
+      }
+      break;
+    }
+  }
+
+  return top;
+}
+#endif /* CH_CFG_USE_TM_HISTOGRAMS == TRUE */
+
 #endif /* CH_CFG_USE_TM == TRUE */
 
 /** @} */
@@ -32,6 +32,18 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Maximum size of the stream header.
+ */
+#define TRACE_HEADER_SIZE       (4U + 10U)
+
+/**
+ * @brief   Size of the buffer used by @p chDbgDrainTrace().
+ */
+#define TRACE_DRAIN_SIZE        (4U * CH_TRACE_STREAM_RECORD_SIZE)
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -49,6 +61,23 @@
 /*===========================================================================*/
 
 #if (CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the trace buffer slot following the specified one.
+ *
+ * @param[in] tep       pointer to a trace buffer slot
+ * @return              The pointer to the next slot.
+ *
+ * @notapi
+ */
+static inline ch_trace_event_t *trace_following(ch_trace_event_t *tep) {
+
+  if (++tep >= &currcore->dbg.trace_buffer.buffer[CH_DBG_TRACE_BUFFER_SIZE]) {
+    tep = &currcore->dbg.trace_buffer.buffer[0];
+  }
+
+  return tep;
+}
+
 /**
  * @brief   Writes a time stamp and increases the trace buffer pointer.
  *
@@ -56,22 +85,132 @@
  */
 NOINLINE static void trace_next(void) {
 
-  ch.dbg.trace_buffer.ptr->time    = chVTGetSystemTimeX();
+  currcore->dbg.trace_buffer.ptr->time    = chVTGetSystemTimeX();
 #if PORT_SUPPORTS_RT == TRUE
-  ch.dbg.trace_buffer.ptr->rtstamp = chSysGetRealtimeCounterX();
+  currcore->dbg.trace_buffer.ptr->rtstamp = chSysGetRealtimeCounterX();
 #else
-  ch.dbg.trace_buffer.ptr->rtstamp = (rtcnt_t)0;
+  currcore->dbg.trace_buffer.ptr->rtstamp = (rtcnt_t)0;
 #endif
 
   /* Trace hook, useful in order to interface debug tools.*/
-  CH_CFG_TRACE_HOOK(ch.dbg.trace_buffer.ptr);
+  CH_CFG_TRACE_HOOK(currcore->dbg.trace_buffer.ptr);
+
+#if CH_DBG_TRACE_STREAM == TRUE
+  {
+    ch_trace_buffer_t *tbp = &currcore->dbg.trace_buffer;
+    ch_trace_event_t *np;
+    size_t used;
+
+    /* Records in the FIFO, the slot pointed by "ptr" is always free.*/
+    if (tbp->ptr >= tbp->rdptr) {
+      used = (size_t)(tbp->ptr - tbp->rdptr);
+    }
+    else {
+      used = (size_t)CH_DBG_TRACE_BUFFER_SIZE -
+             (size_t)(tbp->rdptr - tbp->ptr);
+    }
+
+    /* Pending losses require an extra slot for the drop record, it is
+       inserted before the new record in order to preserve the ordering.*/
+    if ((used + ((tbp->lost > (ucnt_t)0) ? 2U : 1U)) >=
+        (size_t)CH_DBG_TRACE_BUFFER_SIZE) {
+      tbp->lost++;
+      tbp->drops++;
+      return;
+    }
+    if (tbp->lost > (ucnt_t)0) {
+      np = trace_following(tbp->ptr);
+      *np = *tbp->ptr;
+      tbp->ptr->type       = CH_TRACE_TYPE_DROP;
+      tbp->ptr->state      = 0U;
+      tbp->ptr->u.drop.n   = tbp->lost;
+      tbp->ptr             = np;
+      tbp->lost            = (ucnt_t)0;
+    }
+  }
+#endif
+
+  currcore->dbg.trace_buffer.ptr =
+      trace_following(currcore->dbg.trace_buffer.ptr);
+}
 
-  if (++ch.dbg.trace_buffer.ptr >=
-      &ch.dbg.trace_buffer.buffer[CH_DBG_TRACE_BUFFER_SIZE]) {
-    ch.dbg.trace_buffer.ptr = &ch.dbg.trace_buffer.buffer[0];
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Writes a variable length integer.
+ * @details Seven bits per byte are written, least significant first, the
+ *          most significant bit is set in all bytes except the last one.
+ *
+ * @param[out] bp       pointer to the output buffer
+ * @param[in] value     value to be written
+ * @return              The pointer after the written bytes.
+ *
+ * @notapi
+ */
+static uint8_t *trace_put_varint(uint8_t *bp, uintptr_t value) {
+
+  while (value >= (uintptr_t)0x80) {
+    *bp++ = (uint8_t)(value | (uintptr_t)0x80);
+    value >>= 7;
   }
+  *bp++ = (uint8_t)value;
+
+  return bp;
 }
-#endif
+
+/**
+ * @brief   Encodes a trace record.
+ * @details The record is encoded as an header byte containing type and
+ *          state, the system time and accurate time stamp deltas from the
+ *          previous record then the type-specific payload.
+ *
+ * @param[out] bp       pointer to the output buffer, it must be able to
+ *                      contain @p CH_TRACE_STREAM_RECORD_SIZE bytes
+ * @param[in] tep       pointer to the record to be encoded
+ * @return              The pointer after the written bytes.
+ *
+ * @notapi
+ */
+static uint8_t *trace_encode(uint8_t *bp, const ch_trace_event_t *tep) {
+  ch_trace_buffer_t *tbp = &currcore->dbg.trace_buffer;
+
+  *bp++ = (uint8_t)(tep->type | (tep->state << 3));
+  bp = trace_put_varint(bp, (uintptr_t)chTimeDiffX(tbp->rdtime, tep->time));
+  bp = trace_put_varint(bp, (uintptr_t)((tep->rtstamp - tbp->rdrtstamp) &
+                                        0xFFFFFFU));
+  tbp->rdtime    = tep->time;
+  tbp->rdrtstamp = tep->rtstamp;
+
+  switch (tep->type) {
+  case CH_TRACE_TYPE_SWITCH:
+    bp = trace_put_varint(bp, (uintptr_t)tep->u.sw.ntp);
+    bp = trace_put_varint(bp, (uintptr_t)tep->u.sw.wtobjp);
+    break;
+  case CH_TRACE_TYPE_ISR_ENTER:
+  case CH_TRACE_TYPE_ISR_LEAVE:
+    bp = trace_put_varint(bp, (uintptr_t)tep->u.isr.name);
+    break;
+  case CH_TRACE_TYPE_HALT:
+    bp = trace_put_varint(bp, (uintptr_t)tep->u.halt.reason);
+    break;
+  case CH_TRACE_TYPE_USER:
+    bp = trace_put_varint(bp, (uintptr_t)tep->u.user.up1);
+    bp = trace_put_varint(bp, (uintptr_t)tep->u.user.up2);
+    break;
+  case CH_TRACE_TYPE_OBJECT:
+    bp = trace_put_varint(bp, (uintptr_t)tep->u.obj.objp);
+    bp = trace_put_varint(bp, tep->u.obj.arg);
+    break;
+  case CH_TRACE_TYPE_DROP:
+    bp = trace_put_varint(bp, (uintptr_t)tep->u.drop.n);
+    break;
+  default:
+    break;
+  }
+
+  return bp;
+}
+#endif /* CH_DBG_TRACE_STREAM == TRUE */
+#endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 
 /*===========================================================================*/
 /* Module exported functions.                                                */
@@ -85,12 +224,20 @@ NOINLINE static void trace_next(void) {
 void _trace_init(void) {
   unsigned i;
 
-  ch.dbg.trace_buffer.suspended = (uint16_t)~CH_DBG_TRACE_MASK;
-  ch.dbg.trace_buffer.size      = CH_DBG_TRACE_BUFFER_SIZE;
-  ch.dbg.trace_buffer.ptr       = &ch.dbg.trace_buffer.buffer[0];
+  currcore->dbg.trace_buffer.suspended = (uint16_t)~CH_DBG_TRACE_MASK;
+  currcore->dbg.trace_buffer.size      = CH_DBG_TRACE_BUFFER_SIZE;
+  currcore->dbg.trace_buffer.ptr       = &currcore->dbg.trace_buffer.buffer[0];
   for (i = 0U; i < (unsigned)CH_DBG_TRACE_BUFFER_SIZE; i++) {
-    ch.dbg.trace_buffer.buffer[i].type = CH_TRACE_TYPE_UNUSED;
+    currcore->dbg.trace_buffer.buffer[i].type = CH_TRACE_TYPE_UNUSED;
   }
+#if CH_DBG_TRACE_STREAM == TRUE
+  currcore->dbg.trace_buffer.rdptr     = &currcore->dbg.trace_buffer.buffer[0];
+  currcore->dbg.trace_buffer.lost      = (ucnt_t)0;
+  currcore->dbg.trace_buffer.drops     = (ucnt_t)0;
+  currcore->dbg.trace_buffer.rdtime    = (systime_t)0;
+  currcore->dbg.trace_buffer.rdrtstamp = 0U;
+  currcore->dbg.trace_buffer.rdstarted = false;
+#endif
 }
 
 /**
@@ -105,11 +252,12 @@ void _trace_switch(thread_t *ntp, thread_t *otp) {
 
   (void)ntp;
 
-  if ((ch.dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_SWITCH) == 0U) {
-    ch.dbg.trace_buffer.ptr->type        = CH_TRACE_TYPE_SWITCH;
-    ch.dbg.trace_buffer.ptr->state       = (uint8_t)otp->state;
-    ch.dbg.trace_buffer.ptr->u.sw.ntp    = currp;
-    ch.dbg.trace_buffer.ptr->u.sw.wtobjp = otp->u.wtobjp;
+  if ((currcore->dbg.trace_buffer.suspended &
+       CH_DBG_TRACE_MASK_SWITCH) == 0U) {
+    currcore->dbg.trace_buffer.ptr->type        = CH_TRACE_TYPE_SWITCH;
+    currcore->dbg.trace_buffer.ptr->state       = (uint8_t)otp->state;
+    currcore->dbg.trace_buffer.ptr->u.sw.ntp    = currp;
+    currcore->dbg.trace_buffer.ptr->u.sw.wtobjp = otp->u.wtobjp;
     trace_next();
   }
 }
@@ -123,11 +271,11 @@ void _trace_switch(thread_t *ntp, thread_t *otp) {
  */
 void _trace_isr_enter(const char *isr) {
 
-  if ((ch.dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_ISR) == 0U) {
+  if ((currcore->dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_ISR) == 0U) {
     port_lock_from_isr();
-    ch.dbg.trace_buffer.ptr->type        = CH_TRACE_TYPE_ISR_ENTER;
-    ch.dbg.trace_buffer.ptr->state       = 0U;
-    ch.dbg.trace_buffer.ptr->u.isr.name  = isr;
+    currcore->dbg.trace_buffer.ptr->type        = CH_TRACE_TYPE_ISR_ENTER;
+    currcore->dbg.trace_buffer.ptr->state       = 0U;
+    currcore->dbg.trace_buffer.ptr->u.isr.name  = isr;
     trace_next();
     port_unlock_from_isr();
   }
@@ -142,11 +290,11 @@ void _trace_isr_enter(const char *isr) {
  */
 void _trace_isr_leave(const char *isr) {
 
-  if ((ch.dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_ISR) == 0U) {
+  if ((currcore->dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_ISR) == 0U) {
     port_lock_from_isr();
-    ch.dbg.trace_buffer.ptr->type        = CH_TRACE_TYPE_ISR_LEAVE;
-    ch.dbg.trace_buffer.ptr->state       = 0U;
-    ch.dbg.trace_buffer.ptr->u.isr.name  = isr;
+    currcore->dbg.trace_buffer.ptr->type        = CH_TRACE_TYPE_ISR_LEAVE;
+    currcore->dbg.trace_buffer.ptr->state       = 0U;
+    currcore->dbg.trace_buffer.ptr->u.isr.name  = isr;
     trace_next();
     port_unlock_from_isr();
   }
@@ -161,14 +309,39 @@ void _trace_isr_leave(const char *isr) {
  */
 void _trace_halt(const char *reason) {
 
-  if ((ch.dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_HALT) == 0U) {
-    ch.dbg.trace_buffer.ptr->type          = CH_TRACE_TYPE_HALT;
-    ch.dbg.trace_buffer.ptr->state         = 0;
-    ch.dbg.trace_buffer.ptr->u.halt.reason = reason;
+  if ((currcore->dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_HALT) == 0U) {
+    currcore->dbg.trace_buffer.ptr->type          = CH_TRACE_TYPE_HALT;
+    currcore->dbg.trace_buffer.ptr->state         = 0;
+    currcore->dbg.trace_buffer.ptr->u.halt.reason = reason;
     trace_next();
   }
 }
 
+#if ((CH_DBG_TRACE_MASK & CH_DBG_TRACE_MASK_OBJECTS) != 0U) ||              \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Inserts in the circular debug trace buffer a kernel object record.
+ * @note    Must be invoked from within a critical zone.
+ *
+ * @param[in] op        the operation, one of the @p CH_TRACE_OP_XXX values
+ * @param[in] objp      pointer to the kernel object
+ * @param[in] arg       operation argument
+ *
+ * @notapi
+ */
+void _trace_object(unsigned op, void *objp, uintptr_t arg) {
+
+  if ((currcore->dbg.trace_buffer.suspended &
+       CH_DBG_TRACE_MASK_OBJECTS) == 0U) {
+    currcore->dbg.trace_buffer.ptr->type       = CH_TRACE_TYPE_OBJECT;
+    currcore->dbg.trace_buffer.ptr->state      = (uint8_t)op;
+    currcore->dbg.trace_buffer.ptr->u.obj.objp = objp;
+    currcore->dbg.trace_buffer.ptr->u.obj.arg  = arg;
+    trace_next();
+  }
+}
+#endif
+
 /**
  * @brief   Adds an user trace record to the trace buffer.
  *
@@ -181,11 +354,11 @@ void chDbgWriteTraceI(void *up1, void *up2) {
 
   chDbgCheckClassI();
 
-  if ((ch.dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_USER) == 0U) {
-    ch.dbg.trace_buffer.ptr->type       = CH_TRACE_TYPE_USER;
-    ch.dbg.trace_buffer.ptr->state      = 0;
-    ch.dbg.trace_buffer.ptr->u.user.up1 = up1;
-    ch.dbg.trace_buffer.ptr->u.user.up2 = up2;
+  if ((currcore->dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_USER) == 0U) {
+    currcore->dbg.trace_buffer.ptr->type       = CH_TRACE_TYPE_USER;
+    currcore->dbg.trace_buffer.ptr->state      = 0;
+    currcore->dbg.trace_buffer.ptr->u.user.up1 = up1;
+    currcore->dbg.trace_buffer.ptr->u.user.up2 = up2;
     trace_next();
   }
 }
@@ -216,7 +389,7 @@ void chDbgSuspendTraceI(uint16_t mask) {
 
   chDbgCheckClassI();
 
-  ch.dbg.trace_buffer.suspended |= mask;
+  currcore->dbg.trace_buffer.suspended |= mask;
 }
 
 /**
@@ -244,7 +417,7 @@ void chDbgResumeTraceI(uint16_t mask) {
 
   chDbgCheckClassI();
 
-  ch.dbg.trace_buffer.suspended &= ~mask;
+  currcore->dbg.trace_buffer.suspended &= ~mask;
 }
 
 /**
@@ -260,6 +433,103 @@ void chDbgResumeTrace(uint16_t mask) {
   chDbgResumeTraceI(mask);
   chSysUnlock();
 }
+
+#if (CH_DBG_TRACE_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reads and encodes trace records from the trace FIFO.
+ * @details The first call writes the stream header: the "CHT" signature,
+ *          the format version and the system tick frequency. Records are
+ *          removed from the FIFO and encoded as long as there is space for
+ *          a complete record in the output buffer.
+ * @note    The trace of the current core is read, there must be a single
+ *          reader for each core.
+ *
+ * @param[out] bp       pointer to the output buffer
+ * @param[in] n         size of the output buffer
+ * @return              The number of bytes written in the buffer.
+ * @retval 0            if the FIFO is empty or the buffer is too small.
+ *
+ * @api
+ */
+size_t chDbgReadTrace(uint8_t *bp, size_t n) {
+  ch_trace_buffer_t *tbp = &currcore->dbg.trace_buffer;
+  uint8_t *p = bp;
+  ch_trace_event_t te;
+
+  chDbgCheck(bp != NULL);
+
+  if (!tbp->rdstarted) {
+    if (n < TRACE_HEADER_SIZE) {
+      return (size_t)0;
+    }
+    *p++ = (uint8_t)'C';
+    *p++ = (uint8_t)'H';
+    *p++ = (uint8_t)'T';
+    *p++ = (uint8_t)CH_TRACE_STREAM_VERSION;
+    p = trace_put_varint(p, (uintptr_t)CH_CFG_ST_FREQUENCY);
+    tbp->rdstarted = true;
+  }
+
+  while ((size_t)(&bp[n] - p) >= CH_TRACE_STREAM_RECORD_SIZE) {
+
+    /* The record is copied within a critical zone, the encoding is
+       performed outside.*/
+    chSysLock();
+    if (tbp->rdptr == tbp->ptr) {
+      chSysUnlock();
+      break;
+    }
+    te = *tbp->rdptr;
+    tbp->rdptr = trace_following(tbp->rdptr);
+    chSysUnlock();
+
+    p = trace_encode(p, &te);
+  }
+
+  return (size_t)(p - bp);
+}
+
+/**
+ * @brief   Drains the trace FIFO into a sink.
+ * @details Records are read and encoded in blocks, each block is passed to
+ *          the sink function. The function returns when the FIFO is empty.
+ * @note    A @p BaseSequentialStream can be used as sink by passing its
+ *          @p write() method and the stream itself as object.
+ *
+ * @param[in] sink      the sink function
+ * @param[in] obj       the sink object
+ * @return              The number of bytes passed to the sink.
+ *
+ * @api
+ */
+size_t chDbgDrainTrace(ch_trace_sink_t sink, void *obj) {
+  uint8_t buf[TRACE_DRAIN_SIZE];
+  size_t n, total;
+
+  chDbgCheck(sink != NULL);
+
+  total = (size_t)0;
+  while ((n = chDbgReadTrace(buf, sizeof (buf))) > (size_t)0) {
+    (void) sink(obj, buf, n);
+    total += n;
+  }
+
+  return total;
+}
+
+/**
+ * @brief   Returns the total number of lost trace records.
+ *
+ * @return              The number of records discarded because the trace
+ *                      FIFO was full.
+ *
+ * @xclass
+ */
+ucnt_t chDbgGetTraceDropsX(void) {
+
+  return currcore->dbg.trace_buffer.drops;
+}
+#endif /* CH_DBG_TRACE_STREAM == TRUE */
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 
 /** @} */
@@ -71,6 +71,38 @@
  */
 #define is_timer(vtlp, vtp) ((vtp) != (virtual_timer_t *)(vtlp))
 
+#if (CH_CFG_USE_TIMER_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Largest interval representable in the timing wheel.
+ */
+#define VT_WHEEL_MAX_DELTA                                                  \
+  (((sysinterval_t)1 << (CH_VT_WHEEL_BITS * CH_CFG_VT_WHEEL_LEVELS)) -      \
+   (sysinterval_t)1)
+
+/**
+ * @brief   Value of @p nextdelta when the wheel is empty.
+ */
+#define VT_WHEEL_NO_EVENTS  ((sysinterval_t)-1)
+
+/**
+ * @brief   Shift of the slot index for a wheel level.
+ *
+ * @param[in] level     the wheel level
+ *
+ * @notapi
+ */
+#define vt_wheel_shift(level) (CH_VT_WHEEL_BITS * (unsigned)(level))
+
+/**
+ * @brief   Slot empty check.
+ *
+ * @param[in] sp        pointer to the slot header
+ *
+ * @notapi
+ */
+#define is_slot_empty(sp) ((sp) == (virtual_timers_slot_t *)(sp)->next)
+#endif /* CH_CFG_USE_TIMER_WHEEL == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -87,7 +119,8 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
-#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
+#if ((CH_CFG_USE_TIMER_WHEEL == FALSE) && (CH_CFG_ST_TIMEDELTA > 0)) ||     \
+    defined(__DOXYGEN__)
 /**
  * @brief   Delta list compression.
  *
@@ -117,10 +150,298 @@ static void vt_list_compress(virtual_timers_list_t *vtlp,
 }
 #endif
 
+#if (CH_CFG_USE_TIMER_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the position of the least significant bit set in a word.
+ * @pre     The word must not be zero.
+ *
+ * @param[in] w         the word to be scanned
+ * @return              The bit position, from 0 to 31.
+ *
+ * @notapi
+ */
+static inline unsigned vt_wheel_lsb(uint32_t w) {
+
+#if defined(__GNUC__)
+  return (unsigned)__builtin_ctzl((unsigned long)w);
+#else
+  unsigned n = 0U;
+
+  while ((w & 1U) == 0U) {
+    w >>= 1;
+    n++;
+  }
+
+  return n;
+#endif
+}
+
+#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Checks if the timing wheel is empty.
+ *
+ * @param[in] vtlp      pointer to the timers header
+ * @return              The wheel state.
+ * @retval false        if the wheel contains at least one timer.
+ * @retval true         if the wheel is empty.
+ *
+ * @notapi
+ */
+static bool vt_wheel_is_empty(const virtual_timers_list_t *vtlp) {
+  uint32_t map = 0U;
+  unsigned level;
+
+  for (level = 0U; level < (unsigned)CH_CFG_VT_WHEEL_LEVELS; level++) {
+    map |= vtlp->wmap[level];
+  }
+
+  return (bool)(map == 0U);
+}
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+
+/**
+ * @brief   Links a timer into the timing wheel.
+ * @details The timer is put in the lowest level able to represent its
+ *          delay, the slot is selected using the expiration time bits
+ *          of that level.
+ *
+ * @param[in] vtlp      pointer to the timers header
+ * @param[in] vtp       pointer to the timer
+ * @param[in] delta     wheel ticks from @p wtime to the expiration, it
+ *                      must not exceed @p VT_WHEEL_MAX_DELTA
+ * @return              The wheel ticks from @p wtime to the wheel event
+ *                      serving the timer, its expiration or the cascade
+ *                      of its slot.
+ *
+ * @notapi
+ */
+static sysinterval_t vt_wheel_link(virtual_timers_list_t *vtlp,
+                                   virtual_timer_t *vtp,
+                                   sysinterval_t delta) {
+  virtual_timers_slot_t *sp;
+  unsigned level, slot, shift;
+
+  /* Level selection, the loop is bounded by the number of levels.*/
+  level = 0U;
+  while ((level < ((unsigned)CH_CFG_VT_WHEEL_LEVELS - 1U)) &&
+         ((delta >> vt_wheel_shift(level + 1U)) != (sysinterval_t)0)) {
+    level++;
+  }
+  shift = vt_wheel_shift(level);
+
+  /* Slot selection using the expiration time.*/
+  vtp->delta = vtlp->wtime + delta;
+  slot = (unsigned)(vtp->delta >> shift) & CH_VT_WHEEL_MASK;
+
+  /* Insertion at the end of the slot.*/
+  sp = &vtlp->slots[level][slot];
+  vtp->next = (virtual_timer_t *)sp;
+  vtp->prev = sp->prev;
+  vtp->prev->next = vtp;
+  sp->prev = vtp;
+  vtlp->wmap[level] |= (uint32_t)1U << slot;
+
+  return (sysinterval_t)(((vtp->delta >> shift) << shift) - vtlp->wtime);
+}
+
+/**
+ * @brief   Unlinks a timer from the timing wheel.
+ *
+ * @param[in] vtlp      pointer to the timers header
+ * @param[in] vtp       pointer to the timer
+ *
+ * @notapi
+ */
+static void vt_wheel_unlink(virtual_timers_list_t *vtlp,
+                            virtual_timer_t *vtp) {
+
+  vtp->prev->next = vtp->next;
+  vtp->next->prev = vtp->prev;
+
+  /* If the timer was alone then both links point to the slot header,
+     the slot became empty and its bit is cleared.*/
+  if (vtp->prev == vtp->next) {
+    unsigned i = (unsigned)((virtual_timers_slot_t *)vtp->next -
+                            &vtlp->slots[0][0]);
+
+    vtlp->wmap[i >> CH_VT_WHEEL_BITS] &= ~((uint32_t)1U <<
+                                           (i & CH_VT_WHEEL_MASK));
+  }
+}
+
+/**
+ * @brief   Inserts a timer into the timing wheel.
+ * @details Delays exceeding the wheel range are split, the part in
+ *          excess is stored in the timer and served when the first part
+ *          expires.
+ *
+ * @param[in] vtlp      pointer to the timers header
+ * @param[in] vtp       pointer to the timer
+ * @param[in] base      wheel ticks from @p wtime to the delay start, it
+ *                      must not exceed @p VT_WHEEL_MAX_DELTA
+ * @param[in] delay     the timer delay
+ * @return              The wheel ticks from @p wtime to the wheel event
+ *                      serving the timer.
+ *
+ * @notapi
+ */
+static sysinterval_t vt_wheel_insert(virtual_timers_list_t *vtlp,
+                                     virtual_timer_t *vtp,
+                                     sysinterval_t base,
+                                     sysinterval_t delay) {
+
+  if (delay > (VT_WHEEL_MAX_DELTA - base)) {
+    vtp->residual = delay - (VT_WHEEL_MAX_DELTA - base);
+    return vt_wheel_link(vtlp, vtp, VT_WHEEL_MAX_DELTA);
+  }
+
+  vtp->residual = (sysinterval_t)0;
+  return vt_wheel_link(vtlp, vtp, base + delay);
+}
+
+/**
+ * @brief   Returns the interval until the next wheel event.
+ * @details A wheel event is either the expiration of a first level slot
+ *          or the cascade of an upper level slot, the search is bounded
+ *          by the number of levels.
+ *
+ * @param[in] vtlp      pointer to the timers header
+ * @return              The wheel ticks from @p wtime to the next event.
+ * @retval VT_WHEEL_NO_EVENTS if the wheel is empty.
+ *
+ * @notapi
+ */
+static sysinterval_t vt_wheel_next(const virtual_timers_list_t *vtlp) {
+  sysinterval_t next = VT_WHEEL_NO_EVENTS;
+  unsigned level;
+
+  for (level = 0U; level < (unsigned)CH_CFG_VT_WHEEL_LEVELS; level++) {
+    uint32_t map = vtlp->wmap[level];
+
+    if (map != 0U) {
+      unsigned shift = vt_wheel_shift(level);
+      unsigned cur = (unsigned)(vtlp->wtime >> shift) & CH_VT_WHEEL_MASK;
+      sysinterval_t n;
+
+      /* Rotating the map so that bit zero is the slot after the current
+         one, the current slot itself is one full turn away.*/
+      map = (map >> ((cur + 1U) & CH_VT_WHEEL_MASK)) |
+            (map << ((CH_VT_WHEEL_SLOTS - 1U - cur) & CH_VT_WHEEL_MASK));
+      n = (sysinterval_t)(vtlp->wtime >> shift) +
+          (sysinterval_t)vt_wheel_lsb(map) + (sysinterval_t)1;
+      n = (sysinterval_t)((n << shift) - vtlp->wtime);
+      if (n < next) {
+        next = n;
+      }
+    }
+  }
+
+  return next;
+}
+
+/**
+ * @brief   Processes the wheel slots reached at the current wheel time.
+ * @details Upper level slots whose boundary has been reached are
+ *          cascaded to the lower levels then the expired timers are
+ *          triggered.
+ * @note    The system lock is released after moving each timer and
+ *          around each callback, the critical zone is bounded and does
+ *          not depend on the number of timers.
+ *
+ * @param[in] vtlp      pointer to the timers header
+ *
+ * @notapi
+ */
+static void vt_wheel_process(virtual_timers_list_t *vtlp) {
+  sysinterval_t wtime = vtlp->wtime;
+  virtual_timers_slot_t *sp;
+  unsigned level;
+
+  /* Cascading the upper levels, a level is reached only when all the
+     lower levels complete a turn.*/
+  for (level = 1U; level < (unsigned)CH_CFG_VT_WHEEL_LEVELS; level++) {
+    unsigned shift = vt_wheel_shift(level);
+
+    if ((wtime & (((sysinterval_t)1 << shift) - (sysinterval_t)1)) !=
+        (sysinterval_t)0) {
+      break;
+    }
+
+    sp = &vtlp->slots[level][(unsigned)(wtime >> shift) & CH_VT_WHEEL_MASK];
+    while (!is_slot_empty(sp)) {
+      virtual_timer_t *vtp = sp->next;
+
+      vt_wheel_unlink(vtlp, vtp);
+      (void) vt_wheel_link(vtlp, vtp, vtp->delta - wtime);
+
+      /* Giving a chance to pending interrupts after each moved timer.*/
+      chSysUnlockFromISR();
+      chSysLockFromISR();
+    }
+  }
+
+  /* Triggering the expired timers, new timers cannot be added to this
+     slot because their delay is always greater than zero.*/
+  sp = &vtlp->slots[0][(unsigned)wtime & CH_VT_WHEEL_MASK];
+  while (!is_slot_empty(sp)) {
+    virtual_timer_t *vtp = sp->next;
+
+    vt_wheel_unlink(vtlp, vtp);
+
+    /* Long delays are served in multiple rounds.*/
+    if (vtp->residual > (sysinterval_t)0) {
+      (void) vt_wheel_insert(vtlp, vtp, (sysinterval_t)0, vtp->residual);
+    }
+    else {
+      vtfunc_t fn = vtp->func;
+
+      vtp->func = NULL;
+
+      _trace_object(CH_TRACE_OP_VT_FIRE, vtp, (uintptr_t)0);
+
+      /* The callback is invoked outside the kernel critical zone.*/
+      chSysUnlockFromISR();
+      fn(vtp->par);
+      chSysLockFromISR();
+    }
+  }
+}
+
+#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Alarm time for the next wheel event.
+ * @pre     The wheel time must be aligned to the current system time.
+ *
+ * @param[in] vtlp      pointer to the timers header
+ * @return              The system time of the next alarm.
+ *
+ * @notapi
+ */
+static systime_t vt_wheel_alarm_time(const virtual_timers_list_t *vtlp) {
+  sysinterval_t delta = vtlp->nextdelta;
+
+  /* Making sure to not schedule an event closer than CH_CFG_ST_TIMEDELTA
+     ticks from now.*/
+  if (delta < (sysinterval_t)CH_CFG_ST_TIMEDELTA) {
+    delta = (sysinterval_t)CH_CFG_ST_TIMEDELTA;
+  }
+#if CH_CFG_INTERVALS_SIZE > CH_CFG_ST_RESOLUTION
+  /* The delta could be too large for the physical timer to handle.*/
+  else if (delta > (sysinterval_t)TIME_MAX_SYSTIME) {
+    delta = (sysinterval_t)TIME_MAX_SYSTIME;
+  }
+#endif
+
+  return chTimeAddX(vtlp->lasttime, delta);
+}
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+#endif /* CH_CFG_USE_TIMER_WHEEL == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TIMER_WHEEL == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Virtual Timers initialization.
  * @note    Internal use only.
@@ -129,13 +450,13 @@ static void vt_list_compress(virtual_timers_list_t *vtlp,
  */
 void _vt_init(void) {
 
-  ch.vtlist.next = (virtual_timer_t *)&ch.vtlist;
-  ch.vtlist.prev = (virtual_timer_t *)&ch.vtlist;
-  ch.vtlist.delta = (sysinterval_t)-1;
+  currcore->vtlist.next = (virtual_timer_t *)&currcore->vtlist;
+  currcore->vtlist.prev = (virtual_timer_t *)&currcore->vtlist;
+  currcore->vtlist.delta = (sysinterval_t)-1;
 #if CH_CFG_ST_TIMEDELTA == 0
-  ch.vtlist.systime = (systime_t)0;
+  currcore->vtlist.systime = (systime_t)0;
 #else /* CH_CFG_ST_TIMEDELTA > 0 */
-  ch.vtlist.lasttime = (systime_t)0;
+  currcore->vtlist.lasttime = (systime_t)0;
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
 }
 
@@ -163,13 +484,15 @@ void _vt_init(void) {
  */
 void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
                 vtfunc_t vtfunc, void *par) {
-  virtual_timers_list_t *vtlp = &ch.vtlist;
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
   virtual_timer_t *p;
   sysinterval_t delta;
 
   chDbgCheckClassI();
   chDbgCheck((vtp != NULL) && (vtfunc != NULL) && (delay != TIME_IMMEDIATE));
 
+  _trace_object(CH_TRACE_OP_VT_SET, vtp, (uintptr_t)delay);
+
   vtp->par = par;
   vtp->func = vtfunc;
 
@@ -275,12 +598,14 @@ void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
  * @iclass
  */
 void chVTDoResetI(virtual_timer_t *vtp) {
-  virtual_timers_list_t *vtlp = &ch.vtlist;
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
 
   chDbgCheckClassI();
   chDbgCheck(vtp != NULL);
   chDbgAssert(vtp->func != NULL, "timer not set or already triggered");
 
+  _trace_object(CH_TRACE_OP_VT_RESET, vtp, (uintptr_t)0);
+
 #if CH_CFG_ST_TIMEDELTA == 0
 
   /* The delta of the timer is added to the next timer.*/
@@ -373,7 +698,7 @@ void chVTDoResetI(virtual_timer_t *vtp) {
  * @iclass
  */
 void chVTDoTickI(void) {
-  virtual_timers_list_t *vtlp = &ch.vtlist;
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
 
   chDbgCheckClassI();
 
@@ -391,6 +716,7 @@ void chVTDoTickI(void) {
       vtp->func = NULL;
       vtp->next->prev = (virtual_timer_t *)vtlp;
       vtlp->next = vtp->next;
+      _trace_object(CH_TRACE_OP_VT_FIRE, vtp, (uintptr_t)0);
       chSysUnlockFromISR();
       fn(vtp->par);
       chSysLockFromISR();
@@ -434,6 +760,8 @@ void chVTDoTickI(void) {
         port_timer_stop_alarm();
       }
 
+      _trace_object(CH_TRACE_OP_VT_FIRE, vtp, (uintptr_t)0);
+
       /* The callback is invoked outside the kernel critical zone.*/
       chSysUnlockFromISR();
       fn(vtp->par);
@@ -474,4 +802,243 @@ void chVTDoTickI(void) {
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
 }
 
+#else /* CH_CFG_USE_TIMER_WHEEL == TRUE */
+/**
+ * @brief   Virtual Timers initialization.
+ * @note    Internal use only.
+ *
+ * @notapi
+ */
+void _vt_init(void) {
+  unsigned level, slot;
+
+  for (level = 0U; level < (unsigned)CH_CFG_VT_WHEEL_LEVELS; level++) {
+    currcore->vtlist.wmap[level] = 0U;
+    for (slot = 0U; slot < CH_VT_WHEEL_SLOTS; slot++) {
+      currcore->vtlist.slots[level][slot].next =
+          (virtual_timer_t *)&currcore->vtlist.slots[level][slot];
+      currcore->vtlist.slots[level][slot].prev =
+          (virtual_timer_t *)&currcore->vtlist.slots[level][slot];
+    }
+  }
+  currcore->vtlist.wtime = (sysinterval_t)0;
+#if CH_CFG_ST_TIMEDELTA == 0
+  currcore->vtlist.systime = (systime_t)0;
+#else /* CH_CFG_ST_TIMEDELTA > 0 */
+  currcore->vtlist.nextdelta = VT_WHEEL_NO_EVENTS;
+  currcore->vtlist.lasttime = (systime_t)0;
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+}
+
+/**
+ * @brief   Enables a virtual timer.
+ * @details The timer is enabled and programmed to trigger after the delay
+ *          specified as parameter.
+ * @pre     The timer must not be already armed before calling this function.
+ * @note    The callback function is invoked from interrupt context.
+ *
+ * @param[out] vtp      the @p virtual_timer_t structure pointer
+ * @param[in] delay     the number of ticks before the operation timeouts, the
+ *                      special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] vtfunc    the timer callback function. After invoking the
+ *                      callback the timer is disabled and the structure can
+ *                      be disposed or reused.
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @iclass
+ */
+void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
+                vtfunc_t vtfunc, void *par) {
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
+
+  chDbgCheckClassI();
+  chDbgCheck((vtp != NULL) && (vtfunc != NULL) && (delay != TIME_IMMEDIATE));
+
+  _trace_object(CH_TRACE_OP_VT_SET, vtp, (uintptr_t)delay);
+
+  vtp->par = par;
+  vtp->func = vtfunc;
+
+#if CH_CFG_ST_TIMEDELTA > 0
+  {
+    systime_t now = chVTGetSystemTimeX();
+    sysinterval_t deltanow, event;
+    bool empty;
+
+    /* If the requested delay is lower than the minimum safe delta then it
+       is raised to the minimum safe value.*/
+    if (delay < (sysinterval_t)CH_CFG_ST_TIMEDELTA) {
+      delay = (sysinterval_t)CH_CFG_ST_TIMEDELTA;
+    }
+
+    /* If no wheel event is due then the wheel time is moved to the current
+       time, this never happens while the wheel is being processed because
+       "nextdelta" is zero.*/
+    empty = (bool)(vtlp->nextdelta == VT_WHEEL_NO_EVENTS);
+    deltanow = chTimeDiffX(vtlp->lasttime, now);
+    if (empty || (deltanow < vtlp->nextdelta)) {
+      vtlp->lasttime = now;
+      vtlp->wtime += deltanow;
+      if (!empty) {
+        vtlp->nextdelta -= deltanow;
+      }
+      deltanow = (sysinterval_t)0;
+    }
+
+    chDbgAssert(deltanow <= VT_WHEEL_MAX_DELTA, "wheel time too late");
+
+    /* If the new timer is served before the next wheel event then the alarm
+       is moved, if the wheel is behind the current time then the alarm is
+       already pending.*/
+    event = vt_wheel_insert(vtlp, vtp, deltanow, delay);
+    if (event < vtlp->nextdelta) {
+      vtlp->nextdelta = event;
+      if (empty) {
+        port_timer_start_alarm(vt_wheel_alarm_time(vtlp));
+      }
+      else if (deltanow == (sysinterval_t)0) {
+        port_timer_set_alarm(vt_wheel_alarm_time(vtlp));
+      }
+    }
+  }
+#else /* CH_CFG_ST_TIMEDELTA == 0 */
+  (void) vt_wheel_insert(vtlp, vtp, (sysinterval_t)0, delay);
+#endif /* CH_CFG_ST_TIMEDELTA == 0 */
+}
+
+/**
+ * @brief   Disables a Virtual Timer.
+ * @pre     The timer must be in armed state before calling this function.
+ *
+ * @param[in] vtp       the @p virtual_timer_t structure pointer
+ *
+ * @iclass
+ */
+void chVTDoResetI(virtual_timer_t *vtp) {
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
+
+  chDbgCheckClassI();
+  chDbgCheck(vtp != NULL);
+  chDbgAssert(vtp->func != NULL, "timer not set or already triggered");
+
+  _trace_object(CH_TRACE_OP_VT_RESET, vtp, (uintptr_t)0);
+
+  vt_wheel_unlink(vtlp, vtp);
+  vtp->func = NULL;
+
+#if CH_CFG_ST_TIMEDELTA > 0
+  /* If the wheel became empty then the alarm timer is stopped, the alarm
+     is not touched while the wheel is being processed. The alarm is not
+     moved otherwise, an early alarm just finds nothing to process.*/
+  if ((vtlp->nextdelta != (sysinterval_t)0) && vt_wheel_is_empty(vtlp)) {
+    vtlp->nextdelta = VT_WHEEL_NO_EVENTS;
+    port_timer_stop_alarm();
+  }
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+}
+
+/**
+ * @brief   Virtual timers ticker.
+ * @note    The system lock is released before entering the callback and
+ *          re-acquired immediately after. It is callback's responsibility
+ *          to acquire the lock if needed. This is done in order to reduce
+ *          interrupts jitter when many timers are in use.
+ *
+ * @iclass
+ */
+void chVTDoTickI(void) {
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
+
+  chDbgCheckClassI();
+
+#if CH_CFG_ST_TIMEDELTA == 0
+  vtlp->systime++;
+  vtlp->wtime++;
+  vt_wheel_process(vtlp);
+#else /* CH_CFG_ST_TIMEDELTA > 0 */
+  systime_t now;
+  sysinterval_t deltanow;
+
+  /* Processing all the wheel events between "lasttime" and now, the
+     wheel time jumps from an event to the next one.*/
+  while (true) {
+
+    /* Getting the system time as reference.*/
+    now = chVTGetSystemTimeX();
+    deltanow = chTimeDiffX(vtlp->lasttime, now);
+
+    if ((vtlp->nextdelta == VT_WHEEL_NO_EVENTS) ||
+        (deltanow < vtlp->nextdelta)) {
+      break;
+    }
+
+    vtlp->lasttime = chTimeAddX(vtlp->lasttime, vtlp->nextdelta);
+    vtlp->wtime += vtlp->nextdelta;
+    vtlp->nextdelta = (sysinterval_t)0;
+    vt_wheel_process(vtlp);
+    vtlp->nextdelta = vt_wheel_next(vtlp);
+  }
+
+  /* If the wheel is empty then the alarm timer is stopped.*/
+  if (vtlp->nextdelta == VT_WHEEL_NO_EVENTS) {
+    port_timer_stop_alarm();
+
+    return;
+  }
+
+  /* The wheel time is aligned to the current time and the alarm is
+     programmed for the next wheel event.*/
+  vtlp->lasttime = now;
+  vtlp->wtime += deltanow;
+  vtlp->nextdelta -= deltanow;
+  port_timer_set_alarm(vt_wheel_alarm_time(vtlp));
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+}
+
+/**
+ * @brief   Returns the time interval until the next timer event.
+ * @note    The returned interval is the time of the next wheel event, it
+ *          can be a cascade of timers between wheel levels so it can be
+ *          lower than the time of the next timer expiration.
+ *
+ * @param[out] timep    pointer to a variable that will contain the time
+ *                      interval until the next timer elapses. This pointer
+ *                      can be @p NULL if the information is not required.
+ * @return              The time, in ticks, until next time event.
+ * @retval false        if the timers list is empty.
+ * @retval true         if the timers list contains at least one timer.
+ *
+ * @iclass
+ */
+bool chVTGetTimersStateI(sysinterval_t *timep) {
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
+  sysinterval_t next;
+
+  chDbgCheckClassI();
+
+  next = vt_wheel_next(vtlp);
+  if (next == VT_WHEEL_NO_EVENTS) {
+    return false;
+  }
+
+  if (timep != NULL) {
+#if CH_CFG_ST_TIMEDELTA == 0
+    *timep = next;
+#else
+    sysinterval_t nowdelta = chTimeDiffX(vtlp->lasttime,
+                                         chVTGetSystemTimeX());
+
+    *timep = (next > nowdelta) ? (next - nowdelta) : (sysinterval_t)0;
+#endif
+  }
+
+  return true;
+}
+#endif /* CH_CFG_USE_TIMER_WHEEL == TRUE */
+
 /** @} */
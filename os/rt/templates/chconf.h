@@ -83,6 +83,31 @@
 #define CH_CFG_ST_TIMEDELTA                 2
 #endif
 
+/**
+ * @brief   Hierarchical timing wheel for virtual timers.
+ * @details If enabled the virtual timers are kept in a timing wheel
+ *          instead of a delta list, arming and disarming a timer take
+ *          constant time regardless of the number of armed timers.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_TIMER_WHEEL)
+#define CH_CFG_USE_TIMER_WHEEL              FALSE
+#endif
+
+/**
+ * @brief   Number of levels in the timing wheel.
+ * @details Each level has 32 slots and covers 32 times the range of the
+ *          previous level.
+ *
+ * @note    The default is 4.
+ * @note    The value multiplied by 5 must be lower than
+ *          @p CH_CFG_INTERVALS_SIZE.
+ */
+#if !defined(CH_CFG_VT_WHEEL_LEVELS)
+#define CH_CFG_VT_WHEEL_LEVELS              4
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -140,6 +165,32 @@
 #define CH_CFG_OPTIMIZE_SPEED               TRUE
 #endif
 
+/**
+ * @brief   Bitmap-indexed ready list.
+ * @details If enabled the ready list is organized as one FIFO queue for
+ *          each priority level plus a bitmap of the non-empty levels,
+ *          insertion and removal of ready threads take constant time.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires about 2kB of additional RAM on 32 bits architectures.
+ */
+#if !defined(CH_CFG_USE_READY_BITMAP)
+#define CH_CFG_USE_READY_BITMAP             FALSE
+#endif
+
+/**
+ * @brief   Multi-core mode.
+ * @details If enabled the kernel runs one instance on each core, threads
+ *          run on the core that created them and can be awakened by the
+ *          other cores.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires a port supporting SMP.
+ */
+#if !defined(CH_CFG_SMP_MODE)
+#define CH_CFG_SMP_MODE                     FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -160,6 +211,29 @@
 #define CH_CFG_USE_TM                       TRUE
 #endif
 
+/**
+ * @brief   Time Measurement histograms.
+ * @details If enabled then the histogram-backed time measurement objects
+ *          are included in the kernel, if statistics are enabled then the
+ *          critical zones durations are also recorded in histograms.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_TM_HISTOGRAMS)
+#define CH_CFG_USE_TM_HISTOGRAMS            FALSE
+#endif
+
+/**
+ * @brief   Time Measurement histograms precision.
+ * @details Each power of two range of values is divided in 2^N linear
+ *          buckets.
+ *
+ * @note    The default is @p 3.
+ */
+#if !defined(CH_CFG_TM_HISTOGRAM_PRECISION)
+#define CH_CFG_TM_HISTOGRAM_PRECISION       3
+#endif
+
 /**
  * @brief   Threads registry APIs.
  * @details If enabled then the registry APIs are included in the kernel.
@@ -226,6 +300,19 @@
 #define CH_CFG_USE_MUTEXES_RECURSIVE        FALSE
 #endif
 
+/**
+ * @brief   Mutexes spin count.
+ * @details In multi-core mode @p chMtxLock() polls a mutex owned by a
+ *          thread running on another core up to this number of times
+ *          before queuing the calling thread.
+ *
+ * @note    The default is @p 0, spinning disabled.
+ * @note    Requires @p CH_CFG_USE_MUTEXES and @p CH_CFG_SMP_MODE.
+ */
+#if !defined(CH_CFG_MUTEXES_SPIN_COUNT)
+#define CH_CFG_MUTEXES_SPIN_COUNT           0
+#endif
+
 /**
  * @brief   Conditional Variables APIs.
  * @details If enabled then the conditional variables APIs are included
@@ -250,6 +337,18 @@
 #define CH_CFG_USE_CONDVARS_TIMEOUT         TRUE
 #endif
 
+/**
+ * @brief   Readers-writer locks APIs.
+ * @details If enabled then the readers-writer locks APIs are included in
+ *          the kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MUTEXES.
+ */
+#if !defined(CH_CFG_USE_RWLOCKS)
+#define CH_CFG_USE_RWLOCKS                  FALSE
+#endif
+
 /**
  * @brief   Events Flags APIs.
  * @details If enabled then the event flags APIs are included in the kernel.
@@ -272,6 +371,20 @@
 #define CH_CFG_USE_EVENTS_TIMEOUT           TRUE
 #endif
 
+/**
+ * @brief   Events listeners flags index.
+ * @details If enabled then the listeners of an event source are grouped
+ *          by flags mask, broadcasts only visit the listeners interested
+ *          in the broadcasted flags.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Only listeners with identical flags masks are grouped.
+ * @note    Requires @p CH_CFG_USE_EVENTS.
+ */
+#if !defined(CH_CFG_USE_EVENTS_INDEX)
+#define CH_CFG_USE_EVENTS_INDEX             FALSE
+#endif
+
 /**
  * @brief   Synchronous Messages APIs.
  * @details If enabled then the synchronous messages APIs are included
@@ -370,6 +483,29 @@
 #define CH_CFG_USE_HEAP                     TRUE
 #endif
 
+/**
+ * @brief   Segregated-fit heap allocator.
+ * @details If enabled the heaps use a two levels segregated-fit (TLSF)
+ *          allocator instead of the first-fit one, allocation and release
+ *          times do not depend on the heap fragmentation.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_HEAP.
+ */
+#if !defined(CH_CFG_USE_HEAP_TLSF)
+#define CH_CFG_USE_HEAP_TLSF                FALSE
+#endif
+
+/**
+ * @brief   Number of first level size classes of the TLSF allocator.
+ *
+ * @note    The default is 16.
+ * @note    Requires @p CH_CFG_USE_HEAP_TLSF.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_LEVELS)
+#define CH_CFG_HEAP_TLSF_LEVELS             16
+#endif
+
 /**
  * @brief   Memory Pools Allocator APIs.
  * @details If enabled then the memory pools allocator APIs are included
@@ -392,6 +528,17 @@
 #define CH_CFG_USE_OBJ_FIFOS                TRUE
 #endif
 
+/**
+ * @brief   Single producer single consumer objects FIFOs.
+ * @details If enabled then the objects FIFOs are lock-free rings, each
+ *          FIFO must have at most one sender and one receiver.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_OBJ_FIFOS_SPSC)
+#define CH_CFG_OBJ_FIFOS_SPSC               FALSE
+#endif
+
 /**
  * @brief   Pipes APIs.
  * @details If enabled then the pipes APIs are included
@@ -403,6 +550,17 @@
 #define CH_CFG_USE_PIPES                    TRUE
 #endif
 
+/**
+ * @brief   Single producer single consumer pipes.
+ * @details If enabled then the pipes are lock-free rings, each pipe must
+ *          have at most one writer and one reader.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_PIPES_SPSC)
+#define CH_CFG_PIPES_SPSC                   FALSE
+#endif
+
 /**
  * @brief   Objects Caches APIs.
  * @details If enabled then the objects caches APIs are included
@@ -414,6 +572,26 @@
 #define CH_CFG_USE_OBJ_CACHES               TRUE
 #endif
 
+/**
+ * @brief   Maximum number of objects in a clustered write.
+ *
+ * @note    The default is 8.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_CLUSTER_MAX)
+#define CH_CFG_OBJ_CACHES_CLUSTER_MAX       8
+#endif
+
+/**
+ * @brief   Objects Caches statistics.
+ * @details If enabled then hits, misses, evictions, writes and prefetches
+ *          are counted for each cache.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_STATS)
+#define CH_CFG_OBJ_CACHES_STATS             FALSE
+#endif
+
 /**
  * @brief   Delegate threads APIs.
  * @details If enabled then the delegate threads APIs are included
@@ -436,6 +614,27 @@
 #define CH_CFG_USE_JOBS                     TRUE
 #endif
 
+/**
+ * @brief   Jobs Pools APIs.
+ * @details If enabled then the work-stealing jobs pools APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_JOBS.
+ */
+#if !defined(CH_CFG_USE_JOBS_POOLS)
+#define CH_CFG_USE_JOBS_POOLS               FALSE
+#endif
+
+/**
+ * @brief   Number of jobs priority levels in jobs pools.
+ *
+ * @note    The default is 2.
+ */
+#if !defined(CH_CFG_JOBS_PRIORITIES)
+#define CH_CFG_JOBS_PRIORITIES              2
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -465,6 +664,19 @@
 #define CH_CFG_FACTORY_MAX_NAMES_LENGTH     8
 #endif
 
+/**
+ * @brief   Size of the hashed names index.
+ * @details If greater than zero then each objects list is split in the
+ *          specified number of hash buckets and lookups by name, and by
+ *          pointer for registered objects, take constant time on average.
+ *
+ * @note    The default is 0, no index.
+ * @note    The value must be zero or a power of two.
+ */
+#if !defined(CH_CFG_FACTORY_HASH_SIZE)
+#define CH_CFG_FACTORY_HASH_SIZE            0
+#endif
+
 /**
  * @brief   Enables the registry of generic objects.
  */
@@ -578,6 +790,18 @@
 #define CH_DBG_TRACE_BUFFER_SIZE            128
 #endif
 
+/**
+ * @brief   Streaming trace mode.
+ * @details If enabled the trace buffer is handled as a FIFO drained by
+ *          @p chDbgReadTrace() or @p chDbgDrainTrace(), records are never
+ *          overwritten and lost records are reported in the stream.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_DBG_TRACE_STREAM)
+#define CH_DBG_TRACE_STREAM                 FALSE
+#endif
+
 /**
  * @brief   Debug option, stack checks.
  * @details If enabled then a runtime stack check is performed.
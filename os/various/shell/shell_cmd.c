@@ -158,12 +158,12 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
   tp = chRegFirstThread();
   do {
 #if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)
-    uint32_t stklimit = (uint32_t)tp->wabase;
+    uint32_t stklimit = (uint32_t)(uintptr_t)tp->wabase;
 #else
     uint32_t stklimit = 0U;
 #endif
     chprintf(chp, "%08lx %08lx %08lx %4lu %4lu %9s %12s" SHELL_NEWLINE_STR,
-             stklimit, (uint32_t)tp->ctx.sp, (uint32_t)tp,
+             stklimit, (uint32_t)(uintptr_t)tp->ctx.sp, (uint32_t)(uintptr_t)tp,
              (uint32_t)tp->refs - 1, (uint32_t)tp->prio, states[tp->state],
              tp->name == NULL ? "" : tp->name);
     tp = chRegNextThread(tp);
@@ -171,6 +171,83 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 }
 #endif
 
+#if (SHELL_CMD_TOP_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_top(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static const char *states[] = {CH_STATE_NAMES};
+  struct {
+    thread_t    *tp;
+    rttime_t    cumulative;
+  } samples[SHELL_CMD_TOP_MAX_THREADS];
+  thread_stats_t ts;
+  thread_t *tp;
+  rtcnt_t start, window;
+  unsigned i, n;
+
+  (void)argv;
+  if (argc > 0) {
+    shellUsage(chp, "top");
+    return;
+  }
+
+  /* First sample of the run times.*/
+  n = 0U;
+  start = chSysGetRealtimeCounterX();
+  tp = chRegFirstThread();
+  do {
+    if (n < (unsigned)SHELL_CMD_TOP_MAX_THREADS) {
+      chRegGetThreadStatsX(tp, &ts);
+#if CH_CFG_USE_DYNAMIC == TRUE
+      /* The reference keeps the sampled thread in the registry until
+         the second sample, its memory cannot be reused meanwhile.*/
+      samples[n].tp         = chThdAddRef(tp);
+#else
+      samples[n].tp         = tp;
+#endif
+      samples[n].cumulative = ts.cumulative;
+      n++;
+    }
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+
+  chThdSleepMilliseconds(1000);
+
+  /* The CPU load is the run time increment over the sampling window,
+     threads created in the meanwhile are accounted from their start. A
+     run time lower than the sampled one means that the thread has been
+     recreated at the same address.*/
+  window = chSysGetRealtimeCounterX() - start;
+  chprintf(chp, "    addr prio     state  cpu%%  switches  worstlat  "
+                "stkfree         name" SHELL_NEWLINE_STR);
+  tp = chRegFirstThread();
+  do {
+    rttime_t delta;
+
+    chRegGetThreadStatsX(tp, &ts);
+    delta = ts.cumulative;
+    for (i = 0U; i < n; i++) {
+      if ((samples[i].tp == tp) && (samples[i].cumulative <= delta)) {
+        delta -= samples[i].cumulative;
+        break;
+      }
+    }
+    delta = (delta * 1000U) / (rttime_t)window;
+    chprintf(chp, "%08lx %4lu %9s %3lu.%lu %9lu %9lu %8lu %12s" SHELL_NEWLINE_STR,
+             (uint32_t)(uintptr_t)tp, (uint32_t)tp->prio, states[tp->state],
+             (uint32_t)(delta / 10U), (uint32_t)(delta % 10U),
+             (uint32_t)ts.n_switches, (uint32_t)ts.worst_lat,
+             (uint32_t)ts.stack_unused, tp->name == NULL ? "" : tp->name);
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+
+#if CH_CFG_USE_DYNAMIC == TRUE
+  /* Releasing the references taken on the first sample.*/
+  for (i = 0U; i < n; i++) {
+    chThdRelease(samples[i].tp);
+  }
+#endif
+}
+#endif
+
 #if (SHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 static THD_FUNCTION(test_rt, arg) {
   BaseSequentialStream *chp = (BaseSequentialStream *)arg;
@@ -238,6 +315,9 @@ const ShellCommand shell_local_commands[] = {
 #if SHELL_CMD_THREADS_ENABLED == TRUE
   {"threads", cmd_threads},
 #endif
+#if SHELL_CMD_TOP_ENABLED == TRUE
+  {"top", cmd_top},
+#endif
 #if SHELL_CMD_TEST_ENABLED == TRUE
   {"test", cmd_test},
 #endif
@@ -30,6 +30,7 @@
  * - @subpage cry_test_sequence_007
  * - @subpage cry_test_sequence_008
  * - @subpage cry_test_sequence_009
+ * - @subpage cry_test_sequence_010
  * .
  */
 
@@ -51,15 +52,36 @@
  * @brief   Array of test sequences.
  */
 const testsequence_t * const cry_test_suite_array[] = {
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
   &cry_test_sequence_001,
+#endif
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
   &cry_test_sequence_002,
+#endif
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
   &cry_test_sequence_003,
+#endif
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
   &cry_test_sequence_004,
+#endif
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
   &cry_test_sequence_005,
+#endif
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
   &cry_test_sequence_006,
+#endif
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
   &cry_test_sequence_007,
+#endif
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
   &cry_test_sequence_008,
+#endif
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
   &cry_test_sequence_009,
+#endif
+#if (HAL_CRY_ENFORCE_FALLBACK == TRUE) || defined(__DOXYGEN__)
+  &cry_test_sequence_010,
+#endif
   NULL
 };
 
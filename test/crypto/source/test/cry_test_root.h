@@ -33,6 +33,7 @@
 #include "cry_test_sequence_007.h"
 #include "cry_test_sequence_008.h"
 #include "cry_test_sequence_009.h"
+#include "cry_test_sequence_010.h"
 
 #if !defined(__DOXYGEN__)
 
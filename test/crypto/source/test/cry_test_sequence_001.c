@@ -28,12 +28,20 @@
  * <h2>Description</h2>
  * AES ECB.
  *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_CRY_ENFORCE_FALLBACK == FALSE
+ * .
+ *
  * <h2>Test Cases</h2>
  * - @subpage cry_test_001_001
  * - @subpage cry_test_001_002
  * .
  */
 
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
+
 /****************************************************************************
  * Shared code.
  ****************************************************************************/
@@ -389,3 +397,5 @@ const testsequence_t cry_test_sequence_001 = {
   "AES ECB",
   cry_test_sequence_001_array
 };
+
+#endif /* HAL_CRY_ENFORCE_FALLBACK == FALSE */
@@ -28,12 +28,20 @@
  * <h2>Description</h2>
  * AES CFB.
  *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_CRY_ENFORCE_FALLBACK == FALSE
+ * .
+ *
  * <h2>Test Cases</h2>
  * - @subpage cry_test_002_001
  * - @subpage cry_test_002_002
  * .
  */
 
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
+
 /****************************************************************************
  * Shared code.
  ****************************************************************************/
@@ -389,3 +397,5 @@ const testsequence_t cry_test_sequence_002 = {
   "AES CFB",
   cry_test_sequence_002_array
 };
+
+#endif /* HAL_CRY_ENFORCE_FALLBACK == FALSE */
@@ -28,6 +28,12 @@
  * <h2>Description</h2>
  * (T)DES testing.
  *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_CRY_ENFORCE_FALLBACK == FALSE
+ * .
+ *
  * <h2>Test Cases</h2>
  * - @subpage cry_test_004_001
  * - @subpage cry_test_004_002
@@ -37,6 +43,8 @@
  * .
  */
 
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
+
 /****************************************************************************
  * Shared code.
  ****************************************************************************/
@@ -623,3 +631,5 @@ const testsequence_t cry_test_sequence_004 = {
   "(T)DES",
   cry_test_sequence_004_array
 };
+
+#endif /* HAL_CRY_ENFORCE_FALLBACK == FALSE */
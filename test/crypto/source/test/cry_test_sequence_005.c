@@ -28,11 +28,19 @@
  * <h2>Description</h2>
  * TRNG testing.
  *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_CRY_ENFORCE_FALLBACK == FALSE
+ * .
+ *
  * <h2>Test Cases</h2>
  * - @subpage cry_test_005_001
  * .
  */
 
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
+
 /****************************************************************************
  * Shared code.
  ****************************************************************************/
@@ -125,3 +133,5 @@ const testsequence_t cry_test_sequence_005 = {
   "TRNG",
   cry_test_sequence_005_array
 };
+
+#endif /* HAL_CRY_ENFORCE_FALLBACK == FALSE */
@@ -28,6 +28,12 @@
  * <h2>Description</h2>
  * SHA testing.
  *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_CRY_ENFORCE_FALLBACK == FALSE
+ * .
+ *
  * <h2>Test Cases</h2>
  * - @subpage cry_test_007_001
  * - @subpage cry_test_007_002
@@ -35,6 +41,8 @@
  * .
  */
 
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
+
 /****************************************************************************
  * Shared code.
  ****************************************************************************/
@@ -460,3 +468,5 @@ const testsequence_t cry_test_sequence_007 = {
   "SHA",
   cry_test_sequence_007_array
 };
+
+#endif /* HAL_CRY_ENFORCE_FALLBACK == FALSE */
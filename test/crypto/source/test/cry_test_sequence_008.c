@@ -28,12 +28,20 @@
  * <h2>Description</h2>
  * GCM testing.
  *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_CRY_ENFORCE_FALLBACK == FALSE
+ * .
+ *
  * <h2>Test Cases</h2>
  * - @subpage cry_test_008_001
  * - @subpage cry_test_008_002
  * .
  */
 
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
+
 /****************************************************************************
  * Shared code.
  ****************************************************************************/
@@ -355,3 +363,5 @@ const testsequence_t cry_test_sequence_008 = {
   "GCM",
   cry_test_sequence_008_array
 };
+
+#endif /* HAL_CRY_ENFORCE_FALLBACK == FALSE */
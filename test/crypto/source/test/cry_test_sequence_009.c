@@ -28,12 +28,20 @@
  * <h2>Description</h2>
  * HMAC testing.
  *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_CRY_ENFORCE_FALLBACK == FALSE
+ * .
+ *
  * <h2>Test Cases</h2>
  * - @subpage cry_test_009_001
  * - @subpage cry_test_009_002
  * .
  */
 
+#if (HAL_CRY_ENFORCE_FALLBACK == FALSE) || defined(__DOXYGEN__)
+
 /****************************************************************************
  * Shared code.
  ****************************************************************************/
@@ -277,3 +285,5 @@ const testsequence_t cry_test_sequence_009 = {
   "HMAC",
   cry_test_sequence_009_array
 };
+
+#endif /* HAL_CRY_ENFORCE_FALLBACK == FALSE */
@@ -0,0 +1,1087 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "cry_test_root.h"
+
+/**
+ * @file    cry_test_sequence_010.c
+ * @brief   Test Sequence 010 code.
+ *
+ * @page cry_test_sequence_010 [10] Software fall-back
+ *
+ * File: @ref cry_test_sequence_010.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the software fall-back implementations of the
+ * cryptographic driver against known answers and measures their
+ * throughput.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_CRY_ENFORCE_FALLBACK == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage cry_test_010_001
+ * - @subpage cry_test_010_002
+ * - @subpage cry_test_010_003
+ * - @subpage cry_test_010_004
+ * - @subpage cry_test_010_005
+ * - @subpage cry_test_010_006
+ * - @subpage cry_test_010_007
+ * - @subpage cry_test_010_008
+ * - @subpage cry_test_010_009
+ * - @subpage cry_test_010_010
+ * .
+ */
+
+#if (HAL_CRY_ENFORCE_FALLBACK == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#define BMK_SIZE                1024
+
+static CRYDriver cryd, cryd2;
+
+static const CRYConfig cry_config = {0};
+
+static uint8_t cry_buf1[BMK_SIZE], cry_buf2[BMK_SIZE];
+
+/* FIPS-197 appendix C.*/
+static const uint8_t fips_key[32] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B,
+  0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+  0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+};
+
+static const uint8_t fips_plain[16] = {
+  0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB,
+  0xCC, 0xDD, 0xEE, 0xFF
+};
+
+static const uint8_t fips_cipher[3][16] = {
+  {0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+   0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A},
+  {0xDD, 0xA9, 0x7C, 0xA4, 0x86, 0x4C, 0xDF, 0xE0,
+   0x6E, 0xAF, 0x70, 0xA0, 0xEC, 0x0D, 0x71, 0x91},
+  {0x8E, 0xA2, 0xB7, 0xCA, 0x51, 0x67, 0x45, 0xBF,
+   0xEA, 0xFC, 0x49, 0x90, 0x4B, 0x49, 0x60, 0x89}
+};
+
+/* SP 800-38A appendix F, AES-128.*/
+static const uint8_t sp_key[16] = {
+  0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88,
+  0x09, 0xCF, 0x4F, 0x3C
+};
+
+static const uint8_t sp_iv[16] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B,
+  0x0C, 0x0D, 0x0E, 0x0F
+};
+
+static const uint8_t sp_ctr[16] = {
+  0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFB,
+  0xFC, 0xFD, 0xFE, 0xFF
+};
+
+static const uint8_t sp_plain[64] = {
+  0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96, 0xE9, 0x3D, 0x7E, 0x11,
+  0x73, 0x93, 0x17, 0x2A, 0xAE, 0x2D, 0x8A, 0x57, 0x1E, 0x03, 0xAC, 0x9C,
+  0x9E, 0xB7, 0x6F, 0xAC, 0x45, 0xAF, 0x8E, 0x51, 0x30, 0xC8, 0x1C, 0x46,
+  0xA3, 0x5C, 0xE4, 0x11, 0xE5, 0xFB, 0xC1, 0x19, 0x1A, 0x0A, 0x52, 0xEF,
+  0xF6, 0x9F, 0x24, 0x45, 0xDF, 0x4F, 0x9B, 0x17, 0xAD, 0x2B, 0x41, 0x7B,
+  0xE6, 0x6C, 0x37, 0x10
+};
+
+static const uint8_t sp_ecb[64] = {
+  0x3A, 0xD7, 0x7B, 0xB4, 0x0D, 0x7A, 0x36, 0x60, 0xA8, 0x9E, 0xCA, 0xF3,
+  0x24, 0x66, 0xEF, 0x97, 0xF5, 0xD3, 0xD5, 0x85, 0x03, 0xB9, 0x69, 0x9D,
+  0xE7, 0x85, 0x89, 0x5A, 0x96, 0xFD, 0xBA, 0xAF, 0x43, 0xB1, 0xCD, 0x7F,
+  0x59, 0x8E, 0xCE, 0x23, 0x88, 0x1B, 0x00, 0xE3, 0xED, 0x03, 0x06, 0x88,
+  0x7B, 0x0C, 0x78, 0x5E, 0x27, 0xE8, 0xAD, 0x3F, 0x82, 0x23, 0x20, 0x71,
+  0x04, 0x72, 0x5D, 0xD4
+};
+
+static const uint8_t sp_cbc[64] = {
+  0x76, 0x49, 0xAB, 0xAC, 0x81, 0x19, 0xB2, 0x46, 0xCE, 0xE9, 0x8E, 0x9B,
+  0x12, 0xE9, 0x19, 0x7D, 0x50, 0x86, 0xCB, 0x9B, 0x50, 0x72, 0x19, 0xEE,
+  0x95, 0xDB, 0x11, 0x3A, 0x91, 0x76, 0x78, 0xB2, 0x73, 0xBE, 0xD6, 0xB8,
+  0xE3, 0xC1, 0x74, 0x3B, 0x71, 0x16, 0xE6, 0x9E, 0x22, 0x22, 0x95, 0x16,
+  0x3F, 0xF1, 0xCA, 0xA1, 0x68, 0x1F, 0xAC, 0x09, 0x12, 0x0E, 0xCA, 0x30,
+  0x75, 0x86, 0xE1, 0xA7
+};
+
+static const uint8_t sp_cfb[64] = {
+  0x3B, 0x3F, 0xD9, 0x2E, 0xB7, 0x2D, 0xAD, 0x20, 0x33, 0x34, 0x49, 0xF8,
+  0xE8, 0x3C, 0xFB, 0x4A, 0xC8, 0xA6, 0x45, 0x37, 0xA0, 0xB3, 0xA9, 0x3F,
+  0xCD, 0xE3, 0xCD, 0xAD, 0x9F, 0x1C, 0xE5, 0x8B, 0x26, 0x75, 0x1F, 0x67,
+  0xA3, 0xCB, 0xB1, 0x40, 0xB1, 0x80, 0x8C, 0xF1, 0x87, 0xA4, 0xF4, 0xDF,
+  0xC0, 0x4B, 0x05, 0x35, 0x7C, 0x5D, 0x1C, 0x0E, 0xEA, 0xC4, 0xC6, 0x6F,
+  0x9F, 0xF7, 0xF2, 0xE6
+};
+
+static const uint8_t sp_ctr_cipher[64] = {
+  0x87, 0x4D, 0x61, 0x91, 0xB6, 0x20, 0xE3, 0x26, 0x1B, 0xEF, 0x68, 0x64,
+  0x99, 0x0D, 0xB6, 0xCE, 0x98, 0x06, 0xF6, 0x6B, 0x79, 0x70, 0xFD, 0xFF,
+  0x86, 0x17, 0x18, 0x7B, 0xB9, 0xFF, 0xFD, 0xFF, 0x5A, 0xE4, 0xDF, 0x3E,
+  0xDB, 0xD5, 0xD3, 0x5E, 0x5B, 0x4F, 0x09, 0x02, 0x0D, 0xB0, 0x3E, 0xAB,
+  0x1E, 0x03, 0x1D, 0xDA, 0x2F, 0xBE, 0x03, 0xD1, 0x79, 0x21, 0x70, 0xA0,
+  0xF3, 0x00, 0x9C, 0xEE
+};
+
+/* GCM specification, test case 4.*/
+static const uint8_t gcm_key[16] = {
+  0xFE, 0xFF, 0xE9, 0x92, 0x86, 0x65, 0x73, 0x1C, 0x6D, 0x6A, 0x8F, 0x94,
+  0x67, 0x30, 0x83, 0x08
+};
+
+static const uint8_t gcm_iv[16] = {
+  0xCA, 0xFE, 0xBA, 0xBE, 0xFA, 0xCE, 0xDB, 0xAD, 0xDE, 0xCA, 0xF8, 0x88,
+  0x00, 0x00, 0x00, 0x01
+};
+
+static const uint8_t gcm_aad[20] = {
+  0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED, 0xFA, 0xCE,
+  0xDE, 0xAD, 0xBE, 0xEF, 0xAB, 0xAD, 0xDA, 0xD2
+};
+
+static const uint8_t gcm_plain[60] = {
+  0xD9, 0x31, 0x32, 0x25, 0xF8, 0x84, 0x06, 0xE5, 0xA5, 0x59, 0x09, 0xC5,
+  0xAF, 0xF5, 0x26, 0x9A, 0x86, 0xA7, 0xA9, 0x53, 0x15, 0x34, 0xF7, 0xDA,
+  0x2E, 0x4C, 0x30, 0x3D, 0x8A, 0x31, 0x8A, 0x72, 0x1C, 0x3C, 0x0C, 0x95,
+  0x95, 0x68, 0x09, 0x53, 0x2F, 0xCF, 0x0E, 0x24, 0x49, 0xA6, 0xB5, 0x25,
+  0xB1, 0x6A, 0xED, 0xF5, 0xAA, 0x0D, 0xE6, 0x57, 0xBA, 0x63, 0x7B, 0x39
+};
+
+static const uint8_t gcm_cipher[60] = {
+  0x42, 0x83, 0x1E, 0xC2, 0x21, 0x77, 0x74, 0x24, 0x4B, 0x72, 0x21, 0xB7,
+  0x84, 0xD0, 0xD4, 0x9C, 0xE3, 0xAA, 0x21, 0x2F, 0x2C, 0x02, 0xA4, 0xE0,
+  0x35, 0xC1, 0x7E, 0x23, 0x29, 0xAC, 0xA1, 0x2E, 0x21, 0xD5, 0x14, 0xB2,
+  0x54, 0x66, 0x93, 0x1C, 0x7D, 0x8F, 0x6A, 0x5A, 0xAC, 0x84, 0xAA, 0x05,
+  0x1B, 0xA3, 0x0B, 0x39, 0x6A, 0x0A, 0xAC, 0x97, 0x3D, 0x58, 0xE0, 0x91
+};
+
+static const uint8_t gcm_tag[16] = {
+  0x5B, 0xC9, 0x4F, 0xBC, 0x32, 0x21, 0xA5, 0xDB, 0x94, 0xFA, 0xE9, 0x5A,
+  0xE7, 0x12, 0x1A, 0x47
+};
+
+/* FIPS 180-2 two blocks message.*/
+static const char sha_msg[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+static const uint8_t sha1_digest[20] = {
+  0x84, 0x98, 0x3E, 0x44, 0x1C, 0x3B, 0xD2, 0x6E, 0xBA, 0xAE, 0x4A, 0xA1,
+  0xF9, 0x51, 0x29, 0xE5, 0xE5, 0x46, 0x70, 0xF1
+};
+
+static const uint8_t sha256_digest[32] = {
+  0x24, 0x8D, 0x6A, 0x61, 0xD2, 0x06, 0x38, 0xB8, 0xE5, 0xC0, 0x26, 0x93,
+  0x0C, 0x3E, 0x60, 0x39, 0xA3, 0x3C, 0xE4, 0x59, 0x64, 0xFF, 0x21, 0x67,
+  0xF6, 0xEC, 0xED, 0xD4, 0x19, 0xDB, 0x06, 0xC1
+};
+
+static const uint8_t sha512_digest[64] = {
+  0x20, 0x4A, 0x8F, 0xC6, 0xDD, 0xA8, 0x2F, 0x0A, 0x0C, 0xED, 0x7B, 0xEB,
+  0x8E, 0x08, 0xA4, 0x16, 0x57, 0xC1, 0x6E, 0xF4, 0x68, 0xB2, 0x28, 0xA8,
+  0x27, 0x9B, 0xE3, 0x31, 0xA7, 0x03, 0xC3, 0x35, 0x96, 0xFD, 0x15, 0xC1,
+  0x3B, 0x1B, 0x07, 0xF9, 0xAA, 0x1D, 0x3B, 0xEA, 0x57, 0x78, 0x9C, 0xA0,
+  0x31, 0xAD, 0x85, 0xC7, 0xA7, 0x1D, 0xD7, 0x03, 0x54, 0xEC, 0x63, 0x12,
+  0x38, 0xCA, 0x34, 0x45
+};
+
+/* RFC 4231 test case 6, the key is 131 bytes of 0xAA.*/
+static const char hmac_data[] = "Test Using Larger Than Block-Size Key - Hash Key First";
+
+static const uint8_t hmac256_digest[32] = {
+  0x60, 0xE4, 0x31, 0x59, 0x1E, 0xE0, 0xB6, 0x7F, 0x0D, 0x8A, 0x26, 0xAA,
+  0xCB, 0xF5, 0xB7, 0x7F, 0x8E, 0x0B, 0xC6, 0x21, 0x37, 0x28, 0xC5, 0x14,
+  0x05, 0x46, 0x04, 0x0F, 0x0E, 0xE3, 0x7F, 0x54
+};
+
+static const uint8_t hmac512_digest[64] = {
+  0x80, 0xB2, 0x42, 0x63, 0xC7, 0xC1, 0xA3, 0xEB, 0xB7, 0x14, 0x93, 0xC1,
+  0xDD, 0x7B, 0xE8, 0xB4, 0x9B, 0x46, 0xD1, 0xF4, 0x1B, 0x4A, 0xEE, 0xC1,
+  0x12, 0x1B, 0x01, 0x37, 0x83, 0xF8, 0xF3, 0x52, 0x6B, 0x56, 0xD0, 0x37,
+  0xE0, 0x5F, 0x25, 0x98, 0xBD, 0x0F, 0xD2, 0x21, 0x5D, 0x6A, 0x1E, 0x52,
+  0x95, 0xE6, 0x4F, 0x73, 0xF6, 0x3F, 0x0A, 0xEC, 0x8B, 0x91, 0x5A, 0x98,
+  0x5D, 0x78, 0x65, 0x98
+};
+
+static uint8_t hmac_key[131];
+
+static void bmk_aes_ecb(void) {
+
+  (void) cryEncryptAES_ECB(&cryd, 0, BMK_SIZE, cry_buf1, cry_buf2);
+}
+
+static void bmk_aes_cbc(void) {
+
+  (void) cryEncryptAES_CBC(&cryd, 0, BMK_SIZE, cry_buf1, cry_buf2, sp_iv);
+}
+
+static void bmk_aes_ctr(void) {
+
+  (void) cryEncryptAES_CTR(&cryd, 0, BMK_SIZE, cry_buf1, cry_buf2, sp_ctr);
+}
+
+static void bmk_aes_gcm(void) {
+  uint8_t tag[16];
+
+  (void) cryEncryptAES_GCM(&cryd, 0, 0, gcm_aad, BMK_SIZE, cry_buf1,
+                           cry_buf2, gcm_iv, sizeof tag, tag);
+}
+
+static void bmk_sha256(void) {
+  SHA256Context ctx;
+
+  (void) crySHA256Init(&cryd, &ctx);
+  (void) crySHA256Update(&cryd, &ctx, BMK_SIZE, cry_buf1);
+  (void) crySHA256Final(&cryd, &ctx, cry_buf2);
+}
+
+static void bmk_sha512(void) {
+  SHA512Context ctx;
+
+  (void) crySHA512Init(&cryd, &ctx);
+  (void) crySHA512Update(&cryd, &ctx, BMK_SIZE, cry_buf1);
+  (void) crySHA512Final(&cryd, &ctx, cry_buf2);
+}
+
+static void bmk_hmac256(void) {
+  HMACSHA256Context ctx;
+
+  (void) cryHMACSHA256Init(&cryd, &ctx);
+  (void) cryHMACSHA256Update(&cryd, &ctx, BMK_SIZE, cry_buf1);
+  (void) cryHMACSHA256Final(&cryd, &ctx, cry_buf2);
+}
+
+static void bmk_run(const char *name, void (*fn)(void)) {
+  systime_t start, end;
+  uint32_t n = 0;
+
+  start = osalOsGetSystemTimeX();
+  end = osalTimeAddX(start, TIME_MS2I(1000));
+  do {
+    fn();
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (osalTimeIsInRangeX(osalOsGetSystemTimeX(), start, end));
+
+  test_print("--- ");
+  test_print(name);
+  test_print(" : ");
+  test_printn(n * BMK_SIZE);
+  test_println(" bytes/S");
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page cry_test_010_001 [10.1] AES single block known answers
+ *
+ * <h2>Description</h2>
+ * The AES single block operations are tested against the FIPS-197 known
+ * answers for the three key sizes.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.1.1] Encrypting and decrypting the reference block with 128,
+ *   192 and 256 bits keys, the results must match the known answers.
+ * - [10.1.2] Invalid key sizes and key identifiers are rejected.
+ * .
+ */
+
+static void cry_test_010_001_setup(void) {
+  cryObjectInit(&cryd);
+  cryStart(&cryd, &cry_config);
+}
+
+static void cry_test_010_001_teardown(void) {
+  cryStop(&cryd);
+}
+
+static void cry_test_010_001_execute(void) {
+  uint8_t out[16], back[16];
+  unsigned i;
+  cryerror_t err;
+
+  /* [10.1.1] Encrypting and decrypting the reference block with 128,
+     192 and 256 bits keys, the results must match the known answers.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < 3; i++) {
+      err = cryLoadAESTransientKey(&cryd, 16U + (i * 8U), fips_key);
+      test_assert(err == CRY_NOERROR, "key not loaded");
+      err = cryEncryptAES(&cryd, 0, fips_plain, out);
+      test_assert(err == CRY_NOERROR, "encryption failed");
+      test_assert(memcmp(out, fips_cipher[i], 16) == 0, "ciphertext mismatch");
+      err = cryDecryptAES(&cryd, 0, out, back);
+      test_assert(err == CRY_NOERROR, "decryption failed");
+      test_assert(memcmp(back, fips_plain, 16) == 0, "plaintext mismatch");
+    }
+  }
+  test_end_step(1);
+
+  /* [10.1.2] Invalid key sizes and key identifiers are rejected.*/
+  test_set_step(2);
+  {
+    err = cryLoadAESTransientKey(&cryd, 20, fips_key);
+    test_assert(err == CRY_ERR_INV_KEY_SIZE, "invalid key size accepted");
+    err = cryEncryptAES(&cryd, 0, fips_plain, out);
+    test_assert(err == CRY_ERR_INV_KEY_ID, "no key loaded");
+    err = cryLoadAESTransientKey(&cryd, 16, fips_key);
+    test_assert(err == CRY_NOERROR, "key not loaded");
+    err = cryEncryptAES(&cryd, 1, fips_plain, out);
+    test_assert(err == CRY_ERR_INV_KEY_ID, "invalid key identifier accepted");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t cry_test_010_001 = {
+  "AES single block known answers",
+  cry_test_010_001_setup,
+  cry_test_010_001_teardown,
+  cry_test_010_001_execute
+};
+
+
+/**
+ * @page cry_test_010_002 [10.2] AES modes known answers
+ *
+ * <h2>Description</h2>
+ * The AES ECB, CBC, CFB and CTR modes are tested against the SP 800-38A
+ * known answers, decryption is performed in place.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.2.1] AES-ECB encryption and decryption.
+ * - [10.2.2] AES-CBC encryption and decryption.
+ * - [10.2.3] AES-CFB encryption and decryption, the last segment is
+ *   partial.
+ * - [10.2.4] AES-CTR encryption and decryption, the last block is
+ *   partial.
+ * .
+ */
+
+static void cry_test_010_002_setup(void) {
+  cryObjectInit(&cryd);
+  cryStart(&cryd, &cry_config);
+  (void) cryLoadAESTransientKey(&cryd, sizeof sp_key, sp_key);
+}
+
+static void cry_test_010_002_teardown(void) {
+  cryStop(&cryd);
+}
+
+static void cry_test_010_002_execute(void) {
+  cryerror_t err;
+
+  /* [10.2.1] AES-ECB encryption and decryption.*/
+  test_set_step(1);
+  {
+    err = cryEncryptAES_ECB(&cryd, 0, sizeof sp_plain, sp_plain, cry_buf1);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    test_assert(memcmp(cry_buf1, sp_ecb, sizeof sp_ecb) == 0, "ciphertext mismatch");
+    err = cryDecryptAES_ECB(&cryd, 0, sizeof sp_plain, cry_buf1, cry_buf1);
+    test_assert(err == CRY_NOERROR, "decryption failed");
+    test_assert(memcmp(cry_buf1, sp_plain, sizeof sp_plain) == 0, "plaintext mismatch");
+  }
+  test_end_step(1);
+
+  /* [10.2.2] AES-CBC encryption and decryption.*/
+  test_set_step(2);
+  {
+    err = cryEncryptAES_CBC(&cryd, 0, sizeof sp_plain, sp_plain, cry_buf1, sp_iv);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    test_assert(memcmp(cry_buf1, sp_cbc, sizeof sp_cbc) == 0, "ciphertext mismatch");
+    err = cryDecryptAES_CBC(&cryd, 0, sizeof sp_plain, cry_buf1, cry_buf1, sp_iv);
+    test_assert(err == CRY_NOERROR, "decryption failed");
+    test_assert(memcmp(cry_buf1, sp_plain, sizeof sp_plain) == 0, "plaintext mismatch");
+  }
+  test_end_step(2);
+
+  /* [10.2.3] AES-CFB encryption and decryption, the last segment is
+     partial.*/
+  test_set_step(3);
+  {
+    err = cryEncryptAES_CFB(&cryd, 0, sizeof sp_plain - 5U, sp_plain, cry_buf1, sp_iv);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    test_assert(memcmp(cry_buf1, sp_cfb, sizeof sp_cfb - 5U) == 0, "ciphertext mismatch");
+    err = cryDecryptAES_CFB(&cryd, 0, sizeof sp_plain - 5U, cry_buf1, cry_buf1, sp_iv);
+    test_assert(err == CRY_NOERROR, "decryption failed");
+    test_assert(memcmp(cry_buf1, sp_plain, sizeof sp_plain - 5U) == 0, "plaintext mismatch");
+  }
+  test_end_step(3);
+
+  /* [10.2.4] AES-CTR encryption and decryption, the last block is
+     partial.*/
+  test_set_step(4);
+  {
+    err = cryEncryptAES_CTR(&cryd, 0, sizeof sp_plain - 5U, sp_plain, cry_buf1, sp_ctr);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    test_assert(memcmp(cry_buf1, sp_ctr_cipher, sizeof sp_ctr_cipher - 5U) == 0, "ciphertext mismatch");
+    err = cryDecryptAES_CTR(&cryd, 0, sizeof sp_plain - 5U, cry_buf1, cry_buf1, sp_ctr);
+    test_assert(err == CRY_NOERROR, "decryption failed");
+    test_assert(memcmp(cry_buf1, sp_plain, sizeof sp_plain - 5U) == 0, "plaintext mismatch");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t cry_test_010_002 = {
+  "AES modes known answers",
+  cry_test_010_002_setup,
+  cry_test_010_002_teardown,
+  cry_test_010_002_execute
+};
+
+
+/**
+ * @page cry_test_010_003 [10.3] AES-GCM known answers
+ *
+ * <h2>Description</h2>
+ * AES-GCM is tested against a known answer of the GCM specification,
+ * the authentication data and the text are not multiple of the block
+ * size. A modified tag must be rejected.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.3.1] Encrypting, the ciphertext and the tag must match the
+ *   known answers.
+ * - [10.3.2] Decrypting with a truncated tag.
+ * - [10.3.3] Decrypting with a modified tag, the authentication must
+ *   fail.
+ * .
+ */
+
+static void cry_test_010_003_setup(void) {
+  cryObjectInit(&cryd);
+  cryStart(&cryd, &cry_config);
+  (void) cryLoadAESTransientKey(&cryd, sizeof gcm_key, gcm_key);
+}
+
+static void cry_test_010_003_teardown(void) {
+  cryStop(&cryd);
+}
+
+static void cry_test_010_003_execute(void) {
+  uint8_t tag[16];
+  cryerror_t err;
+
+  /* [10.3.1] Encrypting, the ciphertext and the tag must match the
+     known answers.*/
+  test_set_step(1);
+  {
+    err = cryEncryptAES_GCM(&cryd, 0, sizeof gcm_aad, gcm_aad,
+                            sizeof gcm_plain, gcm_plain, cry_buf1,
+                            gcm_iv, sizeof tag, tag);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    test_assert(memcmp(cry_buf1, gcm_cipher, sizeof gcm_cipher) == 0, "ciphertext mismatch");
+    test_assert(memcmp(tag, gcm_tag, sizeof gcm_tag) == 0, "tag mismatch");
+  }
+  test_end_step(1);
+
+  /* [10.3.2] Decrypting with a truncated tag.*/
+  test_set_step(2);
+  {
+    err = cryDecryptAES_GCM(&cryd, 0, sizeof gcm_aad, gcm_aad,
+                            sizeof gcm_cipher, gcm_cipher, cry_buf2,
+                            gcm_iv, 12, gcm_tag);
+    test_assert(err == CRY_NOERROR, "decryption failed");
+    test_assert(memcmp(cry_buf2, gcm_plain, sizeof gcm_plain) == 0, "plaintext mismatch");
+  }
+  test_end_step(2);
+
+  /* [10.3.3] Decrypting with a modified tag, the authentication must
+     fail.*/
+  test_set_step(3);
+  {
+    tag[15] ^= 1U;
+    err = cryDecryptAES_GCM(&cryd, 0, sizeof gcm_aad, gcm_aad,
+                            sizeof gcm_cipher, gcm_cipher, cry_buf2,
+                            gcm_iv, sizeof tag, tag);
+    test_assert(err == CRY_ERR_AUTH_FAILED, "authentication not failed");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t cry_test_010_003 = {
+  "AES-GCM known answers",
+  cry_test_010_003_setup,
+  cry_test_010_003_teardown,
+  cry_test_010_003_execute
+};
+
+
+/**
+ * @page cry_test_010_004 [10.4] SHA known answers
+ *
+ * <h2>Description</h2>
+ * SHA-1, SHA-256 and SHA-512 are tested against known answers, the
+ * message is fed in two parts in order to test the partial blocks
+ * handling.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.4.1] SHA-1 digest.
+ * - [10.4.2] SHA-256 digest.
+ * - [10.4.3] SHA-512 digest.
+ * .
+ */
+
+static void cry_test_010_004_setup(void) {
+  cryObjectInit(&cryd);
+  cryStart(&cryd, &cry_config);
+}
+
+static void cry_test_010_004_teardown(void) {
+  cryStop(&cryd);
+}
+
+static void cry_test_010_004_execute(void) {
+  SHA1Context sha1ctx;
+  SHA256Context sha256ctx;
+  SHA512Context sha512ctx;
+  uint8_t digest[64];
+
+  /* [10.4.1] SHA-1 digest.*/
+  test_set_step(1);
+  {
+    (void) crySHA1Init(&cryd, &sha1ctx);
+    (void) crySHA1Update(&cryd, &sha1ctx, 10, (const uint8_t *)sha_msg);
+    (void) crySHA1Update(&cryd, &sha1ctx, sizeof sha_msg - 11U, (const uint8_t *)sha_msg + 10);
+    (void) crySHA1Final(&cryd, &sha1ctx, digest);
+    test_assert(memcmp(digest, sha1_digest, sizeof sha1_digest) == 0, "digest mismatch");
+  }
+  test_end_step(1);
+
+  /* [10.4.2] SHA-256 digest.*/
+  test_set_step(2);
+  {
+    (void) crySHA256Init(&cryd, &sha256ctx);
+    (void) crySHA256Update(&cryd, &sha256ctx, 10, (const uint8_t *)sha_msg);
+    (void) crySHA256Update(&cryd, &sha256ctx, sizeof sha_msg - 11U, (const uint8_t *)sha_msg + 10);
+    (void) crySHA256Final(&cryd, &sha256ctx, digest);
+    test_assert(memcmp(digest, sha256_digest, sizeof sha256_digest) == 0, "digest mismatch");
+  }
+  test_end_step(2);
+
+  /* [10.4.3] SHA-512 digest.*/
+  test_set_step(3);
+  {
+    (void) crySHA512Init(&cryd, &sha512ctx);
+    (void) crySHA512Update(&cryd, &sha512ctx, 10, (const uint8_t *)sha_msg);
+    (void) crySHA512Update(&cryd, &sha512ctx, sizeof sha_msg - 11U, (const uint8_t *)sha_msg + 10);
+    (void) crySHA512Final(&cryd, &sha512ctx, digest);
+    test_assert(memcmp(digest, sha512_digest, sizeof sha512_digest) == 0, "digest mismatch");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t cry_test_010_004 = {
+  "SHA known answers",
+  cry_test_010_004_setup,
+  cry_test_010_004_teardown,
+  cry_test_010_004_execute
+};
+
+
+/**
+ * @page cry_test_010_005 [10.5] HMAC known answers
+ *
+ * <h2>Description</h2>
+ * HMAC-SHA256 and HMAC-SHA512 are tested against the RFC 4231 known
+ * answers, the key is longer than the hash block size.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.5.1] Loading the key.
+ * - [10.5.2] HMAC-SHA256 digest.
+ * - [10.5.3] HMAC-SHA512 digest.
+ * .
+ */
+
+static void cry_test_010_005_setup(void) {
+  cryObjectInit(&cryd);
+  cryStart(&cryd, &cry_config);
+  memset(hmac_key, 0xAA, sizeof hmac_key);
+}
+
+static void cry_test_010_005_teardown(void) {
+  cryStop(&cryd);
+}
+
+static void cry_test_010_005_execute(void) {
+  HMACSHA256Context hmac256ctx;
+  HMACSHA512Context hmac512ctx;
+  uint8_t digest[64];
+  cryerror_t err;
+
+  /* [10.5.1] Loading the key.*/
+  test_set_step(1);
+  {
+    err = cryLoadHMACTransientKey(&cryd, sizeof hmac_key, hmac_key);
+    test_assert(err == CRY_NOERROR, "key not loaded");
+  }
+  test_end_step(1);
+
+  /* [10.5.2] HMAC-SHA256 digest.*/
+  test_set_step(2);
+  {
+    (void) cryHMACSHA256Init(&cryd, &hmac256ctx);
+    (void) cryHMACSHA256Update(&cryd, &hmac256ctx, sizeof hmac_data - 1U, (const uint8_t *)hmac_data);
+    (void) cryHMACSHA256Final(&cryd, &hmac256ctx, digest);
+    test_assert(memcmp(digest, hmac256_digest, sizeof hmac256_digest) == 0, "digest mismatch");
+  }
+  test_end_step(2);
+
+  /* [10.5.3] HMAC-SHA512 digest.*/
+  test_set_step(3);
+  {
+    (void) cryHMACSHA512Init(&cryd, &hmac512ctx);
+    (void) cryHMACSHA512Update(&cryd, &hmac512ctx, sizeof hmac_data - 1U, (const uint8_t *)hmac_data);
+    (void) cryHMACSHA512Final(&cryd, &hmac512ctx, digest);
+    test_assert(memcmp(digest, hmac512_digest, sizeof hmac512_digest) == 0, "digest mismatch");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t cry_test_010_005 = {
+  "HMAC known answers",
+  cry_test_010_005_setup,
+  cry_test_010_005_teardown,
+  cry_test_010_005_execute
+};
+
+
+/**
+ * @page cry_test_010_006 [10.6] Throughput
+ *
+ * <h2>Description</h2>
+ * The throughput of the software implementations is measured on 1kB
+ * buffers, each operation is repeated for one second.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.6.1] AES-128 ECB, CBC, CTR and GCM encryption throughput.
+ * - [10.6.2] SHA-256, SHA-512 and HMAC-SHA256 throughput.
+ * .
+ */
+
+static void cry_test_010_006_setup(void) {
+  cryObjectInit(&cryd);
+  cryStart(&cryd, &cry_config);
+  (void) cryLoadAESTransientKey(&cryd, sizeof sp_key, sp_key);
+  (void) cryLoadHMACTransientKey(&cryd, sizeof sp_key, sp_key);
+  memset(cry_buf1, 0x55, sizeof cry_buf1);
+}
+
+static void cry_test_010_006_teardown(void) {
+  cryStop(&cryd);
+}
+
+static void cry_test_010_006_execute(void) {
+
+  /* [10.6.1] AES-128 ECB, CBC, CTR and GCM encryption throughput.*/
+  test_set_step(1);
+  {
+    bmk_run("AES-128 ECB", bmk_aes_ecb);
+    bmk_run("AES-128 CBC", bmk_aes_cbc);
+    bmk_run("AES-128 CTR", bmk_aes_ctr);
+    bmk_run("AES-128 GCM", bmk_aes_gcm);
+  }
+  test_end_step(1);
+
+  /* [10.6.2] SHA-256, SHA-512 and HMAC-SHA256 throughput.*/
+  test_set_step(2);
+  {
+    bmk_run("SHA-256", bmk_sha256);
+    bmk_run("SHA-512", bmk_sha512);
+    bmk_run("HMAC-SHA256", bmk_hmac256);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t cry_test_010_006 = {
+  "Throughput",
+  cry_test_010_006_setup,
+  cry_test_010_006_teardown,
+  cry_test_010_006_execute
+};
+
+
+/**
+ * @page cry_test_010_007 [10.7] AES-CTR streaming and scatter-gather
+ *
+ * <h2>Description</h2>
+ * The SP 800-38A message is processed in parts of irregular size using
+ * the streaming and the scatter-gather functions, the result must match
+ * the known answer.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.7.1] Streaming encryption in parts of 1, 20 and 43 bytes.
+ * - [10.7.2] In place scatter-gather decryption of three buffers.
+ * .
+ */
+
+static void cry_test_010_007_setup(void) {
+  cryObjectInit(&cryd);
+  cryStart(&cryd, &cry_config);
+  (void) cryLoadAESTransientKey(&cryd, sizeof sp_key, sp_key);
+}
+
+static void cry_test_010_007_teardown(void) {
+  cryStop(&cryd);
+}
+
+static void cry_test_010_007_execute(void) {
+  AESCTRContext ctx;
+  cryiovec_t iov[3];
+  cryerror_t err;
+
+  /* [10.7.1] Streaming encryption in parts of 1, 20 and 43 bytes.*/
+  test_set_step(1);
+  {
+    err = cryAES_CTRInit(&cryd, &ctx, 0, sp_ctr);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = cryAES_CTRUpdate(&cryd, &ctx, 1, &sp_plain[0], &cry_buf1[0]);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = cryAES_CTRUpdate(&cryd, &ctx, 20, &sp_plain[1], &cry_buf1[1]);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = cryAES_CTRUpdate(&cryd, &ctx, 43, &sp_plain[21], &cry_buf1[21]);
+    test_assert(err == CRY_NOERROR, "update failed");
+    test_assert(memcmp(cry_buf1, sp_ctr_cipher, sizeof sp_ctr_cipher) == 0, "ciphertext mismatch");
+  }
+  test_end_step(1);
+
+  /* [10.7.2] In place scatter-gather decryption of three buffers.*/
+  test_set_step(2);
+  {
+    iov[0].base = &cry_buf1[0];
+    iov[0].size = 5;
+    iov[1].base = &cry_buf1[5];
+    iov[1].size = 32;
+    iov[2].base = &cry_buf1[37];
+    iov[2].size = 27;
+    err = cryAES_CTRV(&cryd, 0, 3, iov, sp_ctr);
+    test_assert(err == CRY_NOERROR, "decryption failed");
+    test_assert(memcmp(cry_buf1, sp_plain, sizeof sp_plain) == 0, "plaintext mismatch");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t cry_test_010_007 = {
+  "AES-CTR streaming and scatter-gather",
+  cry_test_010_007_setup,
+  cry_test_010_007_teardown,
+  cry_test_010_007_execute
+};
+
+/**
+ * @page cry_test_010_008 [10.8] AES-GCM streaming
+ *
+ * <h2>Description</h2>
+ * The GCM known answer is reproduced feeding the authenticated data and
+ * the text in parts of irregular size. A modified tag must be rejected.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.8.1] Encrypting, the authenticated data in parts of 7 and 13
+ *   bytes, the text in parts of 1, 16 and 43 bytes.
+ * - [10.8.2] Decrypting in place in parts of 33 and 27 bytes.
+ * - [10.8.3] Decrypting with a modified tag, the authentication must
+ *   fail.
+ * .
+ */
+
+static void cry_test_010_008_setup(void) {
+  cryObjectInit(&cryd);
+  cryStart(&cryd, &cry_config);
+  (void) cryLoadAESTransientKey(&cryd, sizeof gcm_key, gcm_key);
+}
+
+static void cry_test_010_008_teardown(void) {
+  cryStop(&cryd);
+}
+
+static void cry_test_010_008_execute(void) {
+  AESGCMContext ctx;
+  uint8_t tag[16];
+  cryerror_t err;
+
+  /* [10.8.1] Encrypting, the authenticated data in parts of 7 and 13
+     bytes, the text in parts of 1, 16 and 43 bytes.*/
+  test_set_step(1);
+  {
+    err = cryAES_GCMInit(&cryd, &ctx, 0, gcm_iv);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    (void) cryAES_GCMUpdateAuth(&cryd, &ctx, 7, &gcm_aad[0]);
+    (void) cryAES_GCMUpdateAuth(&cryd, &ctx, 13, &gcm_aad[7]);
+    (void) cryEncryptAES_GCMUpdate(&cryd, &ctx, 1, &gcm_plain[0], &cry_buf1[0]);
+    (void) cryEncryptAES_GCMUpdate(&cryd, &ctx, 16, &gcm_plain[1], &cry_buf1[1]);
+    (void) cryEncryptAES_GCMUpdate(&cryd, &ctx, 43, &gcm_plain[17], &cry_buf1[17]);
+    err = cryEncryptAES_GCMFinal(&cryd, &ctx, sizeof tag, tag);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(cry_buf1, gcm_cipher, sizeof gcm_cipher) == 0, "ciphertext mismatch");
+    test_assert(memcmp(tag, gcm_tag, sizeof gcm_tag) == 0, "tag mismatch");
+  }
+  test_end_step(1);
+
+  /* [10.8.2] Decrypting in place in parts of 33 and 27 bytes.*/
+  test_set_step(2);
+  {
+    (void) cryAES_GCMInit(&cryd, &ctx, 0, gcm_iv);
+    (void) cryAES_GCMUpdateAuth(&cryd, &ctx, sizeof gcm_aad, gcm_aad);
+    (void) cryDecryptAES_GCMUpdate(&cryd, &ctx, 33, &cry_buf1[0], &cry_buf1[0]);
+    (void) cryDecryptAES_GCMUpdate(&cryd, &ctx, 27, &cry_buf1[33], &cry_buf1[33]);
+    err = cryDecryptAES_GCMFinal(&cryd, &ctx, sizeof tag, tag);
+    test_assert(err == CRY_NOERROR, "authentication failed");
+    test_assert(memcmp(cry_buf1, gcm_plain, sizeof gcm_plain) == 0, "plaintext mismatch");
+  }
+  test_end_step(2);
+
+  /* [10.8.3] Decrypting with a modified tag, the authentication must
+     fail.*/
+  test_set_step(3);
+  {
+    tag[0] ^= 0x80U;
+    (void) cryAES_GCMInit(&cryd, &ctx, 0, gcm_iv);
+    (void) cryAES_GCMUpdateAuth(&cryd, &ctx, sizeof gcm_aad, gcm_aad);
+    (void) cryDecryptAES_GCMUpdate(&cryd, &ctx, sizeof gcm_cipher, gcm_cipher, cry_buf2);
+    err = cryDecryptAES_GCMFinal(&cryd, &ctx, sizeof tag, tag);
+    test_assert(err == CRY_ERR_AUTH_FAILED, "authentication not failed");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t cry_test_010_008 = {
+  "AES-GCM streaming",
+  cry_test_010_008_setup,
+  cry_test_010_008_teardown,
+  cry_test_010_008_execute
+};
+
+/**
+ * @page cry_test_010_009 [10.9] AES-GCM scatter-gather
+ *
+ * <h2>Description</h2>
+ * A frame made of a header and a payload in separate buffers is
+ * encrypted and decrypted in place, the header is authenticated. A
+ * modified tag must be rejected and the text cleared.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.9.1] Preparing the descriptors, the authenticated data is split
+ *   in two buffers, the text is split between two buffers.
+ * - [10.9.2] Encrypting, the ciphertext and the tag must match the
+ *   known answers.
+ * - [10.9.3] Decrypting, the plaintext must match.
+ * - [10.9.4] Decrypting with a modified tag, the authentication must
+ *   fail and the text must be cleared.
+ * .
+ */
+
+static void cry_test_010_009_setup(void) {
+  cryObjectInit(&cryd);
+  cryStart(&cryd, &cry_config);
+  (void) cryLoadAESTransientKey(&cryd, sizeof gcm_key, gcm_key);
+}
+
+static void cry_test_010_009_teardown(void) {
+  cryStop(&cryd);
+}
+
+static void cry_test_010_009_execute(void) {
+  cryiovec_t aiov[2], tiov[2];
+  uint8_t tag[16];
+  cryerror_t err;
+  unsigned i;
+
+  /* [10.9.1] Preparing the descriptors, the authenticated data is split
+     in two buffers, the text is split between two buffers.*/
+  test_set_step(1);
+  {
+    memcpy(cry_buf1, gcm_plain, 24);
+    memcpy(cry_buf2, &gcm_plain[24], sizeof gcm_plain - 24U);
+    aiov[0].base = (uint8_t *)&gcm_aad[0];
+    aiov[0].size = 4;
+    aiov[1].base = (uint8_t *)&gcm_aad[4];
+    aiov[1].size = sizeof gcm_aad - 4U;
+    tiov[0].base = cry_buf1;
+    tiov[0].size = 24;
+    tiov[1].base = cry_buf2;
+    tiov[1].size = sizeof gcm_plain - 24U;
+  }
+  test_end_step(1);
+
+  /* [10.9.2] Encrypting, the ciphertext and the tag must match the
+     known answers.*/
+  test_set_step(2);
+  {
+    err = cryEncryptAES_GCMV(&cryd, 0, 2, aiov, 2, tiov, gcm_iv, sizeof tag, tag);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    test_assert(memcmp(cry_buf1, gcm_cipher, 24) == 0, "ciphertext mismatch");
+    test_assert(memcmp(cry_buf2, &gcm_cipher[24], sizeof gcm_cipher - 24U) == 0, "ciphertext mismatch");
+    test_assert(memcmp(tag, gcm_tag, sizeof gcm_tag) == 0, "tag mismatch");
+  }
+  test_end_step(2);
+
+  /* [10.9.3] Decrypting, the plaintext must match.*/
+  test_set_step(3);
+  {
+    err = cryDecryptAES_GCMV(&cryd, 0, 2, aiov, 2, tiov, gcm_iv, sizeof tag, tag);
+    test_assert(err == CRY_NOERROR, "authentication failed");
+    test_assert(memcmp(cry_buf1, gcm_plain, 24) == 0, "plaintext mismatch");
+    test_assert(memcmp(cry_buf2, &gcm_plain[24], sizeof gcm_plain - 24U) == 0, "plaintext mismatch");
+  }
+  test_end_step(3);
+
+  /* [10.9.4] Decrypting with a modified tag, the authentication must
+     fail and the text must be cleared.*/
+  test_set_step(4);
+  {
+    memcpy(cry_buf1, gcm_cipher, 24);
+    memcpy(cry_buf2, &gcm_cipher[24], sizeof gcm_cipher - 24U);
+    tag[7] ^= 0x01U;
+    err = cryDecryptAES_GCMV(&cryd, 0, 2, aiov, 2, tiov, gcm_iv, sizeof tag, tag);
+    test_assert(err == CRY_ERR_AUTH_FAILED, "authentication not failed");
+    for (i = 0; i < sizeof gcm_cipher - 24U; i++) {
+      test_assert(cry_buf2[i] == 0U, "text not cleared");
+    }
+  }
+  test_end_step(4);
+}
+
+static const testcase_t cry_test_010_009 = {
+  "AES-GCM scatter-gather",
+  cry_test_010_009_setup,
+  cry_test_010_009_teardown,
+  cry_test_010_009_execute
+};
+
+/**
+ * @page cry_test_010_010 [10.10] Transient keys isolation
+ *
+ * <h2>Description</h2>
+ * The fall-back transient keys are stored in each driver instance, keys
+ * loaded in a driver are not visible to another driver and are cleared
+ * when the driver is stopped.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.10.1] Loading the AES and HMAC keys in the first driver, the
+ *   second driver must not be able to use them.
+ * - [10.10.2] Using the keys in the first driver.
+ * - [10.10.3] Restarting the first driver, the keys must have been
+ *   cleared.
+ * .
+ */
+
+static void cry_test_010_010_setup(void) {
+  cryObjectInit(&cryd);
+  cryObjectInit(&cryd2);
+  cryStart(&cryd, &cry_config);
+  cryStart(&cryd2, &cry_config);
+  memset(hmac_key, 0xAA, sizeof hmac_key);
+}
+
+static void cry_test_010_010_teardown(void) {
+  cryStop(&cryd2);
+  cryStop(&cryd);
+}
+
+static void cry_test_010_010_execute(void) {
+  HMACSHA256Context hmac256ctx;
+  uint8_t out[16];
+  cryerror_t err;
+
+  /* [10.10.1] Loading the AES and HMAC keys in the first driver, the
+     second driver must not be able to use them.*/
+  test_set_step(1);
+  {
+    err = cryLoadAESTransientKey(&cryd, 16, fips_key);
+    test_assert(err == CRY_NOERROR, "key not loaded");
+    err = cryLoadHMACTransientKey(&cryd, sizeof hmac_key, hmac_key);
+    test_assert(err == CRY_NOERROR, "key not loaded");
+    err = cryEncryptAES(&cryd2, 0, fips_plain, out);
+    test_assert(err == CRY_ERR_INV_KEY_ID, "AES key shared");
+    err = cryHMACSHA256Init(&cryd2, &hmac256ctx);
+    test_assert(err == CRY_ERR_INV_KEY_ID, "HMAC key shared");
+  }
+  test_end_step(1);
+
+  /* [10.10.2] Using the keys in the first driver.*/
+  test_set_step(2);
+  {
+    err = cryEncryptAES(&cryd, 0, fips_plain, out);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    test_assert(memcmp(out, fips_cipher[0], 16) == 0, "ciphertext mismatch");
+    err = cryHMACSHA256Init(&cryd, &hmac256ctx);
+    test_assert(err == CRY_NOERROR, "HMAC init failed");
+  }
+  test_end_step(2);
+
+  /* [10.10.3] Restarting the first driver, the keys must have been
+     cleared.*/
+  test_set_step(3);
+  {
+    cryStop(&cryd);
+    cryStart(&cryd, &cry_config);
+    err = cryEncryptAES(&cryd, 0, fips_plain, out);
+    test_assert(err == CRY_ERR_INV_KEY_ID, "AES key not cleared");
+    err = cryHMACSHA256Init(&cryd, &hmac256ctx);
+    test_assert(err == CRY_ERR_INV_KEY_ID, "HMAC key not cleared");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t cry_test_010_010 = {
+  "Transient keys isolation",
+  cry_test_010_010_setup,
+  cry_test_010_010_teardown,
+  cry_test_010_010_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const cry_test_sequence_010_array[] = {
+  &cry_test_010_001,
+  &cry_test_010_002,
+  &cry_test_010_003,
+  &cry_test_010_004,
+  &cry_test_010_005,
+  &cry_test_010_006,
+  &cry_test_010_007,
+  &cry_test_010_008,
+  &cry_test_010_009,
+  &cry_test_010_010,
+  NULL
+};
+
+/**
+ * @brief   Software fall-back.
+ */
+const testsequence_t cry_test_sequence_010 = {
+  "Software fall-back",
+  cry_test_sequence_010_array
+};
+
+#endif /* HAL_CRY_ENFORCE_FALLBACK == TRUE */
@@ -37,6 +37,10 @@
  * - @subpage mfs_test_001_005
  * - @subpage mfs_test_001_006
  * - @subpage mfs_test_001_007
+ * - @subpage mfs_test_001_008
+ * - @subpage mfs_test_001_009
+ * - @subpage mfs_test_001_010
+ * - @subpage mfs_test_001_011
  * .
  */
 
@@ -47,6 +51,59 @@
 #include <string.h>
 #include "hal_mfs.h"
 
+/* Exported by the MFS driver.*/
+uint16_t crc16(uint16_t crc, const uint8_t *data, size_t n);
+
+static flash_offset_t bank_get_offset(mfs_bank_t bank) {
+
+  return flashGetSectorOffset(mfscfg1.flashp,
+                              bank == MFS_BANK_0 ? mfscfg1.bank0_start :
+                                                   mfscfg1.bank1_start);
+}
+
+static flash_error_t bank_write_raw_header(mfs_bank_t bank,
+                                           uint32_t magic2,
+                                           uint32_t counter) {
+  mfs_bank_header_t bhdr;
+
+  bhdr.fields.magic1    = MFS_BANK_MAGIC_1;
+  bhdr.fields.magic2    = magic2;
+  bhdr.fields.counter   = counter;
+  bhdr.fields.reserved1 = (uint16_t)mfscfg1.erased;
+  bhdr.fields.crc       = crc16(0xFFFFU, bhdr.hdr8,
+                                sizeof (mfs_bank_header_t) -
+                                sizeof (uint16_t));
+
+  return flashProgram(mfscfg1.flashp, bank_get_offset(bank),
+                      sizeof (mfs_bank_header_t), bhdr.hdr8);
+}
+
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+static flash_error_t bank_write_raw_record(mfs_bank_t bank,
+                                           flash_offset_t offset,
+                                           mfs_id_t id,
+                                           size_t n,
+                                           const uint8_t *buffer) {
+  mfs_data_header_t dhdr;
+  flash_error_t ferr;
+
+  memset(dhdr.hdr8, 0xFF, sizeof dhdr);
+  dhdr.fields.magic1 = MFS_HEADER_MAGIC_1;
+  dhdr.fields.magic2 = MFS_HEADER_MAGIC_2;
+  dhdr.fields.id     = id;
+  dhdr.fields.size   = (uint32_t)n;
+  dhdr.fields.crc    = crc16(0xFFFFU, buffer, n);
+
+  offset += bank_get_offset(bank);
+  ferr = flashProgram(mfscfg1.flashp, offset + sizeof (mfs_data_header_t),
+                      n, buffer);
+  if (ferr != FLASH_NO_ERROR)
+    return ferr;
+  return flashProgram(mfscfg1.flashp, offset,
+                      sizeof (mfs_data_header_t), dhdr.hdr8);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -698,6 +755,7 @@ static const testcase_t mfs_test_001_006 = {
   mfs_test_001_006_execute
 };
 
+#if (MFS_CFG_USE_CHECKPOINTS == FALSE) || defined(__DOXYGEN__)
 /**
  * @page mfs_test_001_007 [1.7] Testing garbage collection by erasing
  *
@@ -705,6 +763,12 @@ static const testcase_t mfs_test_001_006 = {
  * The garbage collection procedure is triggered by an erase operation
  * and the state of both banks is checked.
  *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_USE_CHECKPOINTS == FALSE
+ * .
+ *
  * <h2>Test Steps</h2>
  * - [1.7.1] Filling up the storage by writing records with increasing
  *   IDs, MFS_NO_ERROR is expected.
@@ -804,6 +868,507 @@ static const testcase_t mfs_test_001_007 = {
   mfs_test_001_007_teardown,
   mfs_test_001_007_execute
 };
+#endif /* MFS_CFG_USE_CHECKPOINTS == FALSE */
+
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_001_008 [1.8] Mounting from a checkpoint
+ *
+ * <h2>Description</h2>
+ * Records are written, the storage is mounted again and the records
+ * index is loaded from the most recent checkpoint, records written
+ * after the checkpoint are recovered by scanning.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_USE_CHECKPOINTS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [1.8.1] Writing records until a checkpoint is written, a slot must
+ *   have been used.
+ * - [1.8.2] Writing and erasing records after the checkpoint.
+ * - [1.8.3] Mounting again, the state must be the same and the records
+ *   must be readable.
+ * - [1.8.4] The checkpoint slot is damaged, on mount the records index
+ *   is rebuilt by scanning all records.
+ * - [1.8.5] A garbage collection writes a checkpoint in the new bank.
+ * .
+ */
+
+static void mfs_test_001_008_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_008_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_008_execute(void) {
+  flash_offset_t next_offset;
+  flash_offset_t used_space;
+
+  /* [1.8.1] Writing records until a checkpoint is written, a slot must
+     have been used.*/
+  test_set_step(1);
+  {
+    mfs_id_t id;
+
+    for (id = 1; id <= MFS_CFG_CHECKPOINT_INTERVAL; id++) {
+      mfs_error_t err;
+
+      err = mfsWriteRecord(&mfs1, id, sizeof mfs_pattern16, mfs_pattern16);
+      test_assert(err == MFS_NO_ERROR, "error creating the record");
+    }
+    test_assert(mfs1.cp_slot == 1U, "checkpoint not written");
+    test_assert(mfs1.cp_pending == 0U, "pending operations");
+  }
+  test_end_step(1);
+
+  /* [1.8.2] Writing and erasing records after the checkpoint.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern32, mfs_pattern32);
+    test_assert(err == MFS_NO_ERROR, "error updating the record");
+    err = mfsEraseRecord(&mfs1, 2);
+    test_assert(err == MFS_NO_ERROR, "error erasing the record");
+    next_offset = mfs1.next_offset;
+    used_space  = mfs1.used_space;
+  }
+  test_end_step(2);
+
+  /* [1.8.3] Mounting again, the state must be the same and the records
+     must be readable.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+    mfs_id_t id;
+    size_t size;
+
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "mount failed");
+    test_assert(mfs1.cp_slot == 1U, "wrong slot");
+    test_assert(mfs1.cp_pending == 2U, "wrong pending operations");
+    test_assert(mfs1.next_offset == next_offset, "wrong next offset");
+    test_assert(mfs1.used_space == used_space, "wrong used space");
+
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof mfs_pattern32, "unexpected record length");
+    test_assert(memcmp(mfs_pattern32, mfs_buffer, size) == 0,
+                "wrong record content");
+
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 2, &size, mfs_buffer);
+    test_assert(err == MFS_ERR_NOT_FOUND, "record not erased");
+
+    for (id = 3; id <= MFS_CFG_CHECKPOINT_INTERVAL; id++) {
+      size = sizeof mfs_buffer;
+      err = mfsReadRecord(&mfs1, id, &size, mfs_buffer);
+      test_assert(err == MFS_NO_ERROR, "record not found");
+      test_assert(size == sizeof mfs_pattern16, "unexpected record length");
+      test_assert(memcmp(mfs_pattern16, mfs_buffer, size) == 0,
+                  "wrong record content");
+    }
+  }
+  test_end_step(3);
+
+  /* [1.8.4] The checkpoint slot is damaged, on mount the records index
+     is rebuilt by scanning all records.*/
+  test_set_step(4);
+  {
+    static const uint8_t zero[sizeof (mfs_checkpoint_slot_t)] = {0};
+    mfs_error_t err;
+    flash_error_t ferr;
+    flash_sector_t sector;
+    size_t size;
+
+    sector = mfs1.current_bank == MFS_BANK_0 ? mfscfg1.bank0_start :
+                                               mfscfg1.bank1_start;
+    ferr = flashProgram(mfscfg1.flashp,
+                        flashGetSectorOffset(mfscfg1.flashp, sector) +
+                        MFS_ALIGN_NEXT(sizeof (mfs_bank_header_t)),
+                        sizeof zero, zero);
+    test_assert(ferr == FLASH_NO_ERROR, "slot program failed");
+
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "mount failed");
+    test_assert(mfs1.cp_slot == 1U, "wrong slot");
+    test_assert(mfs1.cp_pending == MFS_CFG_CHECKPOINT_INTERVAL + 2U,
+                "wrong pending operations");
+    test_assert(mfs1.next_offset == next_offset, "wrong next offset");
+    test_assert(mfs1.used_space == used_space, "wrong used space");
+
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(memcmp(mfs_pattern32, mfs_buffer, size) == 0,
+                "wrong record content");
+  }
+  test_end_step(4);
+
+  /* [1.8.5] A garbage collection writes a checkpoint in the new bank.*/
+  test_set_step(5);
+  {
+    mfs_error_t err;
+
+    err = mfsPerformGarbageCollection(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "garbage collection failed");
+    test_assert(mfs1.cp_slot == 1U, "checkpoint not written");
+    next_offset = mfs1.next_offset;
+    used_space  = mfs1.used_space;
+
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "mount failed");
+    test_assert(mfs1.cp_pending == 0U, "pending operations");
+    test_assert(mfs1.next_offset == next_offset, "wrong next offset");
+    test_assert(mfs1.used_space == used_space, "wrong used space");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t mfs_test_001_008 = {
+  "Mounting from a checkpoint",
+  mfs_test_001_008_setup,
+  mfs_test_001_008_teardown,
+  mfs_test_001_008_execute
+};
+#endif /* MFS_CFG_USE_CHECKPOINTS == TRUE */
+
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_001_009 [1.9] Sparse 32 bits keys
+ *
+ * <h2>Description</h2>
+ * Records are written using sparse 32 bits identifiers in random order
+ * until the records index is full, the index must be kept sorted and
+ * the records must be found again after mounting the storage.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_USE_SORTED_INDEX == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [1.9.1] Writing MFS_CFG_MAX_RECORDS records with scrambled
+ *   identifiers, MFS_NO_ERROR is expected and the index must be sorted.
+ * - [1.9.2] The index is full, creating a new record must fail with
+ *   MFS_ERR_OUT_OF_MEM, updating an existing record must succeed.
+ * - [1.9.3] Erasing a record, the new record can then be created.
+ * - [1.9.4] Mounting again, all records must be found.
+ * .
+ */
+
+static void mfs_test_001_009_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_001_009_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_009_execute(void) {
+
+  /* [1.9.1] Writing MFS_CFG_MAX_RECORDS records with scrambled
+     identifiers, MFS_NO_ERROR is expected and the index must be sorted.*/
+  test_set_step(1);
+  {
+    uint32_t i;
+
+    for (i = 1U; i <= MFS_CFG_MAX_RECORDS; i++) {
+      mfs_error_t err;
+
+      err = mfsWriteRecord(&mfs1, (mfs_id_t)(0x9E3779B1U * i),
+                           sizeof mfs_pattern10, mfs_pattern10);
+      test_assert(err == MFS_NO_ERROR, "error creating the record");
+    }
+    test_assert(mfs1.descriptors_num == MFS_CFG_MAX_RECORDS,
+                "wrong number of records");
+    for (i = 1U; i < MFS_CFG_MAX_RECORDS; i++) {
+      test_assert(mfs1.descriptors[i - 1U].id < mfs1.descriptors[i].id,
+                  "index not sorted");
+    }
+  }
+  test_end_step(1);
+
+  /* [1.9.2] The index is full, creating a new record must fail with
+     MFS_ERR_OUT_OF_MEM, updating an existing record must succeed.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+    size_t size;
+
+    err = mfsWriteRecord(&mfs1, 1U, sizeof mfs_pattern10, mfs_pattern10);
+    test_assert(err == MFS_ERR_OUT_OF_MEM, "record created");
+
+    err = mfsWriteRecord(&mfs1, (mfs_id_t)(0x9E3779B1U * 2U),
+                         sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(err == MFS_NO_ERROR, "error updating the record");
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, (mfs_id_t)(0x9E3779B1U * 2U), &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof mfs_pattern16, "unexpected record length");
+    test_assert(memcmp(mfs_pattern16, mfs_buffer, size) == 0,
+                "wrong record content");
+  }
+  test_end_step(2);
+
+  /* [1.9.3] Erasing a record, the new record can then be created.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+
+    err = mfsEraseRecord(&mfs1, (mfs_id_t)0x9E3779B1U);
+    test_assert(err == MFS_NO_ERROR, "error erasing the record");
+    err = mfsWriteRecord(&mfs1, 1U, sizeof mfs_pattern10, mfs_pattern10);
+    test_assert(err == MFS_NO_ERROR, "error creating the record");
+    test_assert(mfs1.descriptors[0].id == 1U, "index not sorted");
+  }
+  test_end_step(3);
+
+  /* [1.9.4] Mounting again, all records must be found.*/
+  test_set_step(4);
+  {
+    mfs_error_t err;
+    uint32_t i;
+    size_t size;
+
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "mount failed");
+    test_assert(mfs1.descriptors_num == MFS_CFG_MAX_RECORDS,
+                "wrong number of records");
+
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, (mfs_id_t)0x9E3779B1U, &size, mfs_buffer);
+    test_assert(err == MFS_ERR_NOT_FOUND, "record not erased");
+
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1U, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof mfs_pattern10, "unexpected record length");
+
+    for (i = 3U; i <= MFS_CFG_MAX_RECORDS; i++) {
+      size = sizeof mfs_buffer;
+      err = mfsReadRecord(&mfs1, (mfs_id_t)(0x9E3779B1U * i), &size, mfs_buffer);
+      test_assert(err == MFS_NO_ERROR, "record not found");
+      test_assert(size == sizeof mfs_pattern10, "unexpected record length");
+      test_assert(memcmp(mfs_pattern10, mfs_buffer, size) == 0,
+                  "wrong record content");
+    }
+  }
+  test_end_step(4);
+}
+
+static const testcase_t mfs_test_001_009 = {
+  "Sparse 32 bits keys",
+  mfs_test_001_009_setup,
+  mfs_test_001_009_teardown,
+  mfs_test_001_009_execute
+};
+#endif /* MFS_CFG_USE_SORTED_INDEX == TRUE */
+
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_001_010 [1.10] Converting banks written without checkpoints
+ *
+ * <h2>Description</h2>
+ * A bank written with checkpoints disabled is mounted with checkpoints
+ * enabled, the bank is converted by a garbage collection and the
+ * records are preserved.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_USE_CHECKPOINTS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [1.10.1] Writing a bank without checkpoints area using low level
+ *   functions.
+ * - [1.10.2] Mounting the bank, MFS_WARN_GC is expected, the record
+ *   must be readable and a checkpoint must have been written.
+ * - [1.10.3] Mounting again, MFS_NO_ERROR is expected and the record
+ *   must be readable.
+ * .
+ */
+
+static void mfs_test_001_010_setup(void) {
+  mfsObjectInit(&mfs1);
+}
+
+static void mfs_test_001_010_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_010_execute(void) {
+
+  /* [1.10.1] Writing a bank without checkpoints area using low level
+     functions.*/
+  test_set_step(1);
+  {
+    flash_error_t ferr;
+
+    ferr = bank_erase(MFS_BANK_0);
+    test_assert(ferr == FLASH_NO_ERROR, "Bank 0 erase failure");
+    ferr = bank_erase(MFS_BANK_1);
+    test_assert(ferr == FLASH_NO_ERROR, "Bank 1 erase failure");
+    ferr = bank_write_raw_record(MFS_BANK_0,
+                                 MFS_ALIGN_NEXT(sizeof (mfs_bank_header_t)),
+                                 1, sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(ferr == FLASH_NO_ERROR, "record write failure");
+#if MFS_CFG_USE_SORTED_INDEX == TRUE
+    ferr = bank_write_raw_header(MFS_BANK_0, MFS_BANK_MAGIC_SI_2, 1);
+#else
+    ferr = bank_write_raw_header(MFS_BANK_0, MFS_BANK_MAGIC_2, 1);
+#endif
+    test_assert(ferr == FLASH_NO_ERROR, "header write failure");
+  }
+  test_end_step(1);
+
+  /* [1.10.2] Mounting the bank, MFS_WARN_GC is expected, the record
+     must be readable and a checkpoint must have been written.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+    size_t size;
+
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_WARN_GC, "bank not converted");
+    test_assert(mfs1.current_bank == MFS_BANK_1, "unexpected bank");
+    test_assert(mfs1.cp_slot == 1U, "checkpoint not written");
+    test_assert(bank_verify_erased(MFS_BANK_0) == FLASH_NO_ERROR,
+                "bank 0 not erased");
+
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof mfs_pattern16, "unexpected record length");
+    test_assert(memcmp(mfs_pattern16, mfs_buffer, size) == 0,
+                "wrong record content");
+  }
+  test_end_step(2);
+
+  /* [1.10.3] Mounting again, MFS_NO_ERROR is expected and the record
+     must be readable.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+    size_t size;
+
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "mount failed");
+
+    size = sizeof mfs_buffer;
+    err = mfsReadRecord(&mfs1, 1, &size, mfs_buffer);
+    test_assert(err == MFS_NO_ERROR, "record not found");
+    test_assert(size == sizeof mfs_pattern16, "unexpected record length");
+    test_assert(memcmp(mfs_pattern16, mfs_buffer, size) == 0,
+                "wrong record content");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t mfs_test_001_010 = {
+  "Converting banks written without checkpoints",
+  mfs_test_001_010_setup,
+  mfs_test_001_010_teardown,
+  mfs_test_001_010_execute
+};
+#endif /* MFS_CFG_USE_CHECKPOINTS == TRUE */
+
+/**
+ * @page mfs_test_001_011 [1.11] Incompatible storage layout
+ *
+ * <h2>Description</h2>
+ * A bank written with an incompatible layout must not be erased on
+ * mount, the mount fails until the storage is erased explicitly.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.11.1] Writing a bank header with an incompatible layout using
+ *   low level functions.
+ * - [1.11.2] Mounting, MFS_ERR_INV_LAYOUT is expected and the bank must
+ *   not have been erased.
+ * - [1.11.3] Erasing the storage using mfsErase(), the storage must be
+ *   usable afterward.
+ * .
+ */
+
+static void mfs_test_001_011_setup(void) {
+  mfsObjectInit(&mfs1);
+}
+
+static void mfs_test_001_011_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_001_011_execute(void) {
+
+  /* [1.11.1] Writing a bank header with an incompatible layout using
+     low level functions.*/
+  test_set_step(1);
+  {
+    flash_error_t ferr;
+
+    ferr = bank_erase(MFS_BANK_0);
+    test_assert(ferr == FLASH_NO_ERROR, "Bank 0 erase failure");
+    ferr = bank_erase(MFS_BANK_1);
+    test_assert(ferr == FLASH_NO_ERROR, "Bank 1 erase failure");
+#if MFS_CFG_USE_SORTED_INDEX == TRUE
+    ferr = bank_write_raw_header(MFS_BANK_0, MFS_BANK_MAGIC_2, 1);
+#else
+    ferr = bank_write_raw_header(MFS_BANK_0, MFS_BANK_MAGIC_SI_2, 1);
+#endif
+    test_assert(ferr == FLASH_NO_ERROR, "header write failure");
+  }
+  test_end_step(1);
+
+  /* [1.11.2] Mounting, MFS_ERR_INV_LAYOUT is expected and the bank must
+     not have been erased.*/
+  test_set_step(2);
+  {
+    mfs_error_t err;
+
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_ERR_INV_LAYOUT, "unexpected mount result");
+    test_assert(mfs1.state == MFS_ERROR, "unexpected state");
+    test_assert(bank_verify_erased(MFS_BANK_0) != FLASH_NO_ERROR,
+                "bank 0 erased");
+  }
+  test_end_step(2);
+
+  /* [1.11.3] Erasing the storage using mfsErase(), the storage must be
+     usable afterward.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+
+    err = mfsErase(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "erase failed");
+    test_assert(mfs1.state == MFS_READY, "unexpected state");
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(err == MFS_NO_ERROR, "error creating the record");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t mfs_test_001_011 = {
+  "Incompatible storage layout",
+  mfs_test_001_011_setup,
+  mfs_test_001_011_teardown,
+  mfs_test_001_011_execute
+};
 
 /****************************************************************************
  * Exported data.
@@ -819,7 +1384,19 @@ const testcase_t * const mfs_test_sequence_001_array[] = {
   &mfs_test_001_004,
   &mfs_test_001_005,
   &mfs_test_001_006,
+#if (MFS_CFG_USE_CHECKPOINTS == FALSE) || defined(__DOXYGEN__)
   &mfs_test_001_007,
+#endif
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+  &mfs_test_001_008,
+#endif
+#if (MFS_CFG_USE_SORTED_INDEX == TRUE) || defined(__DOXYGEN__)
+  &mfs_test_001_009,
+#endif
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+  &mfs_test_001_010,
+#endif
+  &mfs_test_001_011,
   NULL
 };
 
@@ -0,0 +1,152 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "mfs_test_root.h"
+
+/**
+ * @file    mfs_test_sequence_004.c
+ * @brief   Test Sequence 004 code.
+ *
+ * @page mfs_test_sequence_004 [4] Performance tests
+ *
+ * File: @ref mfs_test_sequence_004.c
+ *
+ * <h2>Description</h2>
+ * This test sequence measures the performance of the MFS module.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage mfs_test_004_001
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include "hal_mfs.h"
+
+static flash_offset_t bank_free_space(void) {
+  flash_sector_t sector;
+
+  sector = mfs1.current_bank == MFS_BANK_0 ? mfscfg1.bank0_start :
+                                             mfscfg1.bank1_start;
+
+  return (flashGetSectorOffset(mfscfg1.flashp, sector) +
+          mfscfg1.bank_size) - mfs1.next_offset;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page mfs_test_004_001 [4.1] Mount time
+ *
+ * <h2>Description</h2>
+ * The bank is filled with record updates and then it is mounted
+ * repeatedly for one second, the number of mount operations is
+ * reported. With checkpoints enabled only the records written after the
+ * most recent checkpoint are scanned.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.1.1] Filling the bank with record updates, MFS_NO_ERROR is
+ *   expected.
+ * - [4.1.2] Mounting the storage repeatedly for one second, the score
+ *   is printed.
+ * .
+ */
+
+static void mfs_test_004_001_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_004_001_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_001_execute(void) {
+
+  /* [4.1.1] Filling the bank with record updates, MFS_NO_ERROR is
+     expected.*/
+  test_set_step(1);
+  {
+    mfs_id_t id = 1;
+
+    while (bank_free_space() > 512U) {
+      mfs_error_t err;
+
+      err = mfsWriteRecord(&mfs1, id, sizeof mfs_pattern16, mfs_pattern16);
+      test_assert(err == MFS_NO_ERROR, "error writing the record");
+      id = (id % MFS_CFG_MAX_RECORDS) + 1U;
+    }
+  }
+  test_end_step(1);
+
+  /* [4.1.2] Mounting the storage repeatedly for one second, the score
+     is printed.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+    uint32_t n = 0;
+
+    start = osalOsGetSystemTimeX();
+    end = osalTimeAddX(start, TIME_MS2I(1000));
+    do {
+      mfs_error_t err;
+
+      err = mfsStart(&mfs1, &mfscfg1);
+      test_assert(err == MFS_NO_ERROR, "mount failed");
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (osalTimeIsInRangeX(osalOsGetSystemTimeX(), start, end));
+
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" mounts/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t mfs_test_004_001 = {
+  "Mount time",
+  mfs_test_004_001_setup,
+  mfs_test_004_001_teardown,
+  mfs_test_004_001_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const mfs_test_sequence_004_array[] = {
+  &mfs_test_004_001,
+  NULL
+};
+
+/**
+ * @brief   Performance tests.
+ */
+const testsequence_t mfs_test_sequence_004 = {
+  "Performance tests",
+  mfs_test_sequence_004_array
+};
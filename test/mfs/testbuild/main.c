@@ -0,0 +1,66 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "hal_mfs.h"
+#include "mfs_test_root.h"
+#include "console.h"
+
+#include "ram_flash.h"
+
+const MFSConfig mfscfg1 = {
+  .flashp           = (BaseFlash *)&RFD1,
+  .erased           = 0xFFFFFFFFU,
+  .bank_size        = 4096U,
+  .bank0_start      = 0U,
+  .bank0_sectors    = 2U,
+  .bank1_start      = 2U,
+  .bank1_sectors    = 2U
+};
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+
+  (void)argc;
+  (void)argv;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  /* Flash device emulated in RAM.*/
+  rflObjectInit(&RFD1);
+
+  test_execute((BaseSequentialStream *)&CD1, &mfs_test_suite);
+  if (test_global_fail)
+    exit(1);
+  else
+    exit(0);
+}
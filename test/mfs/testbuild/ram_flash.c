@@ -0,0 +1,195 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ram_flash.c
+ * @brief   RAM-backed flash device code.
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "ram_flash.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+#define RAM_FLASH_SIZE      (RAM_FLASH_SECTORS_COUNT * RAM_FLASH_SECTOR_SIZE)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   RAM flash device instance.
+ */
+RamFlashDriver RFD1;
+
+/*===========================================================================*/
+/* Module local variables and types.                                         */
+/*===========================================================================*/
+
+static const flash_descriptor_t rfl_descriptor = {
+  .attributes       = FLASH_ATTR_ERASED_IS_ONE,
+  .page_size        = 1U,
+  .sectors_count    = RAM_FLASH_SECTORS_COUNT,
+  .sectors          = NULL,
+  .sectors_size     = RAM_FLASH_SECTOR_SIZE,
+  .address          = NULL,
+  .size             = RAM_FLASH_SIZE
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static const flash_descriptor_t *rfl_get_descriptor(void *instance) {
+
+  (void)instance;
+
+  return &rfl_descriptor;
+}
+
+static flash_error_t rfl_read(void *instance, flash_offset_t offset,
+                              size_t n, uint8_t *rp) {
+  RamFlashDriver *rflp = (RamFlashDriver *)instance;
+
+  if ((offset > RAM_FLASH_SIZE) || (n > RAM_FLASH_SIZE - offset)) {
+    return FLASH_ERROR_READ;
+  }
+
+  memcpy((void *)rp, (const void *)&rflp->array[offset], n);
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t rfl_program(void *instance, flash_offset_t offset,
+                                 size_t n, const uint8_t *pp) {
+  RamFlashDriver *rflp = (RamFlashDriver *)instance;
+
+  if ((offset > RAM_FLASH_SIZE) || (n > RAM_FLASH_SIZE - offset)) {
+    return FLASH_ERROR_PROGRAM;
+  }
+
+  /* Like a NOR array, programming can only clear bits.*/
+  while (n > 0U) {
+    rflp->array[offset] &= *pp;
+    offset++;
+    pp++;
+    n--;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t rfl_start_erase_all(void *instance) {
+  RamFlashDriver *rflp = (RamFlashDriver *)instance;
+
+  memset((void *)rflp->array, 0xFF, RAM_FLASH_SIZE);
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t rfl_start_erase_sector(void *instance,
+                                            flash_sector_t sector) {
+  RamFlashDriver *rflp = (RamFlashDriver *)instance;
+
+  if (sector >= RAM_FLASH_SECTORS_COUNT) {
+    return FLASH_ERROR_ERASE;
+  }
+
+  memset((void *)&rflp->array[sector * RAM_FLASH_SECTOR_SIZE], 0xFF,
+         RAM_FLASH_SECTOR_SIZE);
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t rfl_query_erase(void *instance, uint32_t *wait_time) {
+
+  (void)instance;
+
+  /* Erase operations complete immediately.*/
+  if (wait_time != NULL) {
+    *wait_time = 0U;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t rfl_verify_erase(void *instance, flash_sector_t sector) {
+  RamFlashDriver *rflp = (RamFlashDriver *)instance;
+  const uint8_t *p;
+  uint32_t n;
+
+  if (sector >= RAM_FLASH_SECTORS_COUNT) {
+    return FLASH_ERROR_VERIFY;
+  }
+
+  p = &rflp->array[sector * RAM_FLASH_SECTOR_SIZE];
+  for (n = 0U; n < RAM_FLASH_SECTOR_SIZE; n++) {
+    if (p[n] != 0xFFU) {
+      return FLASH_ERROR_VERIFY;
+    }
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t rfl_acquire_exclusive(void *instance) {
+
+  (void)instance;
+
+  return FLASH_ERROR_UNIMPLEMENTED;
+}
+
+static flash_error_t rfl_release_exclusive(void *instance) {
+
+  (void)instance;
+
+  return FLASH_ERROR_UNIMPLEMENTED;
+}
+
+static const struct BaseFlashVMT vmt = {
+  (size_t)0,
+  rfl_get_descriptor,
+  rfl_read,
+  rfl_program,
+  rfl_start_erase_all,
+  rfl_start_erase_sector,
+  rfl_query_erase,
+  rfl_verify_erase,
+  rfl_acquire_exclusive,
+  rfl_release_exclusive
+};
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a RAM flash device, the array is left erased.
+ *
+ * @param[out] rflp     pointer to a @p RamFlashDriver structure
+ *
+ * @init
+ */
+void rflObjectInit(RamFlashDriver *rflp) {
+
+  rflp->vmt   = &vmt;
+  rflp->state = FLASH_READY;
+  (void) rfl_start_erase_all(rflp);
+}
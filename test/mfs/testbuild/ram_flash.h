@@ -0,0 +1,79 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ram_flash.h
+ * @brief   RAM-backed flash device header.
+ * @details A @p BaseFlash implementation emulating a NOR flash in RAM, it
+ *          allows to run the MFS test suite on the simulator.
+ */
+
+#ifndef RAM_FLASH_H
+#define RAM_FLASH_H
+
+#include "hal_flash.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of sectors of the emulated device.
+ */
+#define RAM_FLASH_SECTORS_COUNT             8U
+
+/**
+ * @brief   Size of the sectors of the emulated device.
+ */
+#define RAM_FLASH_SECTOR_SIZE               2048U
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @extends BaseFlash
+ *
+ * @brief   Structure representing a RAM-backed flash device.
+ */
+typedef struct {
+  /**
+   * @brief   Virtual Methods Table.
+   */
+  const struct BaseFlashVMT *vmt;
+  _base_flash_data
+  /**
+   * @brief   Flash array.
+   */
+  uint8_t                   array[RAM_FLASH_SECTORS_COUNT *
+                                  RAM_FLASH_SECTOR_SIZE];
+} RamFlashDriver;
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern RamFlashDriver RFD1;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void rflObjectInit(RamFlashDriver *rflp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAM_FLASH_H */
@@ -31,6 +31,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage nil_test_003_001
+ * - @subpage nil_test_003_002
  * .
  */
 
@@ -40,6 +41,28 @@
 
 #include "ch.h"
 
+static THD_WORKING_AREA(wa_timeouts, 128);
+static thread_reference_t tr1;
+
+static THD_FUNCTION(sleeper, arg) {
+
+  (void)arg;
+
+  chThdSleep(60);
+  test_emit_token('C');
+}
+
+static THD_FUNCTION(waiter, arg) {
+  msg_t msg;
+
+  (void)arg;
+
+  chSysLock();
+  msg = chThdSuspendTimeoutS(&tr1, 100);
+  chSysUnlock();
+  test_emit_token(msg == MSG_OK ? 'B' : 'X');
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -141,6 +164,95 @@ static const testcase_t nil_test_003_001 = {
   nil_test_003_001_execute
 };
 
+/**
+ * @page nil_test_003_002 [3.2] Threads timeouts ordering
+ *
+ * <h2>Description</h2>
+ * Two threads wait with different timeouts, one of them is woken up
+ * before its timeout expires. The remaining timeout must expire on time
+ * and the threads must be woken up in deadline order.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.2.1] Starting two threads, the first sleeps for 60 ticks, the
+ *   second waits to be resumed with a timeout of 100 ticks.
+ * - [3.2.2] Sleeping for 20 ticks, both threads must still be waiting.
+ * - [3.2.3] Resuming the second thread 40 ticks after start, its
+ *   timeout is removed before expiring.
+ * - [3.2.4] Waiting for the first thread, it must be woken up at its
+ *   deadline and the tokens must be in order.
+ * .
+ */
+
+static void nil_test_003_002_execute(void) {
+  thread_t *tp1, *tp2;
+  systime_t time;
+
+  /* [3.2.1] Starting two threads, the first sleeps for 60 ticks, the
+     second waits to be resumed with a timeout of 100 ticks.*/
+  test_set_step(1);
+  {
+    thread_descriptor_t td1 = {
+      .name  = "sleeper",
+      .wbase = wa_common,
+      .wend  = THD_WORKING_AREA_END(wa_common),
+      .prio  = chThdGetPriorityX() - 1,
+      .funcp = sleeper,
+      .arg   = NULL
+    };
+    thread_descriptor_t td2 = {
+      .name  = "waiter",
+      .wbase = wa_timeouts,
+      .wend  = THD_WORKING_AREA_END(wa_timeouts),
+      .prio  = chThdGetPriorityX() - 2,
+      .funcp = waiter,
+      .arg   = NULL
+    };
+
+    tr1 = NULL;
+    time = chVTGetSystemTimeX();
+    tp1 = chThdCreate(&td1);
+    tp2 = chThdCreate(&td2);
+  }
+  test_end_step(1);
+
+  /* [3.2.2] Sleeping for 20 ticks, both threads must still be waiting.*/
+  test_set_step(2);
+  {
+    chThdSleep(20);
+    test_emit_token('A');
+  }
+  test_end_step(2);
+
+  /* [3.2.3] Resuming the second thread 40 ticks after start, its
+     timeout is removed before expiring.*/
+  test_set_step(3);
+  {
+    chThdSleepUntil(chTimeAddX(time, 40));
+    chThdResume(&tr1, MSG_OK);
+    (void) chThdWait(tp2);
+  }
+  test_end_step(3);
+
+  /* [3.2.4] Waiting for the first thread, it must be woken up at its
+     deadline and the tokens must be in order.*/
+  test_set_step(4);
+  {
+    (void) chThdWait(tp1);
+    test_assert_time_window(chTimeAddX(time, 60),
+                            chTimeAddX(time, 60 + 1),
+                            "out of time window");
+    test_assert_sequence("ABC", "invalid sequence");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t nil_test_003_002 = {
+  "Threads timeouts ordering",
+  NULL,
+  NULL,
+  nil_test_003_002_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -150,6 +262,7 @@ static const testcase_t nil_test_003_001 = {
  */
 const testcase_t * const nil_test_sequence_003_array[] = {
   &nil_test_003_001,
+  &nil_test_003_002,
   NULL
 };
 
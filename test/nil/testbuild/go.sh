@@ -0,0 +1,49 @@
+#!/bin/bash
+export XDEFS
+
+XDEFS=""
+
+function clean() {
+  echo -n "  * Cleaning..."
+  make clean > /dev/null
+  echo "OK"
+}
+
+function compile() {
+  echo -n "  * Building..."
+  if ! make > buildlog.txt
+  then
+    echo "failed"
+    clean
+    exit
+  fi
+  mv -f buildlog.txt ./reports/${1}_build.txt
+  echo "OK"
+}
+
+function test() {
+  if [ -z "$2" ]
+  then
+    msg=$1": Default Settings"
+    XDEFS=
+  else
+    msg=$1": "$2
+    XDEFS=$2
+  fi
+  echo $msg
+  compile $1
+  clean
+}
+
+mkdir reports 2> /dev/null
+
+test cfg1 ""
+test cfg2 "-DCH_DBG_SYSTEM_STATE_CHECK=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE"
+test cfg3 "-DCH_CFG_ST_TIMEDELTA=2"
+test cfg4 "-DCH_CFG_USE_TIMEOUTS_LIST=TRUE"
+test cfg5 "-DCH_CFG_USE_TIMEOUTS_LIST=TRUE -DCH_CFG_ST_TIMEDELTA=2"
+test cfg6 "-DCH_CFG_USE_TIMEOUTS_LIST=TRUE -DCH_CFG_ST_TIMEDELTA=2 -DCH_DBG_SYSTEM_STATE_CHECK=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE"
+
+rm *log.txt 2> /dev/null
+echo
+echo "Done"
@@ -38,6 +38,8 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_003_001
  * - @subpage oslib_test_003_002
+ * - @subpage oslib_test_003_003
+ * - @subpage oslib_test_003_004
  * .
  */
 
@@ -98,7 +100,7 @@ static void oslib_test_003_001_execute(void) {
 
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
   }
   test_end_step(1);
@@ -112,7 +114,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 0, "not reset");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
   }
   test_end_step(2);
@@ -127,7 +129,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 0, "not reset");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
   }
   test_end_step(3);
@@ -138,7 +140,7 @@ static void oslib_test_003_001_execute(void) {
     chPipeResume(&pipe1);
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
   }
   test_end_step(4);
@@ -152,7 +154,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE, "wrong size");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == PIPE_SIZE),
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE),
                 "invalid pipe state");
   }
   test_end_step(5);
@@ -167,7 +169,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE, "wrong size");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
     test_assert(memcmp(pipe_pattern, buf, PIPE_SIZE) == 0, "content mismatch");
   }
@@ -182,7 +184,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 4, "wrong size");
     test_assert((pipe1.rdptr != pipe1.wrptr) &&
                 (pipe1.rdptr == pipe1.buffer) &&
-                (pipe1.cnt == 4),
+                (chPipeGetUsedCount(&pipe1) == 4),
                 "invalid pipe state");
   }
   test_end_step(7);
@@ -196,7 +198,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE - 4, "wrong size");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == PIPE_SIZE),
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE),
                 "invalid pipe state");
   }
   test_end_step(8);
@@ -211,7 +213,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 4, "wrong size");
     test_assert((pipe1.rdptr != pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == PIPE_SIZE - 4),
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE - 4),
                 "invalid pipe state");
     test_assert(memcmp(pipe_pattern, buf, 4) == 0, "content mismatch");
   }
@@ -227,7 +229,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE - 4, "wrong size");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
     test_assert(memcmp(pipe_pattern, buf, PIPE_SIZE - 4) == 0, "content mismatch");
   }
@@ -242,7 +244,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 5, "wrong size");
     test_assert((pipe1.rdptr != pipe1.wrptr) &&
                 (pipe1.rdptr == pipe1.buffer) &&
-                (pipe1.cnt == 5),
+                (chPipeGetUsedCount(&pipe1) == 5),
                 "invalid pipe state");
   }
   test_end_step(11);
@@ -257,7 +259,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 5, "wrong size");
     test_assert((pipe1.rdptr == pipe1.wrptr) &&
                 (pipe1.wrptr != pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
     test_assert(memcmp(pipe_pattern, buf, 5) == 0, "content mismatch");
   }
@@ -272,7 +274,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE, "wrong size");
     test_assert((pipe1.rdptr == pipe1.wrptr) &&
                 (pipe1.wrptr != pipe1.buffer) &&
-                (pipe1.cnt == PIPE_SIZE),
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE),
                 "invalid pipe state");
   }
   test_end_step(13);
@@ -287,7 +289,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE, "wrong size");
     test_assert((pipe1.rdptr == pipe1.wrptr) &&
                 (pipe1.wrptr != pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
     test_assert(memcmp(pipe_pattern, buf, PIPE_SIZE) == 0, "content mismatch");
   }
@@ -329,7 +331,7 @@ static void oslib_test_003_002_execute(void) {
     test_assert(n == 0, "wrong size");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
   }
   test_end_step(1);
@@ -343,7 +345,7 @@ static void oslib_test_003_002_execute(void) {
     test_assert(n == PIPE_SIZE / 2, "wrong size");
     test_assert((pipe1.rdptr == pipe1.wrptr) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == PIPE_SIZE / 2),
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE / 2),
                 "invalid pipe state");
   }
   test_end_step(2);
@@ -356,6 +358,313 @@ static const testcase_t oslib_test_003_002 = {
   oslib_test_003_002_execute
 };
 
+/**
+ * @page oslib_test_003_003 [3.3] Pipes zero-copy API
+ *
+ * <h2>Description</h2>
+ * The in place write and read functions are tested, spans must wrap
+ * around the buffer boundary and partial reservations must be returned
+ * on timeout.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] Reserving and committing the whole pipe, single span
+ *   expected.
+ * - [3.3.2] Reserving on a full pipe, must fail.
+ * - [3.3.3] Peeking and consuming the whole pipe, single span expected.
+ * - [3.3.4] Peeking on an empty pipe, must fail.
+ * - [3.3.5] Moving the pipe pointers near the buffer end.
+ * - [3.3.6] Reserving and committing across the buffer boundary, two
+ *   spans expected.
+ * - [3.3.7] Peeking across the buffer boundary, two spans expected,
+ *   consuming a part of the data.
+ * - [3.3.8] Reserving more than the free space with timeout, partial
+ *   reservation expected.
+ * - [3.3.9] Peeking more than the available data with timeout, partial
+ *   data expected.
+ * .
+ */
+
+static void oslib_test_003_003_setup(void) {
+  chPipeObjectInit(&pipe1, buffer, PIPE_SIZE);
+}
+
+static void oslib_test_003_003_execute(void) {
+
+  /* [3.3.1] Reserving and committing the whole pipe, single span
+     expected.*/
+  test_set_step(1);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeWriteReserve(&pipe1, PIPE_SIZE, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert((span.buf1 == pipe1.buffer) && (span.n1 == PIPE_SIZE) &&
+                (span.buf2 == NULL) && (span.n2 == 0),
+                "invalid span");
+    memcpy(span.buf1, pipe_pattern, span.n1);
+    chPipeWriteCommit(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer) &&
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE),
+                "invalid pipe state");
+  }
+  test_end_step(1);
+
+  /* [3.3.2] Reserving on a full pipe, must fail.*/
+  test_set_step(2);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeWriteReserve(&pipe1, 1, &span, TIME_IMMEDIATE);
+    test_assert(n == 0, "wrong size");
+    test_assert(chPipeGetUsedCount(&pipe1) == PIPE_SIZE, "invalid pipe state");
+  }
+  test_end_step(2);
+
+  /* [3.3.3] Peeking and consuming the whole pipe, single span expected.*/
+  test_set_step(3);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeReadPeek(&pipe1, PIPE_SIZE, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert((span.buf1 == pipe1.buffer) && (span.n1 == PIPE_SIZE) &&
+                (span.buf2 == NULL) && (span.n2 == 0),
+                "invalid span");
+    test_assert(memcmp(pipe_pattern, span.buf1, PIPE_SIZE) == 0, "content mismatch");
+    chPipeReadConsume(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer) &&
+                (chPipeGetUsedCount(&pipe1) == 0),
+                "invalid pipe state");
+  }
+  test_end_step(3);
+
+  /* [3.3.4] Peeking on an empty pipe, must fail.*/
+  test_set_step(4);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeReadPeek(&pipe1, 1, &span, TIME_IMMEDIATE);
+    test_assert(n == 0, "wrong size");
+    test_assert(chPipeGetUsedCount(&pipe1) == 0, "invalid pipe state");
+  }
+  test_end_step(4);
+
+  /* [3.3.5] Moving the pipe pointers near the buffer end.*/
+  test_set_step(5);
+  {
+    size_t n;
+    uint8_t buf[PIPE_SIZE];
+
+    n = chPipeWriteTimeout(&pipe1, pipe_pattern, PIPE_SIZE - 2, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE - 2, "wrong size");
+    n = chPipeReadTimeout(&pipe1, buf, PIPE_SIZE - 2, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE - 2, "wrong size");
+    test_assert((pipe1.rdptr == pipe1.buffer + PIPE_SIZE - 2) &&
+                (pipe1.wrptr == pipe1.buffer + PIPE_SIZE - 2) &&
+                (chPipeGetUsedCount(&pipe1) == 0),
+                "invalid pipe state");
+  }
+  test_end_step(5);
+
+  /* [3.3.6] Reserving and committing across the buffer boundary, two
+     spans expected.*/
+  test_set_step(6);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeWriteReserve(&pipe1, PIPE_SIZE / 2, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE / 2, "wrong size");
+    test_assert((span.buf1 == pipe1.buffer + PIPE_SIZE - 2) && (span.n1 == 2) &&
+                (span.buf2 == pipe1.buffer) && (span.n2 == PIPE_SIZE / 2 - 2),
+                "invalid spans");
+    memcpy(span.buf1, pipe_pattern, span.n1);
+    memcpy(span.buf2, pipe_pattern + span.n1, span.n2);
+    chPipeWriteCommit(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.buffer + PIPE_SIZE - 2) &&
+                (pipe1.wrptr == pipe1.buffer + PIPE_SIZE / 2 - 2) &&
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE / 2),
+                "invalid pipe state");
+  }
+  test_end_step(6);
+
+  /* [3.3.7] Peeking across the buffer boundary, two spans expected,
+     consuming a part of the data.*/
+  test_set_step(7);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeReadPeek(&pipe1, PIPE_SIZE / 2, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE / 2, "wrong size");
+    test_assert((span.buf1 == pipe1.buffer + PIPE_SIZE - 2) && (span.n1 == 2) &&
+                (span.buf2 == pipe1.buffer) && (span.n2 == PIPE_SIZE / 2 - 2),
+                "invalid spans");
+    test_assert((memcmp(pipe_pattern, span.buf1, span.n1) == 0) &&
+                (memcmp(pipe_pattern + span.n1, span.buf2, span.n2) == 0),
+                "content mismatch");
+    chPipeReadConsume(&pipe1, 3);
+    test_assert((pipe1.rdptr == pipe1.buffer + 1) &&
+                (pipe1.wrptr == pipe1.buffer + PIPE_SIZE / 2 - 2) &&
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE / 2 - 3),
+                "invalid pipe state");
+  }
+  test_end_step(7);
+
+  /* [3.3.8] Reserving more than the free space with timeout, partial
+     reservation expected.*/
+  test_set_step(8);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeWriteReserve(&pipe1, PIPE_SIZE, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE / 2 + 3, "wrong size");
+    test_assert((span.buf1 == pipe1.buffer + PIPE_SIZE / 2 - 2) &&
+                (span.n1 == PIPE_SIZE / 2 + 2) &&
+                (span.buf2 == pipe1.buffer) && (span.n2 == 1),
+                "invalid spans");
+    chPipeWriteCommit(&pipe1, 0);
+    test_assert(chPipeGetUsedCount(&pipe1) == PIPE_SIZE / 2 - 3,
+                "invalid pipe state");
+  }
+  test_end_step(8);
+
+  /* [3.3.9] Peeking more than the available data with timeout, partial
+     data expected.*/
+  test_set_step(9);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeReadPeek(&pipe1, PIPE_SIZE, &span, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE / 2 - 3, "wrong size");
+    test_assert((span.buf1 == pipe1.buffer + 1) &&
+                (span.n1 == PIPE_SIZE / 2 - 3) &&
+                (span.buf2 == NULL) && (span.n2 == 0),
+                "invalid span");
+    test_assert(memcmp(pipe_pattern + 3, span.buf1, span.n1) == 0,
+                "content mismatch");
+    chPipeReadConsume(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.wrptr) &&
+                (chPipeGetUsedCount(&pipe1) == 0),
+                "invalid pipe state");
+  }
+  test_end_step(9);
+}
+
+static const testcase_t oslib_test_003_003 = {
+  "Pipes zero-copy API",
+  oslib_test_003_003_setup,
+  NULL,
+  oslib_test_003_003_execute
+};
+
+#if (CH_CFG_PIPES_SPSC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_003_004 [3.4] Pipes SPSC I-class API
+ *
+ * <h2>Description</h2>
+ * The I-class functions available in SPSC mode are tested, the pipe is
+ * filled and emptied from within a critical zone.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_PIPES_SPSC == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.4.1] Writing half pipe.
+ * - [3.4.2] Writing more than the free space, partial write expected.
+ * - [3.4.3] Reading the whole pipe.
+ * - [3.4.4] Reading from an empty pipe, must fail.
+ * .
+ */
+
+static void oslib_test_003_004_setup(void) {
+  chPipeObjectInit(&pipe1, buffer, PIPE_SIZE);
+}
+
+static void oslib_test_003_004_execute(void) {
+
+  /* [3.4.1] Writing half pipe.*/
+  test_set_step(1);
+  {
+    size_t n;
+
+    chSysLock();
+    n = chPipeWriteI(&pipe1, pipe_pattern, PIPE_SIZE / 2);
+    chSysUnlock();
+    test_assert(n == PIPE_SIZE / 2, "wrong size");
+    test_assert((pipe1.wrptr == pipe1.buffer + PIPE_SIZE / 2) &&
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE / 2),
+                "invalid pipe state");
+  }
+  test_end_step(1);
+
+  /* [3.4.2] Writing more than the free space, partial write expected.*/
+  test_set_step(2);
+  {
+    size_t n;
+
+    chSysLock();
+    n = chPipeWriteI(&pipe1, pipe_pattern, PIPE_SIZE);
+    chSysUnlock();
+    test_assert(n == PIPE_SIZE / 2, "wrong size");
+    test_assert((pipe1.wrptr == pipe1.buffer) &&
+                (chPipeGetFreeCount(&pipe1) == 0),
+                "invalid pipe state");
+  }
+  test_end_step(2);
+
+  /* [3.4.3] Reading the whole pipe.*/
+  test_set_step(3);
+  {
+    size_t n;
+    uint8_t buf[PIPE_SIZE];
+
+    chSysLock();
+    n = chPipeReadI(&pipe1, buf, PIPE_SIZE);
+    chSysUnlock();
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert((memcmp(pipe_pattern, buf, PIPE_SIZE / 2) == 0) &&
+                (memcmp(pipe_pattern, buf + PIPE_SIZE / 2, PIPE_SIZE / 2) == 0),
+                "content mismatch");
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (chPipeGetUsedCount(&pipe1) == 0),
+                "invalid pipe state");
+  }
+  test_end_step(3);
+
+  /* [3.4.4] Reading from an empty pipe, must fail.*/
+  test_set_step(4);
+  {
+    size_t n;
+    uint8_t buf[PIPE_SIZE];
+
+    chSysLock();
+    n = chPipeReadI(&pipe1, buf, PIPE_SIZE);
+    chSysUnlock();
+    test_assert(n == 0, "wrong size");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_003_004 = {
+  "Pipes SPSC I-class API",
+  oslib_test_003_004_setup,
+  NULL,
+  oslib_test_003_004_execute
+};
+#endif /* CH_CFG_PIPES_SPSC == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -366,6 +675,10 @@ static const testcase_t oslib_test_003_002 = {
 const testcase_t * const oslib_test_sequence_003_array[] = {
   &oslib_test_003_001,
   &oslib_test_003_002,
+  &oslib_test_003_003,
+#if (CH_CFG_PIPES_SPSC == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_003_004,
+#endif
   NULL
 };
 
@@ -37,6 +37,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_004_001
+ * - @subpage oslib_test_004_002
  * .
  */
 
@@ -54,7 +55,7 @@ static msg_t msg_queue[JOBS_QUEUE_SIZE];
 
 static void job_slow(void *arg) {
 
-  test_emit_token((int)arg);
+  test_emit_token((char)(uintptr_t)arg);
   chThdSleepMilliseconds(10);
 }
 
@@ -70,6 +71,28 @@ static THD_FUNCTION(Thread1, arg) {
   } while (msg == MSG_OK);
 }
 
+#if CH_CFG_USE_JOBS_POOLS == TRUE
+#define JOBS_POOL_SIZE 8
+
+static jobs_pool_t jpool;
+static job_descriptor_t pool_jobs[JOBS_POOL_SIZE];
+static jobs_worker_t workers[2];
+
+static void job_fast(void *arg) {
+
+  test_emit_token((char)(uintptr_t)arg);
+}
+
+static THD_FUNCTION(Thread2, arg) {
+  jobs_worker_t *jwp = (jobs_worker_t *)arg;
+  msg_t msg;
+
+  do {
+    msg = chJobPoolDispatch(jwp);
+  } while (msg == MSG_OK);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -132,7 +155,7 @@ static void oslib_test_004_001_execute(void) {
     for (i = 0; i < 8; i++) {
       jdp = chJobGet(&jq);
       jdp->jobfunc = job_slow;
-      jdp->jobarg  = (void *)('a' + i);
+      jdp->jobarg  = (void *)(uintptr_t)('a' + i);
       chJobPost(&jq, jdp);
     }
   }
@@ -165,6 +188,163 @@ static const testcase_t oslib_test_004_001 = {
   oslib_test_004_001_execute
 };
 
+#if (CH_CFG_USE_JOBS_POOLS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_004_002 [4.2] Jobs pool test
+ *
+ * <h2>Description</h2>
+ * The jobs pool API is tested for functionality, jobs priorities, work
+ * stealing and statistics are checked.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_JOBS_POOLS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.2.1] Initializing the Jobs Pool object with two workers.
+ * - [4.2.2] Starting the worker threads, they have lower priority and
+ *   do not run yet.
+ * - [4.2.3] Posting a batch of normal and high priority jobs followed
+ *   by two null jobs, the jobs are distributed among the workers.
+ * - [4.2.4] Waiting for the workers to terminate, high priority jobs
+ *   must be executed first, the first worker steals a high priority job
+ *   from the second worker.
+ * - [4.2.5] Checking the statistics, all the job objects must have been
+ *   returned.
+ * - [4.2.6] Dispatching from an empty pool, a timeout is expected.
+ * - [4.2.7] Allocating the job objects again, the priorities left by
+ *   the previous jobs must have been reset.
+ * .
+ */
+
+static void oslib_test_004_002_execute(void) {
+  thread_t *tp1, *tp2;
+
+  /* [4.2.1] Initializing the Jobs Pool object with two workers.*/
+  test_set_step(1);
+  {
+    chJobPoolObjectInit(&jpool, JOBS_POOL_SIZE, pool_jobs, 2, workers);
+  }
+  test_end_step(1);
+
+  /* [4.2.2] Starting the worker threads, they have lower priority and
+     do not run yet.*/
+  test_set_step(2);
+  {
+    thread_descriptor_t td1 = {
+      .name  = "worker1",
+      .wbase = wa1Thread1,
+      .wend  = THD_WORKING_AREA_END(wa1Thread1),
+      .prio  = chThdGetPriorityX() - 1,
+      .funcp = Thread2,
+      .arg   = (void *)&workers[0]
+    };
+    tp1 = chThdCreate(&td1);
+
+    thread_descriptor_t td2 = {
+      .name  = "worker2",
+      .wbase = wa2Thread1,
+      .wend  = THD_WORKING_AREA_END(wa2Thread1),
+      .prio  = chThdGetPriorityX() - 2,
+      .funcp = Thread2,
+      .arg   = (void *)&workers[1]
+    };
+    tp2 = chThdCreate(&td2);
+  }
+  test_end_step(2);
+
+  /* [4.2.3] Posting a batch of normal and high priority jobs followed
+     by two null jobs, the jobs are distributed among the workers.*/
+  test_set_step(3);
+  {
+    unsigned i;
+    job_descriptor_t *jdps[JOBS_POOL_SIZE];
+    static const char tokens[JOBS_POOL_SIZE] = {
+      'a', 'b', 'c', 'd', 'A', 'B', 0, 0
+    };
+
+    for (i = 0; i < JOBS_POOL_SIZE; i++) {
+      jdps[i] = chJobPoolGetTimeout(&jpool, TIME_IMMEDIATE);
+      test_assert(jdps[i] != NULL, "allocation failed");
+      jdps[i]->jobfunc = tokens[i] != 0 ? job_fast : NULL;
+      jdps[i]->jobarg  = (void *)(uintptr_t)tokens[i];
+      jdps[i]->jobprio = (i == 4) || (i == 5) ? 1U : 0U;
+    }
+    test_assert(chJobPoolGetTimeout(&jpool, TIME_IMMEDIATE) == NULL,
+                "pool not empty");
+    chJobPoolPostBatch(&jpool, jdps, JOBS_POOL_SIZE);
+  }
+  test_end_step(3);
+
+  /* [4.2.4] Waiting for the workers to terminate, high priority jobs
+     must be executed first, the first worker steals a high priority job
+     from the second worker.*/
+  test_set_step(4);
+  {
+    (void) chThdWait(tp1);
+    (void) chThdWait(tp2);
+    test_assert_sequence("ABacbd", "unexpected tokens");
+  }
+  test_end_step(4);
+
+  /* [4.2.5] Checking the statistics, all the job objects must have been
+     returned.*/
+  test_set_step(5);
+  {
+    jobs_pool_stats_t stats;
+    cnt_t n;
+
+    chJobPoolGetStats(&jpool, &stats);
+    test_assert(stats.depth == 0U, "not empty");
+    test_assert(stats.posted == 8U, "wrong posted count");
+    test_assert(stats.executed == 6U, "wrong executed count");
+    test_assert(stats.steals == 1U, "wrong steals count");
+    chSysLock();
+    n = chGuardedPoolGetCounterI(&jpool.free);
+    chSysUnlock();
+    test_assert(n == JOBS_POOL_SIZE, "jobs not returned");
+  }
+  test_end_step(5);
+
+  /* [4.2.6] Dispatching from an empty pool, a timeout is expected.*/
+  test_set_step(6);
+  {
+    msg_t msg;
+
+    msg = chJobPoolDispatchTimeout(&workers[0], TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "wrong message");
+  }
+  test_end_step(6);
+
+  /* [4.2.7] Allocating the job objects again, the priorities left by
+     the previous jobs must have been reset.*/
+  test_set_step(7);
+  {
+    unsigned i;
+    job_descriptor_t *jdps[JOBS_POOL_SIZE];
+
+    for (i = 0; i < JOBS_POOL_SIZE; i++) {
+      jdps[i] = chJobPoolGetTimeout(&jpool, TIME_IMMEDIATE);
+      test_assert(jdps[i] != NULL, "allocation failed");
+      test_assert(jdps[i]->jobprio == 0U, "priority not reset");
+    }
+    for (i = 0; i < JOBS_POOL_SIZE; i++) {
+      chGuardedPoolFree(&jpool.free, (void *)jdps[i]);
+    }
+  }
+  test_end_step(7);
+}
+
+static const testcase_t oslib_test_004_002 = {
+  "Jobs pool test",
+  NULL,
+  NULL,
+  oslib_test_004_002_execute
+};
+#endif /* CH_CFG_USE_JOBS_POOLS == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -174,6 +354,9 @@ static const testcase_t oslib_test_004_001 = {
  */
 const testcase_t * const oslib_test_sequence_004_array[] = {
   &oslib_test_004_001,
+#if (CH_CFG_USE_JOBS_POOLS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_004_002,
+#endif
   NULL
 };
 
@@ -37,6 +37,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_006_001
+ * - @subpage oslib_test_006_002
  * .
  */
 
@@ -88,6 +89,35 @@ static bool obj_write(objects_cache_t *ocp,
   return false;
 }
 
+static bool obj_writev(objects_cache_t *ocp,
+                       oc_object_t * const *objs,
+                       ucnt_t n,
+                       bool async) {
+  ucnt_t i;
+
+  test_emit_token('(');
+  for (i = 0; i < n; i++) {
+    test_emit_token('A' + objs[i]->obj_key);
+  }
+  test_emit_token(')');
+
+  if (async) {
+    for (i = 0; i < n; i++) {
+      chCacheReleaseObject(ocp, objs[i]);
+    }
+  }
+
+  return false;
+}
+
+static void obj_dirty(uint32_t group, uint32_t key) {
+  oc_object_t *objp = chCacheGetObject(&cache1, group, key);
+
+  objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+  objp->obj_flags |= OC_FLAG_LAZYWRITE;
+  chCacheReleaseObject(&cache1, objp);
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -243,6 +273,148 @@ static const testcase_t oslib_test_006_001 = {
   oslib_test_006_001_execute
 };
 
+/**
+ * @page oslib_test_006_002 [6.2] Cache write-back and read-ahead
+ *
+ * <h2>Description</h2>
+ * Dirty objects with adjacent keys are written using the cluster
+ * writer, sequential accesses trigger the read-ahead.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.2.1] Cache initialization with a cluster writer and a read-ahead
+ *   of two objects.
+ * - [6.2.2] Making all objects dirty then flushing the cache, a single
+ *   cluster write is expected.
+ * - [6.2.3] Making all objects dirty again then getting a new object,
+ *   the evicted object is written together with the adjacent ones.
+ * - [6.2.4] Reading two consecutive objects, the second read triggers
+ *   the read-ahead of the following two objects.
+ * - [6.2.5] Checking the objects read ahead.
+ * - [6.2.6] Checking the statistics, if enabled.
+ * .
+ */
+
+static void oslib_test_006_002_execute(void) {
+
+  /* [6.2.1] Cache initialization with a cluster writer and a read-ahead
+     of two objects.*/
+  test_set_step(1);
+  {
+    chCacheObjectInit(&cache1,
+                      NUM_HASH_ENTRIES,
+                      hash_headers,
+                      NUM_OBJECTS,
+                      sizeof (cached_object_t),
+                      objects,
+                      obj_read,
+                      obj_write);
+    chCacheSetClusterWriter(&cache1, obj_writev);
+    chCacheSetReadAhead(&cache1, 2U);
+  }
+  test_end_step(1);
+
+  /* [6.2.2] Making all objects dirty then flushing the cache, a single
+     cluster write is expected.*/
+  test_set_step(2);
+  {
+    uint32_t i;
+    bool error;
+
+    for (i = 0; i < NUM_OBJECTS; i++) {
+      obj_dirty(0U, i);
+    }
+    error = chCacheFlush(&cache1);
+
+    test_assert(error == false, "returned error");
+    test_assert_sequence("(ABCD)", "unexpected tokens");
+
+    error = chCacheFlush(&cache1);
+
+    test_assert(error == false, "returned error");
+    test_assert_sequence("", "unexpected tokens");
+  }
+  test_end_step(2);
+
+  /* [6.2.3] Making all objects dirty again then getting a new object,
+     the evicted object is written together with the adjacent ones.*/
+  test_set_step(3);
+  {
+    uint32_t i;
+    oc_object_t *objp;
+
+    for (i = 0; i < NUM_OBJECTS; i++) {
+      obj_dirty(0U, i);
+    }
+    objp = chCacheGetObject(&cache1, 0U, NUM_OBJECTS * 2);
+
+    test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U, "in sync");
+    test_assert_sequence("(ABCD)", "unexpected tokens");
+
+    chCacheReleaseObject(&cache1, objp);
+  }
+  test_end_step(3);
+
+  /* [6.2.4] Reading two consecutive objects, the second read triggers
+     the read-ahead of the following two objects.*/
+  test_set_step(4);
+  {
+    uint32_t i;
+    oc_object_t *objp;
+
+    for (i = 0; i < 2; i++) {
+      objp = chCacheGetObject(&cache1, 1U, i);
+
+      test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U, "in sync");
+
+      (void) chCacheReadObject(&cache1, objp, false);
+      chCacheReleaseObject(&cache1, objp);
+    }
+
+    test_assert_sequence("abcd", "unexpected tokens");
+  }
+  test_end_step(4);
+
+  /* [6.2.5] Checking the objects read ahead.*/
+  test_set_step(5);
+  {
+    uint32_t i;
+
+    for (i = 2; i < 4; i++) {
+      oc_object_t *objp = chCacheGetObject(&cache1, 1U, i);
+
+      test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U, "not in sync");
+
+      chCacheReleaseObject(&cache1, objp);
+    }
+
+    test_assert_sequence("", "unexpected tokens");
+  }
+  test_end_step(5);
+
+  /* [6.2.6] Checking the statistics, if enabled.*/
+  test_set_step(6);
+  {
+#if CH_CFG_OBJ_CACHES_STATS == TRUE
+    oc_stats_t stats;
+
+    chCacheGetStats(&cache1, &stats);
+    test_assert(stats.hits == 6U, "wrong hits count");
+    test_assert(stats.misses == 7U, "wrong misses count");
+    test_assert(stats.writes == 2U, "wrong writes count");
+    test_assert(stats.written == 8U, "wrong written count");
+    test_assert(stats.prefetches == 2U, "wrong prefetches count");
+#endif
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_006_002 = {
+  "Cache write-back and read-ahead",
+  NULL,
+  NULL,
+  oslib_test_006_002_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -252,6 +424,7 @@ static const testcase_t oslib_test_006_001 = {
  */
 const testcase_t * const oslib_test_sequence_006_array[] = {
   &oslib_test_006_001,
+  &oslib_test_006_002,
   NULL
 };
 
@@ -39,6 +39,11 @@
  * - @subpage oslib_test_007_001
  * - @subpage oslib_test_007_002
  * - @subpage oslib_test_007_003
+ * - @subpage oslib_test_007_004
+ * - @subpage oslib_test_007_005
+ * - @subpage oslib_test_007_006
+ * - @subpage oslib_test_007_007
+ * - @subpage oslib_test_007_008
  * .
  */
 
@@ -50,11 +55,11 @@
 
 #define MEMORY_POOL_SIZE 4
 
-static uint32_t objects[MEMORY_POOL_SIZE];
-static MEMORYPOOL_DECL(mp1, sizeof (uint32_t), PORT_NATURAL_ALIGN, NULL);
+static void *objects[MEMORY_POOL_SIZE];
+static MEMORYPOOL_DECL(mp1, sizeof (void *), PORT_NATURAL_ALIGN, NULL);
 
 #if CH_CFG_USE_SEMAPHORES
-static GUARDEDMEMORYPOOL_DECL(gmp1, sizeof (uint32_t), PORT_NATURAL_ALIGN);
+static GUARDEDMEMORYPOOL_DECL(gmp1, sizeof (void *), PORT_NATURAL_ALIGN);
 #endif
 
 static void *null_provider(size_t size, unsigned align) {
@@ -65,6 +70,27 @@ static void *null_provider(size_t size, unsigned align) {
   return NULL;
 }
 
+#define MAGAZINE_SIZE 2
+
+static void *magazine_objs[MAGAZINE_SIZE];
+static pool_magazine_t pmag1;
+
+#if CH_CFG_USE_SEMAPHORES
+static void *batch_objs[MEMORY_POOL_SIZE / 2];
+static msg_t batch_msg;
+
+static THD_WORKING_AREA(waBatchThread, 256);
+static THD_FUNCTION(BatchThread, arg) {
+
+  (void)arg;
+
+  batch_msg = chGuardedPoolAllocBatchTimeout(&gmp1, batch_objs,
+                                             MEMORY_POOL_SIZE / 2,
+                                             TIME_MS2I(1000));
+  chThdExit(MSG_OK);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -89,7 +115,7 @@ static void *null_provider(size_t size, unsigned align) {
  */
 
 static void oslib_test_007_001_setup(void) {
-  chPoolObjectInit(&mp1, sizeof (uint32_t), NULL);
+  chPoolObjectInit(&mp1, sizeof (void *), NULL);
 }
 
 static void oslib_test_007_001_execute(void) {
@@ -144,7 +170,7 @@ static void oslib_test_007_001_execute(void) {
      more memory.*/
   test_set_step(7);
   {
-    chPoolObjectInit(&mp1, sizeof (uint32_t), null_provider);
+    chPoolObjectInit(&mp1, sizeof (void *), null_provider);
     test_assert(chPoolAlloc(&mp1) == NULL, "provider returned memory");
   }
   test_end_step(7);
@@ -183,7 +209,7 @@ static const testcase_t oslib_test_007_001 = {
  */
 
 static void oslib_test_007_002_setup(void) {
-  chGuardedPoolObjectInit(&gmp1, sizeof (uint32_t));
+  chGuardedPoolObjectInit(&gmp1, sizeof (void *));
 }
 
 static void oslib_test_007_002_execute(void) {
@@ -266,7 +292,7 @@ static const testcase_t oslib_test_007_002 = {
  */
 
 static void oslib_test_007_003_setup(void) {
-  chGuardedPoolObjectInit(&gmp1, sizeof (uint32_t));
+  chGuardedPoolObjectInit(&gmp1, sizeof (void *));
 }
 
 static void oslib_test_007_003_execute(void) {
@@ -288,6 +314,445 @@ static const testcase_t oslib_test_007_003 = {
 };
 #endif /* CH_CFG_USE_SEMAPHORES */
 
+/**
+ * @page oslib_test_007_004 [7.4] Allocating and releasing through a magazine
+ *
+ * <h2>Description</h2>
+ * The magazine layer in front of a memory pool is tested, objects are
+ * moved between the magazine and the pool when the magazine becomes
+ * empty or full.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.4.1] Adding the objects to the pool using chPoolLoadArray() and
+ *   initializing a magazine in front of it.
+ * - [7.4.2] Emptying the pool using chPoolMagazineAlloc().
+ * - [7.4.3] Now must be empty.
+ * - [7.4.4] Releasing the objects using chPoolMagazineFree(), the
+ *   magazine must never exceed its capacity.
+ * - [7.4.5] Flushing the magazine, all the objects must be back in the
+ *   pool.
+ * .
+ */
+
+static void oslib_test_007_004_setup(void) {
+  chPoolObjectInit(&mp1, sizeof (void *), NULL);
+}
+
+static void oslib_test_007_004_execute(void) {
+  unsigned i;
+
+  /* [7.4.1] Adding the objects to the pool using chPoolLoadArray() and
+     initializing a magazine in front of it.*/
+  test_set_step(1);
+  {
+    chPoolLoadArray(&mp1, objects, MEMORY_POOL_SIZE);
+    chPoolMagazineObjectInit(&pmag1, &mp1, magazine_objs, MAGAZINE_SIZE);
+  }
+  test_end_step(1);
+
+  /* [7.4.2] Emptying the pool using chPoolMagazineAlloc().*/
+  test_set_step(2);
+  {
+    for (i = 0; i < MEMORY_POOL_SIZE; i++)
+      test_assert(chPoolMagazineAlloc(&pmag1) != NULL, "list empty");
+  }
+  test_end_step(2);
+
+  /* [7.4.3] Now must be empty.*/
+  test_set_step(3);
+  {
+    test_assert(chPoolMagazineAlloc(&pmag1) == NULL, "list not empty");
+    test_assert(chPoolMagazineGetCountX(&pmag1) == 0U, "magazine not empty");
+  }
+  test_end_step(3);
+
+  /* [7.4.4] Releasing the objects using chPoolMagazineFree(), the
+     magazine must never exceed its capacity.*/
+  test_set_step(4);
+  {
+    for (i = 0; i < MEMORY_POOL_SIZE; i++) {
+      chPoolMagazineFree(&pmag1, &objects[i]);
+      test_assert(chPoolMagazineGetCountX(&pmag1) <= MAGAZINE_SIZE, "magazine overflow");
+    }
+  }
+  test_end_step(4);
+
+  /* [7.4.5] Flushing the magazine, all the objects must be back in the
+     pool.*/
+  test_set_step(5);
+  {
+    chPoolMagazineFlush(&pmag1);
+    test_assert(chPoolMagazineGetCountX(&pmag1) == 0U, "magazine not empty");
+    for (i = 0; i < MEMORY_POOL_SIZE; i++)
+      test_assert(chPoolAlloc(&mp1) != NULL, "list empty");
+    test_assert(chPoolAlloc(&mp1) == NULL, "list not empty");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_007_004 = {
+  "Allocating and releasing through a magazine",
+  oslib_test_007_004_setup,
+  NULL,
+  oslib_test_007_004_execute
+};
+
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_007_005 [7.5] Allocating and releasing through a magazine on a guarded memory pool
+ *
+ * <h2>Description</h2>
+ * The magazine layer in front of a guarded memory pool is tested, the
+ * guard semaphore must be kept in sync with the objects in the pool.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.5.1] Adding the objects to the pool using
+ *   chGuardedPoolLoadArray() and initializing a magazine in front of
+ *   it.
+ * - [7.5.2] Emptying the pool using
+ *   chGuardedPoolMagazineAllocTimeout().
+ * - [7.5.3] Now must be empty, the guard counter must be zero.
+ * - [7.5.4] Releasing the objects using chPoolMagazineFree() then
+ *   flushing the magazine, the guard counter must account all the
+ *   objects.
+ * .
+ */
+
+static void oslib_test_007_005_setup(void) {
+  chGuardedPoolObjectInit(&gmp1, sizeof (void *));
+}
+
+static void oslib_test_007_005_execute(void) {
+  unsigned i;
+
+  /* [7.5.1] Adding the objects to the pool using
+     chGuardedPoolLoadArray() and initializing a magazine in front of
+     it.*/
+  test_set_step(1);
+  {
+    chGuardedPoolLoadArray(&gmp1, objects, MEMORY_POOL_SIZE);
+    chGuardedPoolMagazineObjectInit(&pmag1, &gmp1, magazine_objs, MAGAZINE_SIZE);
+  }
+  test_end_step(1);
+
+  /* [7.5.2] Emptying the pool using
+     chGuardedPoolMagazineAllocTimeout().*/
+  test_set_step(2);
+  {
+    for (i = 0; i < MEMORY_POOL_SIZE; i++)
+      test_assert(chGuardedPoolMagazineAllocTimeout(&pmag1, TIME_IMMEDIATE) != NULL, "list empty");
+  }
+  test_end_step(2);
+
+  /* [7.5.3] Now must be empty, the guard counter must be zero.*/
+  test_set_step(3);
+  {
+    test_assert(chGuardedPoolMagazineAllocTimeout(&pmag1, TIME_IMMEDIATE) == NULL, "list not empty");
+    test_assert(chPoolMagazineAlloc(&pmag1) == NULL, "list not empty");
+    test_assert_lock(chGuardedPoolGetCounterI(&gmp1) == (cnt_t)0, "counter out of sync");
+  }
+  test_end_step(3);
+
+  /* [7.5.4] Releasing the objects using chPoolMagazineFree() then
+     flushing the magazine, the guard counter must account all the
+     objects.*/
+  test_set_step(4);
+  {
+    for (i = 0; i < MEMORY_POOL_SIZE; i++)
+      chPoolMagazineFree(&pmag1, &objects[i]);
+    chPoolMagazineFlush(&pmag1);
+    test_assert_lock(chGuardedPoolGetCounterI(&gmp1) == (cnt_t)MEMORY_POOL_SIZE, "counter out of sync");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_007_005 = {
+  "Allocating and releasing through a magazine on a guarded memory pool",
+  oslib_test_007_005_setup,
+  NULL,
+  oslib_test_007_005_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES */
+
+/**
+ * @page oslib_test_007_006 [7.6] Batch allocation and release
+ *
+ * <h2>Description</h2>
+ * Objects are allocated from and released into a memory pool in
+ * batches.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.6.1] Adding the objects to the pool using chPoolFreeBatch().
+ * - [7.6.2] Emptying the pool using chPoolAllocBatch(), requesting one
+ *   more object than available.
+ * - [7.6.3] Now must be empty.
+ * - [7.6.4] Returning the objects using chPoolFreeBatch() then emptying
+ *   the pool again.
+ * .
+ */
+
+static void oslib_test_007_006_setup(void) {
+  chPoolObjectInit(&mp1, sizeof (void *), NULL);
+}
+
+static void oslib_test_007_006_execute(void) {
+  void *objs[MEMORY_POOL_SIZE + 1];
+
+  /* [7.6.1] Adding the objects to the pool using chPoolFreeBatch().*/
+  test_set_step(1);
+  {
+    unsigned i;
+
+    for (i = 0; i < MEMORY_POOL_SIZE; i++)
+      objs[i] = &objects[i];
+    chPoolFreeBatch(&mp1, objs, MEMORY_POOL_SIZE);
+  }
+  test_end_step(1);
+
+  /* [7.6.2] Emptying the pool using chPoolAllocBatch(), requesting one
+     more object than available.*/
+  test_set_step(2);
+  {
+    test_assert(chPoolAllocBatch(&mp1, objs, MEMORY_POOL_SIZE + 1) == MEMORY_POOL_SIZE, "wrong count");
+  }
+  test_end_step(2);
+
+  /* [7.6.3] Now must be empty.*/
+  test_set_step(3);
+  {
+    test_assert(chPoolAllocBatch(&mp1, objs, 1) == 0U, "list not empty");
+  }
+  test_end_step(3);
+
+  /* [7.6.4] Returning the objects using chPoolFreeBatch() then emptying
+     the pool again.*/
+  test_set_step(4);
+  {
+    chPoolFreeBatch(&mp1, objs, MEMORY_POOL_SIZE);
+    test_assert(chPoolAllocBatch(&mp1, objs, MEMORY_POOL_SIZE) == MEMORY_POOL_SIZE, "wrong count");
+    test_assert(chPoolAlloc(&mp1) == NULL, "list not empty");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_007_006 = {
+  "Batch allocation and release",
+  oslib_test_007_006_setup,
+  NULL,
+  oslib_test_007_006_execute
+};
+
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_007_007 [7.7] Guarded Memory Pools batch allocation and release
+ *
+ * <h2>Description</h2>
+ * Objects are allocated from and released into a guarded memory pool in
+ * batches, a batch allocation must either get all the objects or none.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.7.1] Adding the objects to the pool using
+ *   chGuardedPoolFreeBatch().
+ * - [7.7.2] Allocating half of the objects using
+ *   chGuardedPoolAllocBatchTimeout().
+ * - [7.7.3] Trying to allocate all the objects with 100mS timeout, must
+ *   fail and leave the pool unchanged.
+ * - [7.7.4] Allocating the remaining objects without waiting using
+ *   chGuardedPoolAllocBatchI(), requesting more objects than available.
+ * - [7.7.5] Returning all the objects using chGuardedPoolFreeBatch().
+ * .
+ */
+
+static void oslib_test_007_007_setup(void) {
+  chGuardedPoolObjectInit(&gmp1, sizeof (void *));
+}
+
+static void oslib_test_007_007_execute(void) {
+  void *objs[MEMORY_POOL_SIZE];
+
+  /* [7.7.1] Adding the objects to the pool using
+     chGuardedPoolFreeBatch().*/
+  test_set_step(1);
+  {
+    unsigned i;
+
+    for (i = 0; i < MEMORY_POOL_SIZE; i++)
+      objs[i] = &objects[i];
+    chGuardedPoolFreeBatch(&gmp1, objs, MEMORY_POOL_SIZE);
+    test_assert_lock(chGuardedPoolGetCounterI(&gmp1) == (cnt_t)MEMORY_POOL_SIZE, "counter out of sync");
+  }
+  test_end_step(1);
+
+  /* [7.7.2] Allocating half of the objects using
+     chGuardedPoolAllocBatchTimeout().*/
+  test_set_step(2);
+  {
+    msg_t msg = chGuardedPoolAllocBatchTimeout(&gmp1, objs, MEMORY_POOL_SIZE / 2, TIME_IMMEDIATE);
+    test_assert(msg == MSG_OK, "allocation failed");
+  }
+  test_end_step(2);
+
+  /* [7.7.3] Trying to allocate all the objects with 100mS timeout, must
+     fail and leave the pool unchanged.*/
+  test_set_step(3);
+  {
+    msg_t msg = chGuardedPoolAllocBatchTimeout(&gmp1, &objs[MEMORY_POOL_SIZE / 2], MEMORY_POOL_SIZE, TIME_MS2I(100));
+    test_assert(msg == MSG_TIMEOUT, "allocation not failed");
+    test_assert_lock(chGuardedPoolGetCounterI(&gmp1) == (cnt_t)(MEMORY_POOL_SIZE / 2), "counter out of sync");
+  }
+  test_end_step(3);
+
+  /* [7.7.4] Allocating the remaining objects without waiting using
+     chGuardedPoolAllocBatchI(), requesting more objects than available.*/
+  test_set_step(4);
+  {
+    size_t n;
+
+    chSysLock();
+    n = chGuardedPoolAllocBatchI(&gmp1, &objs[MEMORY_POOL_SIZE / 2], MEMORY_POOL_SIZE);
+    chSysUnlock();
+    test_assert(n == MEMORY_POOL_SIZE - (MEMORY_POOL_SIZE / 2), "wrong count");
+    test_assert_lock(chGuardedPoolGetCounterI(&gmp1) == (cnt_t)0, "counter out of sync");
+  }
+  test_end_step(4);
+
+  /* [7.7.5] Returning all the objects using chGuardedPoolFreeBatch().*/
+  test_set_step(5);
+  {
+    chGuardedPoolFreeBatch(&gmp1, objs, MEMORY_POOL_SIZE);
+    test_assert_lock(chGuardedPoolGetCounterI(&gmp1) == (cnt_t)MEMORY_POOL_SIZE, "counter out of sync");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_007_007 = {
+  "Guarded Memory Pools batch allocation and release",
+  oslib_test_007_007_setup,
+  NULL,
+  oslib_test_007_007_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES */
+
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_007_008 [7.8] Guarded Memory Pools batch allocation while waiting
+ *
+ * <h2>Description</h2>
+ * A thread waits for a batch of objects while the objects are returned
+ * one at time, the waiting thread must not hold any object until the
+ * whole batch is available.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.8.1] Adding the objects to the pool then allocating all of them
+ *   using chGuardedPoolAllocBatchI().
+ * - [7.8.2] Starting a thread waiting for half of the objects.
+ * - [7.8.3] Returning one object less than the batch size, the object
+ *   must stay in the pool.
+ * - [7.8.4] Returning one more object, the waiting thread must get the
+ *   whole batch.
+ * - [7.8.5] Returning all the objects.
+ * .
+ */
+
+static void oslib_test_007_008_setup(void) {
+  chGuardedPoolObjectInit(&gmp1, sizeof (void *));
+}
+
+static void oslib_test_007_008_execute(void) {
+  void *objs[MEMORY_POOL_SIZE];
+
+  /* [7.8.1] Adding the objects to the pool then allocating all of them
+     using chGuardedPoolAllocBatchI().*/
+  test_set_step(1);
+  {
+    unsigned i;
+    size_t n;
+
+    for (i = 0; i < MEMORY_POOL_SIZE; i++)
+      objs[i] = &objects[i];
+    chGuardedPoolFreeBatch(&gmp1, objs, MEMORY_POOL_SIZE);
+    chSysLock();
+    n = chGuardedPoolAllocBatchI(&gmp1, objs, MEMORY_POOL_SIZE);
+    chSysUnlock();
+    test_assert(n == MEMORY_POOL_SIZE, "wrong count");
+  }
+  test_end_step(1);
+
+  /* [7.8.2] Starting a thread waiting for half of the objects.*/
+  test_set_step(2);
+  {
+    thread_descriptor_t td = {
+      .name  = "batch",
+      .wbase = waBatchThread,
+      .wend  = THD_WORKING_AREA_END(waBatchThread),
+      .prio  = chThdGetPriorityX() + 1,
+      .funcp = BatchThread,
+      .arg   = NULL
+    };
+    batch_msg = MSG_RESET;
+    (void) chThdCreate(&td);
+  }
+  test_end_step(2);
+
+  /* [7.8.3] Returning one object less than the batch size, the object
+     must stay in the pool.*/
+  test_set_step(3);
+  {
+    unsigned i;
+
+    for (i = 0; i < (MEMORY_POOL_SIZE / 2) - 1; i++)
+      chGuardedPoolFree(&gmp1, objs[i]);
+    test_assert(batch_msg == MSG_RESET, "batch allocated");
+    test_assert_lock(chGuardedPoolGetCounterI(&gmp1) == (cnt_t)((MEMORY_POOL_SIZE / 2) - 1), "object held by the waiting thread");
+  }
+  test_end_step(3);
+
+  /* [7.8.4] Returning one more object, the waiting thread must get the
+     whole batch.*/
+  test_set_step(4);
+  {
+    chGuardedPoolFree(&gmp1, objs[(MEMORY_POOL_SIZE / 2) - 1]);
+    test_assert(batch_msg == MSG_OK, "batch not allocated");
+    test_assert_lock(chGuardedPoolGetCounterI(&gmp1) == (cnt_t)0, "counter out of sync");
+  }
+  test_end_step(4);
+
+  /* [7.8.5] Returning all the objects.*/
+  test_set_step(5);
+  {
+    chGuardedPoolFreeBatch(&gmp1, batch_objs, MEMORY_POOL_SIZE / 2);
+    chGuardedPoolFreeBatch(&gmp1, &objs[MEMORY_POOL_SIZE / 2], MEMORY_POOL_SIZE - (MEMORY_POOL_SIZE / 2));
+    test_assert_lock(chGuardedPoolGetCounterI(&gmp1) == (cnt_t)MEMORY_POOL_SIZE, "counter out of sync");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_007_008 = {
+  "Guarded Memory Pools batch allocation while waiting",
+  oslib_test_007_008_setup,
+  NULL,
+  oslib_test_007_008_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -302,6 +767,17 @@ const testcase_t * const oslib_test_sequence_007_array[] = {
 #endif
 #if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
   &oslib_test_007_003,
+#endif
+  &oslib_test_007_004,
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+  &oslib_test_007_005,
+#endif
+  &oslib_test_007_006,
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+  &oslib_test_007_007,
+#endif
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+  &oslib_test_007_008,
 #endif
   NULL
 };
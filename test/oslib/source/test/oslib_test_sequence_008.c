@@ -38,6 +38,8 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_008_001
  * - @subpage oslib_test_008_002
+ * - @subpage oslib_test_008_003
+ * - @subpage oslib_test_008_004
  * .
  */
 
@@ -48,11 +50,16 @@
  ****************************************************************************/
 
 #define ALLOC_SIZE 16
-#define HEAP_SIZE (ALLOC_SIZE * 8)
+#define HEAP_SIZE (ALLOC_SIZE * 16)
 
 static memory_heap_t test_heap;
 static uint8_t test_heap_buffer[HEAP_SIZE];
 
+#define BMK_HEAP_SIZE 2048
+#define BMK_SLOTS 16
+
+static uint8_t test_bmk_buffer[BMK_HEAP_SIZE];
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -268,6 +275,213 @@ static const testcase_t oslib_test_008_002 = {
   oslib_test_008_002_execute
 };
 
+/**
+ * @page oslib_test_008_003 [8.3] Allocation performance
+ *
+ * <h2>Description</h2>
+ * A pseudo-random sequence of allocations and releases of blocks of
+ * variable size is performed on a dedicated heap for one second, the
+ * heap is progressively fragmented. The number of operations and the
+ * final heap fragmentation are printed, the allocator is reported so
+ * that first-fit and TLSF builds can be compared.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.3.1] Clearing the slots array.
+ * - [8.3.2] Allocating or freeing a block of pseudo-random size in a
+ *   random slot for one second, then the heap fragmentation is
+ *   measured.
+ * - [8.3.3] Allocator, score and fragmentation are printed.
+ * - [8.3.4] Releasing all blocks, the heap must not be fragmented.
+ * .
+ */
+
+static void oslib_test_008_003_setup(void) {
+  chHeapObjectInit(&test_heap, test_bmk_buffer, sizeof(test_bmk_buffer));
+}
+
+static void oslib_test_008_003_execute(void) {
+  void *slots[BMK_SLOTS];
+  uint32_t seed, n;
+  size_t frags, total, largest;
+  unsigned i;
+
+  /* [8.3.1] Clearing the slots array.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < BMK_SLOTS; i++) {
+      slots[i] = NULL;
+    }
+    seed = 1U;
+    n = 0U;
+  }
+  test_end_step(1);
+
+  /* [8.3.2] Allocating or freeing a block of pseudo-random size in a
+     random slot for one second, then the heap fragmentation is
+     measured.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    start = chVTGetSystemTimeX();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      seed = (seed * 1103515245U) + 12345U;
+      i = (unsigned)(seed >> 16) % BMK_SLOTS;
+      if (slots[i] != NULL) {
+        chHeapFree(slots[i]);
+        slots[i] = NULL;
+      }
+      else {
+        slots[i] = chHeapAlloc(&test_heap, ((size_t)(seed >> 8) & 0x3FU) + 1U);
+      }
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    frags = chHeapStatus(&test_heap, &total, &largest);
+  }
+  test_end_step(2);
+
+  /* [8.3.3] Allocator, score and fragmentation are printed.*/
+  test_set_step(3);
+  {
+    #if CH_CFG_USE_HEAP_TLSF == TRUE
+    test_println("--- Alloc.: TLSF");
+#else
+    test_println("--- Alloc.: first-fit");
+#endif
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" allocs+frees/S");
+    test_print("--- Frags : ");
+    test_printn((uint32_t)frags);
+    test_print(" fragments, ");
+    test_printn((uint32_t)largest);
+    test_print("/");
+    test_printn((uint32_t)total);
+    test_println(" largest/free bytes");
+    test_print("--- Frag. : ");
+    test_printn(total > 0U ? (uint32_t)(100U - ((largest * 100U) / total)) : 0U);
+    test_println("% of the free space");
+  }
+  test_end_step(3);
+
+  /* [8.3.4] Releasing all blocks, the heap must not be fragmented.*/
+  test_set_step(4);
+  {
+    for (i = 0; i < BMK_SLOTS; i++) {
+      if (slots[i] != NULL) {
+        chHeapFree(slots[i]);
+      }
+    }
+    test_assert(chHeapStatus(&test_heap, NULL, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_008_003 = {
+  "Allocation performance",
+  oslib_test_008_003_setup,
+  NULL,
+  oslib_test_008_003_execute
+};
+
+/**
+ * @page oslib_test_008_004 [8.4] Provider-backed blocks
+ *
+ * <h2>Description</h2>
+ * Blocks obtained from the core allocator through the default heap
+ * provider are allocated around a block allocated directly from the
+ * core allocator. The blocks are released and the core block must not
+ * be affected by the heap.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.4.1] Allocating a block larger than the largest free block of
+ *   the default heap, the block is obtained through the provider.
+ * - [8.4.2] Allocating a block directly from the core allocator and
+ *   filling it with a pattern.
+ * - [8.4.3] Allocating a second block through the provider, both heap
+ *   blocks are then written entirely and released.
+ * - [8.4.4] The core block must not have been modified.
+ * - [8.4.5] Allocating again a block of the same size, one of the
+ *   released blocks must be reused.
+ * .
+ */
+
+static void oslib_test_008_004_execute(void) {
+  uint8_t *p1, *p2, *cp;
+  size_t largest, n;
+  unsigned i;
+
+  /* [8.4.1] Allocating a block larger than the largest free block of
+     the default heap, the block is obtained through the provider.*/
+  test_set_step(1);
+  {
+    (void)chHeapStatus(NULL, NULL, &largest);
+    n = largest + 64U;
+    p1 = chHeapAlloc(NULL, n);
+    test_assert(p1 != NULL, "allocation failed");
+  }
+  test_end_step(1);
+
+  /* [8.4.2] Allocating a block directly from the core allocator and
+     filling it with a pattern.*/
+  test_set_step(2);
+  {
+    cp = chCoreAlloc(64U);
+    test_assert(cp != NULL, "allocation failed");
+    for (i = 0U; i < 64U; i++) {
+      cp[i] = 0x55U;
+    }
+  }
+  test_end_step(2);
+
+  /* [8.4.3] Allocating a second block through the provider, both heap
+     blocks are then written entirely and released.*/
+  test_set_step(3);
+  {
+    p2 = chHeapAlloc(NULL, n);
+    test_assert(p2 != NULL, "allocation failed");
+    for (i = 0U; i < n; i++) {
+      p1[i] = 0xAAU;
+      p2[i] = 0xAAU;
+    }
+    chHeapFree(p1);
+    chHeapFree(p2);
+  }
+  test_end_step(3);
+
+  /* [8.4.4] The core block must not have been modified.*/
+  test_set_step(4);
+  {
+    for (i = 0U; i < 64U; i++) {
+      test_assert(cp[i] == 0x55U, "core block corrupted");
+    }
+  }
+  test_end_step(4);
+
+  /* [8.4.5] Allocating again a block of the same size, one of the
+     released blocks must be reused.*/
+  test_set_step(5);
+  {
+    uint8_t *p3;
+
+    p3 = chHeapAlloc(NULL, n);
+    test_assert((p3 == p1) || (p3 == p2), "released block not reused");
+    chHeapFree(p3);
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_008_004 = {
+  "Provider-backed blocks",
+  NULL,
+  NULL,
+  oslib_test_008_004_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -278,6 +492,8 @@ static const testcase_t oslib_test_008_002 = {
 const testcase_t * const oslib_test_sequence_008_array[] = {
   &oslib_test_008_001,
   &oslib_test_008_002,
+  &oslib_test_008_003,
+  &oslib_test_008_004,
   NULL
 };
 
@@ -42,6 +42,7 @@
  * - @subpage oslib_test_009_004
  * - @subpage oslib_test_009_005
  * - @subpage oslib_test_009_006
+ * - @subpage oslib_test_009_007
  * .
  */
 
@@ -51,6 +52,7 @@
  * Shared code.
  ****************************************************************************/
 
+#define REGISTRY_OBJECTS 16
 
 /****************************************************************************
  * Test cases.
@@ -777,6 +779,103 @@ static const testcase_t oslib_test_009_006 = {
 };
 #endif /* CH_CFG_FACTORY_PIPES == TRUE */
 
+#if (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_009_007 [9.7] Objects Registry lookups
+ *
+ * <h2>Description</h2>
+ * This test case verifies lookups by name and by pointer in a registry
+ * containing many objects.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [9.7.1] Registering many objects with different names, must
+ *   succeed.
+ * - [9.7.2] Retrieving each object by name and by pointer, the
+ *   references must match, then releasing the acquired references.
+ * - [9.7.3] Releasing the objects, they must not be found anymore by
+ *   name nor by pointer.
+ * .
+ */
+
+static void oslib_test_009_007_execute(void) {
+  static uint32_t objects[REGISTRY_OBJECTS];
+  registered_object_t *rops[REGISTRY_OBJECTS];
+  char name[6];
+  unsigned i;
+
+  /* [9.7.1] Registering many objects with different names, must
+     succeed.*/
+  test_set_step(1);
+  {
+    for (i = 0U; i < REGISTRY_OBJECTS; i++) {
+      name[0] = 'o';
+      name[1] = 'b';
+      name[2] = 'j';
+      name[3] = (char)('0' + (i / 10U));
+      name[4] = (char)('0' + (i % 10U));
+      name[5] = '\0';
+      rops[i] = chFactoryRegisterObject(name, (void *)&objects[i]);
+      test_assert(rops[i] != NULL, "cannot register");
+    }
+  }
+  test_end_step(1);
+
+  /* [9.7.2] Retrieving each object by name and by pointer, the
+     references must match, then releasing the acquired references.*/
+  test_set_step(2);
+  {
+    for (i = 0U; i < REGISTRY_OBJECTS; i++) {
+      registered_object_t *rop;
+
+      name[0] = 'o';
+      name[1] = 'b';
+      name[2] = 'j';
+      name[3] = (char)('0' + (i / 10U));
+      name[4] = (char)('0' + (i % 10U));
+      name[5] = '\0';
+      rop = chFactoryFindObject(name);
+      test_assert(rop == rops[i], "wrong object");
+      chFactoryReleaseObject(rop);
+      rop = chFactoryFindObjectByPointer((void *)&objects[i]);
+      test_assert(rop == rops[i], "wrong object");
+      chFactoryReleaseObject(rop);
+    }
+  }
+  test_end_step(2);
+
+  /* [9.7.3] Releasing the objects, they must not be found anymore by
+     name nor by pointer.*/
+  test_set_step(3);
+  {
+    for (i = 0U; i < REGISTRY_OBJECTS; i++) {
+      name[0] = 'o';
+      name[1] = 'b';
+      name[2] = 'j';
+      name[3] = (char)('0' + (i / 10U));
+      name[4] = (char)('0' + (i % 10U));
+      name[5] = '\0';
+      chFactoryReleaseObject(rops[i]);
+      test_assert(chFactoryFindObject(name) == NULL, "found");
+      test_assert(chFactoryFindObjectByPointer((void *)&objects[i]) == NULL, "found");
+    }
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_009_007 = {
+  "Objects Registry lookups",
+  NULL,
+  NULL,
+  oslib_test_009_007_execute
+};
+#endif /* CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -802,6 +901,9 @@ const testcase_t * const oslib_test_sequence_009_array[] = {
 #endif
 #if (CH_CFG_FACTORY_PIPES == TRUE) || defined(__DOXYGEN__)
   &oslib_test_009_006,
+#endif
+#if (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_009_007,
 #endif
   NULL
 };
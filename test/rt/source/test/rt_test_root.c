@@ -32,6 +32,7 @@
  * - @subpage rt_test_sequence_009
  * - @subpage rt_test_sequence_010
  * - @subpage rt_test_sequence_011
+ * - @subpage rt_test_sequence_012
  * .
  */
 
@@ -74,6 +75,9 @@ const testsequence_t * const rt_test_suite_array[] = {
   &rt_test_sequence_010,
 #endif
   &rt_test_sequence_011,
+#if (CH_CFG_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+  &rt_test_sequence_012,
+#endif
   NULL
 };
 
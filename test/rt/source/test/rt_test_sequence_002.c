@@ -36,6 +36,7 @@
  * - @subpage rt_test_002_001
  * - @subpage rt_test_002_002
  * - @subpage rt_test_002_003
+ * - @subpage rt_test_002_004
  * .
  */
 
@@ -60,6 +61,50 @@ static void vtcb(void *p) {
   chSysUnlockFromISR();
 }
 
+#if (CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) &&                  \
+    (CH_DBG_TRACE_STREAM == TRUE)
+static uint8_t tsbuf[8 * CH_TRACE_STREAM_RECORD_SIZE];
+
+/* Sink counting the drained bytes.*/
+static size_t trace_sink(void *obj, const uint8_t *bp, size_t n) {
+
+  (void)bp;
+  *(size_t *)obj += n;
+
+  return n;
+}
+
+/* Decodes a variable length integer.*/
+static const uint8_t *trace_get_varint(const uint8_t *p, uintptr_t *vp) {
+  uintptr_t v = 0U;
+  unsigned shift = 0U;
+
+  do {
+    v |= (uintptr_t)(*p & 0x7FU) << shift;
+    shift += 7U;
+  } while ((*p++ & 0x80U) != 0U);
+  *vp = v;
+
+  return p;
+}
+
+/* Decodes an user or drop record returning its first parameter.*/
+static const uint8_t *trace_decode(const uint8_t *p,
+                                   unsigned *typep, uintptr_t *argp) {
+  uintptr_t dummy;
+
+  *typep = (unsigned)*p++ & 7U;
+  p = trace_get_varint(p, &dummy);
+  p = trace_get_varint(p, &dummy);
+  p = trace_get_varint(p, argp);
+  if (*typep == CH_TRACE_TYPE_USER) {
+    p = trace_get_varint(p, &dummy);
+  }
+
+  return p;
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -240,6 +285,126 @@ static const testcase_t rt_test_002_003 = {
   rt_test_002_003_execute
 };
 
+#if ((CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) && (CH_DBG_TRACE_STREAM == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_002_004 [2.4] Trace stream functionality
+ *
+ * <h2>Description</h2>
+ * The streaming trace FIFO is drained, user records are written and
+ * read back in encoded form, records exceeding the FIFO capacity are
+ * discarded and reported by a drop record.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) &&
+ *   (CH_DBG_TRACE_STREAM == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [2.4.1] Suspending all trace sources except user records then
+ *   draining the FIFO into a sink, the FIFO must be empty after the
+ *   operation.
+ * - [2.4.2] Writing an user record and reading it back.
+ * - [2.4.3] Writing more records than the FIFO capacity, the records in
+ *   excess must be discarded and the records in the FIFO must be read
+ *   back in order.
+ * - [2.4.4] Writing a new record, a drop record must precede it in the
+ *   stream.
+ * .
+ */
+
+static void rt_test_002_004_teardown(void) {
+  chDbgResumeTrace(CH_DBG_TRACE_MASK);
+}
+
+static void rt_test_002_004_execute(void) {
+  size_t n, total;
+  unsigned i, type;
+  uintptr_t arg;
+  ucnt_t drops;
+  const uint8_t *p;
+
+  /* [2.4.1] Suspending all trace sources except user records then
+     draining the FIFO into a sink, the FIFO must be empty after the
+     operation.*/
+  test_set_step(1);
+  {
+    chDbgSuspendTrace((uint16_t)~CH_DBG_TRACE_MASK_USER);
+    total = 0U;
+    (void) chDbgDrainTrace(trace_sink, &total);
+    n = chDbgReadTrace(tsbuf, sizeof (tsbuf));
+    test_assert(n == 0U, "FIFO not empty");
+  }
+  test_end_step(1);
+
+  /* [2.4.2] Writing an user record and reading it back.*/
+  test_set_step(2);
+  {
+    chDbgWriteTrace((void *)0x1234, (void *)5);
+    n = chDbgReadTrace(tsbuf, sizeof (tsbuf));
+    test_assert(n > 0U, "no data");
+    p = trace_decode(tsbuf, &type, &arg);
+    if (type == CH_TRACE_TYPE_DROP) {
+      /* Losses from previous tests.*/
+      p = trace_decode(p, &type, &arg);
+    }
+    test_assert(type == CH_TRACE_TYPE_USER, "wrong record type");
+    test_assert(arg == (uintptr_t)0x1234, "wrong parameter");
+    test_assert(p == &tsbuf[n], "wrong record size");
+  }
+  test_end_step(2);
+
+  /* [2.4.3] Writing more records than the FIFO capacity, the records in
+     excess must be discarded and the records in the FIFO must be read
+     back in order.*/
+  test_set_step(3);
+  {
+    drops = chDbgGetTraceDropsX();
+    for (i = 0U; i < (unsigned)CH_DBG_TRACE_BUFFER_SIZE + 10U; i++) {
+      chDbgWriteTrace((void *)(uintptr_t)i, NULL);
+    }
+    test_assert(chDbgGetTraceDropsX() - drops == 11U, "wrong drops count");
+    i = 0U;
+    while ((n = chDbgReadTrace(tsbuf, sizeof (tsbuf))) > 0U) {
+      p = tsbuf;
+      while (p < &tsbuf[n]) {
+        p = trace_decode(p, &type, &arg);
+        test_assert(type == CH_TRACE_TYPE_USER, "wrong record type");
+        test_assert(arg == (uintptr_t)i, "wrong order");
+        i++;
+      }
+    }
+    test_assert(i == (unsigned)CH_DBG_TRACE_BUFFER_SIZE - 1U,
+                "wrong records count");
+  }
+  test_end_step(3);
+
+  /* [2.4.4] Writing a new record, a drop record must precede it in the
+     stream.*/
+  test_set_step(4);
+  {
+    chDbgWriteTrace((void *)0x55, NULL);
+    n = chDbgReadTrace(tsbuf, sizeof (tsbuf));
+    p = trace_decode(tsbuf, &type, &arg);
+    test_assert(type == CH_TRACE_TYPE_DROP, "missing drop record");
+    test_assert(arg == (uintptr_t)11, "wrong lost records count");
+    p = trace_decode(p, &type, &arg);
+    test_assert(type == CH_TRACE_TYPE_USER, "wrong record type");
+    test_assert(arg == (uintptr_t)0x55, "wrong parameter");
+    test_assert(p == &tsbuf[n], "unexpected data");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_002_004 = {
+  "Trace stream functionality",
+  NULL,
+  rt_test_002_004_teardown,
+  rt_test_002_004_execute
+};
+#endif /* (CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) && (CH_DBG_TRACE_STREAM == TRUE) */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -251,6 +416,9 @@ const testcase_t * const rt_test_sequence_002_array[] = {
   &rt_test_002_001,
   &rt_test_002_002,
   &rt_test_002_003,
+#if ((CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) && (CH_DBG_TRACE_STREAM == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_002_004,
+#endif
   NULL
 };
 
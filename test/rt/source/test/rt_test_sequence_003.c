@@ -32,6 +32,7 @@
  * <h2>Test Cases</h2>
  * - @subpage rt_test_003_001
  * - @subpage rt_test_003_002
+ * - @subpage rt_test_003_003
  * .
  */
 
@@ -41,6 +42,19 @@
 
 #include "ch.h"
 
+#if (CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAMS == TRUE)
+static tm_histogram_t tmh1, tmh2;
+
+/* Checks a percentile against its exact value, the error must be within
+   the histogram precision.*/
+static bool tmh_check(const tm_histogram_t *hp, uint32_t ppm, rtcnt_t exact) {
+  rtcnt_t p = chTMHistogramGetPercentileX(hp, ppm);
+
+  return (p >= exact) &&
+         (p <= exact + (exact / (rtcnt_t)CH_TM_HISTOGRAM_SUB_BUCKETS));
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -153,6 +167,115 @@ static const testcase_t rt_test_003_002 = {
   rt_test_003_002_execute
 };
 
+#if ((CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAMS == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_003_003 [3.3] Time measurement histograms
+ *
+ * <h2>Description</h2>
+ * Known values are recorded in histograms, percentiles, merge and reset
+ * operations are tested.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAMS == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] Recording the values from 1 to 1000, the percentiles must
+ *   be within the histogram precision.
+ * - [3.3.2] Resetting the histogram then recording small values, small
+ *   values must be reported exactly.
+ * - [3.3.3] Merging two histograms, the result must be equal to an
+ *   histogram containing all the values.
+ * - [3.3.4] Performing a measurement, it must be recorded in the
+ *   histogram.
+ * .
+ */
+
+static void rt_test_003_003_execute(void) {
+  rtcnt_t i;
+
+  /* [3.3.1] Recording the values from 1 to 1000, the percentiles must
+     be within the histogram precision.*/
+  test_set_step(1);
+  {
+    chTMHistogramObjectInit(&tmh1);
+    for (i = 1U; i <= 1000U; i++) {
+      chTMHistogramAddX(&tmh1, i);
+    }
+    test_assert(tmh1.tm.n == 1000U, "wrong count");
+    test_assert(tmh1.tm.best == 1U, "wrong best value");
+    test_assert(tmh1.tm.worst == 1000U, "wrong worst value");
+    test_assert(tmh_check(&tmh1, 500000U, 500U), "wrong 50th percentile");
+    test_assert(tmh_check(&tmh1, 990000U, 990U), "wrong 99th percentile");
+    test_assert(tmh_check(&tmh1, 999000U, 999U), "wrong 99.9th percentile");
+    test_assert(chTMHistogramGetPercentileX(&tmh1, 1000000U) == 1000U,
+                "wrong maximum");
+  }
+  test_end_step(1);
+
+  /* [3.3.2] Resetting the histogram then recording small values, small
+     values must be reported exactly.*/
+  test_set_step(2);
+  {
+    chTMHistogramResetX(&tmh1);
+    test_assert(tmh1.tm.n == 0U, "not reset");
+    test_assert(chTMHistogramGetPercentileX(&tmh1, 500000U) == 0U,
+                "not empty");
+    for (i = 0U; i < 4U; i++) {
+      chTMHistogramAddX(&tmh1, i);
+    }
+    test_assert(chTMHistogramGetPercentileX(&tmh1, 250000U) == 0U,
+                "wrong 25th percentile");
+    test_assert(chTMHistogramGetPercentileX(&tmh1, 750000U) == 2U,
+                "wrong 75th percentile");
+    test_assert(chTMHistogramGetPercentileX(&tmh1, 1000000U) == 3U,
+                "wrong maximum");
+  }
+  test_end_step(2);
+
+  /* [3.3.3] Merging two histograms, the result must be equal to an
+     histogram containing all the values.*/
+  test_set_step(3);
+  {
+    chTMHistogramResetX(&tmh1);
+    chTMHistogramObjectInit(&tmh2);
+    for (i = 1U; i <= 500U; i++) {
+      chTMHistogramAddX(&tmh1, i);
+      chTMHistogramAddX(&tmh2, i + 500U);
+    }
+    chTMHistogramMergeX(&tmh1, &tmh2);
+    test_assert(tmh1.tm.n == 1000U, "wrong count");
+    test_assert(tmh1.tm.best == 1U, "wrong best value");
+    test_assert(tmh1.tm.worst == 1000U, "wrong worst value");
+    test_assert(tmh_check(&tmh1, 500000U, 500U), "wrong 50th percentile");
+    test_assert(tmh_check(&tmh1, 990000U, 990U), "wrong 99th percentile");
+  }
+  test_end_step(3);
+
+  /* [3.3.4] Performing a measurement, it must be recorded in the
+     histogram.*/
+  test_set_step(4);
+  {
+    chTMHistogramResetX(&tmh1);
+    chTMHistogramStartX(&tmh1);
+    chTMHistogramStopX(&tmh1);
+    test_assert(tmh1.tm.n == 1U, "not recorded");
+    test_assert(chTMHistogramGetPercentileX(&tmh1, 1000000U) == tmh1.tm.last,
+                "wrong maximum");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_003_003 = {
+  "Time measurement histograms",
+  NULL,
+  NULL,
+  rt_test_003_003_execute
+};
+#endif /* (CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAMS == TRUE) */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -163,6 +286,9 @@ static const testcase_t rt_test_003_002 = {
 const testcase_t * const rt_test_sequence_003_array[] = {
   &rt_test_003_001,
   &rt_test_003_002,
+#if ((CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAMS == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_003_003,
+#endif
   NULL
 };
 
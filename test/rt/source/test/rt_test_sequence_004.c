@@ -34,6 +34,7 @@
  * - @subpage rt_test_004_002
  * - @subpage rt_test_004_003
  * - @subpage rt_test_004_004
+ * - @subpage rt_test_004_005
  * .
  */
 
@@ -46,6 +47,14 @@ static THD_FUNCTION(thread, p) {
   test_emit_token(*(char *)p);
 }
 
+#if (CH_DBG_STATISTICS == TRUE) && (CH_CFG_USE_REGISTRY == TRUE)
+static THD_FUNCTION(thread_stats, p) {
+
+  (void)p;
+  chThdSleepMilliseconds(10);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -339,6 +348,82 @@ static const testcase_t rt_test_004_004 = {
 };
 #endif /* CH_CFG_USE_MUTEXES */
 
+#if ((CH_DBG_STATISTICS == TRUE) && (CH_CFG_USE_REGISTRY == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_004_005 [4.5] Threads statistics
+ *
+ * <h2>Description</h2>
+ * A thread with higher priority is created, it sleeps once then
+ * terminates. The statistics of the thread are checked after each
+ * switch, the switch-ins count is expected to increase by one each time
+ * the thread is scheduled.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_DBG_STATISTICS == TRUE) && (CH_CFG_USE_REGISTRY == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.5.1] Creating a thread with higher priority, it runs immediately
+ *   then sleeps. The thread is expected to have been switched in once.
+ * - [4.5.2] Waiting for the thread to wake up and terminate. The thread
+ *   is expected to have been switched in twice and to have used only
+ *   part of its stack.
+ * - [4.5.3] Checking the statistics of the current thread, it is
+ *   expected to have been switched in at least once.
+ * .
+ */
+
+static void rt_test_004_005_execute(void) {
+  thread_stats_t ts;
+
+  /* [4.5.1] Creating a thread with higher priority, it runs immediately
+     then sleeps. The thread is expected to have been switched in once.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   thread_stats, NULL);
+    chRegGetThreadStatsX(threads[0], &ts);
+    test_assert(ts.n_switches == 1U, "wrong switch-ins count");
+  }
+  test_end_step(1);
+
+  /* [4.5.2] Waiting for the thread to wake up and terminate. The thread
+     is expected to have been switched in twice and to have used only
+     part of its stack.*/
+  test_set_step(2);
+  {
+    chThdSleepMilliseconds(50);
+    chRegGetThreadStatsX(threads[0], &ts);
+    test_assert(ts.n_switches == 2U, "wrong switch-ins count");
+    test_assert(ts.cumulative >= (rttime_t)ts.worst_run, "wrong run time");
+#if CH_DBG_FILL_THREADS == TRUE
+    test_assert((ts.stack_unused > 0U) && (ts.stack_unused < WA_SIZE),
+                "wrong unused stack");
+#endif
+    test_wait_threads();
+  }
+  test_end_step(2);
+
+  /* [4.5.3] Checking the statistics of the current thread, it is
+     expected to have been switched in at least once.*/
+  test_set_step(3);
+  {
+    chRegGetThreadStatsX(chThdGetSelfX(), &ts);
+    test_assert(ts.n_switches > 0U, "wrong switch-ins count");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_004_005 = {
+  "Threads statistics",
+  NULL,
+  NULL,
+  rt_test_004_005_execute
+};
+#endif /* (CH_DBG_STATISTICS == TRUE) && (CH_CFG_USE_REGISTRY == TRUE) */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -352,6 +437,9 @@ const testcase_t * const rt_test_sequence_004_array[] = {
   &rt_test_004_003,
 #if (CH_CFG_USE_MUTEXES) || defined(__DOXYGEN__)
   &rt_test_004_004,
+#endif
+#if ((CH_DBG_STATISTICS == TRUE) && (CH_CFG_USE_REGISTRY == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_004_005,
 #endif
   NULL
 };
@@ -45,6 +45,9 @@
  * - @subpage rt_test_007_007
  * - @subpage rt_test_007_008
  * - @subpage rt_test_007_009
+ * - @subpage rt_test_007_010
+ * - @subpage rt_test_007_011
+ * - @subpage rt_test_007_012
  * .
  */
 
@@ -228,6 +231,59 @@ static THD_FUNCTION(thread9, p) {
 }
 #endif /* CH_CFG_USE_CONDVARS */
 
+#if CH_CFG_USE_RWLOCKS || defined(__DOXYGEN__)
+static RWLOCK_DECL(rw1);
+
+static THD_FUNCTION(rwreader, p) {
+  rwlock_reader_t rd;
+
+  chRWLockReadLock(&rw1, &rd);
+  test_emit_token(*(char *)p);
+  chRWLockReadUnlock(&rw1, &rd);
+}
+
+static THD_FUNCTION(rwwriter, p) {
+
+  chRWLockWriteLock(&rw1);
+  test_emit_token(*(char *)p);
+  chRWLockWriteUnlock(&rw1);
+}
+
+#if CH_DBG_THREADS_PROFILING || defined(__DOXYGEN__)
+/* Low priority reader */
+static THD_FUNCTION(rwthreadL, p) {
+  rwlock_reader_t rd;
+
+  (void)p;
+  chRWLockReadLock(&rw1, &rd);
+  test_cpu_pulse(40);
+  chRWLockReadUnlock(&rw1, &rd);
+  test_cpu_pulse(10);
+  test_emit_token('C');
+}
+
+/* Medium priority thread */
+static THD_FUNCTION(rwthreadM, p) {
+
+  (void)p;
+  chThdSleepMilliseconds(20);
+  test_cpu_pulse(40);
+  test_emit_token('B');
+}
+
+/* High priority writer */
+static THD_FUNCTION(rwthreadH, p) {
+
+  (void)p;
+  chThdSleepMilliseconds(40);
+  chRWLockWriteLock(&rw1);
+  test_cpu_pulse(10);
+  chRWLockWriteUnlock(&rw1);
+  test_emit_token('A');
+}
+#endif /* CH_DBG_THREADS_PROFILING */
+#endif /* CH_CFG_USE_RWLOCKS */
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -1078,6 +1134,259 @@ static const testcase_t rt_test_007_009 = {
 };
 #endif /* CH_CFG_USE_CONDVARS */
 
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_007_010 [7.10] Readers-writer locks, readers and writers ordering
+ *
+ * <h2>Description</h2>
+ * The test thread holds the read lock while other readers and writers
+ * ask for the lock. Readers must enter while there are no writers, a
+ * waiting writer must block the new readers and must inherit their
+ * priority, the readers must inherit the priority of the waiting
+ * writer.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.10.1] Getting the current priority and acquiring the read lock,
+ *   a reader with higher priority must enter immediately.
+ * - [7.10.2] Creating a writer then a reader with higher priorities,
+ *   both must be blocked, the writer must inherit the reader priority
+ *   and the test thread must inherit the writer priority.
+ * - [7.10.3] Releasing the read lock, the priority must return to
+ *   the original level, the writer must run first then the queued
+ *   reader.
+ * .
+ */
+
+static void rt_test_007_010_setup(void) {
+  chRWLockObjectInit(&rw1);
+}
+
+static void rt_test_007_010_execute(void) {
+  rwlock_reader_t rd;
+  tprio_t prio;
+
+  /* [7.10.1] Getting the current priority and acquiring the read lock,
+     a reader with higher priority must enter immediately.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chRWLockReadLock(&rw1, &rd);
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio + 1, rwreader, "A");
+    test_assert_sequence("A", "reader not entered");
+  }
+  test_end_step(1);
+
+  /* [7.10.2] Creating a writer then a reader with higher priorities,
+     both must be blocked, the writer must inherit the reader priority
+     and the test thread must inherit the writer priority.*/
+  test_set_step(2);
+  {
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio + 1, rwwriter, "B");
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio + 2, rwreader, "C");
+    test_assert_sequence("", "not blocked");
+    test_assert_lock(chRWLockGetReadersI(&rw1) == 1, "wrong readers count");
+    test_assert_lock(chRWLockGetWriterI(&rw1) == threads[1], "wrong writer");
+    test_assert(threads[1]->prio == prio + 2, "priority not inherited");
+    test_assert(chThdGetPriorityX() == prio + 2, "reader not boosted");
+  }
+  test_end_step(2);
+
+  /* [7.10.3] Releasing the read lock, the priority must return to
+     the original level, the writer must run first then the queued
+     reader.*/
+  test_set_step(3);
+  {
+    chRWLockReadUnlock(&rw1, &rd);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_wait_threads();
+    test_assert_sequence("BC", "invalid sequence");
+    test_assert_lock(chRWLockGetReadersI(&rw1) == 0, "wrong readers count");
+    test_assert_lock(chRWLockGetWriterI(&rw1) == NULL, "still owned");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_007_010 = {
+  "Readers-writer locks, readers and writers ordering",
+  rt_test_007_010_setup,
+  NULL,
+  rt_test_007_010_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS */
+
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_007_011 [7.11] Readers-writer locks, priority inheritance and try functions
+ *
+ * <h2>Description</h2>
+ * The test thread holds the write lock while a reader and a writer with
+ * higher priority ask for the lock, the test thread must inherit their
+ * priority. The non-blocking lock functions are also tested.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.11.1] Getting the current priority and acquiring the write lock.
+ * - [7.11.2] Creating a reader and a writer with higher priorities, the
+ *   priority of the test thread must be boosted accordingly.
+ * - [7.11.3] Releasing the write lock, the priority must return to the
+ *   original level and the threads must enter in priority order.
+ * - [7.11.4] Testing the non-blocking functions, the write lock must
+ *   fail while there are readers and the read lock must fail while
+ *   there is a writer.
+ * .
+ */
+
+static void rt_test_007_011_setup(void) {
+  chRWLockObjectInit(&rw1);
+}
+
+static void rt_test_007_011_execute(void) {
+  rwlock_reader_t rd1, rd2;
+  tprio_t prio;
+
+  /* [7.11.1] Getting the current priority and acquiring the write lock.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chRWLockWriteLock(&rw1);
+    test_assert_lock(chRWLockGetWriterI(&rw1) == chThdGetSelfX(), "not owner");
+  }
+  test_end_step(1);
+
+  /* [7.11.2] Creating a reader and a writer with higher priorities, the
+     priority of the test thread must be boosted accordingly.*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio + 1, rwreader, "A");
+    test_assert(chThdGetPriorityX() == prio + 1, "priority not inherited");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio + 2, rwwriter, "B");
+    test_assert(chThdGetPriorityX() == prio + 2, "priority not inherited");
+  }
+  test_end_step(2);
+
+  /* [7.11.3] Releasing the write lock, the priority must return to the
+     original level and the threads must enter in priority order.*/
+  test_set_step(3);
+  {
+    chRWLockWriteUnlock(&rw1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_wait_threads();
+    test_assert_sequence("BA", "invalid sequence");
+  }
+  test_end_step(3);
+
+  /* [7.11.4] Testing the non-blocking functions, the write lock must
+     fail while there are readers and the read lock must fail while
+     there is a writer.*/
+  test_set_step(4);
+  {
+    test_assert(chRWLockTryReadLock(&rw1, &rd1), "read lock failed");
+    test_assert(chRWLockTryReadLock(&rw1, &rd2), "read lock failed");
+    test_assert(!chRWLockTryWriteLock(&rw1), "write lock not failed");
+    test_assert_lock(chRWLockGetReadersI(&rw1) == 2, "wrong readers count");
+    chRWLockReadUnlock(&rw1, &rd2);
+    chRWLockReadUnlock(&rw1, &rd1);
+    test_assert(chRWLockTryWriteLock(&rw1), "write lock failed");
+    chSysLock();
+    chRWLockWriteUnlockS(&rw1);
+    chSchRescheduleS();
+    chSysUnlock();
+    test_assert_lock(chRWLockGetWriterI(&rw1) == NULL, "still owned");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_007_011 = {
+  "Readers-writer locks, priority inheritance and try functions",
+  rt_test_007_011_setup,
+  NULL,
+  rt_test_007_011_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS */
+
+#if (CH_CFG_USE_RWLOCKS && CH_DBG_THREADS_PROFILING) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_007_012 [7.12] Readers-writer locks, readers priority inheritance
+ *
+ * <h2>Description</h2>
+ * A low priority thread holds the read lock while a high priority
+ * thread asks for the write lock and a medium priority thread is
+ * consuming CPU time. The reader must inherit the writer priority so
+ * that the medium priority thread cannot starve the writer.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS && CH_DBG_THREADS_PROFILING
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.12.1] Getting the system time for test duration measurement.
+ * - [7.12.2] The three contenders threads are created and let run
+ *   atomically, the goals sequence is tested, the threads must
+ *   complete in priority order.
+ * - [7.12.3] Testing that all threads completed within the specified
+ *   time windows (100mS...100mS+ALLOWED_DELAY).
+ * .
+ */
+
+static void rt_test_007_012_setup(void) {
+  chRWLockObjectInit(&rw1);
+}
+
+static void rt_test_007_012_execute(void) {
+  systime_t time;
+
+  /* [7.12.1] Getting the system time for test duration measurement.*/
+  test_set_step(1);
+  {
+    time = test_wait_tick();
+  }
+  test_end_step(1);
+
+  /* [7.12.2] The three contenders threads are created and let run
+     atomically, the goals sequence is tested, the threads must
+     complete in priority order.*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()-1, rwthreadH, 0);
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriorityX()-2, rwthreadM, 0);
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, chThdGetPriorityX()-3, rwthreadL, 0);
+    test_wait_threads();
+    test_assert_sequence("ABC", "invalid sequence");
+  }
+  test_end_step(2);
+
+  /* [7.12.3] Testing that all threads completed within the specified
+     time windows (100mS...100mS+ALLOWED_DELAY).*/
+  test_set_step(3);
+  {
+    test_assert_time_window(chTimeAddX(time, TIME_MS2I(100)),
+                            chTimeAddX(time, TIME_MS2I(100) + ALLOWED_DELAY),
+                            "out of time window");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_007_012 = {
+  "Readers-writer locks, readers priority inheritance",
+  rt_test_007_012_setup,
+  NULL,
+  rt_test_007_012_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS && CH_DBG_THREADS_PROFILING */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -1108,6 +1417,15 @@ const testcase_t * const rt_test_sequence_007_array[] = {
 #endif
 #if (CH_CFG_USE_CONDVARS) || defined(__DOXYGEN__)
   &rt_test_007_009,
+#endif
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+  &rt_test_007_010,
+#endif
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+  &rt_test_007_011,
+#endif
+#if (CH_CFG_USE_RWLOCKS && CH_DBG_THREADS_PROFILING) || defined(__DOXYGEN__)
+  &rt_test_007_012,
 #endif
   NULL
 };
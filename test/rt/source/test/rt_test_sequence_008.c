@@ -37,6 +37,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage rt_test_008_001
+ * - @subpage rt_test_008_002
  * .
  */
 
@@ -54,6 +55,17 @@ static THD_FUNCTION(msg_thread1, p) {
   chMsgSend(p, 'D');
 }
 
+static thread_t *msg_server;
+
+static THD_FUNCTION(msg_thread2, p) {
+  char c = *(char *)p;
+
+  /* The server modifies the payload in place.*/
+  if (chMsgSendPayload(msg_server, (msg_t)c, &c, sizeof c) == MSG_OK) {
+    test_emit_token(c);
+  }
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -109,6 +121,95 @@ static const testcase_t rt_test_008_001 = {
   rt_test_008_001_execute
 };
 
+/**
+ * @page rt_test_008_002 [8.2] Messages payload and batch receive
+ *
+ * <h2>Description</h2>
+ * Four messenger threads are spawned, each one sends a message carrying
+ * a one character payload to the tester thread.<br>
+ * The tester thread receives the messages in batches, checks the
+ * messages and the payloads, modifies the payloads in place then
+ * releases the senders. The senders must find the modified payloads.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.2.1] Starting the messenger threads, the messages must be
+ *   pending.
+ * - [8.2.2] Receiving a batch of three messages, the messages and the
+ *   payloads are checked then the payloads are modified and the senders
+ *   released.
+ * - [8.2.3] Receiving the last message, the batch must contain one
+ *   message. A further wait must timeout immediately.
+ * .
+ */
+
+static void rt_test_008_002_execute(void) {
+  thread_t *tps[4];
+  msg_t msgs[4];
+  size_t i, n;
+
+  /* [8.2.1] Starting the messenger threads, the messages must be
+     pending.*/
+  test_set_step(1);
+  {
+    msg_server = chThdGetSelfX();
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   msg_thread2, "A");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriorityX() + 1,
+                                   msg_thread2, "B");
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, chThdGetPriorityX() + 1,
+                                   msg_thread2, "C");
+    threads[3] = chThdCreateStatic(wa[3], WA_SIZE, chThdGetPriorityX() + 1,
+                                   msg_thread2, "D");
+    test_assert_lock(chMsgIsPendingI(chThdGetSelfX()), "no pending messages");
+  }
+  test_end_step(1);
+
+  /* [8.2.2] Receiving a batch of three messages, the messages and the
+     payloads are checked then the payloads are modified and the senders
+     released.*/
+  test_set_step(2);
+  {
+    n = chMsgWaitBatch(tps, 3);
+    test_assert(n == 3, "wrong batch size");
+    for (i = 0; i < n; i++) {
+      char *buf;
+      size_t size;
+
+      buf = chMsgGetPayload(tps[i], &size);
+      test_assert(chMsgGet(tps[i]) == (msg_t)('A' + i), "wrong message");
+      test_assert((buf != NULL) && (size == 1), "wrong payload");
+      test_assert(*buf == (char)('A' + i), "wrong payload content");
+      *buf = (char)('a' + i);
+      msgs[i] = MSG_OK;
+    }
+    chMsgReleaseBatch(tps, msgs, n);
+    test_assert_sequence("abc", "invalid sequence");
+  }
+  test_end_step(2);
+
+  /* [8.2.3] Receiving the last message, the batch must contain one
+     message. A further wait must timeout immediately.*/
+  test_set_step(3);
+  {
+    n = chMsgWaitBatch(tps, 4);
+    test_assert(n == 1, "wrong batch size");
+    test_assert(chMsgGet(tps[0]) == 'D', "wrong message");
+    chMsgRelease(tps[0], MSG_RESET);
+    n = chMsgWaitBatchTimeout(tps, 4, TIME_IMMEDIATE);
+    test_assert(n == 0, "unexpected message");
+    test_wait_threads();
+    test_assert_sequence("", "invalid sequence");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_008_002 = {
+  "Messages payload and batch receive",
+  NULL,
+  NULL,
+  rt_test_008_002_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -118,6 +219,7 @@ static const testcase_t rt_test_008_001 = {
  */
 const testcase_t * const rt_test_sequence_008_array[] = {
   &rt_test_008_001,
+  &rt_test_008_002,
   NULL
 };
 
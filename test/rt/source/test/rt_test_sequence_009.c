@@ -42,6 +42,7 @@
  * - @subpage rt_test_009_005
  * - @subpage rt_test_009_006
  * - @subpage rt_test_009_007
+ * - @subpage rt_test_009_008
  * .
  */
 
@@ -573,6 +574,114 @@ static const testcase_t rt_test_009_007 = {
   rt_test_009_007_execute
 };
 
+/**
+ * @page rt_test_009_008 [9.8] Events flags filtering
+ *
+ * <h2>Description</h2>
+ * Listeners with different flags masks are registered on the same Event
+ * Source, broadcasts must only signal the listeners interested in the
+ * broadcasted flags, also after unregistering some of the listeners.
+ *
+ * <h2>Test Steps</h2>
+ * - [9.8.1] Registering four listeners interested in flags 1, 2, 1 and
+ *   3.
+ * - [9.8.2] Broadcasting flag 1, the listeners interested in flag 1
+ *   must be signaled.
+ * - [9.8.3] Unregistering the first and the second listeners then
+ *   broadcasting flags 2, 1 and both, only the remaining interested
+ *   listeners must be signaled.
+ * - [9.8.4] Broadcasting without flags, all the remaining listeners
+ *   must be signaled.
+ * - [9.8.5] Unregistering the remaining listeners.
+ * .
+ */
+
+static void rt_test_009_008_setup(void) {
+  chEvtGetAndClearEvents(ALL_EVENTS);
+  chEvtObjectInit(&es1);
+}
+
+static void rt_test_009_008_teardown(void) {
+  chEvtGetAndClearEvents(ALL_EVENTS);
+}
+
+static void rt_test_009_008_execute(void) {
+  eventmask_t m;
+  event_listener_t el1, el2, el3, el4;
+
+  /* [9.8.1] Registering four listeners interested in flags 1, 2, 1 and
+     3.*/
+  test_set_step(1);
+  {
+    chEvtRegisterMaskWithFlags(&es1, &el1, EVENT_MASK(0), 1);
+    chEvtRegisterMaskWithFlags(&es1, &el2, EVENT_MASK(1), 2);
+    chEvtRegisterMaskWithFlags(&es1, &el3, EVENT_MASK(2), 1);
+    chEvtRegisterMaskWithFlags(&es1, &el4, EVENT_MASK(3), 3);
+  }
+  test_end_step(1);
+
+  /* [9.8.2] Broadcasting flag 1, the listeners interested in flag 1
+     must be signaled.*/
+  test_set_step(2);
+  {
+    chEvtBroadcastFlags(&es1, 1);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (EVENT_MASK(0) | EVENT_MASK(2) | EVENT_MASK(3)),
+                "wrong events mask");
+    test_assert(chEvtGetAndClearFlags(&el1) == 1, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el2) == 0, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el3) == 1, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el4) == 1, "wrong flags");
+  }
+  test_end_step(2);
+
+  /* [9.8.3] Unregistering the first and the second listeners then
+     broadcasting flags 2, 1 and both, only the remaining interested
+     listeners must be signaled.*/
+  test_set_step(3);
+  {
+    chEvtUnregister(&es1, &el1);
+    chEvtUnregister(&es1, &el2);
+    chEvtBroadcastFlags(&es1, 2);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == EVENT_MASK(3), "wrong events mask");
+    chEvtBroadcastFlags(&es1, 1);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (EVENT_MASK(2) | EVENT_MASK(3)), "wrong events mask");
+    chEvtBroadcastFlags(&es1, 3);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (EVENT_MASK(2) | EVENT_MASK(3)), "wrong events mask");
+    test_assert(chEvtGetAndClearFlags(&el4) == 3, "wrong flags");
+  }
+  test_end_step(3);
+
+  /* [9.8.4] Broadcasting without flags, all the remaining listeners
+     must be signaled.*/
+  test_set_step(4);
+  {
+    chEvtBroadcastFlags(&es1, 0);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (EVENT_MASK(2) | EVENT_MASK(3)), "wrong events mask");
+  }
+  test_end_step(4);
+
+  /* [9.8.5] Unregistering the remaining listeners.*/
+  test_set_step(5);
+  {
+    chEvtUnregister(&es1, &el3);
+    chEvtUnregister(&es1, &el4);
+    test_assert(!chEvtIsListeningI(&es1), "stuck listener");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t rt_test_009_008 = {
+  "Events flags filtering",
+  rt_test_009_008_setup,
+  rt_test_009_008_teardown,
+  rt_test_009_008_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -590,6 +699,7 @@ const testcase_t * const rt_test_sequence_009_array[] = {
   &rt_test_009_006,
 #endif
   &rt_test_009_007,
+  &rt_test_009_008,
   NULL
 };
 
@@ -46,6 +46,13 @@
  * - @subpage rt_test_011_010
  * - @subpage rt_test_011_011
  * - @subpage rt_test_011_012
+ * - @subpage rt_test_011_013
+ * - @subpage rt_test_011_014
+ * - @subpage rt_test_011_015
+ * - @subpage rt_test_011_016
+ * - @subpage rt_test_011_017
+ * - @subpage rt_test_011_018
+ * - @subpage rt_test_011_019
  * .
  */
 
@@ -134,6 +141,109 @@ static THD_FUNCTION(bmk_thread8, p) {
   } while(!chThdShouldTerminateX());
 }
 
+#define RLIST_BMK_THREADS 8
+
+static thread_t rlist_threads[RLIST_BMK_THREADS];
+
+#define VT_BMK_TIMERS 32
+
+static virtual_timer_t vt_bmk_timers[VT_BMK_TIMERS];
+
+#if (CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAMS == TRUE)
+static tm_histogram_t bmk_histogram;
+
+static THD_FUNCTION(bmk_thread9, p) {
+  msg_t msg;
+  thread_t *self = chThdGetSelfX();
+
+  (void)p;
+  chSysLock();
+  do {
+    chSchGoSleepS(CH_STATE_SUSPENDED);
+    msg = self->u.rdymsg;
+    if (msg == MSG_OK) {
+      chTMHistogramStopX(&bmk_histogram);
+    }
+  } while (msg == MSG_OK);
+  chSysUnlock();
+}
+#endif
+
+#if CH_CFG_USE_EVENTS == TRUE
+#define EVT_BMK_LISTENERS 32
+
+static EVENTSOURCE_DECL(evt_bmk_source);
+
+static event_listener_t evt_bmk_listeners[EVT_BMK_LISTENERS];
+#endif
+
+#if CH_CFG_USE_RWLOCKS || defined(__DOXYGEN__)
+static rwlock_t rw1;
+#endif
+
+#if CH_CFG_USE_MESSAGES || defined(__DOXYGEN__)
+static volatile uint32_t bmk_msg_count;
+
+static THD_FUNCTION(bmk_msg_client, p) {
+
+  while (!chThdShouldTerminateX()) {
+    (void)chMsgSend((thread_t *)p, 1);
+    bmk_msg_count++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  }
+}
+
+static THD_FUNCTION(bmk_msg_batch_server, p) {
+  thread_t *tps[4];
+  msg_t msgs[4];
+  size_t i, n;
+  bool stop = false;
+
+  (void)p;
+  do {
+    n = chMsgWaitBatch(tps, 4);
+    for (i = 0; i < n; i++) {
+      msgs[i] = chMsgGet(tps[i]);
+      if (msgs[i] == 0) {
+        stop = true;
+      }
+    }
+    chMsgReleaseBatch(tps, msgs, n);
+  } while (!stop);
+}
+
+NOINLINE static uint32_t msg_clients_test(tfunc_t server) {
+  uint32_t n;
+  unsigned i;
+
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() - 2,
+                                 server, NULL);
+  (void)test_wait_tick();
+  bmk_msg_count = 0;
+  for (i = 1; i < 5; i++) {
+    threads[i] = chThdCreateStatic(wa[i], WA_SIZE, chThdGetPriorityX() - 1,
+                                   bmk_msg_client, threads[0]);
+  }
+  chThdSleepMilliseconds(1000);
+  n = bmk_msg_count;
+
+  /* Stopping the clients first then the server.*/
+  for (i = 1; i < 5; i++) {
+    chThdTerminate(threads[i]);
+  }
+  for (i = 1; i < 5; i++) {
+    chThdWait(threads[i]);
+    threads[i] = NULL;
+  }
+  (void)chMsgSend(threads[0], 0);
+  test_wait_threads();
+
+  return n;
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -1034,6 +1144,570 @@ static const testcase_t rt_test_011_012 = {
   rt_test_011_012_execute
 };
 
+/**
+ * @page rt_test_011_013 [11.13] Ready list insertion/removal performance
+ *
+ * <h2>Description</h2>
+ * A set of thread descriptors, with priorities lower than the current
+ * thread, is inserted in the ready list and then removed within the
+ * same critical section. The time required by each operation depends on
+ * the number of threads already in the ready list unless the
+ * bitmap-indexed ready list is enabled.<br>
+ * The performance is calculated by measuring the number of iterations
+ * after a second of continuous operations.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.13.1] The thread descriptors are initialized with decreasing
+ *   priorities, all lower than the current thread priority.
+ * - [11.13.2] The descriptors are inserted in the ready list and
+ *   removed. The operation is repeated continuously in a one-second
+ *   time window.
+ * - [11.13.3] The score is printed.
+ * .
+ */
+
+static void rt_test_011_013_execute(void) {
+  uint32_t n;
+  unsigned i;
+
+  /* [11.13.1] The thread descriptors are initialized with decreasing
+     priorities, all lower than the current thread priority.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < RLIST_BMK_THREADS; i++) {
+      rlist_threads[i].prio  = chThdGetPriorityX() - (tprio_t)(i + 1U);
+      rlist_threads[i].state = CH_STATE_SUSPENDED;
+#if CH_CFG_SMP_MODE == TRUE
+      rlist_threads[i].owner = chThdGetSelfX()->owner;
+#endif
+    }
+  }
+  test_end_step(1);
+
+  /* [11.13.2] The descriptors are inserted in the ready list and
+     removed. The operation is repeated continuously in a one-second
+     time window.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chSysLock();
+      for (i = 0; i < RLIST_BMK_THREADS; i++) {
+        (void) chSchReadyI(&rlist_threads[i]);
+      }
+      for (i = 0; i < RLIST_BMK_THREADS; i++) {
+        (void) chSchDequeueReadyI(&rlist_threads[i]);
+        rlist_threads[i].state = CH_STATE_SUSPENDED;
+      }
+      chSysUnlock();
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [11.13.3] The score is printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Score : ");
+    test_printn(n * RLIST_BMK_THREADS);
+    test_println(" ready+dequeue/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_011_013 = {
+  "Ready list insertion/removal performance",
+  NULL,
+  NULL,
+  rt_test_011_013_execute
+};
+
+/**
+ * @page rt_test_011_014 [11.14] Virtual Timers set/reset performance with many armed timers
+ *
+ * <h2>Description</h2>
+ * A virtual timer is set and immediately reset into a continuous loop
+ * while other timers are armed, the timer is placed in the middle of
+ * the armed timers.<br>
+ * The performance is calculated by measuring the number of iterations
+ * after a second of continuous operations.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.14.1] A timer is set then reset while other timers are armed.
+ *   The operation is repeated continuously in a one-second time window.
+ * - [11.14.2] The score is printed.
+ * .
+ */
+
+static void rt_test_011_014_setup(void) {
+  unsigned i;
+
+  for (i = 0; i < VT_BMK_TIMERS; i++) {
+    chVTSet(&vt_bmk_timers[i], TIME_MS2I(10000) + (sysinterval_t)i, tmo, NULL);
+  }
+}
+
+static void rt_test_011_014_teardown(void) {
+  unsigned i;
+
+  for (i = 0; i < VT_BMK_TIMERS; i++) {
+    chVTReset(&vt_bmk_timers[i]);
+  }
+}
+
+static void rt_test_011_014_execute(void) {
+  static virtual_timer_t vt1;
+  uint32_t n;
+
+  /* [11.14.1] A timer is set then reset while other timers are armed.
+     The operation is repeated continuously in a one-second time window.*/
+  test_set_step(1);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chSysLock();
+      chVTDoSetI(&vt1, TIME_MS2I(10000) + (sysinterval_t)(VT_BMK_TIMERS / 2),
+                 tmo, NULL);
+      chVTDoResetI(&vt1);
+      chSysUnlock();
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [11.14.2] The score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" timers/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_011_014 = {
+  "Virtual Timers set/reset performance with many armed timers",
+  rt_test_011_014_setup,
+  rt_test_011_014_teardown,
+  rt_test_011_014_execute
+};
+
+#if ((CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAMS == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_015 [11.15] Context Switch latency distribution
+ *
+ * <h2>Description</h2>
+ * A thread is created that just performs a @p chSchGoSleepS() into a
+ * loop, the thread is awakened by the tester thread and the time
+ * between the wakeup and the thread execution is recorded in an
+ * histogram. The percentiles of the latency are printed in realtime
+ * counter cycles.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAMS == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.15.1] Starting the target thread at an higher priority level.
+ * - [11.15.2] Waking up the thread repeatedly in a one second time
+ *   window.
+ * - [11.15.3] Stopping the target thread.
+ * - [11.15.4] Percentiles are printed.
+ * .
+ */
+
+static void rt_test_011_015_execute(void) {
+  thread_t *tp;
+
+  /* [11.15.1] Starting the target thread at an higher priority level.*/
+  test_set_step(1);
+  {
+    chTMHistogramObjectInit(&bmk_histogram);
+    tp = threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1,
+                                        bmk_thread9, NULL);
+  }
+  test_end_step(1);
+
+  /* [11.15.2] Waking up the thread repeatedly in a one second time
+     window.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chSysLock();
+      chTMHistogramStartX(&bmk_histogram);
+      chSchWakeupS(tp, MSG_OK);
+      chSysUnlock();
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [11.15.3] Stopping the target thread.*/
+  test_set_step(3);
+  {
+    chSysLock();
+    chSchWakeupS(tp, MSG_TIMEOUT);
+    chSysUnlock();
+    test_wait_threads();
+  }
+  test_end_step(3);
+
+  /* [11.15.4] Percentiles are printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Count : ");
+    test_printn(bmk_histogram.tm.n);
+    test_println(" wakeups");
+    test_print("--- p50   : ");
+    test_printn(chTMHistogramGetPercentileX(&bmk_histogram, 500000U));
+    test_println(" cycles");
+    test_print("--- p99   : ");
+    test_printn(chTMHistogramGetPercentileX(&bmk_histogram, 990000U));
+    test_println(" cycles");
+    test_print("--- p99.9 : ");
+    test_printn(chTMHistogramGetPercentileX(&bmk_histogram, 999000U));
+    test_println(" cycles");
+    test_print("--- Worst : ");
+    test_printn(bmk_histogram.tm.worst);
+    test_println(" cycles");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_011_015 = {
+  "Context Switch latency distribution",
+  NULL,
+  NULL,
+  rt_test_011_015_execute
+};
+#endif /* (CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAMS == TRUE) */
+
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_016 [11.16] Event flags broadcast performance with many listeners
+ *
+ * <h2>Description</h2>
+ * An Event Source with many listeners interested in distinct sets of
+ * two flags is broadcasted into a continuous loop, only one listener
+ * out of eight is interested in the broadcasted flag.<br>
+ * The performance is calculated by measuring the number of iterations
+ * after a second of continuous operations.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.16.1] The Event Source is broadcasted with a single flag. The
+ *   operation is repeated continuously in a one-second time window.
+ * - [11.16.2] The score is printed.
+ * .
+ */
+
+static void rt_test_011_016_setup(void) {
+  unsigned i;
+
+  for (i = 0; i < EVT_BMK_LISTENERS; i++) {
+    chEvtRegisterMaskWithFlags(&evt_bmk_source, &evt_bmk_listeners[i],
+                               EVENT_MASK(0),
+                               ((eventflags_t)1 << (i & 7U)) |
+                               ((eventflags_t)1 << (8U + (i >> 3))));
+  }
+}
+
+static void rt_test_011_016_teardown(void) {
+  unsigned i;
+
+  for (i = 0; i < EVT_BMK_LISTENERS; i++) {
+    chEvtUnregister(&evt_bmk_source, &evt_bmk_listeners[i]);
+  }
+  chEvtGetAndClearEvents(ALL_EVENTS);
+}
+
+static void rt_test_011_016_execute(void) {
+  uint32_t n;
+
+  /* [11.16.1] The Event Source is broadcasted with a single flag. The
+     operation is repeated continuously in a one-second time window.*/
+  test_set_step(1);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chSysLock();
+      chEvtBroadcastFlagsI(&evt_bmk_source, (eventflags_t)1);
+      chSysUnlock();
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [11.16.2] The score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" broadcasts/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_011_016 = {
+  "Event flags broadcast performance with many listeners",
+  rt_test_011_016_setup,
+  rt_test_011_016_teardown,
+  rt_test_011_016_execute
+};
+#endif /* CH_CFG_USE_EVENTS */
+
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_017 [11.17] Readers-writer locks read lock/unlock performance
+ *
+ * <h2>Description</h2>
+ * A readers-writer lock is locked for reading and unlocked into a
+ * continuous loop, no Context Switch happens because there are no
+ * writers.<br>
+ * The performance is calculated by measuring the number of iterations
+ * after a second of continuous operations, the score can be compared
+ * with the mutexes lock/unlock performance.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.17.1] The lock is acquired for reading and released. The
+ *   operation is repeated continuously in a one-second time window.
+ * - [11.17.2] The score is printed.
+ * .
+ */
+
+static void rt_test_011_017_setup(void) {
+  chRWLockObjectInit(&rw1);
+}
+
+static void rt_test_011_017_execute(void) {
+  uint32_t n;
+
+  /* [11.17.1] The lock is acquired for reading and released. The
+     operation is repeated continuously in a one-second time window.*/
+  test_set_step(1);
+  {
+    systime_t start, end;
+    rwlock_reader_t rd;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chRWLockReadLock(&rw1, &rd);
+      chRWLockReadUnlock(&rw1, &rd);
+      chRWLockReadLock(&rw1, &rd);
+      chRWLockReadUnlock(&rw1, &rd);
+      chRWLockReadLock(&rw1, &rd);
+      chRWLockReadUnlock(&rw1, &rd);
+      chRWLockReadLock(&rw1, &rd);
+      chRWLockReadUnlock(&rw1, &rd);
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [11.17.2] The score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n * 4);
+    test_println(" lock+unlock/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_011_017 = {
+  "Readers-writer locks read lock/unlock performance",
+  rt_test_011_017_setup,
+  NULL,
+  rt_test_011_017_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS */
+
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_018 [11.18] Readers-writer locks write lock/unlock performance
+ *
+ * <h2>Description</h2>
+ * A readers-writer lock is locked for writing and unlocked into a
+ * continuous loop, no Context Switch happens because there are no other
+ * threads asking for the lock.<br>
+ * The performance is calculated by measuring the number of iterations
+ * after a second of continuous operations, the score can be compared
+ * with the mutexes lock/unlock performance.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.18.1] The lock is acquired for writing and released. The
+ *   operation is repeated continuously in a one-second time window.
+ * - [11.18.2] The score is printed.
+ * .
+ */
+
+static void rt_test_011_018_setup(void) {
+  chRWLockObjectInit(&rw1);
+}
+
+static void rt_test_011_018_execute(void) {
+  uint32_t n;
+
+  /* [11.18.1] The lock is acquired for writing and released. The
+     operation is repeated continuously in a one-second time window.*/
+  test_set_step(1);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chRWLockWriteLock(&rw1);
+      chRWLockWriteUnlock(&rw1);
+      chRWLockWriteLock(&rw1);
+      chRWLockWriteUnlock(&rw1);
+      chRWLockWriteLock(&rw1);
+      chRWLockWriteUnlock(&rw1);
+      chRWLockWriteLock(&rw1);
+      chRWLockWriteUnlock(&rw1);
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [11.18.2] The score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n * 4);
+    test_println(" lock+unlock/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_011_018 = {
+  "Readers-writer locks write lock/unlock performance",
+  rt_test_011_018_setup,
+  NULL,
+  rt_test_011_018_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS */
+
+#if (CH_CFG_USE_MESSAGES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_019 [11.19] Messages batch performance
+ *
+ * <h2>Description</h2>
+ * Four client threads send messages to a server thread with lower
+ * priority, the messages throughput per second is measured with a
+ * server receiving one message at time and with a server receiving the
+ * messages in batches, both results are printed on the output log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MESSAGES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.19.1] The number of messages exchanged with a server receiving
+ *   one message at time is counted in a one second time window.
+ * - [11.19.2] The number of messages exchanged with a server receiving
+ *   the messages in batches is counted in a one second time window.
+ * - [11.19.3] Score is printed.
+ * .
+ */
+
+static void rt_test_011_019_execute(void) {
+  uint32_t n1, n2;
+
+  /* [11.19.1] The number of messages exchanged with a server receiving
+     one message at time is counted in a one second time window.*/
+  test_set_step(1);
+  {
+    n1 = msg_clients_test(bmk_thread1);
+  }
+  test_end_step(1);
+
+  /* [11.19.2] The number of messages exchanged with a server receiving
+     the messages in batches is counted in a one second time window.*/
+  test_set_step(2);
+  {
+    n2 = msg_clients_test(bmk_msg_batch_server);
+  }
+  test_end_step(2);
+
+  /* [11.19.3] Score is printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Single: ");
+    test_printn(n1);
+    test_println(" msgs/S");
+    test_print("--- Batch : ");
+    test_printn(n2);
+    test_println(" msgs/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_011_019 = {
+  "Messages batch performance",
+  NULL,
+  NULL,
+  rt_test_011_019_execute
+};
+#endif /* CH_CFG_USE_MESSAGES */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -1066,6 +1740,23 @@ const testcase_t * const rt_test_sequence_011_array[] = {
   &rt_test_011_011,
 #endif
   &rt_test_011_012,
+  &rt_test_011_013,
+  &rt_test_011_014,
+#if ((CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAMS == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_011_015,
+#endif
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
+  &rt_test_011_016,
+#endif
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+  &rt_test_011_017,
+#endif
+#if (CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+  &rt_test_011_018,
+#endif
+#if (CH_CFG_USE_MESSAGES) || defined(__DOXYGEN__)
+  &rt_test_011_019,
+#endif
   NULL
 };
 
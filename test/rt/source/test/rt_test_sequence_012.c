@@ -0,0 +1,519 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "rt_test_root.h"
+
+/**
+ * @file    rt_test_sequence_012.c
+ * @brief   Test Sequence 012 code.
+ *
+ * @page rt_test_sequence_012 [12] Multi-core
+ *
+ * File: @ref rt_test_sequence_012.c
+ *
+ * <h2>Description</h2>
+ * This module implements the test sequence for the multi-core mode, a
+ * second kernel instance is started on another core and kernel objects
+ * are shared between the cores.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_SMP_MODE == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage rt_test_012_001
+ * - @subpage rt_test_012_002
+ * - @subpage rt_test_012_003
+ * - @subpage rt_test_012_004
+ * - @subpage rt_test_012_005
+ * .
+ */
+
+#if (CH_CFG_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define SMP_ITERATIONS          1000
+
+static semaphore_t smp_sem_req, smp_sem_ack;
+static unsigned smp_server_core;
+static bool smp_core_started = false;
+
+#if CH_CFG_USE_MESSAGES
+static THD_WORKING_AREA(wa_smp_server, 256);
+static thread_t *smp_server_tp;
+
+static THD_FUNCTION(smp_msg_thread, p) {
+  thread_t *tp;
+  msg_t msg;
+
+  (void)p;
+  while (true) {
+    tp = chMsgWait();
+    msg = chMsgGet(tp);
+    chMsgRelease(tp, msg + 1);
+  }
+}
+#endif
+
+#if CH_CFG_USE_MAILBOXES
+#define SMP_MB_SIZE             4
+
+static msg_t smp_mb_req_buffer[SMP_MB_SIZE], smp_mb_ack_buffer[SMP_MB_SIZE];
+static MAILBOX_DECL(smp_mb_req, smp_mb_req_buffer, SMP_MB_SIZE);
+static MAILBOX_DECL(smp_mb_ack, smp_mb_ack_buffer, SMP_MB_SIZE);
+static THD_WORKING_AREA(wa_smp_mailbox, 256);
+
+static THD_FUNCTION(smp_mb_thread, p) {
+  msg_t msg;
+
+  (void)p;
+  while (true) {
+    (void) chMBFetchTimeout(&smp_mb_req, &msg, TIME_INFINITE);
+    (void) chMBPostTimeout(&smp_mb_ack, msg + 1, TIME_INFINITE);
+  }
+}
+#endif
+
+#if CH_CFG_USE_MUTEXES
+static MUTEX_DECL(smp_mtx);
+static SEMAPHORE_DECL(smp_sem_mtx, 0);
+static volatile bool smp_mtx_run;
+static volatile unsigned smp_mtx_counter;
+static THD_WORKING_AREA(wa_smp_mutex, 256);
+
+/* Short critical zone executed with the mutex owned.*/
+static void smp_mtx_work(void) {
+  unsigned i;
+
+  for (i = 0; i < 64U; i++) {
+    smp_mtx_counter++;
+  }
+}
+
+static THD_FUNCTION(smp_mtx_thread, p) {
+
+  (void)p;
+  while (true) {
+    chSemWait(&smp_sem_mtx);
+    while (smp_mtx_run) {
+      chMtxLock(&smp_mtx);
+      smp_mtx_work();
+      chMtxUnlock(&smp_mtx);
+      smp_mtx_work();
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    }
+    chSemSignal(&smp_sem_ack);
+  }
+}
+#endif
+
+static void smp_core_main(void) {
+
+  chSysInit();
+  smp_server_core = port_get_core_id();
+#if CH_CFG_USE_MESSAGES
+  smp_server_tp = chThdCreateStatic(wa_smp_server, sizeof wa_smp_server,
+                                    NORMALPRIO + 1, smp_msg_thread, NULL);
+#endif
+#if CH_CFG_USE_MAILBOXES
+  (void) chThdCreateStatic(wa_smp_mailbox, sizeof wa_smp_mailbox,
+                           NORMALPRIO + 1, smp_mb_thread, NULL);
+#endif
+#if CH_CFG_USE_MUTEXES
+  (void) chThdCreateStatic(wa_smp_mutex, sizeof wa_smp_mutex,
+                           NORMALPRIO + 1, smp_mtx_thread, NULL);
+#endif
+  chSemSignal(&smp_sem_ack);
+  while (true) {
+    chSemWait(&smp_sem_req);
+    chSemSignal(&smp_sem_ack);
+  }
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page rt_test_012_001 [12.1] Secondary core startup
+ *
+ * <h2>Description</h2>
+ * The second core is started, it initializes its kernel instance and
+ * signals a semaphore owned by the first core. The test expects the
+ * signal to arrive within a time window and the second core to report
+ * its identifier.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.1.1] The second core is started, the thread waits for the
+ *   startup signal.
+ * - [12.1.2] The identifiers of both cores are checked.
+ * .
+ */
+
+static void rt_test_012_001_setup(void) {
+  if (!smp_core_started) {
+    chSemObjectInit(&smp_sem_req, 0);
+    chSemObjectInit(&smp_sem_ack, 0);
+  }
+}
+
+static void rt_test_012_001_execute(void) {
+  msg_t msg;
+
+  /* [12.1.1] The second core is started, the thread waits for the
+     startup signal.*/
+  test_set_step(1);
+  {
+    if (!smp_core_started) {
+      smp_core_started = true;
+      port_start_core(1U, smp_core_main);
+      msg = chSemWaitTimeout(&smp_sem_ack, TIME_MS2I(1000));
+      test_assert(msg == MSG_OK, "core not started");
+    }
+  }
+  test_end_step(1);
+
+  /* [12.1.2] The identifiers of both cores are checked.*/
+  test_set_step(2);
+  {
+    test_assert(port_get_core_id() == 0U, "wrong core identifier");
+    test_assert(smp_server_core == 1U, "wrong core identifier");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_001 = {
+  "Secondary core startup",
+  rt_test_012_001_setup,
+  NULL,
+  rt_test_012_001_execute
+};
+
+
+/**
+ * @page rt_test_012_002 [12.2] Semaphores ping-pong between cores
+ *
+ * <h2>Description</h2>
+ * A semaphore is signaled and a thread on the second core answers by
+ * signaling a second semaphore, the sequence is repeated many times.
+ * The test expects all the answers to arrive within a time window and
+ * no spurious signals.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.2.1] Checking that the second core is running.
+ * - [12.2.2] Signaling the second core and waiting for the answer, the
+ *   operation is repeated SMP_ITERATIONS times.
+ * - [12.2.3] Checking that no signals are pending on both semaphores.
+ * .
+ */
+
+static void rt_test_012_002_execute(void) {
+  unsigned i;
+  msg_t msg;
+
+  /* [12.2.1] Checking that the second core is running.*/
+  test_set_step(1);
+  {
+    test_assert(smp_core_started, "core not started");
+  }
+  test_end_step(1);
+
+  /* [12.2.2] Signaling the second core and waiting for the answer, the
+     operation is repeated SMP_ITERATIONS times.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < SMP_ITERATIONS; i++) {
+      chSemSignal(&smp_sem_req);
+      msg = chSemWaitTimeout(&smp_sem_ack, TIME_MS2I(1000));
+      test_assert(msg == MSG_OK, "no answer");
+    }
+  }
+  test_end_step(2);
+
+  /* [12.2.3] Checking that no signals are pending on both semaphores.*/
+  test_set_step(3);
+  {
+    test_assert_lock(chSemGetCounterI(&smp_sem_req) <= 0, "wrong counter");
+    test_assert_lock(chSemGetCounterI(&smp_sem_ack) == 0, "wrong counter");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_012_002 = {
+  "Semaphores ping-pong between cores",
+  NULL,
+  NULL,
+  rt_test_012_002_execute
+};
+
+
+#if (CH_CFG_USE_MESSAGES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_003 [12.3] Synchronous messages between cores
+ *
+ * <h2>Description</h2>
+ * Messages are sent to a server thread running on the second core, the
+ * server answers each message with the message value incremented by
+ * one. The test expects the correct answer for each message.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MESSAGES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.3.1] Checking that the server thread on the second core exists.
+ * - [12.3.2] Sending messages to the server and checking the answers,
+ *   the operation is repeated SMP_ITERATIONS times.
+ * .
+ */
+
+static void rt_test_012_003_execute(void) {
+  unsigned i;
+  msg_t msg;
+
+  /* [12.3.1] Checking that the server thread on the second core exists.*/
+  test_set_step(1);
+  {
+    test_assert(smp_server_tp != NULL, "no server thread");
+  }
+  test_end_step(1);
+
+  /* [12.3.2] Sending messages to the server and checking the answers,
+     the operation is repeated SMP_ITERATIONS times.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < SMP_ITERATIONS; i++) {
+      msg = chMsgSend(smp_server_tp, (msg_t)i);
+      test_assert(msg == (msg_t)i + 1, "wrong answer");
+    }
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_003 = {
+  "Synchronous messages between cores",
+  NULL,
+  NULL,
+  rt_test_012_003_execute
+};
+#endif /* CH_CFG_USE_MESSAGES */
+
+
+#if (CH_CFG_USE_MAILBOXES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_004 [12.4] Mailboxes between cores
+ *
+ * <h2>Description</h2>
+ * Messages are posted in a mailbox read by a thread running on the
+ * second core, the thread posts each message incremented by one in a
+ * second mailbox. Messages are posted in bursts in order to fill the
+ * mailboxes. The test expects all the answers in the correct order.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.4.1] Checking that the second core is running.
+ * - [12.4.2] Posting bursts of SMP_MB_SIZE messages and fetching the
+ *   answers, the operation is repeated SMP_ITERATIONS / SMP_MB_SIZE
+ *   times.
+ * - [12.4.3] Checking that both mailboxes are empty.
+ * .
+ */
+
+static void rt_test_012_004_execute(void) {
+  unsigned i, j;
+  msg_t msg, ret;
+
+  /* [12.4.1] Checking that the second core is running.*/
+  test_set_step(1);
+  {
+    test_assert(smp_core_started, "core not started");
+  }
+  test_end_step(1);
+
+  /* [12.4.2] Posting bursts of SMP_MB_SIZE messages and fetching the
+     answers, the operation is repeated SMP_ITERATIONS / SMP_MB_SIZE
+     times.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < SMP_ITERATIONS / SMP_MB_SIZE; i++) {
+      for (j = 0; j < SMP_MB_SIZE; j++) {
+        ret = chMBPostTimeout(&smp_mb_req, (msg_t)(i + j), TIME_MS2I(1000));
+        test_assert(ret == MSG_OK, "post failed");
+      }
+      for (j = 0; j < SMP_MB_SIZE; j++) {
+        ret = chMBFetchTimeout(&smp_mb_ack, &msg, TIME_MS2I(1000));
+        test_assert(ret == MSG_OK, "fetch failed");
+        test_assert(msg == (msg_t)(i + j) + 1, "wrong answer");
+      }
+    }
+  }
+  test_end_step(2);
+
+  /* [12.4.3] Checking that both mailboxes are empty.*/
+  test_set_step(3);
+  {
+    test_assert_lock(chMBGetUsedCountI(&smp_mb_req) == 0, "not empty");
+    test_assert_lock(chMBGetUsedCountI(&smp_mb_ack) == 0, "not empty");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_012_004 = {
+  "Mailboxes between cores",
+  NULL,
+  NULL,
+  rt_test_012_004_execute
+};
+#endif /* CH_CFG_USE_MAILBOXES */
+
+
+#if (CH_CFG_USE_MUTEXES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_005 [12.5] Mutexes contention between cores
+ *
+ * <h2>Description</h2>
+ * A mutex is locked and unlocked into a continuous loop by the test
+ * thread while a thread on the second core does the same on the same
+ * mutex, both threads execute a short code section with the mutex owned
+ * and another one without. The performance depends on the
+ * CH_CFG_MUTEXES_SPIN_COUNT setting.<br>
+ * The performance is calculated by measuring the number of iterations
+ * after a second of continuous operations.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MUTEXES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.5.1] Checking that the second core is running then starting the
+ *   thread contending the mutex.
+ * - [12.5.2] The mutex is locked and unlocked. The operation is
+ *   repeated continuously in a one-second time window.
+ * - [12.5.3] Stopping the thread on the second core.
+ * - [12.5.4] The score is printed.
+ * .
+ */
+
+static void rt_test_012_005_execute(void) {
+  uint32_t n;
+
+  /* [12.5.1] Checking that the second core is running then starting the
+     thread contending the mutex.*/
+  test_set_step(1);
+  {
+    test_assert(smp_core_started, "core not started");
+    smp_mtx_run = true;
+    chSemSignal(&smp_sem_mtx);
+  }
+  test_end_step(1);
+
+  /* [12.5.2] The mutex is locked and unlocked. The operation is
+     repeated continuously in a one-second time window.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chMtxLock(&smp_mtx);
+      smp_mtx_work();
+      chMtxUnlock(&smp_mtx);
+      smp_mtx_work();
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [12.5.3] Stopping the thread on the second core.*/
+  test_set_step(3);
+  {
+    smp_mtx_run = false;
+    test_assert(chSemWaitTimeout(&smp_sem_ack, TIME_MS2I(1000)) == MSG_OK,
+                "no answer");
+  }
+  test_end_step(3);
+
+  /* [12.5.4] The score is printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" lock+unlock/S");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_012_005 = {
+  "Mutexes contention between cores",
+  NULL,
+  NULL,
+  rt_test_012_005_execute
+};
+#endif /* CH_CFG_USE_MUTEXES */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const rt_test_sequence_012_array[] = {
+  &rt_test_012_001,
+  &rt_test_012_002,
+#if (CH_CFG_USE_MESSAGES) || defined(__DOXYGEN__)
+  &rt_test_012_003,
+#endif
+#if (CH_CFG_USE_MAILBOXES) || defined(__DOXYGEN__)
+  &rt_test_012_004,
+#endif
+#if (CH_CFG_USE_MUTEXES) || defined(__DOXYGEN__)
+  &rt_test_012_005,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Multi-core.
+ */
+const testsequence_t rt_test_sequence_012 = {
+  "Multi-core",
+  rt_test_sequence_012_array
+};
+
+#endif /* CH_CFG_SMP_MODE == TRUE */
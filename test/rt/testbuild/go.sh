@@ -92,7 +92,7 @@ test cfg2 "-DCH_CFG_OPTIMIZE_SPEED=FALSE"
 test cfg3 "-DCH_CFG_TIME_QUANTUM=0"
 test cfg4 "-DCH_CFG_USE_REGISTRY=FALSE -DCH_CFG_USE_DYNAMIC=FALSE"
 test cfg5 "-DCH_CFG_USE_TM=FALSE"
-test cfg6 "-DCH_CFG_USE_SEMAPHORES=FALSE -DCH_CFG_USE_MAILBOXES=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE"
+test cfg6 "-DCH_CFG_USE_SEMAPHORES=FALSE -DCH_CFG_USE_MAILBOXES=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_OBJ_CACHES=FALSE -DCH_CFG_USE_JOBS=FALSE"
 test cfg7 "-DCH_CFG_USE_SEMAPHORES_PRIORITY=TRUE"
 test cfg8 "-DCH_CFG_USE_MUTEXES=FALSE -DCH_CFG_USE_CONDVARS=FALSE"
 test cfg9 "-DCH_CFG_USE_MUTEXES_RECURSIVE=TRUE"
@@ -100,12 +100,12 @@ test cfg10 "-DCH_CFG_USE_CONDVARS=FALSE"
 test cfg11 "-DCH_CFG_USE_CONDVARS_TIMEOUT=FALSE"
 test cfg12 "-DCH_CFG_USE_EVENTS=FALSE"
 test cfg13 "-DCH_CFG_USE_EVENTS_TIMEOUT=FALSE"
-test cfg14 "-DCH_CFG_USE_MESSAGES=FALSE"
+test cfg14 "-DCH_CFG_USE_MESSAGES=FALSE -DCH_CFG_USE_DELEGATES=FALSE"
 test cfg15 "-DCH_CFG_USE_MESSAGES_PRIORITY=TRUE"
-test cfg16 "-DCH_CFG_USE_MAILBOXES=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE"
-test cfg17 "-DCH_CFG_USE_MEMCORE=FALSE -DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_HEAP=FALSE -DCH_CFG_USE_DYNAMIC=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE"
-test cfg18 "-DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_HEAP=FALSE -DCH_CFG_USE_DYNAMIC=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE"
-test cfg19 "-DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE"
+test cfg16 "-DCH_CFG_USE_MAILBOXES=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_JOBS=FALSE"
+test cfg17 "-DCH_CFG_USE_MEMCORE=FALSE -DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_HEAP=FALSE -DCH_CFG_USE_DYNAMIC=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE -DCH_CFG_USE_JOBS=FALSE"
+test cfg18 "-DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_HEAP=FALSE -DCH_CFG_USE_DYNAMIC=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE -DCH_CFG_USE_JOBS=FALSE"
+test cfg19 "-DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE -DCH_CFG_USE_JOBS=FALSE"
 test cfg20 "-DCH_CFG_USE_HEAP=FALSE -DCH_CFG_USE_FACTORY=FALSE"
 test cfg21 "-DCH_CFG_USE_DYNAMIC=FALSE"
 test cfg22 "-DCH_DBG_STATISTICS=TRUE"
@@ -122,6 +122,30 @@ test cfg32 "-DCH_CFG_ST_RESOLUTION=16 -DCH_CFG_INTERVALS_SIZE=64"
 test cfg33 "-DCH_CFG_INTERVALS_SIZE=64"
 test cfg34 "-DCH_CFG_USE_OBJ_FIFOS=FALSE"
 test cfg35 "-DCH_CFG_USE_FACTORY=FALSE"
+test cfg36 "-DCH_CFG_USE_READY_BITMAP=TRUE"
+test cfg37 "-DCH_CFG_USE_READY_BITMAP=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_SYSTEM_STATE_CHECK=TRUE"
+test cfg38 "-DCH_CFG_USE_TIMER_WHEEL=TRUE"
+test cfg39 "-DCH_CFG_USE_TIMER_WHEEL=TRUE -DCH_CFG_VT_WHEEL_LEVELS=2 -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_SYSTEM_STATE_CHECK=TRUE"
+test cfg40 "-DCH_CFG_USE_HEAP_TLSF=TRUE"
+test cfg41 "-DCH_CFG_USE_HEAP_TLSF=TRUE -DCH_CFG_HEAP_TLSF_LEVELS=4 -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE"
+test cfg42 "-DCH_CFG_FACTORY_HASH_SIZE=16"
+test cfg43 "-DCH_CFG_PIPES_SPSC=TRUE -DCH_CFG_OBJ_FIFOS_SPSC=TRUE"
+test cfg44 "-DCH_CFG_PIPES_SPSC=TRUE -DCH_CFG_OBJ_FIFOS_SPSC=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_SYSTEM_STATE_CHECK=TRUE"
+test cfg45 "-DCH_CFG_USE_JOBS_POOLS=TRUE -DCH_CFG_JOBS_PRIORITIES=3"
+test cfg46 "-DCH_CFG_USE_JOBS_POOLS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_SYSTEM_STATE_CHECK=TRUE"
+test cfg47 "-DCH_CFG_OBJ_CACHES_STATS=TRUE -DCH_CFG_OBJ_CACHES_CLUSTER_MAX=4 -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE"
+test cfg48 "-DCH_CFG_ST_TIMEDELTA=2 -DCH_CFG_TIME_QUANTUM=0 -DCH_DBG_THREADS_PROFILING=FALSE"
+test cfg49 "-DCH_CFG_ST_TIMEDELTA=2 -DCH_CFG_TIME_QUANTUM=0 -DCH_DBG_THREADS_PROFILING=FALSE -DCH_CFG_USE_TIMER_WHEEL=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE"
+test cfg50 "-DSIM_USE_VIRTUAL_TIME=TRUE"
+test cfg51 "-DSIM_USE_VIRTUAL_TIME=TRUE -DCH_CFG_ST_TIMEDELTA=2 -DCH_CFG_TIME_QUANTUM=0 -DCH_DBG_THREADS_PROFILING=FALSE"
+USE_SIM_ARCH=X64 test cfg52 "-DCH_CFG_SMP_MODE=TRUE"
+USE_SIM_ARCH=X64 test cfg53 "-DCH_CFG_SMP_MODE=TRUE -DCH_CFG_USE_READY_BITMAP=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_SYSTEM_STATE_CHECK=TRUE"
+test cfg54 "-DCH_DBG_STATISTICS=TRUE -DCH_DBG_FILL_THREADS=TRUE"
+test cfg55 "-DCH_DBG_TRACE_MASK=CH_DBG_TRACE_MASK_FULL -DCH_DBG_TRACE_STREAM=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE"
+test cfg56 "-DCH_CFG_USE_TM_HISTOGRAMS=TRUE -DCH_DBG_STATISTICS=TRUE"
+test cfg57 "-DCH_CFG_USE_EVENTS_INDEX=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE"
+test cfg58 "-DCH_CFG_USE_RWLOCKS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_SYSTEM_STATE_CHECK=TRUE"
+USE_SIM_ARCH=X64 test cfg59 "-DCH_CFG_SMP_MODE=TRUE -DCH_CFG_USE_RWLOCKS=TRUE -DCH_CFG_MUTEXES_SPIN_COUNT=100"
 
 rm *log.txt 2> /dev/null
 echo
@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+#
+#    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+
+"""Converts a ChibiOS/RT trace stream into the Chrome trace JSON format.
+
+The input is the byte stream produced by chDbgReadTrace() or
+chDbgDrainTrace() with CH_DBG_TRACE_STREAM enabled. The output can be
+loaded in chrome://tracing or in Perfetto.
+
+Threads, ISRs and objects are identified by address, a map file with
+"address name" lines, for example extracted from the ELF symbols or from
+the registry, can be used in order to give them names.
+
+Usage:
+  chtrace2json.py [-r RT_FREQUENCY] [-m MAP_FILE] trace.bin [trace.json]
+"""
+
+import argparse
+import json
+import sys
+
+TYPE_SWITCH = 1
+TYPE_ISR_ENTER = 2
+TYPE_ISR_LEAVE = 3
+TYPE_HALT = 4
+TYPE_USER = 5
+TYPE_OBJECT = 6
+TYPE_DROP = 7
+
+STATE_NAMES = ["READY", "CURRENT", "WTSTART", "SUSPENDED", "QUEUED", "WTSEM",
+               "WTMTX", "WTCOND", "SLEEPING", "WTEXIT", "WTOREVT", "WTANDEVT",
+               "SNDMSGQ", "SNDMSG", "WTMSG", "FINAL"]
+
+OP_NAMES = ["sem wait", "sem signal", "mutex lock", "mutex unlock",
+            "mailbox post", "mailbox fetch", "timer set", "timer reset",
+            "timer fire"]
+
+RTSTAMP_RANGE = 1 << 24
+
+PID = 1
+ISR_TID = 0
+
+
+class TraceError(Exception):
+    pass
+
+
+class Reader(object):
+    """Sequential reader of the encoded stream."""
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def eof(self):
+        return self.pos >= len(self.data)
+
+    def byte(self):
+        if self.eof():
+            raise TraceError("truncated stream")
+        b = self.data[self.pos]
+        self.pos += 1
+        return b
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            b = self.byte()
+            value |= (b & 0x7F) << shift
+            shift += 7
+            if (b & 0x80) == 0:
+                return value
+
+
+def decode(data):
+    """Yields the system tick frequency then (type, state, time, rtdelta,
+    payload) tuples, the system time is absolute and not wrapped, the
+    accurate time stamp is a delta modulo 2^24."""
+    rd = Reader(data)
+    if bytes(data[0:3]) != b"CHT":
+        raise TraceError("not a trace stream")
+    rd.pos = 3
+    version = rd.byte()
+    if version != 1:
+        raise TraceError("unsupported stream version %d" % version)
+    st_frequency = rd.varint()
+    yield st_frequency
+
+    time = 0
+    while not rd.eof():
+        start = rd.pos
+        hdr = rd.byte()
+        rtype = hdr & 7
+        state = hdr >> 3
+        try:
+            time += rd.varint()
+            rtdelta = rd.varint()
+            if rtype in (TYPE_SWITCH, TYPE_USER, TYPE_OBJECT):
+                payload = (rd.varint(), rd.varint())
+            elif rtype in (TYPE_ISR_ENTER, TYPE_ISR_LEAVE, TYPE_HALT,
+                           TYPE_DROP):
+                payload = (rd.varint(),)
+            else:
+                raise TraceError("unknown record type %d at offset %d" %
+                                 (rtype, start))
+        except TraceError as e:
+            if not rd.eof():
+                raise
+            # A capture can be interrupted in the middle of a record.
+            sys.stderr.write("warning: %s, last record ignored\n" % e)
+            return
+        yield (rtype, state, time, rtdelta, payload)
+
+
+def load_map(path):
+    names = {}
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) >= 2:
+                names[int(fields[0], 16)] = fields[1]
+    return names
+
+
+def convert(data, rt_frequency, names):
+    records = decode(data)
+    st_frequency = next(records)
+    events = []
+    current = None
+    isr_depth = 0
+    threads = set()
+    rt_us = 0.0
+    last_time = 0
+
+    def label(addr):
+        return names.get(addr, "0x%x" % addr)
+
+    for rtype, state, time, rtdelta, payload in records:
+
+        # Time stamps in microseconds, the accurate counter is used when
+        # its frequency is known, its wraps are resolved using the system
+        # time delta as reference.
+        if rt_frequency:
+            expected = (time - last_time) * rt_frequency / st_frequency
+            wraps = max(0, round((expected - rtdelta) / RTSTAMP_RANGE))
+            rt_us += (rtdelta + wraps * RTSTAMP_RANGE) * 1e6 / rt_frequency
+            ts = rt_us
+        else:
+            ts = time * 1e6 / st_frequency
+        last_time = time
+
+        tid = ISR_TID if isr_depth > 0 else current
+        if rtype == TYPE_SWITCH:
+            ntp, wtobjp = payload
+            if current is not None:
+                args = {"state": STATE_NAMES[state]
+                        if state < len(STATE_NAMES) else str(state)}
+                if wtobjp != 0:
+                    args["object"] = label(wtobjp)
+                events.append({"ph": "E", "pid": PID, "tid": current,
+                               "ts": ts, "args": args})
+            events.append({"ph": "B", "pid": PID, "tid": ntp, "ts": ts,
+                           "name": label(ntp)})
+            threads.add(ntp)
+            current = ntp
+        elif rtype == TYPE_ISR_ENTER:
+            isr_depth += 1
+            events.append({"ph": "B", "pid": PID, "tid": ISR_TID, "ts": ts,
+                           "name": label(payload[0])})
+        elif rtype == TYPE_ISR_LEAVE:
+            if isr_depth > 0:
+                isr_depth -= 1
+                events.append({"ph": "E", "pid": PID, "tid": ISR_TID,
+                               "ts": ts})
+        elif rtype == TYPE_OBJECT:
+            name = OP_NAMES[state] if state < len(OP_NAMES) else str(state)
+            events.append({"ph": "i", "s": "t", "pid": PID,
+                           "tid": tid if tid is not None else ISR_TID,
+                           "ts": ts, "name": name,
+                           "args": {"object": label(payload[0]),
+                                    "arg": payload[1]}})
+        elif rtype == TYPE_USER:
+            events.append({"ph": "i", "s": "t", "pid": PID,
+                           "tid": tid if tid is not None else ISR_TID,
+                           "ts": ts, "name": "user",
+                           "args": {"up1": "0x%x" % payload[0],
+                                    "up2": "0x%x" % payload[1]}})
+        elif rtype == TYPE_HALT:
+            events.append({"ph": "i", "s": "g", "pid": PID, "tid": ISR_TID,
+                           "ts": ts, "name": "halt",
+                           "args": {"reason": label(payload[0])}})
+        elif rtype == TYPE_DROP:
+            events.append({"ph": "i", "s": "g", "pid": PID, "tid": ISR_TID,
+                           "ts": ts, "name": "records lost",
+                           "args": {"count": payload[0]}})
+
+    # Metadata naming the tracks.
+    events.append({"ph": "M", "pid": PID, "tid": ISR_TID,
+                   "name": "thread_name", "args": {"name": "ISRs"}})
+    for tp in sorted(threads):
+        events.append({"ph": "M", "pid": PID, "tid": tp,
+                       "name": "thread_name", "args": {"name": label(tp)}})
+
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Converts a ChibiOS/RT trace stream to Chrome JSON.")
+    parser.add_argument("-r", "--rt-frequency", type=int, default=0,
+                        help="frequency of the realtime counter in Hz, "
+                             "enables the accurate time stamps")
+    parser.add_argument("-m", "--map", help="file of \"address name\" lines")
+    parser.add_argument("input", help="trace stream file")
+    parser.add_argument("output", nargs="?", help="JSON file, default stdout")
+    args = parser.parse_args()
+
+    names = load_map(args.map) if args.map else {}
+    with open(args.input, "rb") as f:
+        data = f.read()
+    try:
+        trace = convert(data, args.rt_frequency, names)
+    except TraceError as e:
+        sys.stderr.write("error: %s\n" % e)
+        return 1
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())